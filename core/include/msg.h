@@ -176,6 +176,41 @@ int msg_receive(msg_t *m);
  */
 int msg_try_receive(msg_t *m);
 
+/**
+ * @brief Send multiple messages to a thread at once (non-blocking).
+ *
+ * Delivers up to @p num messages from @p m to @p target_pid within a single
+ * critical section and wakes the target at most once. If the target is
+ * waiting in msg_receive(), the first message is handed over directly, the
+ * rest is put into the target's message queue. Delivery stops as soon as the
+ * queue is full, so a target without a message queue gets at most one
+ * message. Can be called from an ISR.
+ *
+ * @param[in] m             Array of @p num messages, must not be NULL.
+ * @param[in] num           Number of messages in @p m.
+ * @param[in] target_pid    PID of target thread
+ *
+ * @return  Number of messages delivered, in order, starting at @p m[0]
+ * @return  -1, on error (invalid PID)
+ */
+int msg_send_batch(msg_t *m, unsigned num, kernel_pid_t target_pid);
+
+/**
+ * @brief Receive multiple messages at once.
+ *
+ * Blocks until at least one message is available, then copies up to @p num
+ * queued messages to @p m within a single critical section. Threads blocked
+ * in msg_send() on the caller are moved into the freed queue space and woken
+ * with at most one context switch.
+ *
+ * @param[out] m    Array of at least @p num ``msg_t`` structures, must not be
+ *                  NULL.
+ * @param[in] num   Maximum number of messages to receive, must be > 0.
+ *
+ * @return  Number of messages received (at least 1).
+ */
+int msg_receive_batch(msg_t *m, unsigned num);
+
 /**
  * @brief Send a message, block until reply received.
  *
@@ -15,6 +15,14 @@
  * @file
  * @brief       RIOT synchronization API
  *
+ * With the `mutex_priority_inheritance` module, a thread blocking on a mutex
+ * raises the priority of the mutex' owner to its own priority until the owner
+ * unlocks the mutex. This bounds priority inversion where a low priority
+ * owner would otherwise be preempted by medium priority threads.
+ * A thread holding several mutexes runs at the highest priority of their
+ * waiters, in whatever order it releases them. The inheritance is not
+ * transitive.
+ *
  * @author      Kaspar Schleiser <kaspar@schleiser.de>
  */
 
@@ -23,6 +31,7 @@
 
 #include "priority_queue.h"
 #include "atomic.h"
+#include "kernel_types.h"
 
 #ifdef __cplusplus
  extern "C" {
@@ -45,13 +54,29 @@ typedef struct mutex_t {
      * @internal
      */
     priority_queue_t queue;
+#if defined(MODULE_MUTEX_PRIORITY_INHERITANCE) || defined(DOXYGEN)
+    /**
+     * @brief   The thread currently holding the mutex.
+     * @internal
+     */
+    kernel_pid_t owner;
+    /**
+     * @brief   The next mutex held by @ref mutex_t::owner.
+     * @internal
+     */
+    struct mutex_t *next_held;
+#endif
 } mutex_t;
 
 /**
  * @brief Static initializer for mutex_t.
  * @details This initializer is preferable to mutex_init().
  */
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+#define MUTEX_INIT { ATOMIC_INIT(0), PRIORITY_QUEUE_INIT, KERNEL_PID_UNDEF, NULL }
+#else
 #define MUTEX_INIT { ATOMIC_INIT(0), PRIORITY_QUEUE_INIT }
+#endif
 
 /**
  * @brief Initializes a mutex object.
@@ -94,6 +94,9 @@
 /**
  * @def SCHED_PRIO_LEVELS
  * @brief The number of thread priority levels
+ *
+ * @note  The scheduler keeps one bit per level in a 32 bit bitmap, so at most
+ *        32 levels are supported.
  */
 #ifndef SCHED_PRIO_LEVELS
 #define SCHED_PRIO_LEVELS 16
@@ -114,6 +117,21 @@ int sched_run(void);
  */
 void sched_set_status(tcb_t *process, unsigned int status);
 
+/**
+ * @brief   Change the priority of a thread
+ *
+ * If the thread is on a runqueue, it is moved to the tail of the runqueue of
+ * its new priority. No context switch is triggered, call sched_switch() if
+ * needed.
+ *
+ * @pre     Interrupts are disabled.
+ *
+ * @param[in]   process     Pointer to the thread control block of the
+ *                          targeted thread
+ * @param[in]   priority    The new priority, must be < SCHED_PRIO_LEVELS
+ */
+void sched_change_priority(tcb_t *process, uint16_t priority);
+
 /**
  * @brief       Yield if approriate.
  *
@@ -74,6 +74,11 @@ typedef struct tcb_t {
     cib_t msg_queue;            /**< message queue                  */
     msg_t *msg_array;           /**< memory holding messages        */
 
+#if defined(MODULE_MUTEX_PRIORITY_INHERITANCE) || defined(DOXYGEN)
+    uint16_t base_priority;     /**< priority without inheritance   */
+    struct mutex_t *mutexes;    /**< mutexes the thread holds       */
+#endif
+
 #if defined DEVELHELP || defined(SCHED_TEST_STACK)
     char *stack_start;          /**< thread's stack start address   */
 #endif
@@ -213,6 +213,97 @@ int msg_send_int(msg_t *m, kernel_pid_t target_pid)
     }
 }
 
+int msg_send_batch(msg_t *m, unsigned num, kernel_pid_t target_pid)
+{
+    unsigned state = disableIRQ();
+    tcb_t *target = (tcb_t *) sched_threads[target_pid];
+    kernel_pid_t sender_pid = inISR() ? KERNEL_PID_ISR : sched_active_pid;
+    unsigned i = 0;
+    int woken = 0;
+
+    if (target == NULL) {
+        DEBUG("msg_send_batch(): target thread does not exist\n");
+        restoreIRQ(state);
+        return -1;
+    }
+
+    if ((num > 0) && (target->status == STATUS_RECEIVE_BLOCKED)) {
+        DEBUG("msg_send_batch: Direct msg copy to %" PRIkernel_pid ".\n",
+              target_pid);
+        m[0].sender_pid = sender_pid;
+        *((msg_t *) target->wait_data) = m[0];
+        sched_set_status(target, STATUS_PENDING);
+        woken = 1;
+        i++;
+    }
+
+    for (; i < num; i++) {
+        m[i].sender_pid = sender_pid;
+        if (!queue_msg(target, &m[i])) {
+            break;
+        }
+    }
+
+    uint16_t target_prio = target->priority;
+    restoreIRQ(state);
+
+    if (woken) {
+        sched_switch(target_prio);
+    }
+
+    return i;
+}
+
+int msg_receive_batch(msg_t *m, unsigned num)
+{
+    assert(num > 0);
+
+    unsigned state = disableIRQ();
+    tcb_t *me = (tcb_t *) sched_active_thread;
+    unsigned n = 0;
+    int queue_index;
+
+    if (me->msg_array) {
+        while ((n < num) && ((queue_index = cib_get(&(me->msg_queue))) >= 0)) {
+            m[n++] = me->msg_array[queue_index];
+        }
+    }
+
+    if (n == 0) {
+        /* nothing queued: block like msg_receive() */
+        restoreIRQ(state);
+        return msg_receive(m);
+    }
+
+    /* move messages of blocked senders into the freed queue space */
+    uint16_t sender_prio = THREAD_PRIORITY_IDLE;
+    while (cib_avail(&(me->msg_queue)) <= me->msg_queue.mask) {
+        priority_queue_node_t *node = priority_queue_remove_head(&(me->msg_waiters));
+
+        if (node == NULL) {
+            break;
+        }
+
+        tcb_t *sender = (tcb_t *) node->data;
+        me->msg_array[cib_put(&(me->msg_queue))] = *((msg_t *) sender->wait_data);
+
+        if (sender->status != STATUS_REPLY_BLOCKED) {
+            sender->wait_data = NULL;
+            sched_set_status(sender, STATUS_PENDING);
+            if (sender->priority < sender_prio) {
+                sender_prio = sender->priority;
+            }
+        }
+    }
+
+    restoreIRQ(state);
+    if (sender_prio < THREAD_PRIORITY_IDLE) {
+        sched_switch(sender_prio);
+    }
+
+    return n;
+}
+
 int msg_send_receive(msg_t *m, msg_t *reply, kernel_pid_t target_pid)
 {
     assert(sched_active_pid != target_pid);
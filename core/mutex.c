@@ -36,17 +36,97 @@
 
 static void mutex_wait(struct mutex_t *mutex);
 
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+/* must be called with interrupts disabled */
+static inline void _set_owner(struct mutex_t *mutex, tcb_t *owner)
+{
+    if (owner) {
+        mutex->owner = owner->pid;
+        mutex->next_held = owner->mutexes;
+        owner->mutexes = mutex;
+    }
+    else {
+        mutex->owner = KERNEL_PID_UNDEF;
+        mutex->next_held = NULL;
+    }
+}
+
+/* must be called with interrupts disabled */
+static inline void _restore_owner_priority(struct mutex_t *mutex)
+{
+    if (mutex->owner == KERNEL_PID_UNDEF) {
+        return;
+    }
+
+    tcb_t *owner = (tcb_t *) sched_threads[mutex->owner];
+
+    if (!owner) {
+        return;
+    }
+
+    /* the owner keeps the highest priority of the waiters of the mutexes it
+     * still holds */
+    uint16_t priority = owner->base_priority;
+
+    for (struct mutex_t **ptr = &owner->mutexes; *ptr;) {
+        if (*ptr == mutex) {
+            *ptr = mutex->next_held;
+            continue;
+        }
+        priority_queue_node_t *waiter = (*ptr)->queue.first;
+
+        if (waiter && (waiter->priority < priority)) {
+            priority = waiter->priority;
+        }
+        ptr = &(*ptr)->next_held;
+    }
+    mutex->next_held = NULL;
+
+    sched_change_priority(owner, priority);
+}
+
+/* must be called with interrupts disabled */
+static inline void _inherit_priority(struct mutex_t *mutex, uint16_t priority)
+{
+    if (mutex->owner == KERNEL_PID_UNDEF) {
+        return;
+    }
+
+    tcb_t *owner = (tcb_t *) sched_threads[mutex->owner];
+
+    if (owner && (owner->priority > priority)) {
+        DEBUG("mutex: raising priority of %" PRIkernel_pid " to %" PRIu16 "\n",
+              owner->pid, priority);
+        sched_change_priority(owner, priority);
+    }
+}
+#else
+#define _set_owner(mutex, owner)            (void)(mutex)
+#define _restore_owner_priority(mutex)      (void)(mutex)
+#define _inherit_priority(mutex, priority)  (void)(mutex)
+#endif
+
 int mutex_trylock(struct mutex_t *mutex)
 {
     DEBUG("%s: trylocking to get mutex. val: %u\n", sched_active_thread->name, ATOMIC_VALUE(mutex->val));
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+    unsigned irqstate = disableIRQ();
+    int res = atomic_set_to_one(&mutex->val);
+    if (res) {
+        _set_owner(mutex, (tcb_t *) sched_active_thread);
+    }
+    restoreIRQ(irqstate);
+    return res;
+#else
     return atomic_set_to_one(&mutex->val);
+#endif
 }
 
 void mutex_lock(struct mutex_t *mutex)
 {
     DEBUG("%s: trying to get mutex. val: %u\n", sched_active_thread->name, ATOMIC_VALUE(mutex->val));
 
-    if (atomic_set_to_one(&mutex->val) == 0) {
+    if (mutex_trylock(mutex) == 0) {
         /* mutex was locked. */
         mutex_wait(mutex);
     }
@@ -60,6 +140,7 @@ static void mutex_wait(struct mutex_t *mutex)
     if (atomic_set_to_one(&mutex->val)) {
         /* somebody released the mutex. return. */
         DEBUG("%s: mutex_wait early out. %u\n", sched_active_thread->name, ATOMIC_VALUE(mutex->val));
+        _set_owner(mutex, (tcb_t *) sched_active_thread);
         restoreIRQ(irqstate);
         return;
     }
@@ -75,6 +156,8 @@ static void mutex_wait(struct mutex_t *mutex)
 
     priority_queue_add(&(mutex->queue), &n);
 
+    _inherit_priority(mutex, sched_active_thread->priority);
+
     restoreIRQ(irqstate);
 
     thread_yield_higher();
@@ -93,10 +176,13 @@ void mutex_unlock(struct mutex_t *mutex)
         return;
     }
 
+    _restore_owner_priority(mutex);
+
     priority_queue_node_t *next = priority_queue_remove_head(&(mutex->queue));
     if (!next) {
         /* the mutex was locked and no thread was waiting for it */
         ATOMIC_VALUE(mutex->val) = 0;
+        _set_owner(mutex, NULL);
         restoreIRQ(irqstate);
         return;
     }
@@ -104,6 +190,7 @@ void mutex_unlock(struct mutex_t *mutex)
     tcb_t *process = (tcb_t *) next->data;
     DEBUG("mutex_unlock: waking up waiting thread %" PRIkernel_pid "\n", process->pid);
     sched_set_status(process, STATUS_PENDING);
+    _set_owner(mutex, process);
 
     uint16_t process_priority = process->priority;
     restoreIRQ(irqstate);
@@ -116,14 +203,18 @@ void mutex_unlock_and_sleep(struct mutex_t *mutex)
     unsigned irqstate = disableIRQ();
 
     if (ATOMIC_VALUE(mutex->val) != 0) {
+        _restore_owner_priority(mutex);
+
         priority_queue_node_t *next = priority_queue_remove_head(&(mutex->queue));
         if (next) {
             tcb_t *process = (tcb_t *) next->data;
             DEBUG("%s: waking up waiter.\n", process->name);
             sched_set_status(process, STATUS_PENDING);
+            _set_owner(mutex, process);
         }
         else {
             ATOMIC_VALUE(mutex->val) = 0; /* This is safe, interrupts are disabled */
+            _set_owner(mutex, NULL);
         }
     }
     DEBUG("%s: going to sleep.\n", sched_active_thread->name);
@@ -55,11 +55,76 @@ volatile kernel_pid_t sched_active_pid = KERNEL_PID_UNDEF;
 clist_node_t *sched_runqueues[SCHED_PRIO_LEVELS];
 static uint32_t runqueue_bitcache = 0;
 
+#if SCHED_PRIO_LEVELS > 32
+#error "SCHED_PRIO_LEVELS must not exceed the width of runqueue_bitcache (32)"
+#endif
+
 #ifdef MODULE_SCHEDSTATISTICS
 static void (*sched_cb) (uint32_t timestamp, uint32_t value) = NULL;
 schedstat sched_pidlist[KERNEL_PID_LAST + 1];
 #endif
 
+/**
+ * @brief   Returns the highest priority level with a runnable thread
+ *
+ * runqueue_bitcache is never empty once the scheduler is started (the idle
+ * thread is always runnable), so count-trailing-zeros is always defined here.
+ * This compiles to a single instruction (or `rbit` + `clz` on Cortex-M3 and
+ * up) instead of the bit-by-bit loop of bitarithm_lsb().
+ */
+static inline unsigned _runqueue_first_prio(void)
+{
+#if defined(__GNUC__)
+    return (unsigned)__builtin_ctz(runqueue_bitcache);
+#else
+    return bitarithm_lsb(runqueue_bitcache);
+#endif
+}
+
+/**
+ * @brief   Appends @p entry to the tail of the runqueue for @p prio
+ *
+ * The runqueue head is the next thread to run, head->prev is its tail, so
+ * both ends are reachable in O(1) and threads of equal priority are scheduled
+ * in FIFO order.
+ */
+static inline void _runqueue_push(clist_node_t *entry, uint16_t prio)
+{
+    clist_node_t *head = sched_runqueues[prio];
+
+    if (head) {
+        entry->next = head;
+        entry->prev = head->prev;
+        head->prev->next = entry;
+        head->prev = entry;
+    }
+    else {
+        entry->next = entry;
+        entry->prev = entry;
+        sched_runqueues[prio] = entry;
+        runqueue_bitcache |= 1 << prio;
+    }
+}
+
+/**
+ * @brief   Unlinks @p entry from the runqueue for @p prio
+ */
+static inline void _runqueue_remove(clist_node_t *entry, uint16_t prio)
+{
+    if (entry->next == entry) {
+        sched_runqueues[prio] = NULL;
+        runqueue_bitcache &= ~(1 << prio);
+    }
+    else {
+        entry->prev->next = entry->next;
+        entry->next->prev = entry->prev;
+
+        if (sched_runqueues[prio] == entry) {
+            sched_runqueues[prio] = entry->next;
+        }
+    }
+}
+
 int sched_run(void)
 {
     sched_context_switch_request = 0;
@@ -69,7 +134,7 @@ int sched_run(void)
     /* The bitmask in runqueue_bitcache is never empty,
      * since the threading should not be started before at least the idle thread was started.
      */
-    int nextrq = bitarithm_lsb(runqueue_bitcache);
+    unsigned nextrq = _runqueue_first_prio();
     tcb_t *next_thread = clist_get_container(sched_runqueues[nextrq], tcb_t, rq_entry);
 
     DEBUG("sched_run: active thread: %" PRIkernel_pid ", next thread: %" PRIkernel_pid "\n",
@@ -135,25 +200,37 @@ void sched_set_status(tcb_t *process, unsigned int status)
         if (!(process->status >= STATUS_ON_RUNQUEUE)) {
             DEBUG("sched_set_status: adding thread %" PRIkernel_pid " to runqueue %" PRIu16 ".\n",
                   process->pid, process->priority);
-            clist_add(&sched_runqueues[process->priority], &(process->rq_entry));
-            runqueue_bitcache |= 1 << process->priority;
+            _runqueue_push(&(process->rq_entry), process->priority);
         }
     }
     else {
         if (process->status >= STATUS_ON_RUNQUEUE) {
             DEBUG("sched_set_status: removing thread %" PRIkernel_pid " to runqueue %" PRIu16 ".\n",
                   process->pid, process->priority);
-            clist_remove(&sched_runqueues[process->priority], &(process->rq_entry));
-
-            if (!sched_runqueues[process->priority]) {
-                runqueue_bitcache &= ~(1 << process->priority);
-            }
+            _runqueue_remove(&(process->rq_entry), process->priority);
         }
     }
 
     process->status = status;
 }
 
+void sched_change_priority(tcb_t *process, uint16_t priority)
+{
+    if (process->priority == priority) {
+        return;
+    }
+
+    DEBUG("sched_change_priority: thread %" PRIkernel_pid " %" PRIu16 " -> %" PRIu16 "\n",
+          process->pid, process->priority, priority);
+
+    if (process->status >= STATUS_ON_RUNQUEUE) {
+        _runqueue_remove(&(process->rq_entry), process->priority);
+        _runqueue_push(&(process->rq_entry), priority);
+    }
+
+    process->priority = priority;
+}
+
 void sched_switch(uint16_t other_prio)
 {
     tcb_t *active_thread = (tcb_t *) sched_active_thread;
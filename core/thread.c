@@ -195,6 +195,11 @@ kernel_pid_t thread_create(char *stack, int stacksize, char priority, int flags,
     cb->priority = priority;
     cb->status = 0;
 
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+    cb->base_priority = priority;
+    cb->mutexes = NULL;
+#endif
+
     cb->rq_entry.next = NULL;
     cb->rq_entry.prev = NULL;
 
@@ -124,6 +124,10 @@ extern const char* (*real_gai_strerror)(int errcode);
 extern FILE* (*real_fopen)(const char *path, const char *mode);
 extern mode_t (*real_umask)(mode_t cmask);
 extern ssize_t (*real_writev)(int fildes, const struct iovec *iov, int iovcnt);
+#ifdef MODULE_NETDEV2_TAP_POLL
+/* The ... is a hack to save includes: */
+extern int (*real_pthread_create)(void *thread, ...);
+#endif
 
 #ifdef __MACH__
 #else
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @defgroup    native_vtime Virtual time
+ * @ingroup     native_cpu
+ * @brief       Runs the timer of native on a simulated clock
+ *
+ * With the pseudomodule `native_vtime`, the timer of native does not follow
+ * the clock of the host. Instead, time stands still while any thread runs
+ * and jumps to the next timer as soon as all threads are idle. A simulation
+ * thus takes only as long as the host needs to compute it, and, as long as
+ * nothing comes in from outside, it takes the same course every time.
+ *
+ * Every read of the timer advances the clock by 1 microsecond, so code that
+ * spins on the timer still gets on.
+ *
+ * By default the clock is local to the instance. Instances that share a
+ * @ref native_shm_radio medium also share a clock in it: it only advances
+ * when all of them are idle, and a frame keeps its receiver counted as
+ * running until it has been woken up. An instance that is killed while it
+ * runs stops the clock for all others until it is started again with the
+ * same node number. Input from the host (TAP, UART) is taken whenever it
+ * comes in and is not synchronized with the clock.
+ *
+ * To try it, build tests/native_vtime, or tests/shm_radio_rpl with VTIME=1.
+ * @{
+ *
+ * @file
+ * @brief       Virtual time of native
+ */
+#ifndef NATIVE_VTIME_H
+#define NATIVE_VTIME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @name    States in native_vtime_node_t::state
+ * @{
+ */
+#define NATIVE_VTIME_OFF        (0U)    /**< not attached */
+#define NATIVE_VTIME_AWAKE      (1U)    /**< running, counted by the clock */
+#define NATIVE_VTIME_IDLE       (2U)    /**< waiting for a signal */
+#define NATIVE_VTIME_CLAIMED    (3U)    /**< woken up, counted by whoever woke it */
+/** @} */
+
+/**
+ * @brief   A clock shared by some instances
+ *
+ * The layout is the same on 32 and 64 bit hosts, so it may be placed in
+ * memory shared with tools.
+ */
+typedef struct {
+    uint64_t now;           /**< current time in microseconds */
+    uint32_t running;       /**< instances that are awake or about to be woken */
+    uint32_t idle_gen;      /**< counts instances going idle */
+} native_vtime_clock_t;
+
+/**
+ * @brief   An instance using a shared clock
+ */
+typedef struct {
+    uint64_t next;          /**< time of the next timer, UINT64_MAX if none */
+    int32_t pid;            /**< host PID of the instance */
+    uint32_t state;         /**< NATIVE_VTIME_OFF, _AWAKE, _IDLE or _CLAIMED */
+    uint32_t kicks;         /**< signals left for the instance while awake */
+    uint32_t reserved;      /**< padding to 24 bytes */
+} native_vtime_node_t;
+
+/**
+ * @brief   Starts the local clock at 0
+ */
+void native_vtime_init(void);
+
+/**
+ * @brief   Reads the clock and advances it by 1 microsecond
+ *
+ * Raises SIGALRM if the timer expired.
+ *
+ * @return  the current time in microseconds
+ */
+uint32_t native_vtime_read(void);
+
+/**
+ * @brief   Sets the timer
+ *
+ * @param[in] offset    microseconds from now
+ */
+void native_vtime_set(uint32_t offset);
+
+/**
+ * @brief   Stops the timer
+ */
+void native_vtime_clear(void);
+
+/**
+ * @brief   Checks the timer on SIGALRM
+ *
+ * @return  true if the timer expired, it is stopped then
+ * @return  false if SIGALRM was raised for another reason
+ */
+bool native_vtime_expired(void);
+
+/**
+ * @brief   Waits for a signal and lets the clock advance meanwhile
+ *
+ * Replaces pause() in the idle thread. Must be called with
+ * _native_in_syscall set.
+ */
+void native_vtime_sleep(void);
+
+/**
+ * @brief   Switches to a clock shared with other instances
+ *
+ * The instances are laid out in memory @p stride bytes apart.
+ *
+ * @param[in] clock     the shared clock
+ * @param[in] nodes     the first instance
+ * @param[in] stride    distance between two instances in bytes
+ * @param[in] num       number of instances
+ * @param[in] self      number of this instance
+ */
+void native_vtime_attach(native_vtime_clock_t *clock, native_vtime_node_t *nodes,
+                         size_t stride, unsigned num, unsigned self);
+
+/**
+ * @brief   Switches back to the local clock
+ */
+void native_vtime_detach(void);
+
+/**
+ * @brief   Sends a signal to another instance and keeps the clock from
+ *          advancing until the instance woke up
+ *
+ * @param[in] node      number of the instance
+ * @param[in] sig       the signal
+ */
+void native_vtime_kick(unsigned node, int sig);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NATIVE_VTIME_H */
+/** @} */
@@ -9,6 +9,15 @@
 /**
  * @ingroup     netdev2
  * @brief       Low-level ethernet driver for native tap interfaces
+ *
+ * By default, the host signals incoming frames with SIGIO and the driver reads
+ * them from the tap device in the RIOT process. With the `netdev2_tap_poll`
+ * module (Linux only), a host thread polls the tap device instead and hands
+ * the frames to RIOT through a ring buffer, with one SIGIO for all frames RIOT
+ * did not yet take. With @ref NETDEV2_TAP_QUEUES > 1, the thread reads from
+ * several queues of a multi-queue tap interface, created with
+ *
+ *     ip tuntap add <name> mode tap multi_queue
  * @{
  *
  * @file
@@ -35,6 +44,34 @@ extern "C" {
 #include "net/if.h"
 #endif
 
+#ifndef NETDEV2_TAP_RX_BUDGET
+/**
+ * @brief   Maximum number of frames the driver reads per interrupt
+ *
+ * Frames that are still pending after that are read after the next
+ * interrupt, which the driver raises itself.
+ */
+#define NETDEV2_TAP_RX_BUDGET   (8U)
+#endif
+
+#if defined(MODULE_NETDEV2_TAP_POLL) || defined(DOXYGEN)
+#ifndef NETDEV2_TAP_QUEUES
+/**
+ * @brief   Number of queues of the tap interface the poll thread reads from
+ */
+#define NETDEV2_TAP_QUEUES      (1U)
+#endif
+
+#ifndef NETDEV2_TAP_RING_SIZE
+/**
+ * @brief   Number of frames the poll thread buffers for RIOT
+ *
+ * Must be a power of 2.
+ */
+#define NETDEV2_TAP_RING_SIZE   (64U)
+#endif
+#endif
+
 /**
  * @brief tap interface state
  */
@@ -44,6 +81,10 @@ typedef struct netdev2_tap {
     int tap_fd;                         /**< host file descriptor for the TAP */
     uint8_t addr[ETHERNET_ADDR_LEN];    /**< The MAC address of the TAP */
     uint8_t promiscous;                 /**< Flag for promiscous mode */
+#if defined(MODULE_NETDEV2_TAP_POLL) || defined(DOXYGEN)
+    int queue_fds[NETDEV2_TAP_QUEUES];  /**< host file descriptors of the
+                                         *   queues, the first is tap_fd */
+#endif
 } netdev2_tap_t;
 
 /**
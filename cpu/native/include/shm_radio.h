@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @defgroup    native_shm_radio Shared memory IEEE 802.15.4 medium
+ * @ingroup     native_cpu
+ * @brief       Virtual IEEE 802.15.4 radio for many native instances on one
+ *              host
+ *
+ * All instances map the same file (e.g. in /dev/shm), which holds a
+ * packet reception rate (PRR) for every pair of nodes and a receive ring for
+ * every node. A sender copies its frame straight into the rings of all nodes
+ * it has a link to, so passing a frame on costs no system call. Only a node
+ * that emptied its ring and waits for more is woken up with SIGUSR2.
+ *
+ * The medium is created and its links are set with
+ * dist/tools/shm_radio/shm_radio.py, e.g.
+ *
+ *     shm_radio.py create /dev/shm/riot_medium 100 grid
+ *
+ * Every instance is then started with its node number and the file:
+ *
+ *     bin/native/app.elf -i <node> -r /dev/shm/riot_medium
+ *
+ * The driver implements @ref gnrc_netdev_driver_t like @ref net_gnrc_zep, so
+ * it is run by @ref net_gnrc_nomac.
+ *
+ * With @ref native_vtime, all instances on the medium share the clock in it.
+ * A medium created with `--vtime` holds that clock until every node attached
+ * and went idle once.
+ *
+ * A node that dies in the middle of copying a frame leaves a slot in the
+ * receiver's ring that is never completed, which stalls the receiver. The
+ * medium has to be created anew then.
+ * @{
+ *
+ * @file
+ * @brief       Definitions of the shared memory IEEE 802.15.4 medium
+ */
+#ifndef SHM_RADIO_H
+#define SHM_RADIO_H
+
+#include <stdint.h>
+
+#include "kernel_types.h"
+#include "native_vtime.h"
+#include "net/gnrc/netdev.h"
+#include "net/gnrc/nettype.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Magic number at the start of the medium
+ */
+#define SHM_RADIO_MAGIC         (0x52534d32)    /* "RSM2" */
+
+/**
+ * @brief   Maximum length of a frame on the medium (without FCS)
+ */
+#define SHM_RADIO_FRAME_LEN_MAX (127U - 2U)
+
+#ifndef SHM_RADIO_RX_BUDGET
+/**
+ * @brief   Maximum number of frames the driver takes from its ring per event
+ *
+ * The driver posts itself another event if there are more, so the MAC
+ * thread does not starve its other messages.
+ */
+#define SHM_RADIO_RX_BUDGET     (8U)
+#endif
+
+/**
+ * @brief   Default PAN ID
+ */
+#define SHM_RADIO_DEFAULT_PANID (0x0023)
+
+/**
+ * @brief   Default channel
+ */
+#define SHM_RADIO_DEFAULT_CHANNEL (26U)
+
+/**
+ * @name    Flags for shm_radio_t::flags
+ * @{
+ */
+#define SHM_RADIO_FLAGS_SRC_ADDR_LONG   (0x0001)    /**< send with long source address */
+#define SHM_RADIO_FLAGS_USE_SRC_PAN     (0x0002)    /**< send source PAN ID */
+/** @} */
+
+/**
+ * @brief   Layout of the medium
+ *
+ * The header is followed by `nodes * nodes` bytes of PRR, where byte
+ * `src * nodes + dst` is the probability (in 1/255) that @p dst receives a
+ * frame of @p src. 0 means that there is no link; the PRR is also used as LQI.
+ * After that, aligned to 64 bytes, come @ref shm_radio_node_t for all nodes,
+ * each followed by shm_radio_medium_t::ring_size slots.
+ */
+typedef struct {
+    uint32_t magic;         /**< @ref SHM_RADIO_MAGIC */
+    uint16_t nodes;         /**< number of nodes */
+    uint16_t ring_size;     /**< slots per node, a power of 2 */
+    native_vtime_clock_t clock; /**< clock shared with @ref native_vtime */
+} shm_radio_medium_t;
+
+/**
+ * @brief   Receive ring of a node in the medium
+ *
+ * Any number of senders put frames into the ring, only the node itself takes
+ * them out. A sender claims a slot by advancing @p head and publishes it with
+ * shm_radio_slot_t::seq once the frame is in.
+ */
+typedef struct {
+    int32_t pid;            /**< host PID of the node, 0 if it is not running */
+    uint32_t waiting;       /**< 1 if the node waits for SIGUSR2 */
+    uint32_t head;          /**< next slot senders claim */
+    uint32_t drops;         /**< frames dropped because the ring was full */
+    native_vtime_node_t vtime;  /**< the node's part in the shared clock */
+    uint8_t pad1[24];       /**< keeps @p tail out of the senders' cache line */
+    uint32_t tail;          /**< next slot the node takes */
+    uint8_t pad2[60];       /**< padding to 128 bytes */
+} shm_radio_node_t;
+
+/**
+ * @brief   A slot of a receive ring
+ */
+typedef struct {
+    uint32_t seq;           /**< position + 1 when full, position when free */
+    uint16_t src;           /**< node number of the sender */
+    uint8_t chan;           /**< channel the frame was sent on */
+    uint8_t len;            /**< length of @p frame */
+    uint8_t frame[SHM_RADIO_FRAME_LEN_MAX + 3]; /**< the frame, padded to 8 byte */
+} shm_radio_slot_t;
+
+/**
+ * @brief   Device descriptor of the shared memory radio
+ */
+typedef struct {
+    gnrc_netdev_driver_t *driver;   /**< pointer to the device's interface */
+    gnrc_netdev_event_cb_t event_cb;/**< netdev event callback */
+    kernel_pid_t mac_pid;           /**< the driver's thread's PID */
+    /**
+     * @brief @ref shm_radio_t specific members
+     * @{
+     */
+    const char *file;               /**< file of the medium */
+    shm_radio_medium_t *medium;     /**< the mapped medium */
+    size_t medium_len;              /**< length of the mapping */
+    uint16_t node;                  /**< the node's number in the medium */
+    uint8_t addr_short[2];          /**< short address in network byte order */
+    uint8_t addr_long[8];           /**< long address in network byte order */
+    uint16_t pan;                   /**< PAN ID */
+    uint16_t flags;                 /**< option flags */
+    gnrc_nettype_t proto;           /**< the target protocol for received packets */
+    uint8_t chan;                   /**< channel */
+    uint8_t seq;                    /**< sequence number for the next frame */
+    /**
+     * @}
+     */
+} shm_radio_t;
+
+/**
+ * @brief   The shared memory radio of this instance
+ */
+extern shm_radio_t shm_radio;
+
+/**
+ * @brief   Reference to the driver's interface
+ */
+extern const gnrc_netdev_driver_t shm_radio_driver;
+
+/**
+ * @brief   Remembers the medium and node number given on the command line
+ *
+ * @param[out] dev  the device to set up
+ * @param[in] file  file of the medium
+ * @param[in] node  number of this node in the medium
+ */
+void shm_radio_setup(shm_radio_t *dev, const char *file, uint16_t node);
+
+/**
+ * @brief   Maps the medium and attaches the node to it
+ *
+ * @param[in,out] dev   the device, set up by shm_radio_setup()
+ *
+ * @return  0 on success
+ * @return  -ENODEV if no medium was given
+ * @return  -EINVAL if the medium is invalid or has no such node
+ */
+int shm_radio_init(shm_radio_t *dev);
+
+/**
+ * @brief   Detaches the node from the medium
+ *
+ * @param[in,out] dev   the device
+ */
+void shm_radio_cleanup(shm_radio_t *dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHM_RADIO_H */
+/** @} */
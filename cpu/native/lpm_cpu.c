@@ -27,6 +27,10 @@
 
 #include "native_internal.h"
 
+#ifdef MODULE_NATIVE_VTIME
+#include "native_vtime.h"
+#endif
+
 static enum lpm_mode native_lpm;
 
 void lpm_init(void)
@@ -39,7 +43,11 @@ void lpm_init(void)
 void _native_lpm_sleep(void)
 {
     _native_in_syscall++; // no switching here
+#ifdef MODULE_NATIVE_VTIME
+    native_vtime_sleep();
+#else
     real_pause();
+#endif
     _native_in_syscall--;
 
     if (_native_sigpend > 0) {
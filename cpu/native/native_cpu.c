@@ -54,6 +54,10 @@
 extern netdev2_tap_t netdev2_tap;
 #endif
 
+#ifdef MODULE_SHM_RADIO
+#include "shm_radio.h"
+#endif
+
 #include "native_internal.h"
 
 #define ENABLE_DEBUG (0)
@@ -71,6 +75,9 @@ int reboot_arch(int mode)
 #ifdef MODULE_NETDEV2_TAP
     netdev2_tap_cleanup(&netdev2_tap);
 #endif
+#ifdef MODULE_SHM_RADIO
+    shm_radio_cleanup(&shm_radio);
+#endif
 
     if (real_execve(_native_argv[0], _native_argv, NULL) == -1) {
         err(EXIT_FAILURE, "reboot: execve");
@@ -21,6 +21,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -46,6 +47,13 @@
 #include <linux/if_ether.h>
 #endif
 
+#ifdef MODULE_NETDEV2_TAP_POLL
+#if defined(__MACH__) || defined(__FreeBSD__)
+#error "netdev2_tap_poll is only supported on Linux"
+#endif
+#include <poll.h>
+#endif
+
 #include "native_internal.h"
 
 #include "net/eui64.h"
@@ -67,6 +75,28 @@ pid_t _sigio_child_pid;
 static void _sigio_child(netdev2_tap_t *dev);
 #endif
 
+/* number of reads from the tap device, to tell if an RX_COMPLETE event was
+ * handled */
+static unsigned _rx_reads;
+
+#ifdef MODULE_NETDEV2_TAP_POLL
+/* frames the poll thread read for RIOT */
+typedef struct {
+    uint16_t len;
+    uint8_t data[ETHERNET_FRAME_LEN];
+} _rx_slot_t;
+
+static _rx_slot_t _rx_ring[NETDEV2_TAP_RING_SIZE];
+static unsigned _rx_head;       /* written by the poll thread only */
+static unsigned _rx_tail;       /* written by RIOT only */
+static int _rx_signalled;       /* SIGIO sent, but RIOT did not look yet */
+static int _rx_full;            /* poll thread waits for RIOT to take frames */
+static int _rx_space_pipe[2];   /* RIOT wakes a waiting poll thread with it */
+static unsigned long _poll_thread_id;   /* pthread_t on Linux */
+
+static void _poll_start(netdev2_tap_t *dev);
+#endif
+
 /* netdev2 interface */
 static int _init(netdev2_t *netdev);
 static int _send(netdev2_t *netdev, const struct iovec *vector, int n);
@@ -109,10 +139,99 @@ static inline int _get_iid(netdev2_t *netdev, eui64_t *value, size_t max_len)
 
     return sizeof(eui64_t);
 }
+
+/* checks if another frame is waiting on the tap device */
+static bool _rx_pending(netdev2_tap_t *dev)
+{
+#ifdef MODULE_NETDEV2_TAP_POLL
+    (void)dev;
+    return __atomic_load_n(&_rx_head, __ATOMIC_ACQUIRE) != _rx_tail;
+#else
+    fd_set rfds;
+    struct timeval t;
+    bool res;
+
+    memset(&t, 0, sizeof(t));
+    FD_ZERO(&rfds);
+    FD_SET(dev->tap_fd, &rfds);
+
+    _native_in_syscall++; /* no switching here */
+    res = (real_select(dev->tap_fd + 1, &rfds, NULL, NULL, &t) == 1);
+    _native_in_syscall--;
+
+    return res;
+#endif
+}
+
+/* reads one frame from the tap device, like read(2) */
+static int _read_frame(netdev2_tap_t *dev, char *buf, int len)
+{
+#ifdef MODULE_NETDEV2_TAP_POLL
+    unsigned tail = _rx_tail;
+    _rx_slot_t *slot;
+    int nread;
+
+    (void)dev;
+    if (__atomic_load_n(&_rx_head, __ATOMIC_ACQUIRE) == tail) {
+        errno = EAGAIN;
+        return -1;
+    }
+    slot = &_rx_ring[tail & (NETDEV2_TAP_RING_SIZE - 1)];
+    nread = (slot->len < len) ? slot->len : len;
+    memcpy(buf, slot->data, nread);
+    __atomic_store_n(&_rx_tail, tail + 1, __ATOMIC_SEQ_CST);
+    if (__atomic_exchange_n(&_rx_full, 0, __ATOMIC_SEQ_CST)) {
+        char c = 0;
+
+        _native_in_syscall++; /* no switching here */
+        real_write(_rx_space_pipe[1], &c, sizeof(c));
+        _native_in_syscall--;
+    }
+
+    return nread;
+#else
+    return real_read(dev->tap_fd, buf, len);
+#endif
+}
+
 static inline void _isr(netdev2_t *netdev)
 {
+    netdev2_tap_t *dev = (netdev2_tap_t*)netdev;
+    unsigned budget = NETDEV2_TAP_RX_BUDGET;
+
     if (netdev->event_callback) {
-        netdev->event_callback(netdev, NETDEV2_EVENT_RX_COMPLETE, (void*)NETDEV2_TYPE_ETHERNET);
+        unsigned reads;
+
+#ifdef MODULE_NETDEV2_TAP_POLL
+        /* frames the poll thread adds from now on need another signal */
+        __atomic_store_n(&_rx_signalled, 0, __ATOMIC_SEQ_CST);
+#endif
+
+        /* drain what arrived since the signal, one RX_COMPLETE per frame, but
+         * stop when a frame is left unread (e.g. for lack of buffer space) */
+        do {
+            reads = _rx_reads;
+            netdev->event_callback(netdev, NETDEV2_EVENT_RX_COMPLETE,
+                                   (void*)NETDEV2_TYPE_ETHERNET);
+        } while ((--budget > 0) && (reads != _rx_reads) && _rx_pending(dev));
+
+        if ((budget == 0) && (reads != _rx_reads) && _rx_pending(dev)) {
+            /* budget used up: come back with the next signal */
+            int sig = SIGIO;
+            extern int _sig_pipefd[2];
+            extern ssize_t (*real_write)(int fd, const void * buf, size_t count);
+
+            _native_in_syscall++; /* no switching here */
+            real_write(_sig_pipefd[1], &sig, sizeof(int));
+            _native_sigpend++;
+            DEBUG("netdev2_tap: sigpend++\n");
+            _native_in_syscall--;
+        }
+#ifdef __MACH__
+        else {
+            kill(_sigio_child_pid, SIGCONT);
+        }
+#endif
     }
 #if DEVELHELP
     else {
@@ -227,7 +346,8 @@ static int _recv(netdev2_t *netdev2, char *buf, int len)
         return ETHERNET_FRAME_LEN;
     }
 
-    int nread = real_read(dev->tap_fd, buf, len);
+    int nread = _read_frame(dev, buf, len);
+    _rx_reads++;
     DEBUG("netdev2_tap: read %d bytes\n", nread);
 
     if (nread > 0) {
@@ -239,36 +359,8 @@ static int _recv(netdev2_t *netdev2, char *buf, int len)
                   "That's not me => Dropped\n",
                   hdr->dst[0], hdr->dst[1], hdr->dst[2],
                   hdr->dst[3], hdr->dst[4], hdr->dst[5]);
-#ifdef __MACH__
-            kill(_sigio_child_pid, SIGCONT);
-#endif
             return 0;
         }
-        /* work around lost signals */
-        fd_set rfds;
-        struct timeval t;
-        memset(&t, 0, sizeof(t));
-        FD_ZERO(&rfds);
-        FD_SET(dev->tap_fd, &rfds);
-
-        _native_in_syscall++; /* no switching here */
-
-        if (real_select(dev->tap_fd + 1, &rfds, NULL, NULL, &t) == 1) {
-            int sig = SIGIO;
-            extern int _sig_pipefd[2];
-            extern ssize_t (*real_write)(int fd, const void * buf, size_t count);
-            real_write(_sig_pipefd[1], &sig, sizeof(int));
-            _native_sigpend++;
-            DEBUG("netdev2_tap: sigpend++\n");
-        }
-        else {
-#ifdef __MACH__
-        kill(_sigio_child_pid, SIGCONT);
-#endif
-        }
-
-        _native_in_syscall--;
-
         return nread;
     }
     else if (nread == -1) {
@@ -353,6 +445,9 @@ static int _init(netdev2_t *netdev)
 #else /* Linux */
     memset(&ifr, 0, sizeof(ifr));
     ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+#if defined(MODULE_NETDEV2_TAP_POLL) && (NETDEV2_TAP_QUEUES > 1)
+    ifr.ifr_flags |= IFF_MULTI_QUEUE;
+#endif
     strncpy(ifr.ifr_name, name, IFNAMSIZ);
     if (real_ioctl(dev->tap_fd, TUNSETIFF, (void *)&ifr) == -1) {
         _native_in_syscall++;
@@ -360,6 +455,21 @@ static int _init(netdev2_t *netdev)
         warnx("probably the tap interface (%s) does not exist or is already in use", name);
         real_exit(EXIT_FAILURE);
     }
+#ifdef MODULE_NETDEV2_TAP_POLL
+    /* attach the other queues to the same interface */
+    dev->queue_fds[0] = dev->tap_fd;
+    for (unsigned q = 1; q < NETDEV2_TAP_QUEUES; q++) {
+        if ((dev->queue_fds[q] = real_open(clonedev, O_RDWR)) == -1) {
+            err(EXIT_FAILURE, "open(%s)", clonedev);
+        }
+        if (real_ioctl(dev->queue_fds[q], TUNSETIFF, (void *)&ifr) == -1) {
+            _native_in_syscall++;
+            warn("ioctl TUNSETIFF");
+            warnx("probably the tap interface (%s) has no multi_queue flag", name);
+            real_exit(EXIT_FAILURE);
+        }
+    }
+#endif
 
     /* get MAC address */
     memset(&ifr, 0, sizeof(ifr));
@@ -386,6 +496,14 @@ static int _init(netdev2_t *netdev)
     /* tuntap signalled IO is not working in OSX,
      * * check http://sourceforge.net/p/tuntaposx/bugs/17/ */
     _sigio_child(dev);
+#elif defined(MODULE_NETDEV2_TAP_POLL)
+    /* the poll thread reads the queues and signals RIOT */
+    for (unsigned q = 0; q < NETDEV2_TAP_QUEUES; q++) {
+        if (fcntl(dev->queue_fds[q], F_SETFL, O_NONBLOCK) == -1) {
+            err(EXIT_FAILURE, "gnrc_tapnet_init(): fcntl(F_SETFL)");
+        }
+    }
+    _poll_start(dev);
 #else
     /* configure fds to send signals on io */
     if (fcntl(dev->tap_fd, F_SETOWN, _native_pid) == -1) {
@@ -414,9 +532,116 @@ void netdev2_tap_cleanup(netdev2_tap_t *dev)
 #endif
 
     /* close the tap device */
+#ifdef MODULE_NETDEV2_TAP_POLL
+    for (unsigned q = 1; q < NETDEV2_TAP_QUEUES; q++) {
+        real_close(dev->queue_fds[q]);
+    }
+#endif
     real_close(dev->tap_fd);
 }
 
+#ifdef MODULE_NETDEV2_TAP_POLL
+/* sends SIGIO unless RIOT still has to look at the ring anyway */
+static void _poll_notify(void)
+{
+    if (!__atomic_exchange_n(&_rx_signalled, 1, __ATOMIC_SEQ_CST)) {
+        kill(_native_pid, SIGIO);
+    }
+}
+
+/* host thread: moves frames from the queues into the ring. Runs outside of
+ * RIOT, so it must not touch anything but the ring and the host's libc. */
+static void *_poll_thread(void *arg)
+{
+    netdev2_tap_t *dev = (netdev2_tap_t *)arg;
+    struct pollfd pfds[NETDEV2_TAP_QUEUES + 1];
+    struct pollfd *space = &pfds[NETDEV2_TAP_QUEUES];
+    unsigned head = _rx_head;
+
+    for (unsigned q = 0; q < NETDEV2_TAP_QUEUES; q++) {
+        pfds[q].fd = dev->queue_fds[q];
+        pfds[q].events = POLLIN;
+    }
+    space->fd = _rx_space_pipe[0];
+    space->events = POLLIN;
+
+    while (1) {
+        bool full = ((head - __atomic_load_n(&_rx_tail, __ATOMIC_ACQUIRE)) ==
+                     NETDEV2_TAP_RING_SIZE);
+
+        if (full) {
+            __atomic_store_n(&_rx_full, 1, __ATOMIC_SEQ_CST);
+            /* RIOT may have taken a frame before it could see the flag */
+            full = ((head - __atomic_load_n(&_rx_tail, __ATOMIC_SEQ_CST)) ==
+                    NETDEV2_TAP_RING_SIZE);
+        }
+        /* with a full ring, leave the frames in the queues of the host */
+        if (poll(full ? space : pfds, full ? 1 : NETDEV2_TAP_QUEUES + 1, -1) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return NULL;
+        }
+        if (space->revents & POLLIN) {
+            char buf[16];
+
+            if (real_read(space->fd, buf, sizeof(buf)) <= 0) {
+                return NULL;
+            }
+        }
+        if (full) {
+            continue;
+        }
+        for (unsigned q = 0; q < NETDEV2_TAP_QUEUES; q++) {
+            unsigned budget = NETDEV2_TAP_RX_BUDGET;
+
+            if (pfds[q].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                /* the device was closed */
+                return NULL;
+            }
+            if (!(pfds[q].revents & POLLIN)) {
+                continue;
+            }
+            /* a few frames per queue, so no queue starves the others */
+            while ((budget-- > 0) &&
+                   ((head - __atomic_load_n(&_rx_tail, __ATOMIC_ACQUIRE)) <
+                    NETDEV2_TAP_RING_SIZE)) {
+                _rx_slot_t *slot = &_rx_ring[head & (NETDEV2_TAP_RING_SIZE - 1)];
+                ssize_t nread = real_read(pfds[q].fd, slot->data, sizeof(slot->data));
+
+                if (nread <= 0) {
+                    break;
+                }
+                slot->len = (uint16_t)nread;
+                __atomic_store_n(&_rx_head, ++head, __ATOMIC_SEQ_CST);
+                _poll_notify();
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void _poll_start(netdev2_tap_t *dev)
+{
+    sigset_t all, old;
+
+    if (real_pipe(_rx_space_pipe) == -1) {
+        err(EXIT_FAILURE, "netdev2_tap: pipe");
+    }
+    /* all signals are for RIOT, so the thread starts with all blocked */
+    _native_in_syscall++; /* no switching here */
+    sigfillset(&all);
+    sigprocmask(SIG_SETMASK, &all, &old);
+    if ((real_pthread_create == NULL) ||
+        (real_pthread_create(&_poll_thread_id, NULL, _poll_thread, dev) != 0)) {
+        errx(EXIT_FAILURE, "netdev2_tap: unable to start poll thread");
+    }
+    sigprocmask(SIG_SETMASK, &old, NULL);
+    _native_in_syscall--;
+}
+#endif
+
 #ifdef __MACH__
 static void _sigio_child(netdev2_tap_t *dev)
 {
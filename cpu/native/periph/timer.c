@@ -19,6 +19,8 @@
  * This is based on native's hwtimer implementation by Ludwig Knüpfer.
  * I removed the multiplexing, as xtimer does the same. (kaspar)
  *
+ * With native_vtime, the timer runs on the simulated clock instead.
+ *
  * @}
  */
 
@@ -42,15 +44,20 @@
 #include "native_internal.h"
 #include "periph/timer.h"
 
+#ifdef MODULE_NATIVE_VTIME
+#include "native_vtime.h"
+#endif
+
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
 #define NATIVE_TIMER_SPEED 1000000
 
-static unsigned long time_null;
-
 static void (*_callback)(int);
 
+#ifndef MODULE_NATIVE_VTIME
+static unsigned long time_null;
+
 static struct itimerval itv;
 
 /**
@@ -61,6 +68,7 @@ static unsigned long ts2ticks(struct timespec *tp)
     /* TODO: check for overflow */
     return((tp->tv_sec * NATIVE_TIMER_SPEED) + (tp->tv_nsec / 1000));
 }
+#endif
 
 /**
  * native timer signal handler
@@ -71,6 +79,11 @@ void native_isr_timer(void)
 {
     DEBUG("%s\n", __func__);
 
+#ifdef MODULE_NATIVE_VTIME
+    if (!native_vtime_expired()) {
+        return;
+    }
+#endif
     _callback(0);
 }
 
@@ -83,8 +96,12 @@ int timer_init(tim_t dev, unsigned int ticks_per_us, void (*callback)(int))
     }
 
     /* initialize time delta */
+#ifdef MODULE_NATIVE_VTIME
+    native_vtime_init();
+#else
     time_null = 0;
     time_null = timer_read(0);
+#endif
 
     timer_irq_disable(dev);
     _callback = callback;
@@ -93,6 +110,7 @@ int timer_init(tim_t dev, unsigned int ticks_per_us, void (*callback)(int))
     return 0;
 }
 
+#ifndef MODULE_NATIVE_VTIME
 static void do_timer_set(unsigned int offset)
 {
     DEBUG("%s\n", __func__);
@@ -113,6 +131,7 @@ static void do_timer_set(unsigned int offset)
     }
     _native_syscall_leave();
 }
+#endif
 
 int timer_set(tim_t dev, int channel, unsigned int offset)
 {
@@ -127,7 +146,13 @@ int timer_set(tim_t dev, int channel, unsigned int offset)
         offset = NATIVE_TIMER_MIN_RES;
     }
 
+#ifdef MODULE_NATIVE_VTIME
+    _native_syscall_enter();
+    native_vtime_set(offset);
+    _native_syscall_leave();
+#else
     do_timer_set(offset);
+#endif
 
     return 1;
 }
@@ -151,7 +176,13 @@ int timer_clear(tim_t dev, int channel)
     (void)dev;
     (void)channel;
 
+#ifdef MODULE_NATIVE_VTIME
+    _native_syscall_enter();
+    native_vtime_clear();
+    _native_syscall_leave();
+#else
     do_timer_set(0);
+#endif
 
     return 1;
 }
@@ -198,10 +229,19 @@ unsigned int timer_read(tim_t dev)
         return 0;
     }
 
-    struct timespec t;
-
     DEBUG("timer_read()\n");
 
+#ifdef MODULE_NATIVE_VTIME
+    unsigned int now;
+
+    _native_syscall_enter();
+    now = native_vtime_read();
+    _native_syscall_leave();
+
+    return now;
+#else
+    struct timespec t;
+
     _native_syscall_enter();
 #ifdef __MACH__
     clock_serv_t cclock;
@@ -221,4 +261,5 @@ unsigned int timer_read(tim_t dev)
     _native_syscall_leave();
 
     return ts2ticks(&t) - time_null;
+#endif
 }
@@ -0,0 +1,643 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @ingroup     native_shm_radio
+ * @{
+ *
+ * @file
+ * @brief       Shared memory IEEE 802.15.4 medium
+ * @}
+ */
+
+#include <err.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "native_internal.h"
+
+#include "msg.h"
+#include "net/gnrc.h"
+#include "net/ieee802154.h"
+#include "shm_radio.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#define _EVENT_RX       (1)
+#define _MIN_CHANNEL    (11U)
+#define _MAX_CHANNEL    (26U)
+
+shm_radio_t shm_radio;
+
+/* offset of the first node in the medium */
+static inline size_t _nodes_offset(unsigned nodes)
+{
+    return (sizeof(shm_radio_medium_t) + (nodes * nodes) + 63) & ~((size_t)63);
+}
+
+static inline size_t _node_len(unsigned ring_size)
+{
+    return sizeof(shm_radio_node_t) + (ring_size * sizeof(shm_radio_slot_t));
+}
+
+static inline uint8_t *_prr(shm_radio_medium_t *medium, unsigned src)
+{
+    return ((uint8_t *)(medium + 1)) + (src * medium->nodes);
+}
+
+static inline shm_radio_node_t *_node(shm_radio_medium_t *medium, unsigned node)
+{
+    return (shm_radio_node_t *)(((uint8_t *)medium) + _nodes_offset(medium->nodes) +
+                                (node * _node_len(medium->ring_size)));
+}
+
+static inline shm_radio_slot_t *_slot(shm_radio_medium_t *medium, shm_radio_node_t *node,
+                                      uint32_t pos)
+{
+    return ((shm_radio_slot_t *)(node + 1)) + (pos & (medium->ring_size - 1));
+}
+
+/* claims a slot in the ring of node, copies the frame and publishes it.
+ * The per-slot sequence numbers let any number of senders do this at once. */
+static bool _put(shm_radio_medium_t *medium, shm_radio_node_t *node, uint16_t src,
+                 uint8_t chan, const uint8_t *frame, uint8_t len)
+{
+    uint32_t pos = __atomic_load_n(&node->head, __ATOMIC_RELAXED);
+    shm_radio_slot_t *slot;
+
+    while (1) {
+        int32_t diff;
+
+        slot = _slot(medium, node, pos);
+        diff = (int32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&node->head, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            __atomic_fetch_add(&node->drops, 1, __ATOMIC_RELAXED);
+            return false;
+        }
+        else {
+            pos = __atomic_load_n(&node->head, __ATOMIC_RELAXED);
+        }
+    }
+    slot->src = src;
+    slot->chan = chan;
+    slot->len = len;
+    memcpy(slot->frame, frame, len);
+    /* pairs with the receiver's store of node->waiting */
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_SEQ_CST);
+
+    return true;
+}
+
+static shm_radio_slot_t *_peek(shm_radio_medium_t *medium, shm_radio_node_t *node)
+{
+    shm_radio_slot_t *slot = _slot(medium, node, node->tail);
+
+    if (__atomic_load_n(&slot->seq, __ATOMIC_SEQ_CST) != (node->tail + 1)) {
+        return NULL;
+    }
+    return slot;
+}
+
+static void _pop(shm_radio_medium_t *medium, shm_radio_node_t *node, shm_radio_slot_t *slot)
+{
+    __atomic_store_n(&slot->seq, node->tail + medium->ring_size, __ATOMIC_RELEASE);
+    node->tail++;
+}
+
+static void _isr(void)
+{
+    msg_t msg;
+
+    if (shm_radio.mac_pid == KERNEL_PID_UNDEF) {
+        return;
+    }
+    msg.type = GNRC_NETDEV_MSG_TYPE_EVENT;
+    msg.content.value = _EVENT_RX;
+    msg_send_int(&msg, shm_radio.mac_pid);
+}
+
+static size_t _make_data_frame_hdr(shm_radio_t *dev, uint8_t *buf,
+                                   gnrc_netif_hdr_t *hdr)
+{
+    static const uint8_t bcast[] = { 0xff, 0xff };
+    const uint8_t *dst = bcast;
+    size_t dst_len = sizeof(bcast);
+    uint8_t flags = IEEE802154_FCF_TYPE_DATA;
+
+    if (!(hdr->flags &
+          (GNRC_NETIF_HDR_FLAGS_BROADCAST | GNRC_NETIF_HDR_FLAGS_MULTICAST))) {
+        dst = gnrc_netif_hdr_get_dst_addr(hdr);
+        dst_len = hdr->dst_l2addr_len;
+        if ((dst_len != 2) && (dst_len != 8)) {
+            /* unsupported address length */
+            return 0;
+        }
+    }
+    if (!(dev->flags & SHM_RADIO_FLAGS_USE_SRC_PAN)) {
+        flags |= IEEE802154_FCF_PAN_COMP;
+    }
+    if (dev->flags & SHM_RADIO_FLAGS_SRC_ADDR_LONG) {
+        return ieee802154_set_frame_hdr(buf, dev->addr_long, sizeof(dev->addr_long),
+                                        dst, dst_len,
+                                        byteorder_btols(byteorder_htons(dev->pan)),
+                                        flags, dev->seq++);
+    }
+    return ieee802154_set_frame_hdr(buf, dev->addr_short, sizeof(dev->addr_short),
+                                    dst, dst_len,
+                                    byteorder_btols(byteorder_htons(dev->pan)),
+                                    flags, dev->seq++);
+}
+
+/* does what the address filter of a real transceiver does */
+static bool _accept(shm_radio_t *dev, uint8_t *mhr)
+{
+    uint8_t tmp = mhr[1] & IEEE802154_FCF_DST_ADDR_MASK;
+    uint16_t pan;
+
+    if (tmp == IEEE802154_FCF_DST_ADDR_VOID) {
+        return false;
+    }
+    pan = mhr[3] | (mhr[4] << 8);
+    if ((pan != dev->pan) && (pan != 0xffff)) {
+        return false;
+    }
+    if (tmp == IEEE802154_FCF_DST_ADDR_SHORT) {
+        return ((mhr[5] == 0xff) && (mhr[6] == 0xff)) ||
+               ((mhr[5] == dev->addr_short[1]) && (mhr[6] == dev->addr_short[0]));
+    }
+    for (int i = 0; i < 8; i++) {
+        if (mhr[5 + i] != dev->addr_long[7 - i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static gnrc_pktsnip_t *_make_netif_hdr(uint8_t *mhr)
+{
+    uint8_t src[8], dst[8];
+    int src_len = ieee802154_get_src(mhr, src);
+    int dst_len = ieee802154_get_dst(mhr, dst);
+    gnrc_pktsnip_t *snip;
+
+    if ((src_len < 0) || (dst_len < 0)) {
+        return NULL;
+    }
+    snip = gnrc_netif_hdr_build(src, (uint8_t)src_len, dst, (uint8_t)dst_len);
+    if ((snip != NULL) && (dst_len == 2) && (dst[0] == 0xff) && (dst[1] == 0xff)) {
+        ((gnrc_netif_hdr_t *)snip->data)->flags |= GNRC_NETIF_HDR_FLAGS_BROADCAST;
+    }
+    return snip;
+}
+
+static int _send(gnrc_netdev_t *netdev, gnrc_pktsnip_t *pkt)
+{
+    shm_radio_t *dev = (shm_radio_t *)netdev;
+    shm_radio_medium_t *medium;
+    uint8_t frame[SHM_RADIO_FRAME_LEN_MAX], *prr;
+    size_t len;
+
+    if (pkt == NULL) {
+        return -ENOMSG;
+    }
+    if ((dev == NULL) || (dev->driver != &shm_radio_driver) || (dev->medium == NULL)) {
+        gnrc_pktbuf_release(pkt);
+        return -ENODEV;
+    }
+    medium = dev->medium;
+    len = _make_data_frame_hdr(dev, frame, (gnrc_netif_hdr_t *)pkt->data);
+    if (len == 0) {
+        DEBUG("shm_radio: error: unable to create 802.15.4 header\n");
+        gnrc_pktbuf_release(pkt);
+        return -ENOMSG;
+    }
+    if ((gnrc_pkt_len(pkt->next) + len) > SHM_RADIO_FRAME_LEN_MAX) {
+        DEBUG("shm_radio: error: packet too large (%u byte) to be send\n",
+              (unsigned)(gnrc_pkt_len(pkt->next) + len));
+        gnrc_pktbuf_release(pkt);
+        return -EOVERFLOW;
+    }
+    for (gnrc_pktsnip_t *snip = pkt->next; snip != NULL; snip = snip->next) {
+        memcpy(&frame[len], snip->data, snip->size);
+        len += snip->size;
+    }
+    gnrc_pktbuf_release(pkt);
+
+    prr = _prr(medium, dev->node);
+    for (unsigned dst = 0; dst < medium->nodes; dst++) {
+        shm_radio_node_t *node = _node(medium, dst);
+        int32_t pid;
+
+        if ((prr[dst] == 0) || (dst == dev->node) ||
+            ((pid = __atomic_load_n(&node->pid, __ATOMIC_RELAXED)) == 0)) {
+            continue;
+        }
+        if ((prr[dst] < UINT8_MAX) && ((real_random() % UINT8_MAX) >= prr[dst])) {
+            continue;
+        }
+        if (_put(medium, node, dev->node, dev->chan, frame, (uint8_t)len) &&
+            __atomic_exchange_n(&node->waiting, 0, __ATOMIC_SEQ_CST)) {
+            /* the node emptied its ring before, wake it up */
+#ifdef MODULE_NATIVE_VTIME
+            native_vtime_kick(dst, SIGUSR2);
+#else
+            _native_in_syscall++;
+            kill(pid, SIGUSR2);
+            _native_in_syscall--;
+#endif
+        }
+    }
+
+    return (int)len;
+}
+
+static void _receive(shm_radio_t *dev, shm_radio_slot_t *slot)
+{
+    gnrc_pktsnip_t *hdr, *payload;
+    gnrc_netif_hdr_t *netif;
+    size_t hdr_len;
+
+    if ((dev->event_cb == NULL) || (slot->chan != dev->chan) ||
+        (slot->len < IEEE802154_FCF_LEN)) {
+        return;
+    }
+    hdr_len = ieee802154_get_frame_hdr_len(slot->frame);
+    if ((hdr_len == 0) || (hdr_len > slot->len) || !_accept(dev, slot->frame)) {
+        return;
+    }
+    hdr = _make_netif_hdr(slot->frame);
+    if (hdr == NULL) {
+        DEBUG("shm_radio: error: unable to allocate netif header\n");
+        return;
+    }
+    netif = (gnrc_netif_hdr_t *)hdr->data;
+    netif->if_pid = dev->mac_pid;
+    netif->lqi = _prr(dev->medium, slot->src)[dev->node];
+    netif->rssi = 0;
+    payload = gnrc_pktbuf_add(hdr, &slot->frame[hdr_len], slot->len - hdr_len, dev->proto);
+    if (payload == NULL) {
+        DEBUG("shm_radio: error: unable to allocate incoming payload\n");
+        gnrc_pktbuf_release(hdr);
+        return;
+    }
+    dev->event_cb(NETDEV_EVENT_RX_COMPLETE, payload);
+}
+
+static int _add_event_cb(gnrc_netdev_t *netdev, gnrc_netdev_event_cb_t cb)
+{
+    msg_t msg;
+
+    if ((netdev == NULL) || (netdev->driver != &shm_radio_driver)) {
+        return -ENODEV;
+    }
+    if (netdev->event_cb != NULL) {
+        return -ENOBUFS;
+    }
+    netdev->event_cb = cb;
+    /* called from the MAC thread: take what arrived so far and wait for
+     * SIGUSR2 from then on */
+    msg.type = GNRC_NETDEV_MSG_TYPE_EVENT;
+    msg.content.value = _EVENT_RX;
+    msg_send_to_self(&msg);
+
+    return 0;
+}
+
+static int _rem_event_cb(gnrc_netdev_t *netdev, gnrc_netdev_event_cb_t cb)
+{
+    if ((netdev == NULL) || (netdev->driver != &shm_radio_driver)) {
+        return -ENODEV;
+    }
+    if (netdev->event_cb != cb) {
+        return -ENOENT;
+    }
+    netdev->event_cb = NULL;
+
+    return 0;
+}
+
+static int _get(gnrc_netdev_t *netdev, netopt_t opt, void *val, size_t max_len)
+{
+    shm_radio_t *dev = (shm_radio_t *)netdev;
+
+    if (dev == NULL) {
+        return -ENODEV;
+    }
+
+    switch (opt) {
+        case NETOPT_ADDRESS:
+            if (max_len < sizeof(dev->addr_short)) {
+                return -EOVERFLOW;
+            }
+            memcpy(val, dev->addr_short, sizeof(dev->addr_short));
+            return sizeof(dev->addr_short);
+
+        case NETOPT_ADDRESS_LONG:
+            if (max_len < sizeof(dev->addr_long)) {
+                return -EOVERFLOW;
+            }
+            memcpy(val, dev->addr_long, sizeof(dev->addr_long));
+            return sizeof(dev->addr_long);
+
+        case NETOPT_ADDR_LEN:
+            if (max_len < sizeof(uint16_t)) {
+                return -EOVERFLOW;
+            }
+            *((uint16_t *)val) = 2;
+            return sizeof(uint16_t);
+
+        case NETOPT_SRC_LEN:
+            if (max_len < sizeof(uint16_t)) {
+                return -EOVERFLOW;
+            }
+            if (dev->flags & SHM_RADIO_FLAGS_SRC_ADDR_LONG) {
+                *((uint16_t *)val) = 8;
+            }
+            else {
+                *((uint16_t *)val) = 2;
+            }
+            return sizeof(uint16_t);
+
+        case NETOPT_NID:
+            if (max_len < sizeof(uint16_t)) {
+                return -EOVERFLOW;
+            }
+            *((uint16_t *)val) = dev->pan;
+            return sizeof(uint16_t);
+
+        case NETOPT_IPV6_IID:
+            if (max_len < sizeof(eui64_t)) {
+                return -EOVERFLOW;
+            }
+            if (dev->flags & SHM_RADIO_FLAGS_SRC_ADDR_LONG) {
+                ieee802154_get_iid(val, dev->addr_long, sizeof(dev->addr_long));
+            }
+            else {
+                ieee802154_get_iid(val, dev->addr_short, sizeof(dev->addr_short));
+            }
+            return sizeof(eui64_t);
+
+        case NETOPT_PROTO:
+            if (max_len < sizeof(gnrc_nettype_t)) {
+                return -EOVERFLOW;
+            }
+            *((gnrc_nettype_t *)val) = dev->proto;
+            return sizeof(gnrc_nettype_t);
+
+        case NETOPT_CHANNEL:
+            if (max_len < sizeof(uint16_t)) {
+                return -EOVERFLOW;
+            }
+            *((uint16_t *)val) = dev->chan;
+            return sizeof(uint16_t);
+
+        case NETOPT_MAX_PACKET_SIZE:
+            if (max_len < sizeof(uint16_t)) {
+                return -EOVERFLOW;
+            }
+            *((uint16_t *)val) = SHM_RADIO_FRAME_LEN_MAX - IEEE802154_MAX_HDR_LEN;
+            return sizeof(uint16_t);
+
+        default:
+            return -ENOTSUP;
+    }
+}
+
+static int _set(gnrc_netdev_t *netdev, netopt_t opt, void *val, size_t len)
+{
+    shm_radio_t *dev = (shm_radio_t *)netdev;
+
+    if (dev == NULL) {
+        return -ENODEV;
+    }
+
+    switch (opt) {
+        case NETOPT_ADDRESS:
+            if (len < sizeof(dev->addr_short)) {
+                return -EOVERFLOW;
+            }
+            memcpy(dev->addr_short, val, sizeof(dev->addr_short));
+            return sizeof(dev->addr_short);
+
+        case NETOPT_ADDRESS_LONG:
+            if (len < sizeof(dev->addr_long)) {
+                return -EOVERFLOW;
+            }
+            memcpy(dev->addr_long, val, sizeof(dev->addr_long));
+            return sizeof(dev->addr_long);
+
+        case NETOPT_SRC_LEN:
+            if (len < sizeof(uint16_t)) {
+                return -EOVERFLOW;
+            }
+            switch (*((uint16_t *)val)) {
+                case 2:
+                    dev->flags &= ~SHM_RADIO_FLAGS_SRC_ADDR_LONG;
+                    break;
+                case 8:
+                    dev->flags |= SHM_RADIO_FLAGS_SRC_ADDR_LONG;
+                    break;
+                default:
+                    return -ENOTSUP;
+            }
+            return sizeof(uint16_t);
+
+        case NETOPT_NID:
+            if (len < sizeof(uint16_t)) {
+                return -EOVERFLOW;
+            }
+            dev->pan = *((uint16_t *)val);
+            return sizeof(uint16_t);
+
+        case NETOPT_PROTO:
+            if (len != sizeof(gnrc_nettype_t)) {
+                return -EINVAL;
+            }
+            dev->proto = *((gnrc_nettype_t *)val);
+            return sizeof(gnrc_nettype_t);
+
+        case NETOPT_CHANNEL:
+            if (len < sizeof(uint16_t)) {
+                return -EOVERFLOW;
+            }
+            if ((*((uint16_t *)val) < _MIN_CHANNEL) || (*((uint16_t *)val) > _MAX_CHANNEL)) {
+                return -ENOTSUP;
+            }
+            dev->chan = (uint8_t)*((uint16_t *)val);
+            return sizeof(uint16_t);
+
+        default:
+            return -ENOTSUP;
+    }
+}
+
+static void _isr_event(gnrc_netdev_t *netdev, uint32_t event_type)
+{
+    shm_radio_t *dev = (shm_radio_t *)netdev;
+    shm_radio_node_t *node;
+    unsigned budget = SHM_RADIO_RX_BUDGET;
+
+    if ((event_type != _EVENT_RX) || (dev->medium == NULL)) {
+        return;
+    }
+    node = _node(dev->medium, dev->node);
+    while (1) {
+        shm_radio_slot_t *slot = _peek(dev->medium, node);
+
+        if (slot == NULL) {
+            /* from now on the next sender wakes us up. Look again, a frame
+             * may have come in before it could see the flag. */
+            __atomic_store_n(&node->waiting, 1, __ATOMIC_SEQ_CST);
+            if ((slot = _peek(dev->medium, node)) == NULL) {
+                return;
+            }
+        }
+        if (budget-- == 0) {
+            msg_t msg;
+
+            msg.type = GNRC_NETDEV_MSG_TYPE_EVENT;
+            msg.content.value = _EVENT_RX;
+            if (msg_send_to_self(&msg) == 1) {
+                return;
+            }
+            /* message queue is full, so go on with the frames */
+            budget = SHM_RADIO_RX_BUDGET;
+        }
+        _receive(dev, slot);
+        _pop(dev->medium, node, slot);
+    }
+}
+
+void shm_radio_setup(shm_radio_t *dev, const char *file, uint16_t node)
+{
+    memset(dev, 0, sizeof(shm_radio_t));
+    dev->file = file;
+    dev->node = node;
+}
+
+int shm_radio_init(shm_radio_t *dev)
+{
+    shm_radio_medium_t *medium;
+    shm_radio_node_t *node;
+    struct stat st;
+    int fd;
+    uint16_t addr = dev->node + 1;
+
+    dev->driver = (gnrc_netdev_driver_t *)&shm_radio_driver;
+    dev->event_cb = NULL;
+    dev->mac_pid = KERNEL_PID_UNDEF;
+    if (dev->file == NULL) {
+        return -ENODEV;
+    }
+
+    _native_in_syscall++;
+    if ((fd = real_open(dev->file, O_RDWR)) == -1) {
+        warn("shm_radio: open(%s)", dev->file);
+        _native_in_syscall--;
+        return -ENODEV;
+    }
+    if ((fstat(fd, &st) == -1) || ((size_t)st.st_size < sizeof(shm_radio_medium_t))) {
+        warnx("shm_radio: %s is no medium", dev->file);
+        real_close(fd);
+        _native_in_syscall--;
+        return -EINVAL;
+    }
+    medium = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    real_close(fd);
+    _native_in_syscall--;
+    if (medium == MAP_FAILED) {
+        warn("shm_radio: mmap(%s)", dev->file);
+        return -EINVAL;
+    }
+    dev->medium = medium;
+    dev->medium_len = st.st_size;
+    if ((medium->magic != SHM_RADIO_MAGIC) || (medium->ring_size == 0) ||
+        (medium->ring_size & (medium->ring_size - 1)) ||
+        ((size_t)st.st_size < (_nodes_offset(medium->nodes) +
+                               (medium->nodes * _node_len(medium->ring_size)))) ||
+        (dev->node >= medium->nodes)) {
+        warnx("shm_radio: %s is no medium or has no node %u", dev->file,
+              (unsigned)dev->node);
+        _native_in_syscall++;
+        munmap(medium, dev->medium_len);
+        _native_in_syscall--;
+        dev->medium = NULL;
+        return -EINVAL;
+    }
+
+    /* drop what a former instance of this node left */
+    node = _node(medium, dev->node);
+    __atomic_store_n(&node->waiting, 0, __ATOMIC_SEQ_CST);
+    for (shm_radio_slot_t *slot; (slot = _peek(medium, node)) != NULL;) {
+        _pop(medium, node, slot);
+    }
+    register_interrupt(SIGUSR2, _isr);
+#ifdef MODULE_NATIVE_VTIME
+    native_vtime_attach(&medium->clock, &_node(medium, 0)->vtime,
+                        _node_len(medium->ring_size), medium->nodes, dev->node);
+#endif
+    __atomic_store_n(&node->pid, _native_pid, __ATOMIC_SEQ_CST);
+
+    /* derive the addresses from the node number */
+    dev->addr_short[0] = (uint8_t)(addr >> 8);
+    dev->addr_short[1] = (uint8_t)addr;
+    memset(dev->addr_long, 0, sizeof(dev->addr_long));
+    dev->addr_long[0] = 0x02;   /* locally administered */
+    dev->addr_long[6] = dev->addr_short[0];
+    dev->addr_long[7] = dev->addr_short[1];
+    dev->pan = SHM_RADIO_DEFAULT_PANID;
+    dev->chan = SHM_RADIO_DEFAULT_CHANNEL;
+    dev->flags = SHM_RADIO_FLAGS_SRC_ADDR_LONG;
+    dev->seq = 0;
+#ifdef MODULE_GNRC_SIXLOWPAN
+    dev->proto = GNRC_NETTYPE_SIXLOWPAN;
+#else
+    dev->proto = GNRC_NETTYPE_UNDEF;
+#endif
+    DEBUG("shm_radio: node %u of %u attached to %s\n", (unsigned)dev->node,
+          (unsigned)medium->nodes, dev->file);
+
+    return 0;
+}
+
+void shm_radio_cleanup(shm_radio_t *dev)
+{
+    if ((dev == NULL) || (dev->medium == NULL)) {
+        return;
+    }
+    __atomic_store_n(&_node(dev->medium, dev->node)->pid, 0, __ATOMIC_SEQ_CST);
+#ifdef MODULE_NATIVE_VTIME
+    native_vtime_detach();
+#endif
+    unregister_interrupt(SIGUSR2);
+    _native_in_syscall++;
+    munmap(dev->medium, dev->medium_len);
+    _native_in_syscall--;
+    dev->medium = NULL;
+}
+
+const gnrc_netdev_driver_t shm_radio_driver = {
+    .send_data = _send,
+    .add_event_callback = _add_event_cb,
+    .rem_event_callback = _rem_event_cb,
+    .get = _get,
+    .set = _set,
+    .isr_event = _isr_event,
+};
@@ -51,6 +51,10 @@ const char *_native_unix_socket_path = NULL;
 extern netdev2_tap_t netdev2_tap;
 #endif
 
+#ifdef MODULE_SHM_RADIO
+#include "shm_radio.h"
+#endif
+
 /**
  * initialize _native_null_in_pipe to allow for reading from stdin
  * @param stdiotype: "stdio" (only initialize pipe) or any string
@@ -200,7 +204,11 @@ void usage_exit(void)
     real_printf(" <tap interface>");
 #endif
 
-    real_printf(" [-i <id>] [-d] [-e|-E] [-o]\n");
+    real_printf(" [-i <id>] [-d] [-e|-E] [-o]");
+#if defined(MODULE_SHM_RADIO)
+    real_printf(" [-r <medium>]");
+#endif
+    real_printf("\n");
 
     real_printf(" help: %s -h\n", _progname);
 
@@ -217,6 +225,11 @@ void usage_exit(void)
             daemon/socket io)\n\
 -o          redirect stdout to file (/tmp/riot.stdout.PID) when not attached\n\
             to socket\n");
+#if defined(MODULE_SHM_RADIO)
+    real_printf("\
+-r <medium> attach to the shared memory radio medium in file <medium> as\n\
+            node <id>\n");
+#endif
 
     real_printf("\n\
 The order of command line arguments matters.\n");
@@ -239,6 +252,9 @@ __attribute__((constructor)) static void startup(int argc, char **argv)
     char *stderrtype = "stdio";
     char *stdouttype = "stdio";
     char *stdiotype = "stdio";
+#if defined(MODULE_SHM_RADIO)
+    char *shm_radio_medium = NULL;
+#endif
 
 #if defined(MODULE_NETDEV2_TAP)
     if (
@@ -297,6 +313,17 @@ __attribute__((constructor)) static void startup(int argc, char **argv)
         else if (strcmp("-o", arg) == 0) {
             stdouttype = "file";
         }
+#if defined(MODULE_SHM_RADIO)
+        else if (strcmp("-r", arg) == 0) {
+            if (argp + 1 < argc) {
+                argp++;
+            }
+            else {
+                usage_exit();
+            }
+            shm_radio_medium = argv[argp];
+        }
+#endif
         else {
             usage_exit();
         }
@@ -315,6 +342,9 @@ __attribute__((constructor)) static void startup(int argc, char **argv)
 #ifdef MODULE_NETDEV2_TAP
     netdev2_tap_setup(&netdev2_tap, argv[1]);
 #endif
+#ifdef MODULE_SHM_RADIO
+    shm_radio_setup(&shm_radio, shm_radio_medium, (uint16_t)_native_id);
+#endif
 
     board_init();
 
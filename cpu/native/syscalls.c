@@ -92,6 +92,9 @@ const char* (*real_gai_strerror)(int errcode);
 FILE* (*real_fopen)(const char *path, const char *mode);
 mode_t (*real_umask)(mode_t cmask);
 ssize_t (*real_writev)(int fildes, const struct iovec *iov, int iovcnt);
+#ifdef MODULE_NETDEV2_TAP_POLL
+int (*real_pthread_create)(void *thread, ...);
+#endif
 
 #ifdef __MACH__
 #else
@@ -454,6 +457,9 @@ void _native_init_syscalls(void)
     *(void **)(&real_clearerr) = dlsym(RTLD_NEXT, "clearerr");
     *(void **)(&real_umask) = dlsym(RTLD_NEXT, "umask");
     *(void **)(&real_writev) = dlsym(RTLD_NEXT, "writev");
+#ifdef MODULE_NETDEV2_TAP_POLL
+    *(void **)(&real_pthread_create) = dlsym(RTLD_NEXT, "pthread_create");
+#endif
 #ifdef __MACH__
 #else
     *(void **)(&real_clock_gettime) = dlsym(RTLD_NEXT, "clock_gettime");
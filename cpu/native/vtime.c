@@ -0,0 +1,341 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @ingroup     native_vtime
+ * @{
+ *
+ * @file
+ * @brief       Virtual time of native
+ *
+ * native_vtime_clock_t::running counts the instances that are awake plus the
+ * wake-ups that are on their way. Whoever brings it down to 0 advances the
+ * clock to the earliest timer of all instances and wakes up the instances
+ * whose timer expired.
+ *
+ * Whoever wakes up an instance counts it first. If the instance is idle, it
+ * is set to NATIVE_VTIME_CLAIMED, takes that count over and gets the signal.
+ * If it is awake, the signal is left in native_vtime_node_t::kicks, which the
+ * instance raises itself after it announced to go idle. Either way, it can't
+ * go idle with a signal for it still underway.
+ * @}
+ */
+
+#ifdef MODULE_NATIVE_VTIME
+
+#include <err.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "native_internal.h"
+#include "native_vtime.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+static native_vtime_clock_t _local_clock = { .running = 1 };
+static native_vtime_node_t _local_node = {
+    .next = UINT64_MAX,
+    .state = NATIVE_VTIME_AWAKE,
+};
+
+/* the clock in use and the instances on it */
+static native_vtime_clock_t *_clock = &_local_clock;
+static uint8_t *_nodes = (uint8_t *)&_local_node;
+static size_t _stride = sizeof(native_vtime_node_t);
+static unsigned _num = 1;
+static unsigned _self = 0;
+
+/* the time as seen by this instance, ahead of the clock by its reads */
+static uint64_t _now;
+static uint64_t _target;
+static bool _armed;
+static bool _raised;
+
+static void _advance(void);
+
+static inline native_vtime_node_t *_node(unsigned node)
+{
+    return (native_vtime_node_t *)(_nodes + (node * _stride));
+}
+
+static inline void _update(void)
+{
+    uint64_t now = __atomic_load_n(&_clock->now, __ATOMIC_SEQ_CST);
+
+    if (now > _now) {
+        _now = now;
+    }
+}
+
+static void _release(uint32_t count)
+{
+    if (__atomic_sub_fetch(&_clock->running, count, __ATOMIC_SEQ_CST) == 0) {
+        _advance();
+    }
+}
+
+/* sets the node awake, it got a signal */
+static void _wake(native_vtime_node_t *node)
+{
+    if (__atomic_exchange_n(&node->state, NATIVE_VTIME_AWAKE, __ATOMIC_SEQ_CST) ==
+        NATIVE_VTIME_CLAIMED) {
+        /* counted twice now */
+        _release(1);
+    }
+}
+
+static bool _claim(native_vtime_node_t *node, int sig)
+{
+    int32_t pid = __atomic_load_n(&node->pid, __ATOMIC_SEQ_CST);
+    uint32_t state = __atomic_load_n(&node->state, __ATOMIC_SEQ_CST);
+
+    __atomic_add_fetch(&_clock->running, 1, __ATOMIC_SEQ_CST);
+    while (1) {
+        uint32_t tmp;
+
+        if ((pid == 0) || (state == NATIVE_VTIME_OFF)) {
+            break;
+        }
+        if (state == NATIVE_VTIME_IDLE) {
+            int res;
+
+            /* hand the count over before it can wake up */
+            if (!__atomic_compare_exchange_n(&node->state, &state, NATIVE_VTIME_CLAIMED,
+                                             false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+                continue;
+            }
+            _native_in_syscall++;
+            res = kill(pid, sig);
+            _native_in_syscall--;
+            if (res == 0) {
+                return true;
+            }
+            /* it is gone, don't let its timer hold up the clock */
+            __atomic_store_n(&node->state, NATIVE_VTIME_OFF, __ATOMIC_SEQ_CST);
+            break;
+        }
+        /* it is awake and raises the signal itself before it goes idle. If it
+         * went idle meanwhile, it may have missed it, so look again. */
+        __atomic_fetch_or(&node->kicks, (uint32_t)1 << sig, __ATOMIC_SEQ_CST);
+        tmp = __atomic_load_n(&node->state, __ATOMIC_SEQ_CST);
+        if (tmp == state) {
+            _release(1);
+            return true;
+        }
+        state = tmp;
+    }
+    _release(1);
+    return false;
+}
+
+static void _advance(void)
+{
+    uint32_t idle_gen;
+    bool gone;
+
+    do {
+        uint32_t running = 0;
+        uint64_t next = UINT64_MAX;
+
+        gone = false;
+
+        /* keep everybody else from advancing as well */
+        if (!__atomic_compare_exchange_n(&_clock->running, &running, 1, false,
+                                         __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+            return;
+        }
+        idle_gen = __atomic_load_n(&_clock->idle_gen, __ATOMIC_SEQ_CST);
+        for (unsigned i = 0; i < _num; i++) {
+            native_vtime_node_t *node = _node(i);
+            uint64_t tmp = __atomic_load_n(&node->next, __ATOMIC_SEQ_CST);
+
+            if ((__atomic_load_n(&node->state, __ATOMIC_SEQ_CST) != NATIVE_VTIME_OFF) &&
+                (tmp < next)) {
+                next = tmp;
+            }
+        }
+        if (next != UINT64_MAX) {
+            if (next > __atomic_load_n(&_clock->now, __ATOMIC_SEQ_CST)) {
+                DEBUG("native_vtime: advancing to %llu\n", (unsigned long long)next);
+                __atomic_store_n(&_clock->now, next, __ATOMIC_SEQ_CST);
+            }
+            for (unsigned i = 0; i < _num; i++) {
+                native_vtime_node_t *node = _node(i);
+
+                if ((__atomic_load_n(&node->state, __ATOMIC_SEQ_CST) != NATIVE_VTIME_OFF) &&
+                    (__atomic_load_n(&node->next, __ATOMIC_SEQ_CST) <= next)) {
+                    gone |= !_claim(node, SIGALRM);
+                }
+            }
+        }
+        /* go again if somebody went idle while we looked at the timers or
+         * the instance we advanced to is gone */
+    } while ((__atomic_sub_fetch(&_clock->running, 1, __ATOMIC_SEQ_CST) == 0) &&
+             (gone || (__atomic_load_n(&_clock->idle_gen, __ATOMIC_SEQ_CST) != idle_gen)));
+}
+
+/* checks for signals that are blocked now but not in mask */
+static bool _signal_pending(const sigset_t *mask)
+{
+    sigset_t pending;
+
+    if (sigpending(&pending) == -1) {
+        return false;
+    }
+    for (int sig = 1; sig < NSIG; sig++) {
+        if ((sigismember(&pending, sig) == 1) && (sigismember(mask, sig) == 0)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void native_vtime_init(void)
+{
+    _local_node.pid = _native_pid;
+    _now = 0;
+    _armed = false;
+}
+
+uint32_t native_vtime_read(void)
+{
+    uint64_t now;
+
+    _update();
+    now = _now++;
+    if (_armed && !_raised && (_target <= now)) {
+        /* nobody else will notice while we are running */
+        _raised = true;
+        _native_in_syscall++;
+        kill(_native_pid, SIGALRM);
+        _native_in_syscall--;
+    }
+    return (uint32_t)now;
+}
+
+void native_vtime_set(uint32_t offset)
+{
+    _update();
+    _target = _now + offset;
+    _armed = true;
+    _raised = false;
+}
+
+void native_vtime_clear(void)
+{
+    _armed = false;
+}
+
+bool native_vtime_expired(void)
+{
+    _update();
+    if (!_armed || (_target > _now)) {
+        return false;
+    }
+    _armed = false;
+    return true;
+}
+
+void native_vtime_sleep(void)
+{
+    native_vtime_node_t *self = _node(_self);
+    sigset_t all, old;
+    uint32_t kicks;
+
+    /* block everything until sigsuspend(), so that no signal slips through
+     * between looking and going idle */
+    sigfillset(&all);
+    if (sigprocmask(SIG_SETMASK, &all, &old) == -1) {
+        err(EXIT_FAILURE, "native_vtime_sleep: sigprocmask");
+    }
+    __atomic_store_n(&self->next, _armed ? _target : UINT64_MAX, __ATOMIC_SEQ_CST);
+    /* from here on, whoever sends a signal hands its count over */
+    __atomic_store_n(&self->state, NATIVE_VTIME_IDLE, __ATOMIC_SEQ_CST);
+    kicks = __atomic_exchange_n(&self->kicks, 0, __ATOMIC_SEQ_CST);
+    for (int sig = 1; sig < 32; sig++) {
+        if (kicks & ((uint32_t)1 << sig)) {
+            kill(_native_pid, sig);
+        }
+    }
+    if ((_native_sigpend > 0) || _signal_pending(&old)) {
+        _wake(self);
+    }
+    else {
+        __atomic_add_fetch(&_clock->idle_gen, 1, __ATOMIC_SEQ_CST);
+        _release(1);
+        sigsuspend(&old);
+        /* the host did not count its signals */
+        __atomic_add_fetch(&_clock->running, 1, __ATOMIC_SEQ_CST);
+        _wake(self);
+    }
+    if (sigprocmask(SIG_SETMASK, &old, NULL) == -1) {
+        err(EXIT_FAILURE, "native_vtime_sleep: sigprocmask");
+    }
+}
+
+void native_vtime_attach(native_vtime_clock_t *clock, native_vtime_node_t *nodes,
+                         size_t stride, unsigned num, unsigned self)
+{
+    native_vtime_node_t *node = (native_vtime_node_t *)(((uint8_t *)nodes) + (self * stride));
+    uint32_t state;
+
+    __atomic_add_fetch(&clock->running, 1, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&node->next, UINT64_MAX, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&node->kicks, 0, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&node->pid, _native_pid, __ATOMIC_SEQ_CST);
+    state = __atomic_exchange_n(&node->state, NATIVE_VTIME_AWAKE, __ATOMIC_SEQ_CST);
+
+    _clock = clock;
+    _nodes = (uint8_t *)nodes;
+    _stride = stride;
+    _num = num;
+    _self = self;
+    /* take over what a former instance that was killed left counted */
+    if ((state == NATIVE_VTIME_AWAKE) || (state == NATIVE_VTIME_CLAIMED)) {
+        _release(1);
+    }
+    _update();
+    DEBUG("native_vtime: attached as %u of %u at %llu\n", self, num,
+          (unsigned long long)_now);
+}
+
+void native_vtime_detach(void)
+{
+    uint32_t state;
+
+    if (_clock == &_local_clock) {
+        return;
+    }
+    state = __atomic_exchange_n(&_node(_self)->state, NATIVE_VTIME_OFF, __ATOMIC_SEQ_CST);
+    if ((state == NATIVE_VTIME_AWAKE) || (state == NATIVE_VTIME_CLAIMED)) {
+        /* like going idle for good */
+        __atomic_add_fetch(&_clock->idle_gen, 1, __ATOMIC_SEQ_CST);
+        _release(1);
+    }
+
+    _clock = &_local_clock;
+    _nodes = (uint8_t *)&_local_node;
+    _stride = sizeof(native_vtime_node_t);
+    _num = 1;
+    _self = 0;
+    _local_clock.now = _now;
+}
+
+void native_vtime_kick(unsigned node, int sig)
+{
+    if ((node < _num) && (sig < 32)) {
+        _claim(_node(node), sig);
+    }
+}
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_NATIVE_VTIME */
@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+# Copyright (C) 2016 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+"""Creates and inspects the medium of the native shared memory radio.
+
+The layout mirrors cpu/native/include/shm_radio.h: a header with the clock
+shared by nodes built with native_vtime, the packet reception rate (PRR) of
+every link in 1/255, and a receive ring per node.
+"""
+
+import argparse
+import math
+import mmap
+import os
+import struct
+import sys
+
+MAGIC = 0x52534d32
+HDR = struct.Struct("<IHHQII")
+NODE = struct.Struct("<iIIIQiII")
+VTIME_STATES = ("off", "awake", "idle", "claimed")
+NODE_LEN = 128
+SLOT_LEN = 136
+VTIME_STATE = 28
+VTIME_AWAKE = 1
+
+
+def nodes_offset(nodes):
+    return (HDR.size + nodes * nodes + 63) & ~63
+
+
+def node_offset(nodes, ring_size, node):
+    return nodes_offset(nodes) + node * (NODE_LEN + ring_size * SLOT_LEN)
+
+
+def medium_len(nodes, ring_size):
+    return node_offset(nodes, ring_size, nodes)
+
+
+def topology(kind, nodes):
+    """Yields the (src, dst) pairs of a topology, in both directions."""
+    if kind == "full":
+        for src in range(nodes):
+            for dst in range(nodes):
+                if src != dst:
+                    yield src, dst
+    elif kind == "line":
+        for src in range(nodes - 1):
+            yield src, src + 1
+            yield src + 1, src
+    elif kind == "grid":
+        width = int(math.ceil(math.sqrt(nodes)))
+        for src in range(nodes):
+            x, y = src % width, src // width
+            for dx, dy in ((1, 0), (0, 1)):
+                if x + dx < width and src + dx + dy * width < nodes:
+                    dst = src + dx + dy * width
+                    yield src, dst
+                    yield dst, src
+    elif kind != "none":
+        raise ValueError("unknown topology " + kind)
+
+
+def open_medium(path):
+    fd = os.open(path, os.O_RDWR)
+    try:
+        m = mmap.mmap(fd, 0)
+    finally:
+        os.close(fd)
+    magic, nodes, ring_size = HDR.unpack_from(m, 0)[:3]
+    if magic != MAGIC or len(m) < medium_len(nodes, ring_size):
+        sys.exit("%s is no medium" % path)
+    return m, nodes, ring_size
+
+
+def create(args):
+    if args.ring & (args.ring - 1) or not 0 < args.nodes < 0xffff:
+        sys.exit("ring size must be a power of 2, nodes between 1 and 65534")
+    length = medium_len(args.nodes, args.ring)
+    fd = os.open(args.file, os.O_RDWR | os.O_CREAT | os.O_TRUNC, 0o666)
+    try:
+        os.ftruncate(fd, length)
+        m = mmap.mmap(fd, length)
+    finally:
+        os.close(fd)
+    # with --vtime, all nodes count as running until they attached and went
+    # idle, so the clock does not run ahead of the nodes that start last
+    HDR.pack_into(m, 0, MAGIC, args.nodes, args.ring, 0,
+                  args.nodes if args.vtime else 0, 0)
+    for src, dst in topology(args.topology, args.nodes):
+        m[HDR.size + src * args.nodes + dst] = args.prr
+    for node in range(args.nodes):
+        off = node_offset(args.nodes, args.ring, node)
+        if args.vtime:
+            struct.pack_into("<I", m, off + VTIME_STATE, VTIME_AWAKE)
+        for i in range(args.ring):
+            struct.pack_into("<I", m, off + NODE_LEN + i * SLOT_LEN, i)
+    m.close()
+
+
+def link(args):
+    m, nodes, _ = open_medium(args.file)
+    if args.src >= nodes or args.dst >= nodes:
+        sys.exit("the medium has only %u nodes" % nodes)
+    m[HDR.size + args.src * nodes + args.dst] = args.prr
+    if args.sym:
+        m[HDR.size + args.dst * nodes + args.src] = args.prr
+    m.close()
+
+
+def stats(args):
+    m, nodes, ring_size = open_medium(args.file)
+    now, running = HDR.unpack_from(m, 0)[3:5]
+    print("%u nodes, %u slots per node" % (nodes, ring_size))
+    print("virtual time %.6f s, %u nodes running" % (now / 1e6, running))
+    print("node    pid       pending  drops  links  vtime")
+    for node in range(nodes):
+        off = node_offset(nodes, ring_size, node)
+        pid, _, head, drops, _, _, state, _ = NODE.unpack_from(m, off)
+        tail, = struct.unpack_from("<I", m, off + 64)
+        links = sum(1 for dst in range(nodes)
+                    if m[HDR.size + node * nodes + dst] != 0)
+        state = VTIME_STATES[state] if state < len(VTIME_STATES) else str(state)
+        print("%-7u %-9d %-8u %-6u %-6u %s" % (node, pid, (head - tail) & 0xffffffff,
+                                               drops, links, state))
+    m.close()
+
+
+def prr(value):
+    value = int(value)
+    if not 0 <= value <= 255:
+        raise argparse.ArgumentTypeError("PRR must be between 0 and 255")
+    return value
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__)
+    sub = p.add_subparsers(dest="cmd")
+    c = sub.add_parser("create", help="create a medium")
+    c.add_argument("file")
+    c.add_argument("nodes", type=int)
+    c.add_argument("topology", nargs="?", default="full",
+                   choices=("full", "line", "grid", "none"))
+    c.add_argument("--prr", type=prr, default=255,
+                   help="PRR of the links of the topology (default: 255)")
+    c.add_argument("--ring", type=int, default=16,
+                   help="frames a node buffers (default: 16)")
+    c.add_argument("--vtime", action="store_true",
+                   help="start the virtual time of native_vtime only when "
+                        "all nodes are up")
+    c.set_defaults(func=create)
+    l = sub.add_parser("link", help="set the PRR from src to dst, 0 cuts it")
+    l.add_argument("file")
+    l.add_argument("src", type=int)
+    l.add_argument("dst", type=int)
+    l.add_argument("prr", type=prr)
+    l.add_argument("--sym", action="store_true", help="set dst to src as well")
+    l.set_defaults(func=link)
+    s = sub.add_parser("stats", help="show nodes, pending frames and drops")
+    s.add_argument("file")
+    s.set_defaults(func=stats)
+    args = p.parse_args()
+    if args.cmd is None:
+        p.print_help()
+        sys.exit(1)
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -183,6 +183,11 @@ void auto_init(void)
     auto_init_netdev2_tap();
 #endif
 
+#ifdef MODULE_SHM_RADIO
+    extern void auto_init_shm_radio(void);
+    auto_init_shm_radio();
+#endif
+
 #endif /* MODULE_AUTO_INIT_GNRC_NETIF */
 
 #ifdef MODULE_GNRC_IPV6_NETIF
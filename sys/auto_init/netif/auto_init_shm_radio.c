@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @ingroup auto_init_gnrc_netif
+ * @{
+ *
+ * @file
+ * @brief   Auto initialization for the shared memory radio of native
+ */
+
+#ifdef MODULE_SHM_RADIO
+
+#include "net/gnrc/nomac.h"
+#include "net/gnrc.h"
+
+#include "shm_radio.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/**
+ * @brief   Define stack parameters for the MAC layer thread
+ * @{
+ */
+#define SHM_RADIO_MAC_STACKSIZE     (THREAD_STACKSIZE_DEFAULT + DEBUG_EXTRA_STACKSIZE)
+#define SHM_RADIO_MAC_PRIO          (THREAD_PRIORITY_MAIN - 4)
+/** @} */
+
+/**
+ * @brief   Stack for the MAC layer thread
+ */
+static char _nomac_stack[SHM_RADIO_MAC_STACKSIZE];
+
+void auto_init_shm_radio(void)
+{
+    if (shm_radio_init(&shm_radio) < 0) {
+        DEBUG("Error initializing shared memory radio\n");
+        return;
+    }
+    gnrc_nomac_init(_nomac_stack, SHM_RADIO_MAC_STACKSIZE, SHM_RADIO_MAC_PRIO,
+                    "shm_radio", (gnrc_netdev_t *)&shm_radio);
+}
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_SHM_RADIO */
+/** @} */
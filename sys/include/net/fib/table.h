@@ -35,6 +35,23 @@ extern "C" {
  */
 #define FIB_MAX_REGISTERED_RP (5)
 
+/**
+ * @brief Node of the longest-prefix-match trie indexing a FIB table
+ *
+ * @details The trie is path-compressed: a node only exists where a
+ *          destination prefix ends or where two prefixes diverge. The key of
+ *          an entry is its address size (one byte) followed by the address,
+ *          up to and including the lowest set bit of the address.
+ */
+typedef struct fib_trie_node_t {
+    /** subtrees continuing with a 0 or a 1 bit at position `bit` */
+    struct fib_trie_node_t *child[2];
+    /** number of leading key bits shared by all entries below this node */
+    uint16_t bit;
+    /** 1 if this is fib_entry_t::node of an entry, 0 for a branching node */
+    uint8_t keyed;
+} fib_trie_node_t;
+
 /**
  * @brief Container descriptor for a FIB entry
  */
@@ -51,6 +68,10 @@ typedef struct fib_entry_t {
     uint32_t next_hop_flags;
     /** Pointer to the shared generic address */
     struct universal_address_container_t *next_hop;
+    /** trie node of this entry's destination */
+    fib_trie_node_t node;
+    /** spare branching node, a trie over n entries needs at most n - 1 */
+    fib_trie_node_t glue;
 } fib_entry_t;
 
 /**
@@ -133,6 +154,14 @@ typedef struct {
     *   e.g. when the unreachable destination is covered by the prefix
     */
     universal_address_container_t* prefix_rp[FIB_MAX_REGISTERED_RP];
+    /** root of the lookup trie over `data.entries` (single hop tables only) */
+    fib_trie_node_t *trie_root;
+    /** unused branching nodes, linked through fib_trie_node_t::child[0] */
+    fib_trie_node_t *trie_free;
+    /** changes whenever an entry is added, updated or removed, so users
+    *   can tell whether results they cached from this table are still valid
+    */
+    uint32_t generation;
 } fib_table_t;
 
 #ifdef __cplusplus
@@ -12,6 +12,14 @@
  * @brief       Provides an implementation of the @ref net_conn by the
  *              @ref net_gnrc
  *
+ * Usually a connection delivers its packets to the thread that created it,
+ * which waits for them in conn_udp_recvfrom() or conn_ip_recvfrom(). With the
+ * pseudomodule `gnrc_conn_async`, connections can instead be added to a
+ * @ref gnrc_conn_mux_t. One thread then serves all of them: the packets of
+ * every connection are queued in the connection, conn_udp_recvfrom() and
+ * conn_ip_recvfrom() take them from there without blocking, and the thread
+ * learns about them through a callback or gnrc_conn_mux_poll().
+ *
  * @{
  *
  * @file
@@ -24,7 +32,9 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <sys/uio.h>
 #include "net/ipv6/addr.h"
+#include "msg.h"
 #include "net/gnrc.h"
 #include "sched.h"
 
@@ -32,16 +42,78 @@
 extern "C" {
 #endif
 
+#if defined(MODULE_GNRC_CONN_ASYNC) || defined(DOXYGEN)
 /**
- * @brief   Connection base class
+ * @brief   Number of packets a connection in a @ref gnrc_conn_mux_t keeps
+ *          until they are received
+ *
+ * Further packets are dropped.
+ */
+#ifndef GNRC_CONN_QUEUE_SIZE
+#define GNRC_CONN_QUEUE_SIZE    (4U)
+#endif
+
+struct gnrc_conn;
+struct gnrc_conn_mux;
+
+/**
+ * @brief   Signals that a packet was queued in a connection
+ *
+ * It may close @p conn, but no other connection of its multiplexer.
+ *
+ * @param[in] conn  The connection (conn_udp_t or conn_ip_t).
+ * @param[in] arg   Argument given to gnrc_conn_async().
+ */
+typedef void (*gnrc_conn_cb_t)(void *conn, void *arg);
+
+/**
+ * @brief   State of a connection in a @ref gnrc_conn_mux_t
  * @internal
  */
 typedef struct {
+    struct gnrc_conn_mux *mux;                  /**< the multiplexer, NULL if not in one */
+    struct gnrc_conn *next;                     /**< next connection of the multiplexer */
+    gnrc_conn_cb_t cb;                          /**< callback, may be NULL */
+    void *arg;                                  /**< argument for gnrc_conn_async_t::cb */
+    gnrc_pktsnip_t *queue[GNRC_CONN_QUEUE_SIZE];    /**< packets not yet received */
+    uint8_t head;                               /**< oldest packet in gnrc_conn_async_t::queue */
+    uint8_t len;                                /**< packets in gnrc_conn_async_t::queue */
+} gnrc_conn_async_t;
+#endif
+
+/**
+ * @brief   Connection base class
+ * @internal
+ */
+typedef struct gnrc_conn {
     gnrc_nettype_t l3_type;                     /**< Network layer type of the connection */
     gnrc_nettype_t l4_type;                     /**< Transport layer type of the connection */
     gnrc_netreg_entry_t netreg_entry;           /**< @p net_ng_netreg entry for the connection */
+#ifdef MODULE_GNRC_CONN_ASYNC
+    gnrc_conn_async_t async;                    /**< asynchronous mode */
+#endif
 } conn_t;
 
+#if defined(MODULE_GNRC_CONN_ASYNC) || defined(DOXYGEN)
+/**
+ * @brief   Multiplexer for many connections served by one thread
+ *
+ * The packets of all its connections are sent to the thread of the
+ * multiplexer, so its message queue is the event queue they share. Hand
+ * every message the thread receives to gnrc_conn_mux_handle(), or wait in
+ * gnrc_conn_mux_poll(), which does so.
+ *
+ * Connections of the multiplexer with the same port or protocol share one
+ * registry entry: conn_t::netreg_entry of only one of them is registered,
+ * the others keep KERNEL_PID_UNDEF as its PID. Each packet is queued in all
+ * of them.
+ */
+typedef struct gnrc_conn_mux {
+    conn_t *conns;                              /**< the connections */
+    kernel_pid_t pid;                           /**< thread serving the connections */
+} gnrc_conn_mux_t;
+#endif
+
 /**
  * @brief   Raw connection type
  * @internal
@@ -52,6 +124,9 @@ struct conn_ip {
     gnrc_nettype_t l4_type;                     /**< Transport layer type of the connection.
                                                  *   Always GNRC_NETTYPE_UNDEF */
     gnrc_netreg_entry_t netreg_entry;           /**< @p net_ng_netreg entry for the connection */
+#ifdef MODULE_GNRC_CONN_ASYNC
+    gnrc_conn_async_t async;                    /**< asynchronous mode */
+#endif
     uint8_t local_addr[sizeof(ipv6_addr_t)];    /**< local IP address */
     size_t local_addr_len;                      /**< length of struct conn_ip::local_addr */
 };
@@ -67,6 +142,9 @@ struct conn_udp {
     gnrc_nettype_t l4_type;                     /**< Transport layer type of the connection.
                                                  *   Always GNRC_NETTYPE_UDP */
     gnrc_netreg_entry_t netreg_entry;           /**< @p net_ng_netreg entry for the connection */
+#ifdef MODULE_GNRC_CONN_ASYNC
+    gnrc_conn_async_t async;                    /**< asynchronous mode */
+#endif
     uint8_t local_addr[sizeof(ipv6_addr_t)];    /**< local IP address */
     size_t local_addr_len;                      /**< length of struct conn_ip::local_addr */
 };
@@ -120,10 +198,137 @@ bool gnrc_conn6_set_local_addr(uint8_t *conn_addr, const ipv6_addr_t *addr);
  * @return  -ENOMEM, if received data was more than max_len.
  * @returne -ETIMEDOUT, if more than 3 IPC messages were not @ref net_ng_netapi receive commands
  *          with the required headers in the packet
+ * @return  -EAGAIN, if @p conn is in a @ref gnrc_conn_mux_t and has no packet queued.
+ *          A packet that does not fit @p max_len stays queued then.
  */
 int gnrc_conn_recvfrom(conn_t *conn, void *data, size_t max_len, void *addr, size_t *addr_len,
                        uint16_t *port);
 
+#if defined(MODULE_GNRC_CONN_ASYNC) || defined(DOXYGEN)
+/**
+ * @brief   Initializes a multiplexer for the calling thread
+ *
+ * @pre The calling thread must provide a message queue. It receives the
+ *      packets of all connections of @p mux, so make it long enough.
+ * @pre The calling thread must not register for packets itself; every packet
+ *      it gets is taken for one of @p mux's connections.
+ *
+ * @param[out] mux  The multiplexer.
+ */
+void gnrc_conn_mux_init(gnrc_conn_mux_t *mux);
+
+/**
+ * @brief   Puts a connection into asynchronous mode
+ *
+ * From now on, the packets for @p conn are sent to the thread of @p mux and
+ * queued in @p conn. conn_udp_recvfrom() and conn_ip_recvfrom() do not block
+ * anymore. conn_udp_close() and conn_ip_close() take @p conn out of @p mux
+ * again and drop the packets still queued. Close @p conn before creating it
+ * anew.
+ *
+ * @param[in,out] conn  A connection created by conn_udp_create() or
+ *                      conn_ip_create().
+ * @param[in] mux       The multiplexer.
+ * @param[in] cb        Called in the thread of @p mux for every packet queued
+ *                      in @p conn. May be NULL.
+ * @param[in] arg       Argument for @p cb.
+ *
+ * @return  0 on success.
+ * @return  -EBADF, if @p conn was not created.
+ * @return  -EBUSY, if @p conn is in another multiplexer.
+ */
+int gnrc_conn_async(void *conn, gnrc_conn_mux_t *mux, gnrc_conn_cb_t cb, void *arg);
+
+/**
+ * @brief   Takes a connection out of its multiplexer and drops its packets
+ *
+ * @internal
+ *
+ * @param[in,out] conn  A connection, in a multiplexer or not.
+ */
+void gnrc_conn_async_close(conn_t *conn);
+
+/**
+ * @brief   Number of packets queued in a connection of a multiplexer
+ *
+ * @param[in] conn  A connection.
+ *
+ * @return  The number of packets conn_udp_recvfrom() or conn_ip_recvfrom()
+ *          would return without blocking.
+ */
+static inline unsigned gnrc_conn_pending(void *conn)
+{
+    return ((conn_t *)conn)->async.len;
+}
+
+/**
+ * @brief   Queues a packet in its connection if @p msg carries one
+ *
+ * Call this for every message the thread of @p mux receives itself.
+ *
+ * @param[in] mux   The multiplexer.
+ * @param[in] msg   A message received by the thread of @p mux.
+ *
+ * @return  1, if @p msg was a packet. It was queued in all connections it
+ *          was meant for, or released if none had room for it.
+ * @return  0, if @p msg is left to the caller.
+ */
+int gnrc_conn_mux_handle(gnrc_conn_mux_t *mux, msg_t *msg);
+
+/**
+ * @brief   Waits until connections of a multiplexer have packets queued
+ *
+ * Like poll(), this reports the connections that can be received from
+ * without blocking. Messages that are not packets are handed back, so the
+ * thread of @p mux can wait for its own events here, too.
+ *
+ * @pre Must be called by the thread of @p mux.
+ *
+ * @param[in] mux       The multiplexer.
+ * @param[out] ready    The connections that have packets queued.
+ * @param[in] max       Number of elements of @p ready.
+ * @param[out] msg      A message that was not a packet.
+ *
+ * @return  Number of connections in @p ready.
+ * @return  0, if a message was stored in @p msg.
+ */
+int gnrc_conn_mux_poll(gnrc_conn_mux_t *mux, void **ready, unsigned max, msg_t *msg);
+#endif
+
+/**
+ * @brief   Sends a UDP datagram whose payload is scattered over externally
+ *          owned buffers without copying it into the packet buffer
+ *
+ * @details Works like conn_udp_sendto(), but every element of @p vector
+ *          becomes a packet snip that refers to the application's buffer
+ *          (see gnrc_pktbuf_add_ext()). The buffers must not be modified
+ *          until @p cb was called. @p cb is called exactly once, also if the
+ *          function fails, possibly before it returns.
+ *
+ * @param[in] vector    The payload buffers.
+ * @param[in] count     Number of elements in @p vector.
+ * @param[in] src       The source address. May be NULL for all any interface address.
+ * @param[in] src_len   Length of @p src. May be 0 if @p src is NULL
+ * @param[in] dst       The receiver's network address.
+ * @param[in] dst_len   Length of @p dst.
+ * @param[in] family    The family of @p src and @p dst (see @ref net_af).
+ * @param[in] sport     The source UDP port.
+ * @param[in] dport     The receiver's UDP port.
+ * @param[in] cb        Called when the buffers of @p vector can be reused.
+ *                      May be NULL.
+ * @param[in] arg       Argument for @p cb.
+ *
+ * @return  The number of payload bytes sent on success.
+ * @return  -ENOMEM, if the packet buffer is full.
+ * @return  -EINVAL, if an address length does not fit @p family.
+ * @return  -EAFNOSUPPORT, if @p family is not supported.
+ */
+int gnrc_conn_udp_sendto_iov(const struct iovec *vector, unsigned count,
+                             const void *src, size_t src_len,
+                             const void *dst, size_t dst_len, int family,
+                             uint16_t sport, uint16_t dport,
+                             gnrc_pktbuf_release_cb_t cb, void *arg);
+
 #ifdef __cplusplus
 }
 #endif
@@ -39,8 +39,37 @@ extern "C" {
 
 #define NETDEV2_MSG_TYPE_EVENT 0x1234
 
+#ifndef GNRC_NETDEV2_RX_BATCH
+/**
+ * @brief   Maximum number of received packets passed on to the next layer at
+ *          once
+ *
+ * All packets a device reports while one NETDEV2_MSG_TYPE_EVENT is handled
+ * are collected and passed on with gnrc_netapi_dispatch_receive_batch(),
+ * consecutive packets of the same type in one go. Drivers that drain several
+ * frames per event (like netdev2_tap) thus wake the next layer once per event
+ * instead of once per frame. If the message queue of the next layer is
+ * full, the adapter waits for it up to @ref GNRC_NETAPI_BATCH_WAIT per
+ * packet, so keep this below its queue size.
+ *
+ * Set to 1 to pass on every packet as soon as it was received.
+ */
+#define GNRC_NETDEV2_RX_BATCH   (8U)
+#endif
+
 typedef struct gnrc_netdev2 gnrc_netdev2_t;
 
+/**
+ * @brief   Receive statistics of a gnrc_netdev2 adapter
+ *
+ * The average number of packets passed on at once is
+ * gnrc_netdev2_stats_t::rx_pkts / gnrc_netdev2_stats_t::rx_batches.
+ */
+typedef struct {
+    uint32_t rx_pkts;       /**< packets passed on to the next layer */
+    uint32_t rx_batches;    /**< number of times packets were passed on */
+} gnrc_netdev2_stats_t;
+
 /**
  * @brief Structure holding gnrc netdev2 adapter state
  *
@@ -76,6 +105,23 @@ struct gnrc_netdev2 {
      * @brief PID of this adapter for netapi messages
      */
     kernel_pid_t pid;
+
+    /**
+     * @brief receive statistics
+     */
+    gnrc_netdev2_stats_t stats;
+
+#if (GNRC_NETDEV2_RX_BATCH > 1) || defined(DOXYGEN)
+    /**
+     * @brief received packets not yet passed on to the next layer
+     */
+    gnrc_pktsnip_t *rx_batch[GNRC_NETDEV2_RX_BATCH];
+
+    /**
+     * @brief number of packets in gnrc_netdev2_t::rx_batch
+     */
+    unsigned rx_batch_len;
+#endif
 };
 
 /**
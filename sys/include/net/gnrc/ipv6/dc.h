@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_ipv6_dc  IPv6 destination cache
+ * @ingroup     net_gnrc_ipv6
+ * @brief       Remembers how unicast destinations were reached last time.
+ *
+ * The destination cache maps a destination address (and the interface a
+ * packet was sent over, if any) to the result of the next-hop determination,
+ * address resolution and source address selection. A packet to a cached
+ * destination skips the FIB, the neighbor cache and the prefix list.
+ *
+ * The cache is flushed as a whole whenever something it is derived from
+ * changes: neighbor cache entries are added or removed, interface addresses
+ * are added or removed, the FIB changes, or neighbor discovery handles a
+ * message or timer event. As a safety net an entry also expires after
+ * @ref GNRC_IPV6_DC_LIFETIME.
+ * @{
+ *
+ * @file
+ * @brief       Destination cache definitions.
+ */
+
+#ifndef GNRC_IPV6_DC_H_
+#define GNRC_IPV6_DC_H_
+
+#include <stdint.h>
+
+#include "kernel_types.h"
+#include "net/ipv6/addr.h"
+#include "net/gnrc/ipv6/nc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef GNRC_IPV6_DC_SIZE
+/**
+ * @brief   The number of entries in the destination cache
+ *
+ * @note    Must be a power of two. The cache is direct mapped, so
+ *          destinations that hash to the same slot replace each other.
+ */
+#define GNRC_IPV6_DC_SIZE           (8)
+#endif
+
+#ifndef GNRC_IPV6_DC_LIFETIME
+/**
+ * @brief   Time in microseconds after which a cached destination is resolved
+ *          again, even if no change was signaled
+ */
+#define GNRC_IPV6_DC_LIFETIME       (1000000U)
+#endif
+
+/**
+ * @brief   gnrc_ipv6_dc_t::src holds the source address selected for the
+ *          destination
+ */
+#define GNRC_IPV6_DC_FLAGS_SRC      (0x01)
+
+/**
+ * @brief   Destination cache entry
+ */
+typedef struct {
+    ipv6_addr_t dst;            /**< destination address */
+    ipv6_addr_t src;            /**< source address selected for gnrc_ipv6_dc_t::dst */
+    uint32_t expires;           /**< xtimer_now() after which the entry is invalid */
+    kernel_pid_t iface;         /**< interface given by the sender, KERNEL_PID_UNDEF for any */
+    kernel_pid_t next_hop_iface;    /**< interface to send over, KERNEL_PID_UNDEF if unused */
+    uint8_t l2_addr[GNRC_IPV6_NC_L2_ADDR_MAX];  /**< link layer address of the next hop */
+    gnrc_ipv6_nc_t *nc_entry;   /**< neighbor cache entry of the next hop, NULL if unknown */
+    uint8_t l2_addr_len;        /**< length of gnrc_ipv6_dc_t::l2_addr */
+    uint8_t flags;              /**< flags as defined above */
+} gnrc_ipv6_dc_t;
+
+/**
+ * @brief   Counters of the destination cache
+ */
+typedef struct {
+    uint32_t hits;              /**< lookups answered by the cache */
+    uint32_t misses;            /**< lookups that needed a full resolution */
+    uint32_t flushes;           /**< number of times the cache was flushed */
+} gnrc_ipv6_dc_stats_t;
+
+/**
+ * @brief   Initializes the destination cache and resets its counters
+ */
+void gnrc_ipv6_dc_init(void);
+
+/**
+ * @brief   Looks up a destination
+ *
+ * A hit marks the neighbor cache entry of the next hop as used, so the
+ * neighbor cache keeps the neighbors the destination cache serves.
+ *
+ * @param[in] iface     The interface the sender asked for. KERNEL_PID_UNDEF
+ *                      if any.
+ * @param[in] dst       A unicast destination address
+ *
+ * @return  The cache entry for @p dst and @p iface, if it is still valid.
+ * @return  NULL, otherwise.
+ */
+gnrc_ipv6_dc_t *gnrc_ipv6_dc_get(kernel_pid_t iface, const ipv6_addr_t *dst);
+
+/**
+ * @brief   Remembers how a destination was reached
+ *
+ * @param[in] iface             The interface the sender asked for.
+ *                              KERNEL_PID_UNDEF if any.
+ * @param[in] dst               The unicast destination address
+ * @param[in] next_hop_iface    The interface the packet was sent over
+ * @param[in] l2_addr           Link layer address of the next hop
+ * @param[in] l2_addr_len       Length of @p l2_addr, must be lesser than or
+ *                              equal to GNRC_IPV6_NC_L2_ADDR_MAX.
+ *
+ * @return  The new cache entry, without a source address and neighbor cache
+ *          entry.
+ * @return  NULL, if @p l2_addr_len is too long.
+ */
+gnrc_ipv6_dc_t *gnrc_ipv6_dc_add(kernel_pid_t iface, const ipv6_addr_t *dst,
+                                 kernel_pid_t next_hop_iface,
+                                 const uint8_t *l2_addr, uint8_t l2_addr_len);
+
+/**
+ * @brief   Stores the source address selected for a destination
+ *
+ * @param[in] entry     A destination cache entry
+ * @param[in] src       The source address
+ */
+static inline void gnrc_ipv6_dc_set_src(gnrc_ipv6_dc_t *entry, const ipv6_addr_t *src)
+{
+    entry->src = *src;
+    entry->flags |= GNRC_IPV6_DC_FLAGS_SRC;
+}
+
+/**
+ * @brief   Stores the neighbor cache entry of the next hop of a destination
+ *
+ * The destination cache is flushed whenever a neighbor cache entry is added
+ * or removed, so @p nc_entry stays valid as long as @p entry does.
+ *
+ * @param[in] entry     A destination cache entry
+ * @param[in] nc_entry  The neighbor cache entry the link layer address of
+ *                      the next hop came from
+ */
+static inline void gnrc_ipv6_dc_set_nc(gnrc_ipv6_dc_t *entry, gnrc_ipv6_nc_t *nc_entry)
+{
+    entry->nc_entry = nc_entry;
+}
+
+/**
+ * @brief   Invalidates all entries of the destination cache
+ */
+void gnrc_ipv6_dc_flush(void);
+
+/**
+ * @brief   Returns the counters of the destination cache
+ *
+ * @return  The counters since the last call of gnrc_ipv6_dc_init().
+ */
+const gnrc_ipv6_dc_stats_t *gnrc_ipv6_dc_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNRC_IPV6_DC_H_ */
+/** @} */
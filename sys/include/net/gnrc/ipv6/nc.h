@@ -42,6 +42,18 @@ extern "C" {
 #define GNRC_IPV6_NC_SIZE           (GNRC_NETIF_NUMOF * 8)
 #endif
 
+#ifndef GNRC_IPV6_NC_BUCKETS
+/**
+ * @brief   Number of hash buckets the neighbor cache is indexed by
+ *
+ * @details Entries are hashed by their IPv6 address, so a lookup only
+ *          compares against the entries in one bucket. Must be a power of
+ *          two; raise it together with @ref GNRC_IPV6_NC_SIZE on nodes that
+ *          keep hundreds of neighbors.
+ */
+#define GNRC_IPV6_NC_BUCKETS        (8)
+#endif
+
 #ifndef GNRC_IPV6_NC_L2_ADDR_MAX
 /**
  * @brief   The maximum size of a link layer address
@@ -85,6 +97,15 @@ extern "C" {
 
 #define GNRC_IPV6_NC_IS_ROUTER          (0x08)  /**< The neighbor is a router */
 
+/**
+ * @brief   The neighbor indicated that it understands 6LoWPAN-GHC
+ *
+ * @see <a href="https://tools.ietf.org/html/rfc7400#section-3.3">
+ *          RFC 7400, section 3.3
+ *      </a>
+ */
+#define GNRC_IPV6_NC_SIXLOWPAN_GHC      (0x40)
+
 #define GNRC_IPV6_NC_TYPE_MASK          (0x30)  /**< Mask for neighbor cache state */
 #define GNRC_IPV6_NC_TYPE_POS           (4)     /**< Shift of neighbor cache state */
 
@@ -175,6 +196,11 @@ void gnrc_ipv6_nc_init(void);
 /**
  * @brief   Adds a neighbor to the neighbor cache
  *
+ * @details If the cache is full the least recently used entry that is
+ *          neither a router, nor registered or tentative (6LoWPAN-ND), nor
+ *          unmanaged is evicted to make room. Entries marked for garbage
+ *          collection are evicted first, then stale and unreachable ones.
+ *
  * @param[in] iface         PID to the interface where the neighbor is.
  * @param[in] ipv6_addr     IPv6 address of the neighbor. Must not be NULL.
  * @param[in] l2_addr       Link layer address of the neighbor. NULL if unknown.
@@ -211,6 +237,31 @@ void gnrc_ipv6_nc_remove(kernel_pid_t iface, const ipv6_addr_t *ipv6_addr);
  */
 gnrc_ipv6_nc_t *gnrc_ipv6_nc_get(kernel_pid_t iface, const ipv6_addr_t *ipv6_addr);
 
+/**
+ * @brief   Searches for the neighbor cache entry used last for a link layer
+ *          address
+ *
+ * @param[in] iface         PID to the interface where the neighbor is.
+ * @param[in] l2_addr       A link layer address
+ * @param[in] l2_addr_len   Length of @p l2_addr
+ *
+ * @return  Of the entries on @p iface with @p l2_addr, the one used last.
+ * @return  NULL, if none is found or @p l2_addr_len is 0.
+ */
+gnrc_ipv6_nc_t *gnrc_ipv6_nc_get_by_l2_addr(kernel_pid_t iface, const uint8_t *l2_addr,
+                                            uint8_t l2_addr_len);
+
+/**
+ * @brief   Marks a neighbor cache entry as used
+ *
+ * When the neighbor cache is full, the entry used longest ago is replaced.
+ * gnrc_ipv6_nc_add() and gnrc_ipv6_nc_get() mark the entries they return
+ * already.
+ *
+ * @param[in] entry     A neighbor cache entry
+ */
+void gnrc_ipv6_nc_touch(gnrc_ipv6_nc_t *entry);
+
 /**
  * @brief   Gets next entry in neighbor cache after @p prev.
  *
@@ -25,6 +25,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "bitfield.h"
 #include "kernel_macros.h"
 #include "kernel_types.h"
 #include "mutex.h"
@@ -345,6 +346,25 @@ typedef struct {
     xtimer_t rtr_adv_timer; /**< Timer for periodic router advertisements */
     msg_t rtr_adv_msg;      /**< msg_t for gnrc_ipv6_netif_t::rtr_adv_timer */
 #endif
+    /**
+     * @brief   Source address candidates of the interface, i.e. its unicast
+     *          addresses.
+     */
+    BITFIELD(src_cand, GNRC_IPV6_NETIF_ADDR_NUMOF);
+
+    /**
+     * @brief   Candidates that win rules 2 and 3 of RFC 6724, section 5,
+     *          indexed by the scope of the destination.
+     */
+    BITFIELD(src_rank[16], GNRC_IPV6_NETIF_ADDR_NUMOF);
+
+    /**
+     * @brief   Bit n is set if gnrc_ipv6_netif_t::src_rank is up to date for
+     *          scope n.
+     */
+    uint16_t src_rank_valid;
+    int8_t src_last_cand;   /**< highest candidate index, -1 if there is none */
+    bool src_cand_valid;    /**< gnrc_ipv6_netif_t::src_cand is up to date */
 } gnrc_ipv6_netif_t;
 
 /**
@@ -451,6 +471,17 @@ void gnrc_ipv6_netif_remove_addr(kernel_pid_t pid, ipv6_addr_t *addr);
  */
 void gnrc_ipv6_netif_reset_addr(kernel_pid_t pid);
 
+/**
+ * @brief   Tells the interface that the lifetimes or flags of one of its
+ *          addresses were changed in place.
+ *
+ * @details Source address selection ranks the addresses of an interface only
+ *          once and keeps the ranking until its addresses change.
+ *
+ * @param[in] pid       The PID to the interface.
+ */
+void gnrc_ipv6_netif_addr_changed(kernel_pid_t pid);
+
 /**
  * @brief   Searches for an address on all interfaces.
  *
@@ -63,6 +63,28 @@ extern "C" {
  */
 #define GNRC_NETAPI_MSG_TYPE_ACK        (0x0205)
 
+#ifndef GNRC_NETAPI_BATCH_SIZE
+/**
+ * @brief   Number of messages gnrc_netapi_dispatch_batch() hands to
+ *          msg_send_batch() at once
+ *
+ * The messages are built on the stack of the caller.
+ */
+#define GNRC_NETAPI_BATCH_SIZE          (8U)
+#endif
+
+#ifndef GNRC_NETAPI_BATCH_WAIT
+/**
+ * @brief   Time in microseconds gnrc_netapi_dispatch_batch() waits at most
+ *          for room in the message queue of a subscriber
+ *
+ * A subscriber that is itself blocked in sending a message or waiting for
+ * a reply may wait for the calling thread, so packets for it are dropped
+ * right away. Only used with the `xtimer` module.
+ */
+#define GNRC_NETAPI_BATCH_WAIT          (10000U)
+#endif
+
 /**
  * @brief   Data structure to be send for setting (@ref GNRC_NETAPI_MSG_TYPE_SET)
  *          and getting (@ref GNRC_NETAPI_MSG_TYPE_GET) options
@@ -98,6 +120,29 @@ int gnrc_netapi_send(kernel_pid_t pid, gnrc_pktsnip_t *pkt);
 int gnrc_netapi_dispatch(gnrc_nettype_t type, uint32_t demux_ctx, uint16_t cmd,
                          gnrc_pktsnip_t *pkt);
 
+/**
+ * @brief   Sends @p cmd for each of @p num packets to all subscribers to
+ *          (@p type, @p demux_ctx).
+ *
+ * Works like gnrc_netapi_dispatch() for each packet in @p pkts, but every
+ * subscriber gets the messages for up to @ref GNRC_NETAPI_BATCH_SIZE packets
+ * with one call to msg_send_batch(), so it is woken at most once for them. The
+ * subscribers receive ordinary @p cmd messages, one per packet. If the
+ * message queue of a subscriber is full, the caller waits up to
+ * @ref GNRC_NETAPI_BATCH_WAIT for each further packet. Packets that still do
+ * not fit are released for the subscriber.
+ *
+ * @param[in] type      type of the targeted network module.
+ * @param[in] demux_ctx demultiplexing context for @p type.
+ * @param[in] cmd       command for all subscribers
+ * @param[in] pkts      packets to send, in order
+ * @param[in] num       number of packets in @p pkts
+ *
+ * @return Number of subscribers to (@p type, @p demux_ctx).
+ */
+int gnrc_netapi_dispatch_batch(gnrc_nettype_t type, uint32_t demux_ctx, uint16_t cmd,
+                               gnrc_pktsnip_t **pkts, unsigned num);
+
 /**
  * @brief   Sends a @ref GNRC_NETAPI_MSG_TYPE_SND command to all subscribers to
  *          (@p type, @p demux_ctx).
@@ -141,6 +186,25 @@ static inline int gnrc_netapi_dispatch_receive(gnrc_nettype_t type, uint32_t dem
     return gnrc_netapi_dispatch(type, demux_ctx, GNRC_NETAPI_MSG_TYPE_RCV, pkt);
 }
 
+/**
+ * @brief   Sends a @ref GNRC_NETAPI_MSG_TYPE_RCV command for each of @p num
+ *          packets to all subscribers to (@p type, @p demux_ctx).
+ *
+ * @see gnrc_netapi_dispatch_batch()
+ *
+ * @param[in] type      type of the targeted network module.
+ * @param[in] demux_ctx demultiplexing context for @p type.
+ * @param[in] pkts      packets holding the received data, in order
+ * @param[in] num       number of packets in @p pkts
+ *
+ * @return Number of subscribers to (@p type, @p demux_ctx).
+ */
+static inline int gnrc_netapi_dispatch_receive_batch(gnrc_nettype_t type, uint32_t demux_ctx,
+                                                     gnrc_pktsnip_t **pkts, unsigned num)
+{
+    return gnrc_netapi_dispatch_batch(type, demux_ctx, GNRC_NETAPI_MSG_TYPE_RCV, pkts, num);
+}
+
 /**
  * @brief   Shortcut function for sending @ref GNRC_NETAPI_MSG_TYPE_GET messages and
  *          parsing the returned @ref GNRC_NETAPI_MSG_TYPE_ACK message
@@ -38,6 +38,19 @@ extern "C" {
  */
 #define GNRC_NETREG_DEMUX_CTX_ALL   (0xffff0000)
 
+/**
+ * @def     GNRC_NETREG_BUCKETS
+ * @brief   Number of hash buckets per protocol type in the registry
+ *
+ * @details Entries are hashed by gnrc_netreg_entry_t::demux_ctx, so a lookup
+ *          only scans the entries that share a bucket. Raise this if many
+ *          contexts (e.g. UDP ports) are registered for one type. Must be a
+ *          power of two.
+ */
+#ifndef GNRC_NETREG_BUCKETS
+#define GNRC_NETREG_BUCKETS         (4)
+#endif
+
 /**
  * @brief   Entry to the @ref net_gnrc_netreg
  */
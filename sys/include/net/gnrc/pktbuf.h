@@ -38,6 +38,8 @@
 #include "cpu_conf.h"
 #include "net/gnrc/pkt.h"
 #include "net/gnrc/nettype.h"
+#include "net/ethernet.h"
+#include "net/ipv6.h"
 #include "utlist.h"
 
 #ifdef __cplusplus
@@ -58,6 +60,64 @@ extern "C" {
 #define GNRC_PKTBUF_SIZE    (6144)
 #endif  /* GNRC_PKTBUF_SIZE */
 
+/**
+ * @name    Size classes of the slab packet buffer (`gnrc_pktbuf_slab`)
+ *
+ * @details The slab implementation splits the packet buffer into fixed-size
+ *          pools: one for packet snip headers, one for small (header-sized)
+ *          chunks and one for MTU-sized payloads. Allocation and release are
+ *          O(1) and the buffer can not fragment, at the cost of internal
+ *          waste within each chunk. Requests larger than
+ *          @ref GNRC_PKTBUF_SLAB_LARGE_SIZE fail.
+ * @{
+ */
+#ifndef GNRC_PKTBUF_SLAB_SNIP_NUMOF
+#define GNRC_PKTBUF_SLAB_SNIP_NUMOF     (32)    /**< number of snip headers */
+#endif
+#ifndef GNRC_PKTBUF_SLAB_SMALL_SIZE
+#define GNRC_PKTBUF_SLAB_SMALL_SIZE     (64)    /**< size of a small chunk */
+#endif
+#ifndef GNRC_PKTBUF_SLAB_SMALL_NUMOF
+#define GNRC_PKTBUF_SLAB_SMALL_NUMOF    (24)    /**< number of small chunks */
+#endif
+/**
+ * @def     GNRC_PKTBUF_SLAB_LARGE_SIZE
+ * @brief   size of a large chunk
+ *
+ * @details Defaults to the largest frame of the link layers in the build:
+ *          a full Ethernet frame if an Ethernet device is used, the IPv6
+ *          minimum MTU otherwise.
+ */
+#ifndef GNRC_PKTBUF_SLAB_LARGE_SIZE
+#if defined(MODULE_NETDEV2_TAP) || defined(MODULE_ENCX24J600)
+#define GNRC_PKTBUF_SLAB_LARGE_SIZE     (ETHERNET_FRAME_LEN)
+#else
+#define GNRC_PKTBUF_SLAB_LARGE_SIZE     (IPV6_MIN_MTU)
+#endif
+#endif
+#ifndef GNRC_PKTBUF_SLAB_LARGE_NUMOF
+#define GNRC_PKTBUF_SLAB_LARGE_NUMOF    (4)     /**< number of large chunks */
+#endif
+/** @} */
+
+/**
+ * @def     GNRC_PKTBUF_EXT_NUMOF
+ * @brief   Maximum number of external buffers with a release callback that
+ *          can be in the packet buffer at the same time
+ *
+ * @see     gnrc_pktbuf_add_ext()
+ */
+#ifndef GNRC_PKTBUF_EXT_NUMOF
+#define GNRC_PKTBUF_EXT_NUMOF   (4)
+#endif
+
+/**
+ * @brief   Callback that hands an external buffer back to its owner
+ *
+ * @param[in] arg   The argument given to gnrc_pktbuf_add_ext().
+ */
+typedef void (*gnrc_pktbuf_release_cb_t)(void *arg);
+
 /**
  * @brief   Initializes packet buffer module.
  */
@@ -84,6 +144,40 @@ void gnrc_pktbuf_init(void);
 gnrc_pktsnip_t *gnrc_pktbuf_add(gnrc_pktsnip_t *next, void *data, size_t size,
                                 gnrc_nettype_t type);
 
+/**
+ * @brief   Adds a new gnrc_pktsnip_t to the packet buffer that refers to
+ *          externally owned data instead of a copy.
+ *
+ * @details Only the snip itself is allocated in the packet buffer. @p data
+ *          must stay valid and must not be modified until @p cb was called,
+ *          which happens when the snip is removed from the packet buffer.
+ *          Layers that need to write to the snip get a copy through
+ *          gnrc_pktbuf_start_write() as usual.
+ *
+ * @note    @p cb is called with the packet buffer locked and must not call
+ *          any packet buffer function.
+ *
+ * @warning gnrc_pktbuf_realloc_data() must not be used on the new snip.
+ *
+ * @param[in] next      Next gnrc_pktsnip_t in the packet. Leave NULL if you
+ *                      want to create a new packet.
+ * @param[in] data      External data of the new gnrc_pktsnip_t. May not be NULL.
+ * @param[in] size      Length of @p data. May not be 0.
+ * @param[in] type      Protocol type of the gnrc_pktsnip_t.
+ * @param[in] cb        Called once @p data is not referenced anymore. May be
+ *                      NULL.
+ * @param[in] arg       Argument for @p cb.
+ *
+ * @return  Pointer to the packet part that represents the new gnrc_pktsnip_t.
+ * @return  NULL, if no space is left in the packet buffer or if already
+ *          @ref GNRC_PKTBUF_EXT_NUMOF callbacks are pending. @p cb is not
+ *          called in that case.
+ * @return  NULL, if @p data == NULL or @p size == 0.
+ */
+gnrc_pktsnip_t *gnrc_pktbuf_add_ext(gnrc_pktsnip_t *next, void *data, size_t size,
+                                    gnrc_nettype_t type, gnrc_pktbuf_release_cb_t cb,
+                                    void *arg);
+
 /**
  * @brief   Marks the first @p size bytes in a received packet with a new
  *          packet snip that is appended to the packet.
@@ -145,6 +239,9 @@ void gnrc_pktbuf_hold(gnrc_pktsnip_t *pkt, unsigned int num);
  *
  * @pre All snips of @p pkt must be in the packet buffer.
  *
+ * @details The release callback of a snip created with
+ *          gnrc_pktbuf_add_ext() is called when it is removed.
+ *
  * @param[in] pkt   A packet.
  */
 void gnrc_pktbuf_release(gnrc_pktsnip_t *pkt);
@@ -204,7 +301,9 @@ static inline gnrc_pktsnip_t *gnrc_pktbuf_remove_snip(gnrc_pktsnip_t *pkt,
  *
  * @note    Only available with DEVELHELP defined.
  *
- * @details Statistics include maximum number of reserved bytes.
+ * @details Statistics include maximum number of reserved bytes. The slab
+ *          implementation prints the current usage and the high-water mark
+ *          of each size class instead.
  */
 void gnrc_pktbuf_stats(void);
 #endif
@@ -67,6 +67,9 @@ typedef struct {
     /**
      * @brief   Lifetime in minutes this context is valid.
      *
+     * @details Counted down once a minute by a timer. When it reaches 0,
+     *          the context is only used for decompression.
+     *
      * @see     <a href="http://tools.ietf.org/html/rfc6775#section-4.2">
      *              6LoWPAN Context Option
      *          </a>
@@ -77,6 +80,9 @@ typedef struct {
 /**
  * @brief   Gets a context matching the given IPv6 address best with its prefix.
  *
+ * The contexts are kept sorted by prefix length, so the first context whose
+ * prefix covers @p addr is returned.
+ *
  * @param[in] addr  An IPv6 address.
  *
  * @return  The context associated with the best prefix for @p addr.
@@ -113,17 +119,23 @@ gnrc_sixlowpan_ctx_t *gnrc_sixlowpan_ctx_update(uint8_t id, const ipv6_addr_t *p
                                                 uint8_t prefix_len, uint16_t ltime,
                                                 bool comp);
 
-#ifdef MODULE_GNRC_SIXLOWPAN_CTX
 /**
  * @brief   Removes context.
  *
  * @param[in] id    A context ID.
  */
-static inline void gnrc_sixlowpan_ctx_remove(uint8_t id)
-{
-    gnrc_sixlowpan_ctx_lookup_id(id)->prefix_len = 0;
-}
-#endif
+void gnrc_sixlowpan_ctx_remove(uint8_t id);
+
+/**
+ * @brief   Gets the generation of the context buffer.
+ *
+ * The generation changes whenever a context is updated, removed or stops
+ * being usable for compression, so users can tell whether results they
+ * derived from the contexts are still valid.
+ *
+ * @return  The current generation.
+ */
+uint16_t gnrc_sixlowpan_ctx_generation(void);
 
 #ifdef TEST_SUITES
 /**
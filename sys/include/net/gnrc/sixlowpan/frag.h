@@ -28,16 +28,83 @@
 
 #include "byteorder.h"
 #include "kernel_types.h"
+#include "msg.h"
 #include "net/gnrc/pkt.h"
 #include "net/sixlowpan.h"
+#include "xtimer.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief   Message type for garbage collection of the reassembly buffer
+ */
+#define GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF (0x0225)
+
+/**
+ * @brief   Message type to send the next fragment of a datagram
+ */
+#define GNRC_SIXLOWPAN_MSG_FRAG_SND     (0x0226)
+
+#ifndef GNRC_SIXLOWPAN_FRAG_MSG_SIZE
+/**
+ * @brief   Number of datagrams that can be fragmented at the same time
+ *
+ * @details Further datagrams are fragmented in one go, as if they were sent
+ *          with a full message queue.
+ */
+#define GNRC_SIXLOWPAN_FRAG_MSG_SIZE    (2U)
+#endif
+
+#ifndef GNRC_SIXLOWPAN_FRAG_GAP
+/**
+ * @brief   Time in microseconds between two fragments of a datagram
+ *
+ * @details With 0 the next fragment is sent as soon as the messages that
+ *          arrived at the 6LoWPAN thread in the meantime were handled.
+ */
+#define GNRC_SIXLOWPAN_FRAG_GAP         (0U)
+#endif
+
+/**
+ * @brief   A datagram that is being fragmented
+ */
+typedef struct {
+    gnrc_pktsnip_t *pkt;        /**< the datagram, NULL if entry is unused */
+    size_t datagram_size;       /**< length of just the IPv6 packet */
+    uint32_t due;               /**< xtimer_now() when the next fragment is due */
+    xtimer_t timer;             /**< timer for @ref GNRC_SIXLOWPAN_FRAG_GAP */
+    msg_t msg;                  /**< @ref GNRC_SIXLOWPAN_MSG_FRAG_SND for this
+                                 *   datagram */
+    uint16_t offset;            /**< number of bytes of the 6LoWPAN payload
+                                 *   sent so far */
+    uint16_t tag;               /**< tag of the datagram */
+    kernel_pid_t pid;           /**< interface to send the datagram over */
+} gnrc_sixlowpan_frag_msg_t;
+
+/**
+ * @brief   Counters of the fragmentation sender
+ */
+typedef struct {
+    uint32_t datagrams;         /**< datagrams sent fragmented */
+    uint32_t fragments;         /**< fragments handed to the interfaces */
+    uint32_t sync;              /**< datagrams fragmented in one go, since
+                                 *   @ref GNRC_SIXLOWPAN_FRAG_MSG_SIZE
+                                 *   datagrams were already in flight */
+    uint16_t in_flight;         /**< datagrams in flight */
+    uint16_t in_flight_max;     /**< maximum of
+                                 *   gnrc_sixlowpan_frag_stats_t::in_flight */
+} gnrc_sixlowpan_frag_stats_t;
+
 /**
  * @brief   Sends a packet fragmented.
  *
+ * @details The first fragment is sent right away. Every following fragment is
+ *          sent on its own @ref GNRC_SIXLOWPAN_MSG_FRAG_SND, so the calling
+ *          thread can handle other packets in between. Must be called by the
+ *          thread that handles @ref GNRC_SIXLOWPAN_MSG_FRAG_SND.
+ *
  * @param[in] pid           The interface to send the packet over.
  * @param[in] pkt           The packet to send.
  * @param[in] datagram_size The length of just the IPv6 packet. It is the value
@@ -47,6 +114,23 @@ extern "C" {
 void gnrc_sixlowpan_frag_send(kernel_pid_t pid, gnrc_pktsnip_t *pkt,
                               size_t datagram_size);
 
+/**
+ * @brief   Sends the next fragment of a datagram.
+ *
+ * @details Called on @ref GNRC_SIXLOWPAN_MSG_FRAG_SND with its
+ *          msg_t::content::ptr.
+ *
+ * @param[in] frag  The datagram that is being fragmented.
+ */
+void gnrc_sixlowpan_frag_send_next(gnrc_sixlowpan_frag_msg_t *frag);
+
+/**
+ * @brief   Returns the counters of the fragmentation sender
+ *
+ * @return  The counters since startup.
+ */
+const gnrc_sixlowpan_frag_stats_t *gnrc_sixlowpan_frag_stats(void);
+
 /**
  * @brief   Handles a packet containing a fragment header.
  *
@@ -54,6 +138,25 @@ void gnrc_sixlowpan_frag_send(kernel_pid_t pid, gnrc_pktsnip_t *pkt,
  */
 void gnrc_sixlowpan_frag_handle_pkt(gnrc_pktsnip_t *pkt);
 
+/**
+ * @brief   Gets a tag for a new datagram.
+ *
+ * @details Datagrams forwarded as fragments need a tag of this node, so they
+ *          share the tag space of gnrc_sixlowpan_frag_send().
+ *
+ * @return  A tag that was not used for a datagram recently.
+ */
+uint16_t gnrc_sixlowpan_frag_next_tag(void);
+
+/**
+ * @brief   Garbage collect reassembly buffer.
+ *
+ * @details Removes datagrams whose last fragment arrived more than
+ *          RBUF_TIMEOUT seconds ago. Must be called by the thread that
+ *          handles the fragments on @ref GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF.
+ */
+void gnrc_sixlowpan_frag_gc_rbuf(void);
+
 #ifdef __cplusplus
 }
 #endif
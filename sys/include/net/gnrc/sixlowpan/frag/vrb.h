@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_sixlowpan_frag_vrb   Virtual reassembly buffer
+ * @ingroup     net_gnrc_sixlowpan_frag
+ * @brief       Forwarding of 6LoWPAN fragments without reassembly
+ *
+ * A 6LoWPAN router normally reassembles a fragmented datagram, hands it to
+ * IPv6 for forwarding and fragments it again for the next hop. With this
+ * module a router decides on the next hop as soon as the first fragment
+ * arrives: the IPv6 header is decompressed from it, the hop limit is
+ * decremented and the header is compressed again for the next link. The
+ * (link-layer source, datagram size, tag) of the datagram is mapped to the
+ * next hop and a new tag in the virtual reassembly buffer, so all subsequent
+ * fragments are forwarded right away with only their tag rewritten.
+ *
+ * A datagram is still reassembled if
+ * - it is addressed to this node, or to a multicast or link-local address,
+ * - the incoming interface is not a router interface,
+ * - the first fragment is not IPHC compressed,
+ * - the next hop is not on a 6LoWPAN interface or can not be resolved,
+ * - a subsequent fragment arrived before the first one, or
+ * - the recompressed first fragment does not fit into a frame.
+ *
+ * @see <a href="https://tools.ietf.org/html/draft-ietf-lwig-6lowpan-virtual-reassembly-00">
+ *          draft-ietf-lwig-6lowpan-virtual-reassembly-00
+ *      </a>
+ * @{
+ *
+ * @file
+ * @brief   Virtual reassembly buffer definitions
+ */
+#ifndef GNRC_SIXLOWPAN_FRAG_VRB_H_
+#define GNRC_SIXLOWPAN_FRAG_VRB_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "kernel_types.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/pkt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef GNRC_SIXLOWPAN_FRAG_VRB_SIZE
+/**
+ * @brief   Number of datagrams that can be forwarded at the same time
+ */
+#define GNRC_SIXLOWPAN_FRAG_VRB_SIZE        (16U)
+#endif
+
+#ifndef GNRC_SIXLOWPAN_FRAG_VRB_TIMEOUT
+/**
+ * @brief   Time in microseconds after the last fragment of a datagram after
+ *          which its entry is freed
+ */
+#define GNRC_SIXLOWPAN_FRAG_VRB_TIMEOUT     (3U * 1000000U)
+#endif
+
+/**
+ * @brief   Maximum length of a link-layer address in the virtual reassembly
+ *          buffer
+ */
+#define GNRC_SIXLOWPAN_FRAG_VRB_L2ADDR_MAX  (8U)
+
+/**
+ * @brief   An entry in the virtual reassembly buffer
+ */
+typedef struct {
+    uint8_t src[GNRC_SIXLOWPAN_FRAG_VRB_L2ADDR_MAX];     /**< link-layer source */
+    uint8_t out_dst[GNRC_SIXLOWPAN_FRAG_VRB_L2ADDR_MAX]; /**< link-layer address of
+                                                          *   the next hop */
+    uint32_t arrival;           /**< xtimer_now() of the last fragment */
+    kernel_pid_t out_iface;     /**< interface to the next hop,
+                                 *   KERNEL_PID_UNDEF if entry is unused */
+    uint16_t datagram_size;     /**< size of the uncompressed datagram */
+    uint16_t tag;               /**< tag of the incoming datagram */
+    uint16_t out_tag;           /**< tag of the outgoing datagram */
+    uint16_t forwarded;         /**< number of bytes of the uncompressed
+                                 *   datagram forwarded so far */
+    uint8_t src_len;            /**< length of gnrc_sixlowpan_frag_vrb_t::src */
+    uint8_t out_dst_len;        /**< length of gnrc_sixlowpan_frag_vrb_t::out_dst */
+} gnrc_sixlowpan_frag_vrb_t;
+
+/**
+ * @brief   Adds an entry to the virtual reassembly buffer
+ *
+ * @param[in] src           Link-layer source of the datagram
+ * @param[in] src_len       Length of @p src
+ * @param[in] datagram_size Size of the uncompressed datagram
+ * @param[in] tag           Tag of the datagram
+ * @param[in] out_iface     Interface to the next hop
+ * @param[in] out_dst       Link-layer address of the next hop
+ * @param[in] out_dst_len   Length of @p out_dst
+ *
+ * @return  The new entry, with a fresh gnrc_sixlowpan_frag_vrb_t::out_tag.
+ * @return  NULL, if the buffer is full or an address is too long.
+ */
+gnrc_sixlowpan_frag_vrb_t *gnrc_sixlowpan_frag_vrb_add(const uint8_t *src, size_t src_len,
+                                                       uint16_t datagram_size, uint16_t tag,
+                                                       kernel_pid_t out_iface,
+                                                       const uint8_t *out_dst,
+                                                       size_t out_dst_len);
+
+/**
+ * @brief   Gets the entry of a datagram
+ *
+ * @param[in] src           Link-layer source of the datagram
+ * @param[in] src_len       Length of @p src
+ * @param[in] datagram_size Size of the uncompressed datagram
+ * @param[in] tag           Tag of the datagram
+ *
+ * @return  The entry of the datagram, if it has not timed out.
+ * @return  NULL, otherwise.
+ */
+gnrc_sixlowpan_frag_vrb_t *gnrc_sixlowpan_frag_vrb_get(const uint8_t *src, size_t src_len,
+                                                       uint16_t datagram_size, uint16_t tag);
+
+/**
+ * @brief   Removes an entry from the virtual reassembly buffer
+ *
+ * @param[in] entry     An entry of the virtual reassembly buffer
+ */
+static inline void gnrc_sixlowpan_frag_vrb_rm(gnrc_sixlowpan_frag_vrb_t *entry)
+{
+    entry->out_iface = KERNEL_PID_UNDEF;
+}
+
+/**
+ * @brief   Forwards a received fragment if possible
+ *
+ * @param[in] pkt       A received fragment with the fragment header in
+ *                      gnrc_pktsnip_t::data and the interface header in
+ *                      gnrc_pktsnip_t::next.
+ * @param[in] frag_size Size of the fragment's payload.
+ * @param[in] offset    Offset of the fragment in the uncompressed datagram.
+ *
+ * @return  true, if the fragment was forwarded. @p pkt is not released.
+ * @return  false, if the fragment has to be reassembled.
+ */
+bool gnrc_sixlowpan_frag_vrb_forward(gnrc_pktsnip_t *pkt, size_t frag_size,
+                                     uint16_t offset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNRC_SIXLOWPAN_FRAG_VRB_H_ */
+/** @} */
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_sixlowpan_ghc  Generic header compression (6LoWPAN-GHC)
+ * @ingroup     net_gnrc_sixlowpan
+ * @brief       Compression of ICMPv6 messages with 6LoWPAN-GHC
+ *
+ * RPL and neighbor discovery messages are mostly made of addresses and
+ * padding IPHC does not touch. 6LoWPAN-GHC compresses them with
+ * backreferences into a dictionary made of the source and destination address
+ * of the IPv6 header and a short static string.
+ *
+ * @ref net_gnrc_sixlowpan_iphc uses GHC for an ICMPv6 message when
+ *  - the packet is not fragmented,
+ *  - the compressed message is shorter than the original, and
+ *  - the receiver indicated that it understands GHC with the 6LoWPAN
+ *    capability indication option (6CIO), which is sent along with router and
+ *    neighbor solicitations and router advertisements. Receivers of multicast
+ *    can not indicate that, so GHC is used for multicast only if
+ *    gnrc_sixlowpan_netif_t::ghc_mcast is set for the interface.
+ *
+ * @see <a href="https://tools.ietf.org/html/rfc7400">RFC 7400</a>
+ * @{
+ *
+ * @file
+ * @brief   6LoWPAN-GHC definitions
+ */
+#ifndef GNRC_SIXLOWPAN_GHC_H_
+#define GNRC_SIXLOWPAN_GHC_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "net/gnrc/netif/hdr.h"
+#include "net/ipv6/hdr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef GNRC_SIXLOWPAN_GHC_MAX_LEN
+/**
+ * @brief   Maximum length of an ICMPv6 message that is compressed with GHC.
+ *
+ * The message is decompressed in one go, so this also is the space a receiver
+ * reserves behind the IPv6 header for a message compressed with GHC.
+ */
+#define GNRC_SIXLOWPAN_GHC_MAX_LEN  (256U)
+#endif
+
+#ifndef GNRC_SIXLOWPAN_GHC_MCAST
+/**
+ * @brief   Default for gnrc_sixlowpan_netif_t::ghc_mcast.
+ *
+ * Only set to 1 when all nodes on the link understand GHC.
+ */
+#define GNRC_SIXLOWPAN_GHC_MCAST    (0)
+#endif
+
+/**
+ * @brief   Length of the dictionary GHC prefixes a message with
+ */
+#define GNRC_SIXLOWPAN_GHC_DICT_LEN (2 * sizeof(ipv6_addr_t) + 16U)
+
+/**
+ * @brief   Compresses an ICMPv6 message.
+ *
+ * @param[out] out      Buffer for the compressed message.
+ * @param[in] out_size  Size of @p out.
+ * @param[in] ipv6_hdr  The IPv6 header of the message.
+ * @param[in] data      The ICMPv6 message.
+ * @param[in] len       Length of @p data.
+ *
+ * @return  length of the compressed message in @p out, on success.
+ * @return  0, if it does not fit into @p out.
+ */
+size_t gnrc_sixlowpan_ghc_compress(uint8_t *out, size_t out_size, const ipv6_hdr_t *ipv6_hdr,
+                                   const uint8_t *data, size_t len);
+
+/**
+ * @brief   Decompresses an ICMPv6 message.
+ *
+ * @param[out] out      Buffer for the ICMPv6 message.
+ * @param[in] out_size  Size of @p out.
+ * @param[in] ipv6_hdr  The (already decompressed) IPv6 header of the message.
+ * @param[in] in        The compressed message, without the GHC dispatch.
+ * @param[in] in_len    Length of @p in.
+ *
+ * @return  length of the ICMPv6 message in @p out, on success.
+ * @return  0, if @p in is malformed or the message does not fit into @p out.
+ */
+size_t gnrc_sixlowpan_ghc_decompress(uint8_t *out, size_t out_size, const ipv6_hdr_t *ipv6_hdr,
+                                     const uint8_t *in, size_t in_len);
+
+/**
+ * @brief   Checks if the receiver of a packet understands GHC.
+ *
+ * @param[in] netif_hdr The netif header of the packet.
+ * @param[in] ipv6_hdr  The IPv6 header of the packet.
+ *
+ * @return  true, if the packet may be compressed with GHC.
+ * @return  false, if not.
+ */
+bool gnrc_sixlowpan_ghc_supported(const gnrc_netif_hdr_t *netif_hdr,
+                                  const ipv6_hdr_t *ipv6_hdr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNRC_SIXLOWPAN_GHC_H_ */
+/** @} */
@@ -10,6 +10,21 @@
  * @defgroup    net_gnrc_sixlowpan_iphc   IPv6 header compression (IPHC)
  * @ingroup     net_gnrc_sixlowpan
  * @brief       IPv6 header compression for 6LoWPAN.
+ *
+ * With the `gnrc_sixlowpan_iphc_nhc` module, UDP headers are compressed, too
+ * (next header compression, see
+ * <a href="https://tools.ietf.org/html/rfc6282#section-4.3.3">
+ *     RFC 6282, section 4.3.3
+ * </a>). Ports are compressed as far as possible, the checksum is always
+ * carried inline.
+ *
+ * Sending the same kind of packet over and over again yields the same
+ * compressed headers each time. The encoder keeps them as a template for the
+ * last @ref GNRC_SIXLOWPAN_IPHC_FLOWS flows, so a packet of a known flow
+ * needs neither a context lookup nor the IID of the interface.
+ *
+ * With the `gnrc_sixlowpan_ghc` module, ICMPv6 messages are compressed with
+ * @ref net_gnrc_sixlowpan_ghc where the receiver supports it.
  * @{
  *
  * @file
@@ -23,36 +38,78 @@
 #include <stdbool.h>
 
 #include "net/gnrc/pkt.h"
+#include "net/ipv6/hdr.h"
 #include "net/sixlowpan.h"
+#include "net/udp.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#ifndef GNRC_SIXLOWPAN_IPHC_FLOWS
+/**
+ * @brief   Number of flows the encoder keeps compression templates for.
+ *
+ * A flow is identified by its IPv6 header (except the payload length), UDP ports
+ * (if compressed) and link-layer addresses. Must be a power of 2, 0 disables
+ * the templates.
+ */
+#define GNRC_SIXLOWPAN_IPHC_FLOWS           (4U)
+#endif
+
+#ifndef GNRC_SIXLOWPAN_IPHC_FLOW_LIFETIME
+/**
+ * @brief   Time in microseconds a compression template is used for
+ *
+ * Templates are dropped right away when a context changes, this only limits
+ * for how long a change of the interface identifier goes unnoticed.
+ */
+#define GNRC_SIXLOWPAN_IPHC_FLOW_LIFETIME   (1U * 1000000U)
+#endif
+
+#if defined(MODULE_GNRC_SIXLOWPAN_IPHC_NHC) || defined(DOXYGEN)
+/**
+ * @brief   Maximum length of the headers gnrc_sixlowpan_iphc_decode() writes
+ *          to its IPv6 header snip.
+ */
+#define GNRC_SIXLOWPAN_IPHC_HDR_MAX         (sizeof(ipv6_hdr_t) + sizeof(udp_hdr_t))
+#else
+#define GNRC_SIXLOWPAN_IPHC_HDR_MAX         (sizeof(ipv6_hdr_t))
+#endif
+
 /**
  * @brief   Decompresses a received 6LoWPAN IPHC frame.
  *
  * @pre (ipv6 != NULL) && (ipv6->size >= sizeof(gnrc_ipv6_hdr_t))
  *
  * @param[out] ipv6         A pre-allocated IPv6 header. Will not be inserted into
- *                          @p pkt
+ *                          @p pkt. A compressed next header is written behind
+ *                          the IPv6 header, so it needs to be
+ *                          @ref GNRC_SIXLOWPAN_IPHC_HDR_MAX bytes long for that.
+ *                          An ICMPv6 message compressed with
+ *                          @ref net_gnrc_sixlowpan_ghc is decompressed there,
+ *                          too; @p ipv6 is grown for it.
  * @param[in,out] pkt       A received 6LoWPAN IPHC frame. IPHC dispatch will not
  *                          be marked.
  * @param[in] datagram_size Size of the full uncompressed IPv6 datagram. May be 0, if @p pkt
  *                          contains the full (unfragmented) IPv6 datagram.
  * @param[in] offset        Offset of the IPHC dispatch in 6LoWPaN frame.
+ * @param[out] nh_len       Length of the decompressed next header behind the
+ *                          IPv6 header in @p ipv6, 0 if there is none.
  *
  * @return  length of the HC dispatches + inline values on success.
  * @return  0 on error.
  */
 size_t gnrc_sixlowpan_iphc_decode(gnrc_pktsnip_t *ipv6, gnrc_pktsnip_t *pkt, size_t datagram_size,
-                                  size_t offset);
+                                  size_t offset, size_t *nh_len);
 
 /**
  * @brief   Compresses a 6LoWPAN for IPHC.
  *
  * @param[in,out] pkt   A 6LoWPAN frame with an uncompressed IPv6 header to
  *                      send. Will be translated to an 6LoWPAN IPHC frame.
+ *                      A UDP header is only compressed if it is in a snip
+ *                      of its own.
  *
  * @return  true, on success
  * @return  false, on error.
@@ -220,6 +220,33 @@ uint8_t gnrc_sixlowpan_nd_opt_ar_handle(kernel_pid_t iface, ipv6_hdr_t *ipv6,
  */
 bool gnrc_sixlowpan_nd_opt_6ctx_handle(uint8_t icmpv6_type, sixlowpan_nd_opt_6ctx_t *ctx_opt);
 
+#if defined(MODULE_GNRC_SIXLOWPAN_GHC) || defined(DOXYGEN)
+/**
+ * @brief   Builds the 6LoWPAN capability indication option, indicating that
+ *          this node understands 6LoWPAN-GHC.
+ *
+ * @param[in] next          More options in the packet. NULL, if there are none.
+ *
+ * @return  The pkt snip list of options, on success
+ * @return  NULL, if packet buffer is full
+ */
+gnrc_pktsnip_t *gnrc_sixlowpan_nd_opt_6cio_build(gnrc_pktsnip_t *next);
+
+/**
+ * @brief   Handles 6LoWPAN capability indication option.
+ *
+ * Marks the neighbor cache entry of the sender as capable of 6LoWPAN-GHC or
+ * not. Options that are too short are ignored.
+ *
+ * @param[in] iface         The interface the 6CIO was received on.
+ * @param[in] src           The source address of the message that contained
+ *                          the option.
+ * @param[in] cio_opt       The 6LoWPAN capability indication option.
+ */
+void gnrc_sixlowpan_nd_opt_6cio_handle(kernel_pid_t iface, const ipv6_addr_t *src,
+                                       const sixlowpan_nd_opt_6cio_t *cio_opt);
+#endif
+
 /**
  * @brief   Handles registration calls after node-wakeup.
  *
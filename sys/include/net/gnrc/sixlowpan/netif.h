@@ -37,6 +37,9 @@ typedef struct {
 #ifdef MODULE_GNRC_SIXLOWPAN_IPHC
     bool iphc_enabled;      /**< enable or disable IPHC */
 #endif
+#ifdef MODULE_GNRC_SIXLOWPAN_GHC
+    bool ghc_mcast;         /**< compress multicast ICMPv6 with 6LoWPAN-GHC */
+#endif
 } gnrc_sixlowpan_netif_t;
 
 /**
@@ -28,7 +28,7 @@
 
 #include "net/gnrc.h"
 #include "periph/uart.h"
-#include "ringbuffer.h"
+#include "tsrb.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,10 +38,10 @@ extern "C" {
  * @brief   UART buffer size used for TX and RX buffers
  *
  * Reduce this value if your expected traffic does not include full IPv6 MTU
- * sized packets
+ * sized packets. Must be a power of two.
  */
 #ifndef GNRC_SLIP_BUFSIZE
-#define GNRC_SLIP_BUFSIZE       (1500U)
+#define GNRC_SLIP_BUFSIZE       (2048U)
 #endif
 
 /**
@@ -49,8 +49,7 @@ extern "C" {
  */
 typedef struct {
     uart_t uart;                    /**< the UART interface */
-    ringbuffer_t in_buf;            /**< RX buffer */
-    ringbuffer_t out_buf;           /**< TX buffer */
+    tsrb_t in_buf;                  /**< RX buffer */
     char rx_mem[GNRC_SLIP_BUFSIZE]; /**< memory used by RX buffer */
     uint32_t in_bytes;              /**< the number of bytes received of a
                                      *   currently incoming packet */
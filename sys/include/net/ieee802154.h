@@ -23,6 +23,7 @@
 
 #include <stdlib.h>
 
+#include "byteorder.h"
 #include "net/eui64.h"
 
 #ifdef __cplusplus
@@ -62,6 +63,71 @@ extern "C" {
 #define IEEE802154_FCF_SRC_ADDR_LONG        (0xc0)
 /** @} */
 
+/**
+ * @brief   Initializes an IEEE 802.15.4 MAC frame header in @p buf.
+ *
+ * Both addresses are expected in network byte order and written to the header
+ * in little-endian order, as the standard requires.
+ * The destination PAN ID is only written with a destination address, the
+ * source PAN ID only with a source address and without
+ * @ref IEEE802154_FCF_PAN_COMP in @p flags.
+ *
+ * @param[out] buf      Buffer for the header. Must be at least
+ *                      @ref IEEE802154_MAX_HDR_LEN bytes long.
+ * @param[in] src       Source address. May be NULL if @p src_len is 0.
+ * @param[in] src_len   Length of @p src. Must be 0, 2, or 8.
+ * @param[in] dst       Destination address. May be NULL if @p dst_len is 0.
+ * @param[in] dst_len   Length of @p dst. Must be 0, 2, or 8.
+ * @param[in] pan       PAN ID.
+ * @param[in] flags     Flags for the first byte of the frame control field,
+ *                      i.e. the frame type and any of
+ *                      @ref IEEE802154_FCF_ACK_REQ and
+ *                      @ref IEEE802154_FCF_PAN_COMP.
+ * @param[in] seq       Sequence number of the frame.
+ *
+ * @return  Length of the header on success.
+ * @return  0, if @p src_len or @p dst_len was of illegal length.
+ */
+size_t ieee802154_set_frame_hdr(uint8_t *buf, const uint8_t *src, size_t src_len,
+                                const uint8_t *dst, size_t dst_len,
+                                le_uint16_t pan, uint8_t flags, uint8_t seq);
+
+/**
+ * @brief   Gets the length of an IEEE 802.15.4 MAC frame header.
+ *
+ * @param[in] mhr   MAC header, at least its frame control field.
+ *
+ * @return  Length of the header on success.
+ * @return  0, if the frame control field is invalid.
+ */
+size_t ieee802154_get_frame_hdr_len(const uint8_t *mhr);
+
+/**
+ * @brief   Gets the source address of an IEEE 802.15.4 MAC frame header.
+ *
+ * @param[in] mhr   MAC header. Must be as long as
+ *                  ieee802154_get_frame_hdr_len() returns for it.
+ * @param[out] src  The source address in network byte order. Must be at
+ *                  least 8 bytes long.
+ *
+ * @return  Length of the source address. 0 if it has none.
+ * @return  -EINVAL, if the frame control field is invalid.
+ */
+int ieee802154_get_src(const uint8_t *mhr, uint8_t *src);
+
+/**
+ * @brief   Gets the destination address of an IEEE 802.15.4 MAC frame header.
+ *
+ * @param[in] mhr   MAC header. Must be as long as
+ *                  ieee802154_get_frame_hdr_len() returns for it.
+ * @param[out] dst  The destination address in network byte order. Must be at
+ *                  least 8 bytes long.
+ *
+ * @return  Length of the destination address. 0 if it has none.
+ * @return  -EINVAL, if the frame control field is invalid.
+ */
+int ieee802154_get_dst(const uint8_t *mhr, uint8_t *dst);
+
 /**
  * @brief   Generates an IPv6 interface identifier from an IEEE 802.15.4 address.
  *
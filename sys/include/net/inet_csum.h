@@ -21,11 +21,36 @@
 #define INET_CSUM_H_
 
 #include <inttypes.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief   Calculates the unnormalized Internet Checksum of @p buf, where the
+ *          buffer provides a slice of the full checksum domain, calculated in
+ *          order.
+ *
+ * @see <a href="https://tools.ietf.org/html/rfc1071">
+ *          RFC 1071
+ *      </a>
+ *
+ * @details The Internet Checksum is not normalized (i. e. its 1's complement
+ *          was not taken of the result) to use it for further calculation.
+ *          Use this function to checksum data that is scattered over several
+ *          buffers of possibly odd length.
+ *
+ * @param[in] sum       An initial value for the checksum.
+ * @param[in] buf       A buffer.
+ * @param[in] len       Length of @p buf in byte.
+ * @param[in] accum_len Accumulated length of checksummed data before @p buf.
+ *
+ * @return  The unnormalized Internet Checksum of @p buf.
+ */
+uint16_t inet_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len,
+                         size_t accum_len);
+
 /**
  * @brief   Calculates the unnormalized Internet Checksum of @p buf.
  *
@@ -42,7 +67,60 @@ extern "C" {
  *
  * @return  The unnormalized Internet Checksum of @p buf.
  */
-uint16_t inet_csum(uint16_t sum, const uint8_t *buf, uint16_t len);
+static inline uint16_t inet_csum(uint16_t sum, const uint8_t *buf, uint16_t len)
+{
+    return inet_csum_slice(sum, buf, len, 0);
+}
+
+/**
+ * @brief   Updates a checksum after some of the data it covers was rewritten
+ *
+ * @see <a href="https://tools.ietf.org/html/rfc1624">
+ *          RFC 1624
+ *      </a>
+ *
+ * @details Use this after changing e.g. an address of a header covered by a
+ *          checksum instead of calculating the checksum over the whole
+ *          packet again. Unlike inet_csum() this works on the normalized
+ *          checksum, i. e. the value as found in the header.
+ *
+ * @param[in] csum      The normalized checksum before the change.
+ * @param[in] old_data  The data before the change.
+ * @param[in] new_data  The data after the change.
+ * @param[in] len       Length of @p old_data and @p new_data in byte. Must
+ *                      be even and the data must start at an even offset
+ *                      into the checksummed data.
+ *
+ * @return  The normalized checksum after the change.
+ */
+uint16_t inet_csum_update(uint16_t csum, const uint8_t *old_data,
+                          const uint8_t *new_data, uint16_t len);
+
+/**
+ * @brief   Updates a checksum after a 16-bit word of the data it covers
+ *          changed
+ *
+ * @see inet_csum_update()
+ *
+ * @param[in] csum      The normalized checksum before the change.
+ * @param[in] old_word  The word before the change, in host byte order.
+ * @param[in] new_word  The word after the change, in host byte order.
+ *
+ * @return  The normalized checksum after the change.
+ */
+static inline uint16_t inet_csum_update16(uint16_t csum, uint16_t old_word,
+                                          uint16_t new_word)
+{
+    /* RFC 1624, eqn. 3: HC' = ~(~HC + ~m + m') */
+    uint32_t sum = (uint16_t)~csum;
+
+    sum += (uint16_t)~old_word;
+    sum += new_word;
+    sum = (sum & 0xffff) + (sum >> 16);
+    sum = (sum & 0xffff) + (sum >> 16);
+
+    return ~sum;
+}
 
 #ifdef __cplusplus
 }
@@ -182,6 +182,14 @@ typedef enum {
      */
     NETOPT_CHANNEL_PAGE,
 
+    /**
+     * @brief   get the receive counters of a gnrc_netdev2 adapter as
+     *          gnrc_netdev2_stats_t
+     *
+     * @note Setting this option will always return -ENOTSUP.
+     */
+    NETOPT_RX_BATCH_STATS,
+
     /* add more options if needed */
 
     /**
@@ -245,6 +245,19 @@ static inline bool sixlowpan_iphc_is(uint8_t *data)
 }
 /** @} */
 
+/**
+ * @name    6LoWPAN-GHC definitions
+ * @{
+ */
+/**
+ * @brief   NHC dispatch for an ICMPv6 message compressed with 6LoWPAN-GHC.
+ * @see <a href="https://tools.ietf.org/html/rfc7400#section-3.2">
+ *          RFC 7400, section 3.2
+ *      </a>
+ */
+#define SIXLOWPAN_NHC_GHC_ICMPV6    (0xdf)
+/** @} */
+
 /**
  * @brief   Prints 6LoWPAN dispatch to stdout.
  *
@@ -41,6 +41,7 @@ extern "C" {
  */
 #define SIXLOWPAN_ND_OPT_AR_LEN                 (2U)
 #define SIXLOWPAN_ND_OPT_ABR_LEN                (3U)
+#define SIXLOWPAN_ND_OPT_6CIO_LEN               (1U)
 /**
  * @}
  */
@@ -71,6 +72,15 @@ extern "C" {
  * @}
  */
 
+/**
+ * @{
+ * @name    Flags for 6LoWPAN capability indication option
+ */
+#define SIXLOWPAN_ND_OPT_6CIO_FLAGS_G           (0x0001)    /**< 6LoWPAN-GHC capable */
+/**
+ * @}
+ */
+
 /**
  * @brief   Duplicate address request and confirmation message format.
  * @extends icmpv6_hdr_t
@@ -142,6 +152,21 @@ typedef struct __attribute__((packed)) {
     ipv6_addr_t braddr;     /**< 6LoWPAN border router address */
 } sixlowpan_nd_opt_abr_t;
 
+/**
+ * @brief   6LoWPAN capability indication option format
+ * @extends ndp_opt_t
+ *
+ * @see <a href="https://tools.ietf.org/html/rfc7400#section-3.3">
+ *          RFC 7400, section 3.3
+ *      </a>
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t type;           /**< option type */
+    uint8_t len;            /**< length in units of 8 octets */
+    network_uint16_t flags; /**< 15-bit reserved, 1-bit G flag */
+    uint8_t resv[4];        /**< reserved field */
+} sixlowpan_nd_opt_6cio_t;
+
 /**
  * @brief   Checks if a 6LoWPAN context in an 6LoWPAN context option is
  *          valid for compression.
@@ -21,7 +21,7 @@
  * @ingroup     sys
  *
  * @brief       Generic pipe implementation.
- * @details     This pipe implementation is a tight wrapper around a ringbuffer.
+ * @details     This pipe implementation is a tight wrapper around a @ref sys_tsrb.
  *              It sends the calling thread to sleep if the ringbuffer is full
  *              or empty, respectively. It can be used in ISRs, too.
  *
@@ -38,7 +38,7 @@
 #include <sys/types.h>
 
 #include "mutex.h"
-#include "ringbuffer.h"
+#include "tsrb.h"
 #include "thread.h"
 
 #ifdef __cplusplus
@@ -54,7 +54,7 @@ extern "C" {
  */
 typedef struct riot_pipe
 {
-    ringbuffer_t *rb;     /**< Wrapped ringbuffer. */
+    tsrb_t *rb;           /**< Wrapped ringbuffer. */
     tcb_t *read_blocked;  /**< A thread that wants to write to this full pipe. */
     tcb_t *write_blocked; /**< A thread that wants to read from this empty pipe. */
     void (*free)(void *); /**< Function to call by pipe_free(). Used like `pipe->free(pipe)`. */
@@ -64,10 +64,11 @@ typedef struct riot_pipe
  * @brief        Initialize a pipe.
  * @param[out]   pipe   Datum to initialize.
  * @param        rb     Ringbuffer to use. Needs to be initialized!
+ *                      Its size must be a power of two.
  * @param        free   Function to call by pipe_free(). Used like `pipe->free(pipe)`.
  *                      Should be `NULL` for statically allocated pipes.
  */
-void pipe_init(pipe_t *pipe, ringbuffer_t *rb, void (*free)(void *));
+void pipe_init(pipe_t *pipe, tsrb_t *rb, void (*free)(void *));
 
 /**
  * @brief        Read from a pipe.
@@ -101,7 +102,8 @@ ssize_t pipe_write(pipe_t *pipe, const void *buf, size_t n);
  * @brief      Dynamically allocate a pipe with room for `size` bytes.
  * @details    This function uses `malloc()` and may break real-time behaviors.
  *             Try not to use this function.
- * @param      size   Size of the underlying ringbuffer to allocate.
+ * @param      size   Size of the underlying ringbuffer to allocate, must be
+ *                    a power of two.
  * @returns    Newly allocated pipe. NULL if the memory is exhausted.
  */
 pipe_t *pipe_malloc(unsigned size);
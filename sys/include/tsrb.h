@@ -17,7 +17,9 @@
  * @brief       Thread-safe ringbuffer implementation
  *
  * This ringbuffer implementation can be used without locking if
- * there's only one producer and one consumer.
+ * there's only one producer and one consumer, e.g. an ISR filling it and a
+ * thread draining it. Bulk operations copy contiguous regions with
+ * `memcpy()`.
  *
  * @note Buffer size must be a power of two!
  *
@@ -128,6 +130,23 @@ int tsrb_get_one(tsrb_t *rb);
  */
 int tsrb_get(tsrb_t *rb, char *dst, size_t n);
 
+/**
+ * @brief       Get bytes from ringbuffer, without removing them
+ * @param[in]   rb  Ringbuffer to operate on
+ * @param[out]  dst buffer to write to
+ * @param[in]   n   max number of bytes to write to @p dst
+ * @return      nr of bytes written to @p dst
+ */
+int tsrb_peek(const tsrb_t *rb, char *dst, size_t n);
+
+/**
+ * @brief       Drop bytes from ringbuffer
+ * @param[in]   rb  Ringbuffer to operate on
+ * @param[in]   n   max number of bytes to drop
+ * @return      nr of bytes dropped
+ */
+int tsrb_drop(tsrb_t *rb, size_t n);
+
 /**
  * @brief       Add a byte to ringbuffer
  * @param[in]   rb  Ringbuffer to operate on
@@ -20,6 +20,11 @@
  * number of active timers.  The reason for this is that multiplexing is
  * realized by next-first singly linked lists.
  *
+ * With the `xtimer_heap` module, timers expiring within the current and the
+ * next low-level timer period are kept in pairing heaps instead. Insertion
+ * then is O(1), removal and expiry are O(log n) amortized. Timers with equal
+ * targets may fire in any order in this mode.
+ *
  * @{
  * @file
  * @brief   xtimer interface definitions
@@ -57,6 +62,11 @@ typedef void (*timer_callback_t)(void*);
  */
 typedef struct xtimer {
     struct xtimer *next;        /**< reference to next timer in timer lists */
+#if defined(MODULE_XTIMER_HEAP) || defined(DOXYGEN)
+    struct xtimer *prev;        /**< parent or previous sibling in timer heap */
+    struct xtimer *child;       /**< first child in timer heap */
+    uint8_t in_heap;            /**< 1 while the timer is in a timer heap */
+#endif
     uint32_t target;            /**< lower 32bit absolute target time */
     uint32_t long_target;       /**< upper 32bit absolute target time */
     timer_callback_t callback;  /**< callback function to call when timer
@@ -203,6 +213,21 @@ void xtimer_set_msg(xtimer_t *timer, uint32_t offset, msg_t *msg, kernel_pid_t t
  */
 void xtimer_set_msg64(xtimer_t *timer, uint64_t offset, msg_t *msg, kernel_pid_t target_pid);
 
+/**
+ * @brief Set a timer that sends a message, with a tolerance window
+ *
+ * Like xtimer_set_msg(), but the message may be sent up to @p slack
+ * microseconds late. See xtimer_set_slack().
+ *
+ * @param[in] timer         timer struct to work with
+ * @param[in] offset        microseconds from now
+ * @param[in] slack         maximum delay in microseconds after @p offset
+ * @param[in] msg           ptr to msg that will be sent
+ * @param[in] target_pid    pid the message will be sent to
+ */
+void xtimer_set_msg_slack(xtimer_t *timer, uint32_t offset, uint32_t slack,
+                          msg_t *msg, kernel_pid_t target_pid);
+
 /**
  * @brief Set a timer that wakes up a thread
  *
@@ -245,6 +270,22 @@ void xtimer_set_wakeup64(xtimer_t *timer, uint64_t offset, kernel_pid_t pid);
  */
 void xtimer_set(xtimer_t *timer, uint32_t offset);
 
+/**
+ * @brief Set a timer to execute a callback within a tolerance window
+ *
+ * Like xtimer_set(), but the callback may be executed anywhere between
+ * @p offset and @p offset + @p slack microseconds from now.
+ *
+ * The target time is rounded to the coarsest time grid that still lies within
+ * the window, so timers with overlapping windows tend to share the same
+ * target and expire within a single low-level timer interrupt.
+ *
+ * @param[in] timer     the timer structure to use
+ * @param[in] offset    earliest expiry, in microseconds from now
+ * @param[in] slack     maximum delay in microseconds after @p offset
+ */
+void xtimer_set_slack(xtimer_t *timer, uint32_t offset, uint32_t slack);
+
 /**
  * @brief remove a timer
  *
@@ -279,6 +320,15 @@ int xtimer_msg_receive_timeout(msg_t *msg, uint32_t us);
  */
 int xtimer_msg_receive_timeout64(msg_t *msg, uint64_t us);
 
+#if defined(MODULE_XTIMER_STATS) || defined(DOXYGEN)
+/**
+ * @brief Number of low-level timer interrupts handled by xtimer
+ *
+ * Only available with the `xtimer_stats` module.
+ */
+extern volatile uint32_t xtimer_isr_count;
+#endif
+
 /**
  * @brief xtimer backoff value
  *
@@ -14,13 +14,86 @@
 
 #include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "byteorder.h"
 #include "od.h"
 #include "net/inet_csum.h"
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
-uint16_t inet_csum(uint16_t sum, const uint8_t *buf, uint16_t len)
+static inline uint32_t _fold(uint64_t csum)
+{
+    while (csum >> 16) {
+        csum = (csum & 0xffff) + (csum >> 16);
+    }
+
+    return (uint32_t)csum;
+}
+
+/*
+ * The one's complement sum is independent of byte order (RFC 1071, 2.(B)),
+ * so the buffer is summed in host order a word at a time and the folded
+ * result is swapped to network order once. `buf` must be 16-bit aligned.
+ */
+static uint16_t _sum_aligned(const uint8_t *buf, uint16_t len)
+{
+    uint64_t acc = 0;
+
+    if ((len >= 2) && ((uintptr_t)buf & 2)) {
+        acc += *((const uint16_t *)(uintptr_t)buf);
+        buf += 2;
+        len -= 2;
+    }
+
+#ifdef __SSE2__
+    if (len >= 16) {
+        /* sums of 16-bit words in 32-bit lanes, cannot overflow for
+         * len < 2^16 */
+        __m128i lo = _mm_setzero_si128();
+        __m128i hi = _mm_setzero_si128();
+        const __m128i zero = _mm_setzero_si128();
+        uint32_t lanes[4];
+
+        for (; len >= 16; buf += 16, len -= 16) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(uintptr_t)buf);
+
+            lo = _mm_add_epi32(lo, _mm_unpacklo_epi16(v, zero));
+            hi = _mm_add_epi32(hi, _mm_unpackhi_epi16(v, zero));
+        }
+        _mm_storeu_si128((__m128i *)lanes, _mm_add_epi32(lo, hi));
+        acc += (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+#endif
+
+    for (; len >= 16; buf += 16, len -= 16) {
+        const uint32_t *w = (const uint32_t *)(uintptr_t)buf;
+
+        acc += (uint64_t)w[0] + w[1] + w[2] + w[3];
+    }
+
+    for (; len >= 2; buf += 2, len -= 2) {
+        acc += *((const uint16_t *)(uintptr_t)buf);
+    }
+
+    if (len) {
+        /* last byte is the top half of a 16-bit word in network order */
+        uint16_t last = 0;
+
+        memcpy(&last, buf, 1);
+        acc += last;
+    }
+
+    return NTOHS(_fold(acc));
+}
+
+uint16_t inet_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len,
+                         size_t accum_len)
 {
     uint32_t csum = sum;
 
@@ -34,23 +107,40 @@ uint16_t inet_csum(uint16_t sum, const uint8_t *buf, uint16_t len)
 #endif
 #endif
 
-    for (int i = 0; i < (len >> 1); buf += 2, i++) {
-        csum += (*buf << 8) + *(buf + 1);   /* group bytes by 16-byte words
-                                             * and add them*/
+    if ((accum_len & 1) && (len > 0)) {
+        /* last slice ended on an odd byte: complete its 16-bit word */
+        csum += *buf;
+        buf++;
+        len--;
     }
 
-    if (len & 1) {                      /* if len is odd */
-        csum += (*buf << 8);            /* add last byte as top half of 16-byte word */
+    if (((uintptr_t)buf & 1) && (len > 0)) {
+        /* the words of the rest straddle 16-bit boundaries: sum them one
+         * byte further on and swap, the first byte is a top half */
+        csum += (*buf << 8);
+        csum += byteorder_swaps(_sum_aligned(buf + 1, len - 1));
     }
-
-    while (csum >> 16) {
-        uint16_t carry = csum >> 16;
-        csum = (csum & 0xffff) + carry;
+    else {
+        csum += _sum_aligned(buf, len);
     }
 
+    csum = _fold(csum);
+
     DEBUG("inet_sum: new sum = 0x%04" PRIx32 "\n", csum);
 
     return csum;
 }
 
+uint16_t inet_csum_update(uint16_t csum, const uint8_t *old_data,
+                          const uint8_t *new_data, uint16_t len)
+{
+    /* RFC 1624, eqn. 3: HC' = ~(~HC + ~m + m') */
+    uint32_t sum = (uint16_t)~csum;
+
+    sum += (uint16_t)~inet_csum(0, old_data, len);
+    sum = inet_csum(_fold(sum), new_data, len);
+
+    return ~sum;
+}
+
 /** @} */
@@ -51,6 +51,7 @@ static const char *_netopt_strmap[] = {
     [NETOPT_IS_WIRED]        = "NETOPT_IS_WIRED",
     [NETOPT_DEVICE_TYPE]     = "NETOPT_DEVICE_TYPE",
     [NETOPT_CHANNEL_PAGE]    = "NETOPT_CHANNEL_PAGE",
+    [NETOPT_RX_BATCH_STATS]  = "NETOPT_RX_BATCH_STATS",
     [NETOPT_NUMOF]           = "NETOPT_NUMOF",
 };
 
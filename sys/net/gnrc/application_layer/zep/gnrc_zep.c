@@ -81,11 +81,10 @@ static size_t _zep_hdr_fill(gnrc_zep_t *dev, gnrc_zep_hdr_t *hdr,
 /* Event handlers for ISR events */
 static void _rx_started_event(gnrc_zep_t *dev);
 
-/* IEEE 802.15.4 helper functions: TODO: generalize add to (gnrc_)ieee802154 */
+/* IEEE 802.15.4 helper functions */
 static size_t _make_data_frame_hdr(gnrc_zep_t *dev, uint8_t *buf,
                                    gnrc_netif_hdr_t *hdr);
-static size_t _get_frame_hdr_len(uint8_t *mhr);
-gnrc_pktsnip_t *_make_netif_hdr(uint8_t *mhr);
+static gnrc_pktsnip_t *_make_netif_hdr(uint8_t *mhr);
 static uint16_t _calc_fcs(uint16_t fcs, const uint8_t *frame, uint8_t frame_len);
 
 kernel_pid_t gnrc_zep_init(gnrc_zep_t *dev, uint16_t src_port, ipv6_addr_t *dst,
@@ -731,7 +730,7 @@ static gnrc_pktsnip_t *_create_received(gnrc_zep_t *dev, gnrc_pktsnip_t *pkt,
 
     pkt = gnrc_pktbuf_remove_snip(pkt, pkt);    /* remove FCS */
 
-    mhr_len = _get_frame_hdr_len(pkt->data);
+    mhr_len = ieee802154_get_frame_hdr_len(pkt->data);
 
     if (mhr_len == 0) {
         return NULL;
@@ -871,191 +870,54 @@ static void _rx_started_event(gnrc_zep_t *dev)
     }
 }
 
-/* TODO: Generalize and move all below to ieee802154 */
 static size_t _make_data_frame_hdr(gnrc_zep_t *dev, uint8_t *buf,
                                    gnrc_netif_hdr_t *hdr)
 {
-    int pos = 0;
-
-    /* we are building a data frame here */
-    buf[0] = IEEE802154_FCF_TYPE_DATA;
-    buf[1] = 0x88;      /* use short src and dst addresses as starting point */
-
-    /* if AUTOACK is enabled, then we also expect ACKs for this packet */
-    if (dev->flags & GNRC_ZEP_FLAGS_AUTOACK) {
-        buf[0] |= IEEE802154_FCF_ACK_REQ;
-    }
-
-    /* fill in destination PAN ID */
-    pos = 3;
-    buf[pos++] = dev->pan.u8[0];
-    buf[pos++] = dev->pan.u8[1];
-
-    /* fill in destination address */
-    if (hdr->flags &
-        (GNRC_NETIF_HDR_FLAGS_BROADCAST | GNRC_NETIF_HDR_FLAGS_MULTICAST)) {
-        buf[pos++] = 0xff;
-        buf[pos++] = 0xff;
-    }
-    else if (hdr->dst_l2addr_len == 2) {
-        uint8_t *dst_addr = gnrc_netif_hdr_get_dst_addr(hdr);
-        buf[pos++] = dst_addr[1];
-        buf[pos++] = dst_addr[0];
-    }
-    else if (hdr->dst_l2addr_len == 8) {
-        buf[1] |= 0x04;
-        uint8_t *dst_addr = gnrc_netif_hdr_get_dst_addr(hdr);
-
-        for (int i = 7;  i >= 0; i--) {
-            buf[pos++] = dst_addr[i];
+    static const uint8_t bcast[] = { 0xff, 0xff };
+    const uint8_t *dst = bcast;
+    size_t dst_len = sizeof(bcast);
+    be_uint16_t addr;
+    be_uint64_t eui64;
+    uint8_t flags = IEEE802154_FCF_TYPE_DATA;
+
+    if (!(hdr->flags &
+          (GNRC_NETIF_HDR_FLAGS_BROADCAST | GNRC_NETIF_HDR_FLAGS_MULTICAST))) {
+        dst = gnrc_netif_hdr_get_dst_addr(hdr);
+        dst_len = hdr->dst_l2addr_len;
+        if ((dst_len != 2) && (dst_len != 8)) {
+            /* unsupported address length */
+            return 0;
         }
     }
-    else {
-        /* unsupported address length */
-        return 0;
-    }
 
-    /* fill in source PAN ID (if applicable) */
-    if (dev->flags & GNRC_ZEP_FLAGS_USE_SRC_PAN) {
-        buf[pos++] = dev->pan.u8[0];
-        buf[pos++] = dev->pan.u8[1];
+    /* if AUTOACK is enabled, then we also expect ACKs for this packet */
+    if (dev->flags & GNRC_ZEP_FLAGS_AUTOACK) {
+        flags |= IEEE802154_FCF_ACK_REQ;
     }
-    else {
-        buf[0] |= IEEE802154_FCF_PAN_COMP;
+    if (!(dev->flags & GNRC_ZEP_FLAGS_USE_SRC_PAN)) {
+        flags |= IEEE802154_FCF_PAN_COMP;
     }
 
-    /* fill in source address */
     if (dev->flags & GNRC_ZEP_FLAGS_SRC_ADDR_LONG) {
-        buf[1] |= 0x40;
-        memcpy(&(buf[pos]), &dev->eui64, 8);
-        pos += 8;
-    }
-    else {
-        memcpy(&(buf[pos]), &dev->addr, 2);
-        pos += 2;
+        eui64 = byteorder_ltobll(dev->eui64);
+        return ieee802154_set_frame_hdr(buf, eui64.u8, sizeof(eui64), dst, dst_len,
+                                        dev->pan, flags, dev->seq++);
     }
-
-    /* set sequence number */
-    buf[2] = dev->seq++;
-    /* return actual header length */
-    return pos;
+    addr = byteorder_ltobs(dev->addr);
+    return ieee802154_set_frame_hdr(buf, addr.u8, sizeof(addr), dst, dst_len,
+                                    dev->pan, flags, dev->seq++);
 }
 
-static size_t _get_frame_hdr_len(uint8_t *mhr)
+static gnrc_pktsnip_t *_make_netif_hdr(uint8_t *mhr)
 {
-    uint8_t tmp;
-    size_t len = 3;
-
-    /* figure out address sizes */
-    tmp = (mhr[1] & IEEE802154_FCF_DST_ADDR_MASK);
+    uint8_t src[8], dst[8];
+    int src_len = ieee802154_get_src(mhr, src);
+    int dst_len = ieee802154_get_dst(mhr, dst);
 
-    if (tmp == IEEE802154_FCF_DST_ADDR_SHORT) {
-        len += 4;
-    }
-    else if (tmp == IEEE802154_FCF_DST_ADDR_LONG) {
-        len += 10;
-    }
-    else if (tmp != IEEE802154_FCF_DST_ADDR_VOID) {
-        return 0;
-    }
-
-    tmp = (mhr[1] & IEEE802154_FCF_SRC_ADDR_MASK);
-
-    if (tmp == IEEE802154_FCF_SRC_ADDR_VOID) {
-        return len;
-    }
-    else {
-        if (!(mhr[0] & IEEE802154_FCF_PAN_COMP)) {
-            len += 2;
-        }
-
-        if (tmp == IEEE802154_FCF_SRC_ADDR_SHORT) {
-            return (len + 2);
-        }
-        else if (tmp == IEEE802154_FCF_SRC_ADDR_LONG) {
-            return (len + 8);
-        }
-    }
-
-    return 0;
-}
-
-gnrc_pktsnip_t *_make_netif_hdr(uint8_t *mhr)
-{
-    uint8_t tmp;
-    uint8_t *addr;
-    uint8_t src_len, dst_len;
-    gnrc_pktsnip_t *snip;
-    gnrc_netif_hdr_t *hdr;
-
-    /* figure out address sizes */
-    tmp = mhr[1] & IEEE802154_FCF_SRC_ADDR_MASK;
-
-    if (tmp == IEEE802154_FCF_SRC_ADDR_SHORT) {
-        src_len = 2;
-    }
-    else if (tmp == IEEE802154_FCF_SRC_ADDR_LONG) {
-        src_len = 8;
-    }
-    else if (tmp == 0) {
-        src_len = 0;
-    }
-    else {
-        return NULL;
-    }
-
-    tmp = mhr[1] & IEEE802154_FCF_DST_ADDR_MASK;
-
-    if (tmp == IEEE802154_FCF_DST_ADDR_SHORT) {
-        dst_len = 2;
-    }
-    else if (tmp == IEEE802154_FCF_DST_ADDR_LONG) {
-        dst_len = 8;
-    }
-    else if (tmp == 0) {
-        dst_len = 0;
-    }
-    else {
-        return NULL;
-    }
-
-    /* allocate space for header */
-    snip = gnrc_pktbuf_add(NULL, NULL, sizeof(gnrc_netif_hdr_t) + src_len + dst_len,
-                           GNRC_NETTYPE_NETIF);
-
-    if (snip == NULL) {
+    if ((src_len < 0) || (dst_len < 0)) {
         return NULL;
     }
-
-    /* fill header */
-    hdr = (gnrc_netif_hdr_t *)snip->data;
-    gnrc_netif_hdr_init(hdr, src_len, dst_len);
-
-    if (dst_len > 0) {
-        tmp = 5 + dst_len;
-        addr = gnrc_netif_hdr_get_dst_addr(hdr);
-
-        for (int i = 0; i < dst_len; i++) {
-            addr[i] = mhr[5 + (dst_len - i) - 1];
-        }
-    }
-    else {
-        tmp = 3;
-    }
-
-    if (!(mhr[0] & IEEE802154_FCF_PAN_COMP)) {
-        tmp += 2;
-    }
-
-    if (src_len > 0) {
-        addr = gnrc_netif_hdr_get_src_addr(hdr);
-
-        for (int i = 0; i < src_len; i++) {
-            addr[i] = mhr[tmp + (src_len - i) - 1];
-        }
-    }
-
-    return snip;
+    return gnrc_netif_hdr_build(src, (uint8_t)src_len, dst, (uint8_t)dst_len);
 }
 
 static uint16_t _calc_fcs(uint16_t fcs, const uint8_t *frame, uint8_t frame_len)
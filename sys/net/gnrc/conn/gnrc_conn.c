@@ -13,6 +13,8 @@
  * @author  Martine Lenders <mlenders@inf.fu-berlin.de>
  */
 
+#include <errno.h>
+
 #include "net/conn.h"
 #include "net/ipv6/hdr.h"
 #include "net/gnrc/conn.h"
@@ -20,6 +22,9 @@
 #include "net/gnrc/ipv6/netif.h"
 #include "net/udp.h"
 
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
 static inline size_t _srcaddr(void *addr, gnrc_pktsnip_t *hdr)
 {
     switch (hdr->type) {
@@ -49,11 +54,236 @@ static inline void _srcport(uint16_t *port, gnrc_pktsnip_t *hdr)
     }
 }
 
+#ifdef MODULE_GNRC_CONN_ASYNC
+static inline gnrc_nettype_t _reg_type(conn_t *conn)
+{
+    /* like conn_udp_create() and conn_ip_create() */
+    return (conn->l4_type != GNRC_NETTYPE_UNDEF) ? conn->l4_type : conn->l3_type;
+}
+
+/* checks if the registry meant pkt for conn: the layer that dispatched pkt
+ * left its header right behind the payload */
+static bool _match(conn_t *conn, gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *hdr = pkt->next;
+    uint32_t demux_ctx = conn->netreg_entry.demux_ctx;
+
+    if ((hdr == NULL) || (hdr->type != _reg_type(conn))) {
+        return false;
+    }
+    if (demux_ctx == GNRC_NETREG_DEMUX_CTX_ALL) {
+        return true;
+    }
+    switch (hdr->type) {
+#ifdef MODULE_GNRC_IPV6
+        case GNRC_NETTYPE_IPV6:
+            return ((ipv6_hdr_t *)hdr->data)->nh == demux_ctx;
+#endif
+#ifdef MODULE_GNRC_UDP
+        case GNRC_NETTYPE_UDP:
+            return byteorder_ntohs(((udp_hdr_t *)hdr->data)->dst_port) == demux_ctx;
+#endif
+        default:
+            return true;
+    }
+}
+
+/* finds another connection of mux with the same demux context as conn */
+static conn_t *_sibling(gnrc_conn_mux_t *mux, conn_t *conn)
+{
+    for (conn_t *c = mux->conns; c != NULL; c = c->async.next) {
+        if ((c != conn) && (_reg_type(c) == _reg_type(conn)) &&
+            (c->netreg_entry.demux_ctx == conn->netreg_entry.demux_ctx)) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
+static int _recvfrom_async(conn_t *conn, void *data, size_t max_len, void *addr,
+                           size_t *addr_len, uint16_t *port)
+{
+    gnrc_conn_async_t *async = &conn->async;
+    gnrc_pktsnip_t *pkt, *hdr;
+    size_t size;
+
+    if (async->len == 0) {
+        return -EAGAIN;
+    }
+    pkt = async->queue[async->head];
+    if (pkt->size > max_len) {
+        return -ENOMEM;
+    }
+    /* the headers were checked by _match() */
+    LL_SEARCH_SCALAR(pkt, hdr, type, conn->l3_type);
+    if (addr != NULL) {
+        *addr_len = _srcaddr(addr, hdr);
+    }
+#if defined(MODULE_CONN_UDP) || defined(MODULE_CONN_TCP)
+    if ((conn->l4_type != GNRC_NETTYPE_UNDEF) && (port != NULL)) {
+        LL_SEARCH_SCALAR(pkt, hdr, type, conn->l4_type);
+        _srcport(port, hdr);
+    }
+#else
+    (void)port;
+#endif
+    memcpy(data, pkt->data, pkt->size);
+    size = pkt->size;
+    async->head = (async->head + 1) % GNRC_CONN_QUEUE_SIZE;
+    async->len--;
+    gnrc_pktbuf_release(pkt);
+    return (int)size;
+}
+
+void gnrc_conn_async_close(conn_t *conn)
+{
+    gnrc_conn_async_t *async = &conn->async;
+    gnrc_conn_mux_t *mux = async->mux;
+    conn_t **ptr;
+
+    if (mux == NULL) {
+        return;
+    }
+    ptr = &mux->conns;
+    while ((*ptr != NULL) && (*ptr != conn)) {
+        ptr = &(*ptr)->async.next;
+    }
+    if (*ptr != NULL) {
+        *ptr = async->next;
+    }
+    while (async->len > 0) {
+        gnrc_pktbuf_release(async->queue[async->head]);
+        async->head = (async->head + 1) % GNRC_CONN_QUEUE_SIZE;
+        async->len--;
+    }
+    /* conn_udp_close() and conn_ip_close() unregistered the entry of the
+     * demux context already, so hand it on to the next connection */
+    if (conn->netreg_entry.pid == mux->pid) {
+        conn_t *sibling = _sibling(mux, conn);
+
+        if (sibling != NULL) {
+            sibling->netreg_entry.pid = mux->pid;
+            gnrc_netreg_register(_reg_type(sibling), &sibling->netreg_entry);
+        }
+    }
+    async->mux = NULL;
+    async->next = NULL;
+}
+
+void gnrc_conn_mux_init(gnrc_conn_mux_t *mux)
+{
+    mux->conns = NULL;
+    mux->pid = sched_active_pid;
+}
+
+int gnrc_conn_async(void *conn, gnrc_conn_mux_t *mux, gnrc_conn_cb_t cb, void *arg)
+{
+    conn_t *c = conn;
+    gnrc_nettype_t type = _reg_type(c);
+
+    if ((c->async.mux == NULL) && (c->netreg_entry.pid == KERNEL_PID_UNDEF)) {
+        return -EBADF;
+    }
+    if ((c->async.mux != NULL) && (c->async.mux != mux)) {
+        return -EBUSY;
+    }
+    c->async.cb = cb;
+    c->async.arg = arg;
+    if (c->async.mux == NULL) {
+        bool shared = (_sibling(mux, c) != NULL);
+
+        c->async.head = 0;
+        c->async.len = 0;
+        c->async.mux = mux;
+        c->async.next = mux->conns;
+        mux->conns = c;
+        /* packets already sent to the creating thread stay there */
+        gnrc_netreg_unregister(type, &c->netreg_entry);
+        /* one entry per demux context, gnrc_conn_mux_handle() hands its
+         * packets to all connections of the context */
+        if (shared) {
+            c->netreg_entry.pid = KERNEL_PID_UNDEF;
+        }
+        else {
+            c->netreg_entry.pid = mux->pid;
+            gnrc_netreg_register(type, &c->netreg_entry);
+        }
+    }
+    return 0;
+}
+
+int gnrc_conn_mux_handle(gnrc_conn_mux_t *mux, msg_t *msg)
+{
+    gnrc_pktsnip_t *pkt = (gnrc_pktsnip_t *)msg->content.ptr;
+    conn_t *next;
+    unsigned num = 0;
+
+    if (msg->type != GNRC_NETAPI_MSG_TYPE_RCV) {
+        return 0;
+    }
+    for (conn_t *conn = mux->conns; conn != NULL; conn = conn->async.next) {
+        if (_match(conn, pkt) && (conn->async.len < GNRC_CONN_QUEUE_SIZE)) {
+            num++;
+        }
+    }
+    if (num == 0) {
+        /* the connection was closed meanwhile or its queue is full */
+        DEBUG("gnrc_conn: no connection takes the packet, dropping it\n");
+        gnrc_pktbuf_release(pkt);
+        return 1;
+    }
+    gnrc_pktbuf_hold(pkt, num - 1);
+    for (conn_t *conn = mux->conns; (conn != NULL) && (num > 0); conn = next) {
+        gnrc_conn_async_t *async = &conn->async;
+
+        /* the callback may close conn */
+        next = async->next;
+        if (!_match(conn, pkt) || (async->len >= GNRC_CONN_QUEUE_SIZE)) {
+            continue;
+        }
+        async->queue[(async->head + async->len) % GNRC_CONN_QUEUE_SIZE] = pkt;
+        async->len++;
+        num--;
+        if (async->cb != NULL) {
+            async->cb(conn, async->arg);
+        }
+    }
+    return 1;
+}
+
+int gnrc_conn_mux_poll(gnrc_conn_mux_t *mux, void **ready, unsigned max, msg_t *msg)
+{
+    assert(mux->pid == sched_active_pid);
+    while (1) {
+        unsigned num = 0;
+
+        for (conn_t *conn = mux->conns; (conn != NULL) && (num < max);
+             conn = conn->async.next) {
+            if (conn->async.len > 0) {
+                ready[num++] = conn;
+            }
+        }
+        if (num > 0) {
+            return (int)num;
+        }
+        msg_receive(msg);
+        if (!gnrc_conn_mux_handle(mux, msg)) {
+            return 0;
+        }
+    }
+}
+#endif /* MODULE_GNRC_CONN_ASYNC */
+
 int gnrc_conn_recvfrom(conn_t *conn, void *data, size_t max_len, void *addr, size_t *addr_len,
                        uint16_t *port)
 {
     msg_t msg;
     int timeout = 3;
+#ifdef MODULE_GNRC_CONN_ASYNC
+    if (conn->async.mux != NULL) {
+        return _recvfrom_async(conn, data, max_len, addr, addr_len, port);
+    }
+#endif
     while ((timeout--) > 0) {
         gnrc_pktsnip_t *pkt, *l3hdr;
         size_t size = 0;
@@ -14,6 +14,7 @@
  */
 
 #include <errno.h>
+#include <string.h>
 #include "net/af.h"
 #include "net/gnrc/conn.h"
 #include "net/gnrc/ipv6.h"
@@ -31,6 +32,10 @@ int conn_ip_create(conn_ip_t *conn, const void *addr, size_t addr_len, int famil
             if (gnrc_conn6_set_local_addr(conn->local_addr, addr)) {
                 conn->l3_type = GNRC_NETTYPE_IPV6;
                 conn->local_addr_len = addr_len;
+#ifdef MODULE_GNRC_CONN_ASYNC
+                /* a new connection is in no multiplexer */
+                memset(&conn->async, 0, sizeof(conn->async));
+#endif
                 conn_ip_close(conn);       /* unregister possibly registered netreg entry */
                 gnrc_conn_reg(&conn->netreg_entry, conn->l3_type, (uint32_t)proto);
             }
@@ -55,6 +60,9 @@ void conn_ip_close(conn_ip_t *conn)
     if (conn->netreg_entry.pid != KERNEL_PID_UNDEF) {
         gnrc_netreg_unregister(conn->l3_type, &conn->netreg_entry);
     }
+#ifdef MODULE_GNRC_CONN_ASYNC
+    gnrc_conn_async_close((conn_t *)conn);
+#endif
 }
 
 int conn_ip_getlocaladdr(conn_ip_t *conn, void *addr)
@@ -14,6 +14,7 @@
  */
 
 #include <errno.h>
+#include <string.h>
 #include "net/af.h"
 #include "net/gnrc/conn.h"
 #include "net/gnrc/ipv6.h"
@@ -34,6 +35,10 @@ int conn_udp_create(conn_udp_t *conn, const void *addr, size_t addr_len,
             if (gnrc_conn6_set_local_addr(conn->local_addr, addr)) {
                 conn->l3_type = GNRC_NETTYPE_IPV6;
                 conn->local_addr_len = addr_len;
+#ifdef MODULE_GNRC_CONN_ASYNC
+                /* a new connection is in no multiplexer */
+                memset(&conn->async, 0, sizeof(conn->async));
+#endif
                 conn_udp_close(conn);       /* unregister possibly registered netreg entry */
                 gnrc_conn_reg(&conn->netreg_entry, conn->l4_type, (uint32_t)port);
             }
@@ -57,6 +62,9 @@ void conn_udp_close(conn_udp_t *conn)
     if (conn->netreg_entry.pid != KERNEL_PID_UNDEF) {
         gnrc_netreg_unregister(GNRC_NETTYPE_UDP, &conn->netreg_entry);
     }
+#ifdef MODULE_GNRC_CONN_ASYNC
+    gnrc_conn_async_close((conn_t *)conn);
+#endif
 }
 
 int conn_udp_getlocaladdr(conn_udp_t *conn, void *addr, uint16_t *port)
@@ -86,17 +94,16 @@ int conn_udp_recvfrom(conn_udp_t *conn, void *data, size_t max_len, void *addr,
     }
 }
 
-int conn_udp_sendto(const void *data, size_t len, const void *src, size_t src_len,
-                    const void *dst, size_t dst_len, int family, uint16_t sport,
-                    uint16_t dport)
+static int _sendto(gnrc_pktsnip_t *payload, const void *src, size_t src_len,
+                   const void *dst, size_t dst_len, int family, uint16_t sport,
+                   uint16_t dport)
 {
     gnrc_pktsnip_t *pkt, *hdr = NULL;
 
-    pkt = gnrc_pktbuf_add(NULL, (void *)data, len, GNRC_NETTYPE_UNDEF); /* data will only be copied */
-    hdr = gnrc_udp_hdr_build(pkt, (uint8_t *)&sport, sizeof(uint16_t), (uint8_t *)&dport,
+    hdr = gnrc_udp_hdr_build(payload, (uint8_t *)&sport, sizeof(uint16_t), (uint8_t *)&dport,
                              sizeof(uint16_t));
     if (hdr == NULL) {
-        gnrc_pktbuf_release(pkt);
+        gnrc_pktbuf_release(payload);
         return -ENOMEM;
     }
     pkt = hdr;
@@ -129,7 +136,58 @@ int conn_udp_sendto(const void *data, size_t len, const void *src, size_t src_le
 
     gnrc_netapi_dispatch_send(GNRC_NETTYPE_UDP, GNRC_NETREG_DEMUX_CTX_ALL, pkt);
 
-    return len;
+    return 0;
+}
+
+int conn_udp_sendto(const void *data, size_t len, const void *src, size_t src_len,
+                    const void *dst, size_t dst_len, int family, uint16_t sport,
+                    uint16_t dport)
+{
+    gnrc_pktsnip_t *pkt;
+    int res;
+
+    pkt = gnrc_pktbuf_add(NULL, (void *)data, len, GNRC_NETTYPE_UNDEF); /* data will only be copied */
+    res = _sendto(pkt, src, src_len, dst, dst_len, family, sport, dport);
+    return (res < 0) ? res : (int)len;
+}
+
+int gnrc_conn_udp_sendto_iov(const struct iovec *vector, unsigned count,
+                             const void *src, size_t src_len,
+                             const void *dst, size_t dst_len, int family,
+                             uint16_t sport, uint16_t dport,
+                             gnrc_pktbuf_release_cb_t cb, void *arg)
+{
+    gnrc_pktsnip_t *payload = NULL;
+    size_t len = 0;
+    int res;
+
+    /* build back to front: the release callback goes to the last snip, which
+     * is also the last one to be removed from the packet buffer */
+    for (unsigned i = count; i > 0; i--) {
+        gnrc_pktsnip_t *snip;
+
+        if (vector[i - 1].iov_len == 0) {
+            continue;
+        }
+        snip = gnrc_pktbuf_add_ext(payload, vector[i - 1].iov_base, vector[i - 1].iov_len,
+                                   GNRC_NETTYPE_UNDEF, (payload == NULL) ? cb : NULL, arg);
+        if (snip == NULL) {
+            if (payload != NULL) {
+                gnrc_pktbuf_release(payload);   /* calls cb */
+            }
+            else if (cb != NULL) {
+                cb(arg);
+            }
+            return -ENOMEM;
+        }
+        payload = snip;
+        len += vector[i - 1].iov_len;
+    }
+    if ((payload == NULL) && (cb != NULL)) {
+        cb(arg);    /* nothing to wait for */
+    }
+    res = _sendto(payload, src, src_len, dst, dst_len, family, sport, dport);
+    return (res < 0) ? res : (int)len;
 }
 
 /** @} */
@@ -19,6 +19,7 @@
  */
 
 #include <errno.h>
+#include <string.h>
 
 #include "kernel.h"
 #include "msg.h"
@@ -40,7 +41,8 @@
 
 #define NETDEV2_NETAPI_MSG_QUEUE_SIZE 8
 
-static void _pass_on_packet(gnrc_pktsnip_t *pkt);
+static void _pass_on_packet(gnrc_netdev2_t *gnrc_netdev2, gnrc_pktsnip_t *pkt);
+static void _flush_rx_batch(gnrc_netdev2_t *gnrc_netdev2);
 
 /**
  * @brief   Function called by the device driver on device events
@@ -71,7 +73,7 @@ static void _event_cb(netdev2_t *dev, netdev2_event_t event, void *data)
                     gnrc_pktsnip_t *pkt = gnrc_netdev2->recv(gnrc_netdev2);
 
                     if (pkt) {
-                        _pass_on_packet(pkt);
+                        _pass_on_packet(gnrc_netdev2, pkt);
                     }
 
                     break;
@@ -82,8 +84,44 @@ static void _event_cb(netdev2_t *dev, netdev2_event_t event, void *data)
     }
 }
 
-static void _pass_on_packet(gnrc_pktsnip_t *pkt)
+#if GNRC_NETDEV2_RX_BATCH > 1
+static void _pass_on_packet(gnrc_netdev2_t *gnrc_netdev2, gnrc_pktsnip_t *pkt)
 {
+    /* only packets of the same type go to the same subscribers */
+    if ((gnrc_netdev2->rx_batch_len == GNRC_NETDEV2_RX_BATCH) ||
+        ((gnrc_netdev2->rx_batch_len > 0) &&
+         (gnrc_netdev2->rx_batch[0]->type != pkt->type))) {
+        _flush_rx_batch(gnrc_netdev2);
+    }
+    gnrc_netdev2->rx_batch[gnrc_netdev2->rx_batch_len++] = pkt;
+}
+
+static void _flush_rx_batch(gnrc_netdev2_t *gnrc_netdev2)
+{
+    gnrc_pktsnip_t **pkts = gnrc_netdev2->rx_batch;
+    unsigned num = gnrc_netdev2->rx_batch_len;
+
+    if (num == 0) {
+        return;
+    }
+    gnrc_netdev2->rx_batch_len = 0;
+    gnrc_netdev2->stats.rx_pkts += num;
+    gnrc_netdev2->stats.rx_batches++;
+    /* throw away packets if no one is interested */
+    if (!gnrc_netapi_dispatch_receive_batch(pkts[0]->type, GNRC_NETREG_DEMUX_CTX_ALL,
+                                            pkts, num)) {
+        DEBUG("gnrc_netdev2: unable to forward %u packets of type %i\n", num,
+              pkts[0]->type);
+        for (unsigned i = 0; i < num; i++) {
+            gnrc_pktbuf_release(pkts[i]);
+        }
+    }
+}
+#else
+static void _pass_on_packet(gnrc_netdev2_t *gnrc_netdev2, gnrc_pktsnip_t *pkt)
+{
+    gnrc_netdev2->stats.rx_pkts++;
+    gnrc_netdev2->stats.rx_batches++;
     /* throw away packet if no one is interested */
     if (!gnrc_netapi_dispatch_receive(pkt->type, GNRC_NETREG_DEMUX_CTX_ALL, pkt)) {
         DEBUG("gnrc_netdev2: unable to forward packet of type %i\n", pkt->type);
@@ -92,6 +130,12 @@ static void _pass_on_packet(gnrc_pktsnip_t *pkt)
     }
 }
 
+static inline void _flush_rx_batch(gnrc_netdev2_t *gnrc_netdev2)
+{
+    (void)gnrc_netdev2;
+}
+#endif
+
 /**
  * @brief   Startup code and event loop of the gnrc_netdev2 layer
  *
@@ -107,6 +151,10 @@ static void *_gnrc_netdev2_thread(void *args)
     netdev2_t *dev = gnrc_netdev2->dev;
 
     gnrc_netdev2->pid = thread_getpid();
+    memset(&gnrc_netdev2->stats, 0, sizeof(gnrc_netdev2->stats));
+#if GNRC_NETDEV2_RX_BATCH > 1
+    gnrc_netdev2->rx_batch_len = 0;
+#endif
 
     gnrc_netapi_opt_t *opt;
     int res;
@@ -158,8 +206,22 @@ static void *_gnrc_netdev2_thread(void *args)
                 opt = (gnrc_netapi_opt_t *)msg.content.ptr;
                 DEBUG("gnrc_netdev2: GNRC_NETAPI_MSG_TYPE_GET received. opt=%s\n",
                         netopt2str(opt->opt));
-                /* get option from device driver */
-                res = dev->driver->get(dev, opt->opt, opt->data, opt->data_len);
+                if (opt->opt == NETOPT_RX_BATCH_STATS) {
+                    /* counters are kept by the adapter, not the driver */
+                    if (opt->data_len < sizeof(gnrc_netdev2_stats_t)) {
+                        res = -EOVERFLOW;
+                    }
+                    else {
+                        memcpy(opt->data, &gnrc_netdev2->stats,
+                               sizeof(gnrc_netdev2_stats_t));
+                        res = sizeof(gnrc_netdev2_stats_t);
+                    }
+                }
+                else {
+                    /* get option from device driver */
+                    res = dev->driver->get(dev, opt->opt, opt->data,
+                                           opt->data_len);
+                }
                 DEBUG("gnrc_netdev2: response of netdev->get: %i\n", res);
                 /* send reply to calling thread */
                 reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
@@ -170,6 +232,8 @@ static void *_gnrc_netdev2_thread(void *args)
                 DEBUG("gnrc_netdev2: Unknown command %" PRIu16 "\n", msg.type);
                 break;
         }
+        /* pass on what the driver received while handling the message */
+        _flush_rx_batch(gnrc_netdev2);
     }
     /* never reached */
     return NULL;
@@ -30,7 +30,7 @@
 #include "net/gnrc.h"
 #include "periph/uart.h"
 #include "od.h"
-#include "ringbuffer.h"
+#include "tsrb.h"
 #include "thread.h"
 #include "net/ipv6/hdr.h"
 
@@ -68,14 +68,14 @@ static void _slip_rx_cb(void *arg, char data)
 
         switch (data) {
             case (_SLIP_END_ESC):
-                if (ringbuffer_add_one(&_SLIP_DEV(arg)->in_buf, _SLIP_END) < 0) {
+                if (tsrb_add_one(&_SLIP_DEV(arg)->in_buf, _SLIP_END) == 0) {
                     _SLIP_DEV(arg)->in_bytes++;
                 }
 
                 break;
 
             case (_SLIP_ESC_ESC):
-                if (ringbuffer_add_one(&_SLIP_DEV(arg)->in_buf, _SLIP_ESC) < 0) {
+                if (tsrb_add_one(&_SLIP_DEV(arg)->in_buf, _SLIP_ESC) == 0) {
                     _SLIP_DEV(arg)->in_bytes++;
                 }
 
@@ -89,7 +89,7 @@ static void _slip_rx_cb(void *arg, char data)
         _SLIP_DEV(arg)->in_esc = 1;
     }
     else {
-        if (ringbuffer_add_one(&_SLIP_DEV(arg)->in_buf, data) < 0) {
+        if (tsrb_add_one(&_SLIP_DEV(arg)->in_buf, data) == 0) {
             _SLIP_DEV(arg)->in_bytes++;
         }
     }
@@ -116,7 +116,7 @@ static void _slip_receive(gnrc_slip_dev_t *dev, size_t bytes)
         return;
     }
 
-    if (ringbuffer_get(&dev->in_buf, pkt->data, bytes) != bytes) {
+    if ((size_t)tsrb_get(&dev->in_buf, pkt->data, bytes) != bytes) {
         DEBUG("slip: could not read %u bytes from ringbuffer\n", (unsigned)bytes);
         gnrc_pktbuf_release(pkt);
         return;
@@ -255,7 +255,7 @@ kernel_pid_t gnrc_slip_init(gnrc_slip_dev_t *dev, uart_t uart, uint32_t baudrate
     dev->slip_pid = KERNEL_PID_UNDEF;
 
     /* initialize buffers */
-    ringbuffer_init(&dev->in_buf, dev->rx_mem, sizeof(dev->rx_mem));
+    tsrb_init(&dev->in_buf, dev->rx_mem, sizeof(dev->rx_mem));
 
     /* initialize UART */
     DEBUG("slip: initialize UART_%d with baudrate %" PRIu32 "\n", uart,
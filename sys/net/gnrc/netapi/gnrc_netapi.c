@@ -23,6 +23,10 @@
 #include "net/gnrc/netreg.h"
 #include "net/gnrc/pktbuf.h"
 #include "net/gnrc/netapi.h"
+#include "thread.h"
+#ifdef MODULE_XTIMER
+#include "xtimer.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
@@ -96,6 +100,100 @@ int gnrc_netapi_dispatch(gnrc_nettype_t type, uint32_t demux_ctx,
     return numof;
 }
 
+#ifdef MODULE_XTIMER
+/* interval to check the message queue of a subscriber for room again */
+#define _BATCH_WAIT_STEP    (1000U)
+#endif
+
+/* sends a packet the subscriber had no room for in the batch, waiting for it
+ * to take the messages it has queued */
+static int _snd_rcv_wait(kernel_pid_t pid, uint16_t type, gnrc_pktsnip_t *pkt)
+{
+    msg_t msg;
+    int ret;
+#ifdef MODULE_XTIMER
+    uint32_t waited = 0;
+#endif
+
+    msg.type = type;
+    msg.content.ptr = (void *)pkt;
+    while ((ret = msg_try_send(&msg, pid)) == 0) {
+#ifdef MODULE_XTIMER
+        int status = thread_getstatus(pid);
+
+        /* a blocking msg_send() would dead-lock with a subscriber that waits
+         * for this thread, e.g. in gnrc_netapi_get() */
+        if ((status == STATUS_SEND_BLOCKED) || (status == STATUS_REPLY_BLOCKED) ||
+            (waited >= GNRC_NETAPI_BATCH_WAIT)) {
+            break;
+        }
+        xtimer_usleep(_BATCH_WAIT_STEP);
+        waited += _BATCH_WAIT_STEP;
+#else
+        break;
+#endif
+    }
+    if (ret < 1) {
+        DEBUG("gnrc_netapi: dropped message to %" PRIkernel_pid " (%s)\n", pid,
+              (ret == 0) ? "receiver queue is full" : "invalid receiver");
+    }
+    return ret;
+}
+
+static void _snd_rcv_batch(kernel_pid_t pid, uint16_t type, gnrc_pktsnip_t **pkts,
+                           unsigned num)
+{
+    msg_t msgs[GNRC_NETAPI_BATCH_SIZE];
+
+    while (num > 0) {
+        unsigned n = (num > GNRC_NETAPI_BATCH_SIZE) ? GNRC_NETAPI_BATCH_SIZE : num;
+        int ret;
+
+        for (unsigned i = 0; i < n; i++) {
+            msgs[i].type = type;
+            msgs[i].content.ptr = (void *)pkts[i];
+        }
+        ret = msg_send_batch(msgs, n, pid);
+        if (ret < 0) {
+            /* invalid receiver */
+            for (unsigned i = 0; i < n; i++) {
+                gnrc_pktbuf_release(pkts[i]);
+            }
+        }
+        else {
+            /* the queue of the receiver is full, let it catch up */
+            for (unsigned i = (unsigned)ret; i < n; i++) {
+                if (_snd_rcv_wait(pid, type, pkts[i]) < 1) {
+                    gnrc_pktbuf_release(pkts[i]);
+                }
+            }
+        }
+        pkts += n;
+        num -= n;
+    }
+}
+
+int gnrc_netapi_dispatch_batch(gnrc_nettype_t type, uint32_t demux_ctx, uint16_t cmd,
+                               gnrc_pktsnip_t **pkts, unsigned num)
+{
+    int numof = gnrc_netreg_num(type, demux_ctx);
+
+    if (numof != 0) {
+        gnrc_netreg_entry_t *sendto = gnrc_netreg_lookup(type, demux_ctx);
+
+        for (unsigned i = 0; i < num; i++) {
+            gnrc_pktbuf_hold(pkts[i], numof - 1);
+        }
+
+        while (sendto) {
+            _snd_rcv_batch(sendto->pid, cmd, pkts, num);
+            sendto = gnrc_netreg_getnext(sendto);
+        }
+    }
+
+    return numof;
+}
+
 int gnrc_netapi_send(kernel_pid_t pid, gnrc_pktsnip_t *pkt)
 {
     return _snd_rcv(pid, GNRC_NETAPI_MSG_TYPE_SND, pkt);
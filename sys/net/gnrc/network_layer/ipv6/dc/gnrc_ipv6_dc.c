@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <string.h>
+
+#include "net/gnrc/ipv6/dc.h"
+#include "xtimer.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#if (GNRC_IPV6_DC_SIZE & (GNRC_IPV6_DC_SIZE - 1)) || (GNRC_IPV6_DC_SIZE == 0)
+#error "GNRC_IPV6_DC_SIZE must be a power of two"
+#endif
+
+static gnrc_ipv6_dc_t dcache[GNRC_IPV6_DC_SIZE];
+static gnrc_ipv6_dc_stats_t stats;
+
+static inline gnrc_ipv6_dc_t *_slot(kernel_pid_t iface, const ipv6_addr_t *dst)
+{
+    uint32_t hash = dst->u32[0].u32 ^ dst->u32[1].u32 ^ dst->u32[2].u32 ^
+                    dst->u32[3].u32 ^ (uint32_t)iface;
+
+    hash ^= hash >> 16;
+    hash ^= hash >> 8;
+    return &dcache[hash & (GNRC_IPV6_DC_SIZE - 1)];
+}
+
+void gnrc_ipv6_dc_init(void)
+{
+    memset(&stats, 0, sizeof(stats));
+    gnrc_ipv6_dc_flush();
+    stats.flushes = 0;
+}
+
+gnrc_ipv6_dc_t *gnrc_ipv6_dc_get(kernel_pid_t iface, const ipv6_addr_t *dst)
+{
+    gnrc_ipv6_dc_t *entry = _slot(iface, dst);
+
+    if ((entry->next_hop_iface != KERNEL_PID_UNDEF) && (entry->iface == iface) &&
+        ipv6_addr_equal(&entry->dst, dst)) {
+        if ((int32_t)(entry->expires - xtimer_now()) > 0) {
+            stats.hits++;
+#ifdef MODULE_GNRC_IPV6_NC
+            if (entry->nc_entry != NULL) {
+                gnrc_ipv6_nc_touch(entry->nc_entry);
+            }
+#endif
+            return entry;
+        }
+        DEBUG("ipv6_dc: entry expired\n");
+        entry->next_hop_iface = KERNEL_PID_UNDEF;
+    }
+    stats.misses++;
+
+    return NULL;
+}
+
+gnrc_ipv6_dc_t *gnrc_ipv6_dc_add(kernel_pid_t iface, const ipv6_addr_t *dst,
+                                 kernel_pid_t next_hop_iface,
+                                 const uint8_t *l2_addr, uint8_t l2_addr_len)
+{
+    gnrc_ipv6_dc_t *entry = _slot(iface, dst);
+
+    if (l2_addr_len > GNRC_IPV6_NC_L2_ADDR_MAX) {
+        return NULL;
+    }
+
+    entry->dst = *dst;
+    entry->expires = xtimer_now() + GNRC_IPV6_DC_LIFETIME;
+    entry->iface = iface;
+    entry->next_hop_iface = next_hop_iface;
+    memcpy(entry->l2_addr, l2_addr, l2_addr_len);
+    entry->l2_addr_len = l2_addr_len;
+    entry->nc_entry = NULL;
+    entry->flags = 0;
+
+    return entry;
+}
+
+void gnrc_ipv6_dc_flush(void)
+{
+    for (unsigned i = 0; i < GNRC_IPV6_DC_SIZE; i++) {
+        dcache[i].next_hop_iface = KERNEL_PID_UNDEF;
+    }
+    stats.flushes++;
+}
+
+const gnrc_ipv6_dc_stats_t *gnrc_ipv6_dc_stats(void)
+{
+    return &stats;
+}
+
+/** @} */
@@ -29,6 +29,7 @@
 #include "thread.h"
 #include "utlist.h"
 
+#include "net/gnrc/ipv6/dc.h"
 #include "net/gnrc/ipv6/nc.h"
 #include "net/gnrc/ipv6/netif.h"
 #include "net/gnrc/ipv6/whitelist.h"
@@ -94,6 +95,9 @@ kernel_pid_t gnrc_ipv6_init(void)
     gnrc_ipv6_fib_table.size = GNRC_IPV6_FIB_TABLE_SIZE;
     fib_init(&gnrc_ipv6_fib_table);
 #endif
+#ifdef MODULE_GNRC_IPV6_DC
+    gnrc_ipv6_dc_init();
+#endif
 
     return gnrc_ipv6_pid;
 }
@@ -108,6 +112,15 @@ void gnrc_ipv6_demux(kernel_pid_t iface, gnrc_pktsnip_t *pkt, uint8_t nh)
 #ifdef MODULE_GNRC_ICMPV6
         case PROTNUM_ICMPV6:
             DEBUG("ipv6: handle ICMPv6 packet (nh = %" PRIu8 ")\n", nh);
+#ifdef MODULE_GNRC_IPV6_DC
+            /* anything but ping may be neighbor discovery or an error that
+             * changes how destinations are reached */
+            if ((pkt->size < sizeof(icmpv6_hdr_t)) ||
+                ((((icmpv6_hdr_t *)pkt->data)->type != ICMPV6_ECHO_REQ) &&
+                 (((icmpv6_hdr_t *)pkt->data)->type != ICMPV6_ECHO_REP))) {
+                gnrc_ipv6_dc_flush();
+            }
+#endif
             gnrc_icmpv6_demux(iface, pkt);
             break;
 #endif
@@ -177,6 +190,14 @@ static void *_event_loop(void *args)
         DEBUG("ipv6: waiting for incoming message.\n");
         msg_receive(&msg);
 
+#ifdef MODULE_GNRC_IPV6_DC
+        if ((msg.type != GNRC_NETAPI_MSG_TYPE_RCV) &&
+            (msg.type != GNRC_NETAPI_MSG_TYPE_SND)) {
+            /* timer events change neighbors, routers, and addresses */
+            gnrc_ipv6_dc_flush();
+        }
+#endif
+
         switch (msg.type) {
             case GNRC_NETAPI_MSG_TYPE_RCV:
                 DEBUG("ipv6: GNRC_NETAPI_MSG_TYPE_RCV received\n");
@@ -561,12 +582,46 @@ static inline kernel_pid_t _next_hop_l2addr(uint8_t *l2addr, uint8_t *l2addr_len
     return found_iface;
 }
 
+#ifdef MODULE_GNRC_IPV6_DC
+static inline bool _dc_usable(ipv6_hdr_t *hdr)
+{
+#ifdef MODULE_GNRC_IPV6_EXT_RH
+    /* the next hop of a source routed packet depends on the packet */
+    if (hdr->nh == PROTNUM_IPV6_EXT_RH) {
+        return false;
+    }
+#endif
+    return !ipv6_addr_is_loopback(&hdr->dst);
+}
+
+static gnrc_ipv6_dc_t *_dc_get(kernel_pid_t iface, ipv6_hdr_t *hdr)
+{
+#ifdef MODULE_FIB
+    static uint32_t fib_generation;
+
+    if (gnrc_ipv6_fib_table.generation != fib_generation) {
+        DEBUG("ipv6: FIB changed, flush destination cache\n");
+        fib_generation = gnrc_ipv6_fib_table.generation;
+        gnrc_ipv6_dc_flush();
+    }
+#endif
+    if (!_dc_usable(hdr)) {
+        return NULL;
+    }
+
+    return gnrc_ipv6_dc_get(iface, &hdr->dst);
+}
+#endif
+
 static void _send(gnrc_pktsnip_t *pkt, bool prep_hdr)
 {
     kernel_pid_t iface = KERNEL_PID_UNDEF;
     gnrc_pktsnip_t *ipv6, *payload;
     ipv6_addr_t *tmp;
     ipv6_hdr_t *hdr;
+#ifdef MODULE_GNRC_IPV6_DC
+    gnrc_ipv6_dc_t *dc_entry;
+#endif
     /* get IPv6 snip and (if present) generic interface header */
     if (pkt->type == GNRC_NETTYPE_NETIF) {
         /* If there is already a netif header (routing protocols and
@@ -608,6 +663,26 @@ static void _send(gnrc_pktsnip_t *pkt, bool prep_hdr)
     if (ipv6_addr_is_multicast(&hdr->dst)) {
         _send_multicast(iface, pkt, ipv6, payload, prep_hdr);
     }
+#ifdef MODULE_GNRC_IPV6_DC
+    /* only remote unicast destinations are cached */
+    else if ((dc_entry = _dc_get(iface, hdr)) != NULL) {
+        DEBUG("ipv6: destination cache hit\n");
+        if (prep_hdr) {
+            if (ipv6_addr_is_unspecified(&hdr->src) &&
+                (dc_entry->flags & GNRC_IPV6_DC_FLAGS_SRC)) {
+                memcpy(&hdr->src, &dc_entry->src, sizeof(ipv6_addr_t));
+            }
+            if (_fill_ipv6_hdr(dc_entry->next_hop_iface, ipv6, payload) < 0) {
+                /* error on filling up header */
+                gnrc_pktbuf_release(pkt);
+                return;
+            }
+        }
+
+        _send_unicast(dc_entry->next_hop_iface, dc_entry->l2_addr,
+                      dc_entry->l2_addr_len, pkt);
+    }
+#endif
     else if ((ipv6_addr_is_loopback(&hdr->dst)) ||      /* dst is loopback address */
              ((iface == KERNEL_PID_UNDEF) && /* or dst registered to any local interface */
               ((iface = gnrc_ipv6_netif_find_by_addr(&tmp, &hdr->dst)) != KERNEL_PID_UNDEF)) ||
@@ -653,6 +728,10 @@ static void _send(gnrc_pktsnip_t *pkt, bool prep_hdr)
     else {
         uint8_t l2addr_len = GNRC_IPV6_NC_L2_ADDR_MAX;
         uint8_t l2addr[l2addr_len];
+#ifdef MODULE_GNRC_IPV6_DC
+        kernel_pid_t dc_iface = iface;
+        bool select_src = prep_hdr && ipv6_addr_is_unspecified(&hdr->src);
+#endif
 
         iface = _next_hop_l2addr(l2addr, &l2addr_len, iface, &hdr->dst, pkt);
 
@@ -670,6 +749,20 @@ static void _send(gnrc_pktsnip_t *pkt, bool prep_hdr)
             }
         }
 
+#ifdef MODULE_GNRC_IPV6_DC
+        if (_dc_usable(hdr) &&
+            ((dc_entry = gnrc_ipv6_dc_add(dc_iface, &hdr->dst, iface,
+                                          l2addr, l2addr_len)) != NULL)) {
+            if (select_src && !ipv6_addr_is_unspecified(&hdr->src)) {
+                gnrc_ipv6_dc_set_src(dc_entry, &hdr->src);
+            }
+#ifdef MODULE_GNRC_IPV6_NC
+            /* the next hop determination just used this entry */
+            gnrc_ipv6_dc_set_nc(dc_entry, gnrc_ipv6_nc_get_by_l2_addr(iface, l2addr,
+                                                                      l2addr_len));
+#endif
+        }
+#endif
         _send_unicast(iface, l2addr, l2addr_len, pkt);
     }
 }
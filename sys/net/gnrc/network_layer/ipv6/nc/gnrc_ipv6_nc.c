@@ -17,6 +17,7 @@
 
 #include "net/gnrc/ipv6.h"
 #include "net/ipv6/addr.h"
+#include "net/gnrc/ipv6/dc.h"
 #include "net/gnrc/ipv6/nc.h"
 #include "net/gnrc/ipv6/netif.h"
 #include "net/gnrc/ndp.h"
@@ -35,22 +36,169 @@
 static char addr_str[IPV6_ADDR_MAX_STR_LEN];
 #endif
 
+#if (GNRC_IPV6_NC_BUCKETS & (GNRC_IPV6_NC_BUCKETS - 1)) || (GNRC_IPV6_NC_BUCKETS == 0)
+#error "GNRC_IPV6_NC_BUCKETS must be a power of two"
+#endif
+
 static gnrc_ipv6_nc_t ncache[GNRC_IPV6_NC_SIZE];
 
+/* the index is kept beside the cache, so gnrc_ipv6_nc_t stays as it is */
+static gnrc_ipv6_nc_t *_buckets[GNRC_IPV6_NC_BUCKETS];
+static gnrc_ipv6_nc_t *_next[GNRC_IPV6_NC_SIZE];   /* bucket chain or free list */
+static gnrc_ipv6_nc_t *_free;
+static uint32_t _last_used[GNRC_IPV6_NC_SIZE];
+static uint32_t _use_clock;
+
+static inline unsigned _idx(const gnrc_ipv6_nc_t *entry)
+{
+    return (unsigned)(entry - ncache);
+}
+
+static inline gnrc_ipv6_nc_t **_bucket(const ipv6_addr_t *ipv6_addr)
+{
+    uint32_t hash = ipv6_addr->u32[0].u32 ^ ipv6_addr->u32[1].u32 ^
+                    ipv6_addr->u32[2].u32 ^ ipv6_addr->u32[3].u32;
+
+    hash ^= hash >> 16;
+    hash ^= hash >> 8;
+    return &_buckets[hash & (GNRC_IPV6_NC_BUCKETS - 1)];
+}
+
+static inline void _touch(gnrc_ipv6_nc_t *entry)
+{
+    _last_used[_idx(entry)] = ++_use_clock;
+}
+
 void gnrc_ipv6_nc_init(void)
 {
     memset(ncache, 0, sizeof(ncache));
+    memset(_buckets, 0, sizeof(_buckets));
+    _free = NULL;
+    _use_clock = 0;
+    /* chain backwards so entries are handed out from the start of the cache */
+    for (int i = GNRC_IPV6_NC_SIZE - 1; i >= 0; i--) {
+        _next[i] = _free;
+        _free = ncache + i;
+        _last_used[i] = 0;
+    }
 }
 
-gnrc_ipv6_nc_t *_find_free_entry(void)
+/* returns the entry for ipv6_addr on any interface, and its link in the chain */
+static gnrc_ipv6_nc_t **_find(const ipv6_addr_t *ipv6_addr)
 {
+    gnrc_ipv6_nc_t **ptr = _bucket(ipv6_addr);
+
+    while ((*ptr != NULL) && !ipv6_addr_equal(&(*ptr)->ipv6_addr, ipv6_addr)) {
+        ptr = &_next[_idx(*ptr)];
+    }
+
+    return ptr;
+}
+
+static void _release(gnrc_ipv6_nc_t *entry)
+{
+    gnrc_ipv6_nc_t **ptr = _find(&entry->ipv6_addr);
+
+    /* unlink from its bucket */
+    while (*ptr != entry) {
+        ptr = &_next[_idx(*ptr)];
+    }
+    *ptr = _next[_idx(entry)];
+#ifdef MODULE_GNRC_IPV6_DC
+    gnrc_ipv6_dc_flush();
+#endif
+
+#ifdef MODULE_GNRC_NDP_NODE
+    while (entry->pkts != NULL) {
+        gnrc_pktbuf_release(entry->pkts->pkt);
+        entry->pkts->pkt = NULL;
+        gnrc_pktqueue_remove_head(&entry->pkts);
+    }
+#endif
+    /* the timer messages point to the entry, which is about to be reused */
+    xtimer_remove(&entry->rtr_timeout);
+    xtimer_remove(&entry->nbr_sol_timer);
+    xtimer_remove(&entry->nbr_adv_timer);
+#ifdef MODULE_GNRC_SIXLOWPAN_ND_ROUTER
+    xtimer_remove(&entry->type_timeout);
+#endif
+#if defined(MODULE_GNRC_NDP_ROUTER) || defined(MODULE_GNRC_SIXLOWPAN_ND_BORDER_ROUTER)
+    xtimer_remove(&entry->rtr_adv_timer);
+#endif
+
+    ipv6_addr_set_unspecified(&(entry->ipv6_addr));
+    entry->iface = KERNEL_PID_UNDEF;
+    entry->flags = 0;
+
+    _next[_idx(entry)] = _free;
+    _free = entry;
+}
+
+/* lower is evicted earlier, -1 is never evicted */
+static int _evict_rank(const gnrc_ipv6_nc_t *entry)
+{
+    if (entry->flags & GNRC_IPV6_NC_IS_ROUTER) {
+        return -1;
+    }
+
+    switch (gnrc_ipv6_nc_get_type(entry)) {
+        case GNRC_IPV6_NC_TYPE_GC:
+            return 0;
+        case GNRC_IPV6_NC_TYPE_NONE:
+            break;
+        default:    /* registered or tentative 6LoWPAN-ND entry */
+            return -1;
+    }
+
+    switch (gnrc_ipv6_nc_get_state(entry)) {
+        case GNRC_IPV6_NC_STATE_UNMANAGED:
+            return -1;
+        case GNRC_IPV6_NC_STATE_STALE:
+        case GNRC_IPV6_NC_STATE_UNREACHABLE:
+            return 1;
+        default:
+            return 2;
+    }
+}
+
+static gnrc_ipv6_nc_t *_evict(void)
+{
+    gnrc_ipv6_nc_t *victim = NULL;
+    int victim_rank = -1;
+
     for (int i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
-        if (ipv6_addr_is_unspecified(&(ncache[i].ipv6_addr))) {
-            return ncache + i;
+        int rank = _evict_rank(ncache + i);
+
+        if ((rank < 0) || ((victim != NULL) && (rank > victim_rank))) {
+            continue;
+        }
+        if ((victim == NULL) || (rank < victim_rank) ||
+            ((int32_t)(_last_used[i] - _last_used[_idx(victim)]) < 0)) {
+            victim = ncache + i;
+            victim_rank = rank;
         }
     }
 
-    return NULL;
+    if (victim != NULL) {
+        DEBUG("ipv6_nc: evict %s\n",
+              ipv6_addr_to_str(addr_str, &victim->ipv6_addr, sizeof(addr_str)));
+        _release(victim);
+    }
+
+    return victim;
+}
+
+static gnrc_ipv6_nc_t *_alloc_entry(void)
+{
+    gnrc_ipv6_nc_t *entry;
+
+    if ((_free == NULL) && (_evict() == NULL)) {
+        return NULL;
+    }
+    entry = _free;
+    _free = _next[_idx(entry)];
+
+    return entry;
 }
 
 gnrc_ipv6_nc_t *gnrc_ipv6_nc_add(kernel_pid_t iface, const ipv6_addr_t *ipv6_addr,
@@ -68,33 +216,30 @@ gnrc_ipv6_nc_t *gnrc_ipv6_nc_add(kernel_pid_t iface, const ipv6_addr_t *ipv6_add
         return NULL;
     }
 
-    for (int i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
-        if (ipv6_addr_equal(&(ncache[i].ipv6_addr), ipv6_addr)) {
-            DEBUG("ipv6_nc: Address %s already registered.\n",
-                  ipv6_addr_to_str(addr_str, ipv6_addr, sizeof(addr_str)));
-
-            if ((l2_addr != NULL) && (l2_addr_len > 0)) {
-                DEBUG("ipv6_nc: Update to L2 address %s",
-                      gnrc_netif_addr_to_str(addr_str, sizeof(addr_str),
-                                             l2_addr, l2_addr_len));
-
-                memcpy(&(ncache[i].l2_addr), l2_addr, l2_addr_len);
-                ncache[i].l2_addr_len = l2_addr_len;
-                ncache[i].flags = flags;
-                DEBUG(" with flags = 0x%0x\n", flags);
-
-            }
-            return &ncache[i];
-        }
+    if ((free_entry = *_find(ipv6_addr)) != NULL) {
+        DEBUG("ipv6_nc: Address %s already registered.\n",
+              ipv6_addr_to_str(addr_str, ipv6_addr, sizeof(addr_str)));
+
+        if ((l2_addr != NULL) && (l2_addr_len > 0)) {
+            DEBUG("ipv6_nc: Update to L2 address %s",
+                  gnrc_netif_addr_to_str(addr_str, sizeof(addr_str),
+                                         l2_addr, l2_addr_len));
+
+            memcpy(&(free_entry->l2_addr), l2_addr, l2_addr_len);
+            free_entry->l2_addr_len = l2_addr_len;
+            free_entry->flags = flags;
+            DEBUG(" with flags = 0x%0x\n", flags);
+#ifdef MODULE_GNRC_IPV6_DC
+            gnrc_ipv6_dc_flush();
+#endif
 
-        if (ipv6_addr_is_unspecified(&(ncache[i].ipv6_addr)) && !free_entry) {
-            /* found the first free entry */
-            free_entry = &ncache[i];
         }
+        _touch(free_entry);
+        return free_entry;
     }
 
-    if (!free_entry) {
-        /* reached end of NC without finding updateable or free entry */
+    if ((free_entry = _alloc_entry()) == NULL) {
+        /* NC is full of entries that must not be evicted */
         DEBUG("ipv6_nc: neighbor cache full.\n");
         return NULL;
     }
@@ -106,6 +251,12 @@ gnrc_ipv6_nc_t *gnrc_ipv6_nc_add(kernel_pid_t iface, const ipv6_addr_t *ipv6_add
     free_entry->pkts = NULL;
 #endif
     memcpy(&(free_entry->ipv6_addr), ipv6_addr, sizeof(ipv6_addr_t));
+    _next[_idx(free_entry)] = *_bucket(ipv6_addr);
+    *_bucket(ipv6_addr) = free_entry;
+    _touch(free_entry);
+#ifdef MODULE_GNRC_IPV6_DC
+    gnrc_ipv6_dc_flush();
+#endif
     DEBUG("ipv6_nc: Register %s for interface %" PRIkernel_pid,
           ipv6_addr_to_str(addr_str, ipv6_addr, sizeof(addr_str)),
           iface);
@@ -154,48 +305,63 @@ void gnrc_ipv6_nc_remove(kernel_pid_t iface, const ipv6_addr_t *ipv6_addr)
               ipv6_addr_to_str(addr_str, ipv6_addr, sizeof(addr_str)),
               iface);
 
-#ifdef MODULE_GNRC_NDP_NODE
-        while (entry->pkts != NULL) {
-            gnrc_pktbuf_release(entry->pkts->pkt);
-            entry->pkts->pkt = NULL;
-            gnrc_pktqueue_remove_head(&entry->pkts);
-        }
-#endif
-#ifdef MODULE_GNRC_SIXLOWPAN_ND_ROUTER
-        xtimer_remove(&entry->type_timeout);
-#endif
-#if defined(MODULE_GNRC_NDP_ROUTER) || defined(MODULE_GNRC_SIXLOWPAN_ND_BORDER_ROUTER)
-        xtimer_remove(&entry->rtr_adv_timer);
-#endif
-
-        ipv6_addr_set_unspecified(&(entry->ipv6_addr));
-        entry->iface = KERNEL_PID_UNDEF;
-        entry->flags = 0;
+        _release(entry);
     }
 }
 
 gnrc_ipv6_nc_t *gnrc_ipv6_nc_get(kernel_pid_t iface, const ipv6_addr_t *ipv6_addr)
 {
+    gnrc_ipv6_nc_t *entry;
+
     if ((ipv6_addr == NULL) || (ipv6_addr_is_unspecified(ipv6_addr))) {
         DEBUG("ipv6_nc: address was NULL or ::\n");
         return NULL;
     }
 
-    for (int i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
-        if (((ncache[i].iface == KERNEL_PID_UNDEF) || (iface == KERNEL_PID_UNDEF) ||
-             (iface == ncache[i].iface)) && ipv6_addr_equal(&(ncache[i].ipv6_addr), ipv6_addr)) {
-            DEBUG("ipv6_nc: Found entry for %s on interface %" PRIkernel_pid
-                  " (0 = all interfaces) [%p]\n",
-                  ipv6_addr_to_str(addr_str, ipv6_addr, sizeof(addr_str)),
-                  iface, (void *)(ncache + i));
-
-            return ncache + i;
-        }
+    /* an address is in the cache at most once, so only the interface is left to check */
+    entry = *_find(ipv6_addr);
+    if ((entry != NULL) &&
+        ((entry->iface == KERNEL_PID_UNDEF) || (iface == KERNEL_PID_UNDEF) ||
+         (iface == entry->iface))) {
+        DEBUG("ipv6_nc: Found entry for %s on interface %" PRIkernel_pid
+              " (0 = all interfaces) [%p]\n",
+              ipv6_addr_to_str(addr_str, ipv6_addr, sizeof(addr_str)),
+              iface, (void *)entry);
+
+        _touch(entry);
+        return entry;
     }
 
     return NULL;
 }
 
+gnrc_ipv6_nc_t *gnrc_ipv6_nc_get_by_l2_addr(kernel_pid_t iface, const uint8_t *l2_addr,
+                                            uint8_t l2_addr_len)
+{
+    gnrc_ipv6_nc_t *res = NULL;
+
+    if (l2_addr_len == 0) {
+        return NULL;
+    }
+    for (unsigned i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
+        gnrc_ipv6_nc_t *entry = &ncache[i];
+
+        if (!ipv6_addr_is_unspecified(&entry->ipv6_addr) && (entry->iface == iface) &&
+            (entry->l2_addr_len == l2_addr_len) &&
+            (memcmp(entry->l2_addr, l2_addr, l2_addr_len) == 0) &&
+            ((res == NULL) || ((int32_t)(_last_used[i] - _last_used[_idx(res)]) > 0))) {
+            res = entry;
+        }
+    }
+
+    return res;
+}
+
+void gnrc_ipv6_nc_touch(gnrc_ipv6_nc_t *entry)
+{
+    _touch(entry);
+}
+
 gnrc_ipv6_nc_t *gnrc_ipv6_nc_get_next(gnrc_ipv6_nc_t *prev)
 {
     if (prev == NULL) {
@@ -251,6 +417,9 @@ gnrc_ipv6_nc_t *gnrc_ipv6_nc_still_reachable(const ipv6_addr_t *ipv6_addr)
               ipv6_addr_to_str(addr_str, ipv6_addr, sizeof(addr_str)));
         entry->flags &= ~(GNRC_IPV6_NC_STATE_MASK >> GNRC_IPV6_NC_STATE_POS);
         entry->flags |= (GNRC_IPV6_NC_STATE_REACHABLE >> GNRC_IPV6_NC_STATE_POS);
+#ifdef MODULE_GNRC_IPV6_DC
+        gnrc_ipv6_dc_flush();
+#endif
     }
 
     return entry;
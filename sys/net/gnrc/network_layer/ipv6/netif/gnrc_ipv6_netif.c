@@ -32,6 +32,7 @@
 #include "net/gnrc/sixlowpan/nd.h"
 #include "net/gnrc/sixlowpan/netif.h"
 
+#include "net/gnrc/ipv6/dc.h"
 #include "net/gnrc/ipv6/netif.h"
 
 #define ENABLE_DEBUG    (0)
@@ -57,6 +58,16 @@ static gnrc_ipv6_netif_t ipv6_ifs[GNRC_NETIF_NUMOF];
 static char addr_str[IPV6_ADDR_MAX_STR_LEN];
 #endif
 
+/* invalidates everything derived from the addresses of an interface */
+static inline void _addrs_changed(gnrc_ipv6_netif_t *entry)
+{
+    entry->src_cand_valid = false;
+    entry->src_rank_valid = 0;
+#ifdef MODULE_GNRC_IPV6_DC
+    gnrc_ipv6_dc_flush();
+#endif
+}
+
 static ipv6_addr_t *_add_addr_to_entry(gnrc_ipv6_netif_t *entry, const ipv6_addr_t *addr,
                                        uint8_t prefix_len, uint8_t flags)
 {
@@ -153,6 +164,9 @@ static ipv6_addr_t *_add_addr_to_entry(gnrc_ipv6_netif_t *entry, const ipv6_addr
 
     tmp_addr->valid_timeout_msg.type = GNRC_NDP_MSG_ADDR_TIMEOUT;
     tmp_addr->valid_timeout_msg.content.ptr = (char *) &tmp_addr->addr;
+    /* the address is complete only now, it might have been ranked while the
+     * mutex was unlocked above */
+    _addrs_changed(entry);
 
     return &(tmp_addr->addr);
 }
@@ -161,6 +175,7 @@ static void _reset_addr_from_entry(gnrc_ipv6_netif_t *entry)
 {
     DEBUG("ipv6 netif: Reset IPv6 addresses on interface %" PRIkernel_pid "\n", entry->pid);
     memset(entry->addrs, 0, sizeof(entry->addrs));
+    _addrs_changed(entry);
 }
 
 void gnrc_ipv6_netif_init(void)
@@ -317,6 +332,7 @@ static void _remove_addr_from_entry(gnrc_ipv6_netif_t *entry, ipv6_addr_t *addr)
                   ipv6_addr_to_str(addr_str, addr, sizeof(addr_str)), entry->pid);
             ipv6_addr_set_unspecified(&(entry->addrs[i].addr));
             entry->addrs[i].flags = 0;
+            _addrs_changed(entry);
 #ifdef MODULE_GNRC_NDP_ROUTER
             /* Removal of prefixes MAY allow the router to retransmit up to
              * GNRC_NDP_MAX_INIT_RTR_ADV_NUMOF unsolicited RA
@@ -377,6 +393,21 @@ void gnrc_ipv6_netif_reset_addr(kernel_pid_t pid)
     mutex_unlock(&entry->mutex);
 }
 
+void gnrc_ipv6_netif_addr_changed(kernel_pid_t pid)
+{
+    gnrc_ipv6_netif_t *entry = gnrc_ipv6_netif_get(pid);
+
+    if (entry == NULL) {
+        return;
+    }
+
+    mutex_lock(&entry->mutex);
+
+    _addrs_changed(entry);
+
+    mutex_unlock(&entry->mutex);
+}
+
 kernel_pid_t gnrc_ipv6_netif_find_by_addr(ipv6_addr_t **out, const ipv6_addr_t *addr)
 {
     for (int i = 0; i < GNRC_NETIF_NUMOF; i++) {
@@ -536,29 +567,25 @@ kernel_pid_t gnrc_ipv6_netif_find_by_prefix(ipv6_addr_t **out, const ipv6_addr_t
  * @see <a href="http://tools.ietf.org/html/rfc6724#section-4">
  *      RFC6724, section 4
  *      </a>
- * @param[in]  iface            the interface used for sending
- * @param[in]  dst              the destination address
- * @param[out] candidate_set    a bitfield representing all addresses
- *                              configured to @p iface, potential candidates
- *                              will be marked as 1
  *
- * @return false if no candidates were found
- * @return true otherwise
+ * Fills gnrc_ipv6_netif_t::src_cand and gnrc_ipv6_netif_t::src_last_cand of
+ * @p iface.
+ *
+ * @param[in]  iface            the interface used for sending
  *
  * @pre the interface entry and its set of addresses must not be changed during
  *      runtime of this function
  */
-static int _create_candidate_set(gnrc_ipv6_netif_t *iface, const ipv6_addr_t *dst,
-                                 uint8_t *candidate_set)
+static void _create_candidate_set(gnrc_ipv6_netif_t *iface)
 {
-    int res = -1;
-
     DEBUG("gathering candidates\n");
 
+    memset(iface->src_cand, 0, sizeof(iface->src_cand));
+    iface->src_last_cand = -1;
+
     /* currently this implementation supports only addresses as source address
      * candidates assigned to this interface. Thus we assume all addresses to be
      * on interface @p iface */
-    (void) dst;
 
     for (int i = 0; i < GNRC_IPV6_NETIF_ADDR_NUMOF; i++) {
         gnrc_ipv6_netif_addr_t *iter = &(iface->addrs[i]);
@@ -587,11 +614,9 @@ static int _create_candidate_set(gnrc_ipv6_netif_t *iface, const ipv6_addr_t *ds
 
         /* put all other addresses into the candidate set */
         DEBUG("add to candidate set\n");
-        bf_set(candidate_set, i);
-        res = i;
+        bf_set(iface->src_cand, i);
+        iface->src_last_cand = i;
     }
-
-    return res;
 }
 
 ipv6_addr_t *gnrc_ipv6_netif_match_prefix(kernel_pid_t pid, const ipv6_addr_t *prefix)
@@ -639,25 +664,23 @@ static uint8_t _get_scope(const ipv6_addr_t *addr, const bool maybe_multicast)
     }
 }
 
-/** @brief Find the best candidate among the configured addresses
- *          for a certain destination address according to the 8 rules
- *          specified in RFC 6734, section 5.
+/**
+ * @brief Ranks the source address candidates of an interface for destinations
+ *        of a given scope according to rules 2 and 3 of RFC 6724, section 5.
  * @see <a href="http://tools.ietf.org/html/rfc6724#section-5">
  *      RFC6724, section 5
  *      </a>
  *
- * @param[in] iface              The interface for sending.
- * @param[in] dst                The destination IPv6 address.
- * @param[in, out] candidate_set The preselected set of candidate addresses as
- *                               a bitfield.
+ * Marks the candidates with the most "points" in
+ * gnrc_ipv6_netif_t::src_rank[@p dst_scope]. The remaining rules either only
+ * depend on the destination itself (1 and 8) or do not apply to gnrc (4 to 7).
  *
- * @pre @p dst is not unspecified.
+ * @param[in] iface              The interface for sending.
+ * @param[in] dst_scope          The scope of the destination address.
  *
- * @return The best matching candidate found on @p iface, may be NULL if none
- *         is found.
+ * @pre gnrc_ipv6_netif_t::src_cand of @p iface is up to date.
  */
-static ipv6_addr_t *_source_address_selection(gnrc_ipv6_netif_t *iface, const ipv6_addr_t *dst,
-                                              uint8_t *candidate_set)
+static void _rank_candidates(gnrc_ipv6_netif_t *iface, uint8_t dst_scope)
 {
     /* create temporary set for assigning "points" to candidates wining in the
      * corresponding rules.
@@ -667,53 +690,34 @@ static ipv6_addr_t *_source_address_selection(gnrc_ipv6_netif_t *iface, const ip
 
     uint8_t max_pts = 0;
 
-    /* _create_candidate_set() assures that `dest` is not unspecified and if
-     * `dst` is loopback rule 1 will fire anyway.  */
-    uint8_t dst_scope = _get_scope(dst, true);
-    DEBUG("finding the best match within the source address candidates\n");
+    DEBUG("ranking source address candidates for scope %u\n", (unsigned)dst_scope);
 
     for (int i = 0; i < GNRC_IPV6_NETIF_ADDR_NUMOF; i++) {
         gnrc_ipv6_netif_addr_t *iter = &(iface->addrs[i]);
-        DEBUG("Checking address: %s\n",
-              ipv6_addr_to_str(addr_str, &(iter->addr), sizeof(addr_str)));
         /* entries which are not  part of the candidate set can be ignored */
-        if (!(bf_isset(candidate_set, i))) {
-            DEBUG("Not part of the candidate set - skipping\n");
+        if (!(bf_isset(iface->src_cand, i))) {
             continue;
         }
 
-        /* Rule 1: if we have an address configured that equals the destination
-         * use this one as source */
-        if (ipv6_addr_equal(&(iter->addr), dst)) {
-            DEBUG("Ease one - rule 1\n");
-            return &(iter->addr);
-        }
-
         /* Rule 2: Prefer appropriate scope. */
-        /* both link local */
         uint8_t candidate_scope = _get_scope(&(iter->addr), false);
         if (candidate_scope == dst_scope) {
             DEBUG("winner for rule 2 (same scope) found\n");
             winner_set[i] += RULE_2A_PTS;
-            if (winner_set[i] > max_pts) {
-                max_pts = RULE_2A_PTS;
-            }
         }
         else if (candidate_scope < dst_scope) {
             DEBUG("winner for rule 2 (smaller scope) found\n");
             winner_set[i] += RULE_2B_PTS;
-            if (winner_set[i] > max_pts) {
-                max_pts = winner_set[i];
-            }
         }
 
         /* Rule 3: Avoid deprecated addresses. */
         if (iter->preferred > 0) {
             DEBUG("winner for rule 3 found\n");
             winner_set[i] += RULE_3_PTS;
-            if (winner_set[i] > max_pts) {
-                max_pts = winner_set[i];
-            }
+        }
+
+        if (winner_set[i] > max_pts) {
+            max_pts = winner_set[i];
         }
 
         /* Rule 4: Prefer home addresses.
@@ -744,19 +748,56 @@ static ipv6_addr_t *_source_address_selection(gnrc_ipv6_netif_t *iface, const ip
          */
     }
 
-    /* reset candidate set to mark winners */
-    memset(candidate_set, 0, (GNRC_IPV6_NETIF_ADDR_NUMOF / 8) + 1);
-    /* check if we have a clear winner */
     /* collect candidates with maximum points */
+    memset(iface->src_rank[dst_scope], 0, sizeof(iface->src_rank[dst_scope]));
     for (int i = 0; i < GNRC_IPV6_NETIF_ADDR_NUMOF; i++) {
-        if (winner_set[i] == max_pts) {
-            bf_set(candidate_set, i);
+        if (bf_isset(iface->src_cand, i) && (winner_set[i] == max_pts)) {
+            bf_set(iface->src_rank[dst_scope], i);
+        }
+    }
+    iface->src_rank_valid |= (1U << dst_scope);
+}
+
+/** @brief Find the best candidate among the configured addresses
+ *          for a certain destination address according to the 8 rules
+ *          specified in RFC 6734, section 5.
+ * @see <a href="http://tools.ietf.org/html/rfc6724#section-5">
+ *      RFC6724, section 5
+ *      </a>
+ *
+ * @param[in] iface              The interface for sending.
+ * @param[in] dst                The destination IPv6 address.
+ *
+ * @pre @p dst is not unspecified.
+ * @pre gnrc_ipv6_netif_t::src_cand of @p iface is up to date.
+ *
+ * @return The best matching candidate found on @p iface, may be NULL if none
+ *         is found.
+ */
+static ipv6_addr_t *_source_address_selection(gnrc_ipv6_netif_t *iface, const ipv6_addr_t *dst)
+{
+    /* _create_candidate_set() assures that `dest` is not unspecified and if
+     * `dst` is loopback rule 1 will fire anyway.  */
+    uint8_t dst_scope = _get_scope(dst, true);
+    DEBUG("finding the best match within the source address candidates\n");
+
+    /* Rule 1: if we have an address configured that equals the destination
+     * use this one as source */
+    for (int i = 0; i <= iface->src_last_cand; i++) {
+        if (bf_isset(iface->src_cand, i) && ipv6_addr_equal(&(iface->addrs[i].addr), dst)) {
+            DEBUG("Ease one - rule 1\n");
+            return &(iface->addrs[i].addr);
         }
     }
 
+    /* Rules 2 and 3 only depend on the scope of the destination */
+    if (!(iface->src_rank_valid & (1U << dst_scope))) {
+        _rank_candidates(iface, dst_scope);
+    }
+
     /* otherwise apply rule 8: Use longest matching prefix. */
     ipv6_addr_t *res = NULL;
-    _find_by_prefix_unsafe(&res, iface, dst, candidate_set);
+    _find_by_prefix_unsafe(&res, iface, dst, iface->src_rank[dst_scope]);
     return res;
 }
 
@@ -765,14 +806,16 @@ ipv6_addr_t *gnrc_ipv6_netif_find_best_src_addr(kernel_pid_t pid, const ipv6_add
     gnrc_ipv6_netif_t *iface = gnrc_ipv6_netif_get(pid);
     ipv6_addr_t *best_src = NULL;
     mutex_lock(&(iface->mutex));
-    BITFIELD(candidate_set, GNRC_IPV6_NETIF_ADDR_NUMOF);
-    memset(candidate_set, 0, sizeof(candidate_set));
 
-    int first_candidate = _create_candidate_set(iface, dst, candidate_set);
-    if (first_candidate >= 0) {
-        best_src = _source_address_selection(iface, dst, candidate_set);
+    if (!iface->src_cand_valid) {
+        /* addresses changed since the last call */
+        _create_candidate_set(iface);
+        iface->src_cand_valid = true;
+    }
+    if (iface->src_last_cand >= 0) {
+        best_src = _source_address_selection(iface, dst);
         if (best_src == NULL) {
-            best_src = &(iface->addrs[first_candidate].addr);
+            best_src = &(iface->addrs[iface->src_last_cand].addr);
         }
     }
     mutex_unlock(&(iface->mutex));
@@ -102,6 +102,9 @@ void gnrc_ndp_nbr_sol_handle(kernel_pid_t iface, gnrc_pktsnip_t *pkt,
 #ifdef MODULE_GNRC_SIXLOWPAN_ND_ROUTER
     ndp_opt_t *sl2a_opt = NULL;
     sixlowpan_nd_opt_ar_t *ar_opt = NULL;
+#endif
+#if defined(MODULE_GNRC_SIXLOWPAN_ND) && defined(MODULE_GNRC_SIXLOWPAN_GHC)
+    sixlowpan_nd_opt_6cio_t *cio_opt = NULL;
 #endif
     int sicmpv6_size = (int)icmpv6_size, l2src_len = 0;
     DEBUG("ndp: received neighbor solicitation (src: %s, ",
@@ -148,6 +151,12 @@ void gnrc_ndp_nbr_sol_handle(kernel_pid_t iface, gnrc_pktsnip_t *pkt,
                 ar_opt = (sixlowpan_nd_opt_ar_t *)opt;
 #endif
                 break;
+#if defined(MODULE_GNRC_SIXLOWPAN_ND) && defined(MODULE_GNRC_SIXLOWPAN_GHC)
+            case NDP_OPT_6CIO:
+                /* handled below, when the neighbor cache entry exists */
+                cio_opt = (sixlowpan_nd_opt_6cio_t *)opt;
+                break;
+#endif
             default:
                 /* silently discard all other options */
                 break;
@@ -192,6 +201,11 @@ void gnrc_ndp_nbr_sol_handle(kernel_pid_t iface, gnrc_pktsnip_t *pkt,
 #else
     _stale_nc(iface, &ipv6->src, l2src, l2src_len);
     memcpy(&nbr_adv_dst, &ipv6->src, sizeof(ipv6_addr_t));
+#endif
+#if defined(MODULE_GNRC_SIXLOWPAN_ND) && defined(MODULE_GNRC_SIXLOWPAN_GHC)
+    if (cio_opt != NULL) {
+        gnrc_sixlowpan_nd_opt_6cio_handle(iface, &ipv6->src, cio_opt);
+    }
 #endif
     gnrc_ndp_internal_send_nbr_adv(iface, tgt, &nbr_adv_dst, ipv6_addr_is_multicast(&ipv6->dst),
                                    nbr_adv_opts);
@@ -385,6 +399,9 @@ void gnrc_ndp_rtr_sol_handle(kernel_pid_t iface, gnrc_pktsnip_t *pkt,
         uint8_t l2src[GNRC_IPV6_NC_L2_ADDR_MAX];
         uint16_t opt_offset = 0;
         uint8_t *buf = (uint8_t *)(rtr_sol + 1);
+#if defined(MODULE_GNRC_SIXLOWPAN_ND) && defined(MODULE_GNRC_SIXLOWPAN_GHC)
+        sixlowpan_nd_opt_6cio_t *cio_opt = NULL;
+#endif
         /* check validity */
         if ((ipv6->hl != 255) || (rtr_sol->code != 0) ||
             (icmpv6_size < sizeof(ndp_rtr_sol_t))) {
@@ -404,6 +421,12 @@ void gnrc_ndp_rtr_sol_handle(kernel_pid_t iface, gnrc_pktsnip_t *pkt,
                         return;
                     }
                     break;
+#if defined(MODULE_GNRC_SIXLOWPAN_ND) && defined(MODULE_GNRC_SIXLOWPAN_GHC)
+                case NDP_OPT_6CIO:
+                    /* handled below, when the neighbor cache entry exists */
+                    cio_opt = (sixlowpan_nd_opt_6cio_t *)opt;
+                    break;
+#endif
 
                 default:
                     /* silently discard all other options */
@@ -420,6 +443,11 @@ void gnrc_ndp_rtr_sol_handle(kernel_pid_t iface, gnrc_pktsnip_t *pkt,
 #endif
         }
         _stale_nc(iface, &ipv6->src, l2src, l2src_len);
+#if defined(MODULE_GNRC_SIXLOWPAN_ND) && defined(MODULE_GNRC_SIXLOWPAN_GHC)
+        if (cio_opt != NULL) {
+            gnrc_sixlowpan_nd_opt_6cio_handle(iface, &ipv6->src, cio_opt);
+        }
+#endif
         /* send delayed */
         if (if_entry->flags & GNRC_IPV6_NETIF_FLAGS_RTR_ADV) {
             uint32_t delay;
@@ -486,6 +514,9 @@ void gnrc_ndp_rtr_adv_handle(kernel_pid_t iface, gnrc_pktsnip_t *pkt, ipv6_hdr_t
     uint8_t l2src[GNRC_IPV6_NC_L2_ADDR_MAX];
 #ifdef MODULE_GNRC_SIXLOWPAN_ND
     uint32_t next_rtr_sol = 0;
+#endif
+#if defined(MODULE_GNRC_SIXLOWPAN_ND) && defined(MODULE_GNRC_SIXLOWPAN_GHC)
+    sixlowpan_nd_opt_6cio_t *cio_opt = NULL;
 #endif
     int sicmpv6_size = (int)icmpv6_size, l2src_len = 0;
     uint16_t opt_offset = 0;
@@ -593,6 +624,12 @@ void gnrc_ndp_rtr_adv_handle(kernel_pid_t iface, gnrc_pktsnip_t *pkt, ipv6_hdr_t
                 gnrc_sixlowpan_nd_opt_abr_handle(iface, rtr_adv, icmpv6_size,
                                                  (sixlowpan_nd_opt_abr_t *)opt);
                 break;
+#endif
+#if defined(MODULE_GNRC_SIXLOWPAN_ND) && defined(MODULE_GNRC_SIXLOWPAN_GHC)
+            case NDP_OPT_6CIO:
+                /* handled below, when the neighbor cache entry exists */
+                cio_opt = (sixlowpan_nd_opt_6cio_t *)opt;
+                break;
 #endif
         }
 
@@ -611,6 +648,11 @@ void gnrc_ndp_rtr_adv_handle(kernel_pid_t iface, gnrc_pktsnip_t *pkt, ipv6_hdr_t
     }
 #endif
     _stale_nc(iface, &ipv6->src, l2src, l2src_len);
+#if defined(MODULE_GNRC_SIXLOWPAN_ND) && defined(MODULE_GNRC_SIXLOWPAN_GHC)
+    if (cio_opt != NULL) {
+        gnrc_sixlowpan_nd_opt_6cio_handle(iface, &ipv6->src, cio_opt);
+    }
+#endif
     /* stop multicast router solicitation retransmission timer */
     xtimer_remove(&if_entry->rtr_sol_timer);
 #ifdef MODULE_GNRC_SIXLOWPAN_ND
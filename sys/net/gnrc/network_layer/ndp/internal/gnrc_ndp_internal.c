@@ -281,6 +281,14 @@ void gnrc_ndp_internal_send_nbr_sol(kernel_pid_t iface, ipv6_addr_t *src, ipv6_a
             return;
         }
         pkt = hdr;
+#ifdef MODULE_GNRC_SIXLOWPAN_GHC
+        if ((hdr = gnrc_sixlowpan_nd_opt_6cio_build(pkt)) == NULL) {
+            DEBUG("ndp internal: error allocating 6LoWPAN capability indication option.\n");
+            gnrc_pktbuf_release(pkt);
+            return;
+        }
+        pkt = hdr;
+#endif
     }
 #endif
 
@@ -329,6 +337,18 @@ void gnrc_ndp_internal_send_rtr_sol(kernel_pid_t iface, ipv6_addr_t *dst)
             }
         }
     }
+#if defined(MODULE_GNRC_SIXLOWPAN_ND) && defined(MODULE_GNRC_SIXLOWPAN_GHC)
+    gnrc_ipv6_netif_t *ipv6_iface = gnrc_ipv6_netif_get(iface);
+
+    if ((ipv6_iface != NULL) && (ipv6_iface->flags & GNRC_IPV6_NETIF_FLAGS_SIXLOWPAN)) {
+        if ((hdr = gnrc_sixlowpan_nd_opt_6cio_build(pkt)) == NULL) {
+            DEBUG("ndp internal: error allocating 6LoWPAN capability indication option.\n");
+            gnrc_pktbuf_release(pkt);
+            return;
+        }
+        pkt = hdr;
+    }
+#endif
     hdr = gnrc_ndp_rtr_sol_build(pkt);
     if (hdr == NULL) {
         DEBUG("ndp internal: error allocating router solicitation.\n");
@@ -497,6 +517,15 @@ void gnrc_ndp_internal_send_rtr_adv(kernel_pid_t iface, ipv6_addr_t *src, ipv6_a
             }
             pkt = hdr;
         }
+#ifdef MODULE_GNRC_SIXLOWPAN_GHC
+        if ((hdr = gnrc_sixlowpan_nd_opt_6cio_build(pkt)) == NULL) {
+            DEBUG("ndp internal: error allocating 6LoWPAN capability indication option.\n");
+            mutex_unlock(&ipv6_iface->mutex);
+            gnrc_pktbuf_release(pkt);
+            return;
+        }
+        pkt = hdr;
+#endif
     }
 #endif /* MODULE_GNRC_SIXLOWPAN_ND_ROUTER */
     if (ipv6_iface->flags & GNRC_IPV6_NETIF_FLAGS_ADV_MTU) {
@@ -748,6 +777,8 @@ bool gnrc_ndp_internal_pi_opt_handle(kernel_pid_t iface, uint8_t icmpv6_type,
     /* on-link flag MUST stay set if it was */
     netif_addr->flags &= ~NDP_OPT_PI_FLAGS_A;
     netif_addr->flags |= (pi_opt->flags & NDP_OPT_PI_FLAGS_MASK);
+    /* preferred lifetime changes source address selection */
+    gnrc_ipv6_netif_addr_changed(iface);
     return true;
 }
 
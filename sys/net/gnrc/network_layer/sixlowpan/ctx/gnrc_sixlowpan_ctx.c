@@ -14,20 +14,29 @@
 
 #include <stdbool.h>
 #include <inttypes.h>
+#include <string.h>
 
+#include "irq.h"
 #include "mutex.h"
 #include "net/gnrc/sixlowpan/ctx.h"
+#include "timex.h"
 #include "xtimer.h"
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
+#define LTIME_TICK      (60U * SEC_IN_USEC)     /**< lifetimes are in minutes */
+
 static gnrc_sixlowpan_ctx_t _ctxs[GNRC_SIXLOWPAN_CTX_SIZE];
-static uint32_t _ctx_inval_times[GNRC_SIXLOWPAN_CTX_SIZE];
+/* IDs of the registered contexts, longest prefix first */
+static uint8_t _order[GNRC_SIXLOWPAN_CTX_SIZE];
+static uint8_t _order_len;
 static mutex_t _ctx_mutex = MUTEX_INIT;
+static uint16_t _generation;
+static xtimer_t _ltime_timer;
+static bool _ltime_running;
 
-static uint32_t _current_minute(void);
-static void _update_lifetime(uint8_t id);
+static void _ltime_tick(void *arg);
 
 #if ENABLE_DEBUG
 static char ipv6str[IPV6_ADDR_MAX_STR_LEN];
@@ -35,25 +44,100 @@ static char ipv6str[IPV6_ADDR_MAX_STR_LEN];
 
 static inline bool _valid(uint8_t id)
 {
-    _update_lifetime(id);
     return (_ctxs[id].prefix_len > 0);
 }
 
+/* the prefix of a context is stored with all bits after prefix_len unset */
+static inline bool _match(const gnrc_sixlowpan_ctx_t *ctx, const ipv6_addr_t *addr)
+{
+    uint8_t bytes = ctx->prefix_len / 8;
+    uint8_t bits = ctx->prefix_len % 8;
+
+    if (memcmp(&ctx->prefix, addr, bytes) != 0) {
+        return false;
+    }
+    return (bits == 0) ||
+           ((addr->u8[bytes] & (uint8_t)(0xff << (8 - bits))) == ctx->prefix.u8[bytes]);
+}
+
+/* may be called from the lifetime timer, so do not rely on the mutex */
+static inline void _next_generation(void)
+{
+    unsigned state = disableIRQ();
+    _generation++;
+    restoreIRQ(state);
+}
+
+static void _order_remove(uint8_t id)
+{
+    for (unsigned i = 0; i < _order_len; i++) {
+        if (_order[i] == id) {
+            _order_len--;
+            memmove(&_order[i], &_order[i + 1], _order_len - i);
+            return;
+        }
+    }
+}
+
+static void _order_add(uint8_t id)
+{
+    unsigned i = _order_len;
+
+    while ((i > 0) && (_ctxs[_order[i - 1]].prefix_len < _ctxs[id].prefix_len)) {
+        _order[i] = _order[i - 1];
+        i--;
+    }
+    _order[i] = id;
+    _order_len++;
+}
+
+/* needs interrupts disabled */
+static void _ltime_start(void)
+{
+    if (!_ltime_running) {
+        _ltime_running = true;
+        _ltime_timer.callback = _ltime_tick;
+        xtimer_set(&_ltime_timer, LTIME_TICK);
+    }
+}
+
+static void _ltime_tick(void *arg)
+{
+    bool running = false;
+
+    (void)arg;
+    for (unsigned id = 0; id < GNRC_SIXLOWPAN_CTX_SIZE; id++) {
+        if (!_valid(id) || (_ctxs[id].ltime == 0)) {
+            continue;
+        }
+        if (--_ctxs[id].ltime == 0) {
+            DEBUG("6lo ctx: context %u was invalidated for compression\n", id);
+            _ctxs[id].flags_id &= ~GNRC_SIXLOWPAN_CTX_FLAGS_COMP;
+            _next_generation();
+        }
+        else {
+            running = true;
+        }
+    }
+    _ltime_running = false;
+    if (running) {
+        _ltime_start();
+    }
+}
+
 gnrc_sixlowpan_ctx_t *gnrc_sixlowpan_ctx_lookup_addr(const ipv6_addr_t *addr)
 {
-    uint8_t best = 0;
     gnrc_sixlowpan_ctx_t *res = NULL;
 
     mutex_lock(&_ctx_mutex);
 
-    for (unsigned int id = 0; id < GNRC_SIXLOWPAN_CTX_SIZE; id++) {
-        if (_valid(id)) {
-            uint8_t match = ipv6_addr_match_prefix(&_ctxs[id].prefix, addr);
+    /* the first match is the longest one */
+    for (unsigned i = 0; i < _order_len; i++) {
+        gnrc_sixlowpan_ctx_t *ctx = &_ctxs[_order[i]];
 
-            if ((_ctxs[id].prefix_len <= match) && (match > best)) {
-                best = match;
-                res = &(_ctxs[id]);
-            }
+        if (_valid(_order[i]) && _match(ctx, addr)) {
+            res = ctx;
+            break;
         }
     }
 
@@ -61,7 +145,8 @@ gnrc_sixlowpan_ctx_t *gnrc_sixlowpan_ctx_lookup_addr(const ipv6_addr_t *addr)
 
 #if ENABLE_DEBUG
     if (res != NULL) {
-        DEBUG("6lo ctx: found context (%u, %s/%" PRIu8 ") ", res->id,
+        DEBUG("6lo ctx: found context (%u, %s/%" PRIu8 ") ",
+              res->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK,
               ipv6_addr_to_str(ipv6str, &res->prefix, sizeof(ipv6str)),
               res->prefix_len);
         DEBUG("for address %s\n", ipv6_addr_to_str(ipv6str, addr, sizeof(ipv6str)));
@@ -73,95 +158,98 @@ gnrc_sixlowpan_ctx_t *gnrc_sixlowpan_ctx_lookup_addr(const ipv6_addr_t *addr)
 
 gnrc_sixlowpan_ctx_t *gnrc_sixlowpan_ctx_lookup_id(uint8_t id)
 {
-    if (id >= GNRC_SIXLOWPAN_CTX_SIZE) {
+    if ((id >= GNRC_SIXLOWPAN_CTX_SIZE) || !_valid(id)) {
         return NULL;
     }
 
-    mutex_lock(&_ctx_mutex);
+    DEBUG("6lo ctx: found context (%u, %s/%" PRIu8 ")\n", id,
+          ipv6_addr_to_str(ipv6str, &_ctxs[id].prefix, sizeof(ipv6str)),
+          _ctxs[id].prefix_len);
 
-    if (_valid(id)) {
-        DEBUG("6lo ctx: found context (%u, %s/%" PRIu8 ")\n", id,
-              ipv6_addr_to_str(ipv6str, &_ctxs[id].prefix, sizeof(ipv6str)),
-              _ctxs[id].prefix_len);
-        mutex_unlock(&_ctx_mutex);
-        return &(_ctxs[id]);
-    }
-
-    mutex_unlock(&_ctx_mutex);
-
-    return NULL;
+    return &(_ctxs[id]);
 }
 
 gnrc_sixlowpan_ctx_t *gnrc_sixlowpan_ctx_update(uint8_t id, const ipv6_addr_t *prefix,
                                                 uint8_t prefix_len, uint16_t ltime,
                                                 bool comp)
 {
+    ipv6_addr_t tmp;
+    unsigned state;
+
     if ((id >= GNRC_SIXLOWPAN_CTX_SIZE) || (prefix_len == 0)) {
         return NULL;
     }
 
-    mutex_lock(&_ctx_mutex);
-
-    _ctxs[id].ltime = ltime;
-
     if (ltime == 0) {
         comp = false;
     }
 
     if (prefix_len > IPV6_ADDR_BIT_LEN) {
-        _ctxs[id].prefix_len = IPV6_ADDR_BIT_LEN;
-    }
-    else {
-        _ctxs[id].prefix_len = prefix_len;
+        prefix_len = IPV6_ADDR_BIT_LEN;
     }
 
-    _ctxs[id].flags_id = (comp) ? (GNRC_SIXLOWPAN_CTX_FLAGS_COMP | id) : id;
+    mutex_lock(&_ctx_mutex);
 
-    if (!ipv6_addr_equal(&(_ctxs[id].prefix), prefix)) {
-        ipv6_addr_set_unspecified(&(_ctxs[id].prefix));
-        ipv6_addr_init_prefix(&(_ctxs[id].prefix), prefix, _ctxs[id].prefix_len);
+    _order_remove(id);
+
+    /* prefix may point to the context itself */
+    ipv6_addr_set_unspecified(&tmp);
+    ipv6_addr_init_prefix(&tmp, prefix, prefix_len);
+
+    /* keep the lifetime timer and gnrc_sixlowpan_ctx_lookup_id(), which does
+     * not take the mutex, from seeing a half updated context */
+    state = disableIRQ();
+    _ctxs[id].prefix = tmp;
+    _ctxs[id].ltime = ltime;
+    _ctxs[id].prefix_len = prefix_len;
+    _ctxs[id].flags_id = (comp) ? (GNRC_SIXLOWPAN_CTX_FLAGS_COMP | id) : id;
+    if (ltime > 0) {
+        _ltime_start();
     }
+    restoreIRQ(state);
+
+    _order_add(id);
     DEBUG("6lo ctx: update context (%u, %s/%" PRIu8 "), lifetime: %" PRIu16 " min\n",
           id, ipv6_addr_to_str(ipv6str, &_ctxs[id].prefix, sizeof(ipv6str)),
           _ctxs[id].prefix_len, _ctxs[id].ltime);
-    _ctx_inval_times[id] = ltime + _current_minute();
+    _next_generation();
 
     mutex_unlock(&_ctx_mutex);
     return &(_ctxs[id]);
 }
 
-static uint32_t _current_minute(void)
+void gnrc_sixlowpan_ctx_remove(uint8_t id)
 {
-    return xtimer_now() / (SEC_IN_USEC * 60);
-}
-
-static void _update_lifetime(uint8_t id)
-{
-    uint32_t now;
-
-    if (_ctxs[id].ltime == 0) {
-        _ctxs[id].flags_id &= ~GNRC_SIXLOWPAN_CTX_FLAGS_COMP;
+    if (id >= GNRC_SIXLOWPAN_CTX_SIZE) {
         return;
     }
 
-    now = _current_minute();
+    mutex_lock(&_ctx_mutex);
+    _order_remove(id);
+    _ctxs[id].prefix_len = 0;
+    _next_generation();
+    mutex_unlock(&_ctx_mutex);
+}
 
-    if (now >= _ctx_inval_times[id]) {
-        DEBUG("6lo ctx: context %u was invalidated for compression\n", id);
-        _ctxs[id].ltime = 0;
-        _ctxs[id].flags_id &= ~GNRC_SIXLOWPAN_CTX_FLAGS_COMP;
-    }
-    else {
-        _ctxs[id].ltime = (uint16_t)(_ctx_inval_times[id] - now);
-    }
+uint16_t gnrc_sixlowpan_ctx_generation(void)
+{
+    return _generation;
 }
 
 #ifdef TEST_SUITES
-#include <string.h>
-
 void gnrc_sixlowpan_ctx_reset(void)
 {
+    unsigned state;
+
+    mutex_lock(&_ctx_mutex);
+    state = disableIRQ();
+    xtimer_remove(&_ltime_timer);
+    _ltime_running = false;
     memset(_ctxs, 0, sizeof(_ctxs));
+    _order_len = 0;
+    restoreIRQ(state);
+    _next_generation();
+    mutex_unlock(&_ctx_mutex);
 }
 #endif
 
@@ -17,8 +17,12 @@
 #include "net/gnrc/netapi.h"
 #include "net/gnrc/netif/hdr.h"
 #include "net/gnrc/sixlowpan/frag.h"
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_VRB
+#include "net/gnrc/sixlowpan/frag/vrb.h"
+#endif
 #include "net/gnrc/sixlowpan/netif.h"
 #include "net/sixlowpan.h"
+#include "thread.h"
 #include "utlist.h"
 
 #include "rbuf.h"
@@ -32,6 +36,10 @@
 #endif
 
 static uint16_t _tag;
+static gnrc_sixlowpan_frag_msg_t _frag_msg[GNRC_SIXLOWPAN_FRAG_MSG_SIZE];
+static gnrc_sixlowpan_frag_stats_t _stats;
+/* thread that handles GNRC_SIXLOWPAN_MSG_FRAG_SND */
+static kernel_pid_t _frag_pid = KERNEL_PID_UNDEF;
 
 static inline uint16_t _floor8(uint16_t length)
 {
@@ -78,7 +86,8 @@ static gnrc_pktsnip_t *_build_frag_pkt(gnrc_pktsnip_t *pkt, size_t payload_len,
 }
 
 static uint16_t _send_1st_fragment(gnrc_sixlowpan_netif_t *iface, gnrc_pktsnip_t *pkt,
-                                   size_t payload_len, size_t datagram_size)
+                                   size_t payload_len, size_t datagram_size,
+                                   uint16_t tag)
 {
     gnrc_pktsnip_t *frag;
     uint16_t local_offset = 0;
@@ -106,7 +115,7 @@ static uint16_t _send_1st_fragment(gnrc_sixlowpan_netif_t *iface, gnrc_pktsnip_t
 
     hdr->disp_size = byteorder_htons((uint16_t)datagram_size);
     hdr->disp_size.u8[0] |= SIXLOWPAN_FRAG_1_DISP;
-    hdr->tag = byteorder_htons(_tag);
+    hdr->tag = byteorder_htons(tag);
 
     pkt = pkt->next;    /* don't copy netif header */
 
@@ -125,7 +134,7 @@ static uint16_t _send_1st_fragment(gnrc_sixlowpan_netif_t *iface, gnrc_pktsnip_t
 
     DEBUG("6lo frag: send first fragment (datagram size: %u, "
           "datagram tag: %" PRIu16 ", fragment size: %" PRIu16 ")\n",
-          (unsigned int)datagram_size, _tag, local_offset);
+          (unsigned int)datagram_size, tag, local_offset);
     if (gnrc_netapi_send(iface->pid, frag) < 1) {
         DEBUG("6lo frag: unable to send first fragment\n");
         gnrc_pktbuf_release(frag);
@@ -136,7 +145,7 @@ static uint16_t _send_1st_fragment(gnrc_sixlowpan_netif_t *iface, gnrc_pktsnip_t
 
 static uint16_t _send_nth_fragment(gnrc_sixlowpan_netif_t *iface, gnrc_pktsnip_t *pkt,
                                    size_t payload_len, size_t datagram_size,
-                                   uint16_t offset)
+                                   uint16_t offset, uint16_t tag)
 {
     gnrc_pktsnip_t *frag;
     /* since dispatches aren't supposed to go into subsequent fragments, we need not account
@@ -162,7 +171,7 @@ static uint16_t _send_nth_fragment(gnrc_sixlowpan_netif_t *iface, gnrc_pktsnip_t
     /* XXX: truncation of datagram_size > 4095 may happen here */
     hdr->disp_size = byteorder_htons((uint16_t)datagram_size);
     hdr->disp_size.u8[0] |= SIXLOWPAN_FRAG_N_DISP;
-    hdr->tag = byteorder_htons(_tag);
+    hdr->tag = byteorder_htons(tag);
     /* don't mention payload diff in offset */
     hdr->offset = (uint8_t)((offset + (datagram_size - payload_len)) >> 3);
     pkt = pkt->next;    /* don't copy netif header */
@@ -202,7 +211,7 @@ static uint16_t _send_nth_fragment(gnrc_sixlowpan_netif_t *iface, gnrc_pktsnip_t
     DEBUG("6lo frag: send subsequent fragment (datagram size: %u, "
           "datagram tag: %" PRIu16 ", offset: %" PRIu8 " (%u bytes), "
           "fragment size: %" PRIu16 ")\n",
-          (unsigned int)datagram_size, _tag, hdr->offset, hdr->offset << 3,
+          (unsigned int)datagram_size, tag, hdr->offset, hdr->offset << 3,
           local_offset);
     if (gnrc_netapi_send(iface->pid, frag) < 1) {
         DEBUG("6lo frag: unable to send subsequent fragment\n");
@@ -212,51 +221,129 @@ static uint16_t _send_nth_fragment(gnrc_sixlowpan_netif_t *iface, gnrc_pktsnip_t
     return local_offset;
 }
 
-void gnrc_sixlowpan_frag_send(kernel_pid_t pid, gnrc_pktsnip_t *pkt,
-                              size_t datagram_size)
+/* sends the next fragment of a datagram, returns true if more are left */
+static bool _send_fragment(gnrc_sixlowpan_frag_msg_t *frag)
 {
-    gnrc_sixlowpan_netif_t *iface = gnrc_sixlowpan_netif_get(pid);
-    uint16_t offset = 0, res;
+    gnrc_sixlowpan_netif_t *iface = gnrc_sixlowpan_netif_get(frag->pid);
     /* payload_len: actual size of the packet vs
      * datagram_size: size of the uncompressed IPv6 packet */
-    size_t payload_len = gnrc_pkt_len(pkt->next);
+    size_t payload_len = gnrc_pkt_len(frag->pkt->next);
+    uint16_t res;
 
-#if defined(DEVELHELP) && defined(ENABLE_DEBUG)
     if (iface == NULL) {
-        DEBUG("6lo frag: iface == NULL, expect segmentation fault.\n");
-        gnrc_pktbuf_release(pkt);
-        return;
+        DEBUG("6lo frag: interface %" PRIkernel_pid " is gone\n", frag->pid);
+        return false;
+    }
+
+    if (frag->offset == 0) {
+        res = _send_1st_fragment(iface, frag->pkt, payload_len, frag->datagram_size,
+                                 frag->tag);
+    }
+    else {
+        res = _send_nth_fragment(iface, frag->pkt, payload_len, frag->datagram_size,
+                                 frag->offset, frag->tag);
+    }
+
+    if (res == 0) {
+        DEBUG("6lo frag: error sending fragment (offset = %" PRIu16 ")\n",
+              frag->offset);
+        return false;
+    }
+
+    _stats.fragments++;
+    frag->offset += res;
+
+    /* (offset + (datagram_size - payload_len) < datagram_size) simplified */
+    return (frag->offset < payload_len);
+}
+
+#if GNRC_SIXLOWPAN_FRAG_GAP
+static void _gap_cb(void *arg)
+{
+    gnrc_sixlowpan_frag_msg_t *frag = arg;
+
+    if (msg_send_int(&frag->msg, _frag_pid) != 1) {
+        /* message queue is full, try again later */
+        xtimer_set(&frag->timer, GNRC_SIXLOWPAN_FRAG_GAP);
     }
+}
 #endif
 
-    if ((res = _send_1st_fragment(iface, pkt, payload_len, datagram_size)) == 0) {
-        /* error sending first fragment */
-        DEBUG("6lo frag: error sending 1st fragment\n");
+/* schedules the next fragment, returns false if it must be sent right away */
+static bool _schedule(gnrc_sixlowpan_frag_msg_t *frag)
+{
+#if GNRC_SIXLOWPAN_FRAG_GAP
+    frag->timer.callback = _gap_cb;
+    frag->timer.arg = frag;
+    xtimer_set(&frag->timer, GNRC_SIXLOWPAN_FRAG_GAP);
+    return true;
+#else
+    return (msg_send_to_self(&frag->msg) == 1);
+#endif
+}
+
+void gnrc_sixlowpan_frag_send(kernel_pid_t pid, gnrc_pktsnip_t *pkt,
+                              size_t datagram_size)
+{
+    gnrc_sixlowpan_frag_msg_t *frag = NULL, tmp;
+
+    for (unsigned i = 0; i < GNRC_SIXLOWPAN_FRAG_MSG_SIZE; i++) {
+        if (_frag_msg[i].pkt == NULL) {
+            frag = &_frag_msg[i];
+            break;
+        }
+    }
+
+    if (frag == NULL) {
+        DEBUG("6lo frag: too many datagrams in flight, send in one go\n");
+        frag = &tmp;
+        _stats.sync++;
+    }
+
+    frag->pkt = pkt;
+    frag->datagram_size = datagram_size;
+    frag->offset = 0;
+    frag->tag = _tag++;
+    frag->pid = pid;
+    frag->msg.type = GNRC_SIXLOWPAN_MSG_FRAG_SND;
+    frag->msg.content.ptr = (char *)frag;
+    _stats.datagrams++;
+
+    if (frag == &tmp) {
+        while (_send_fragment(frag)) {}
         gnrc_pktbuf_release(pkt);
         return;
     }
 
-    offset += res;
-    thread_yield();
+    _frag_pid = thread_getpid();
+    if (++_stats.in_flight > _stats.in_flight_max) {
+        _stats.in_flight_max = _stats.in_flight;
+    }
+    gnrc_sixlowpan_frag_send_next(frag);
+}
 
-    /* (offset + (datagram_size - payload_len) < datagram_size) simplified */
-    while (offset < payload_len) {
-        if ((res = _send_nth_fragment(iface, pkt, payload_len, datagram_size,
-                                      offset)) == 0) {
-            /* error sending subsequent fragment */
-            DEBUG("6lo frag: error sending subsequent fragment (offset = %" PRIu16
-                  ")\n", offset);
-            gnrc_pktbuf_release(pkt);
+void gnrc_sixlowpan_frag_send_next(gnrc_sixlowpan_frag_msg_t *frag)
+{
+    if (frag->pkt == NULL) {
+        return;
+    }
+
+    while (_send_fragment(frag)) {
+        if (_schedule(frag)) {
             return;
         }
-
-        offset += res;
-        thread_yield();
+        /* message queue is full: no one is waiting for the thread anyway */
     }
 
     /* remove original packet from packet buffer */
-    gnrc_pktbuf_release(pkt);
-    _tag++;
+    gnrc_pktbuf_release(frag->pkt);
+    frag->pkt = NULL;
+    _stats.in_flight--;
+}
+
+const gnrc_sixlowpan_frag_stats_t *gnrc_sixlowpan_frag_stats(void)
+{
+    return &_stats;
 }
 
 void gnrc_sixlowpan_frag_handle_pkt(gnrc_pktsnip_t *pkt)
@@ -283,9 +370,30 @@ void gnrc_sixlowpan_frag_handle_pkt(gnrc_pktsnip_t *pkt)
             return;
     }
 
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_VRB
+    /* datagrams that are already reassembled here stay here */
+    if (((offset > 0) ||
+         !rbuf_exists(hdr, byteorder_ntohs(frag->disp_size) & SIXLOWPAN_FRAG_SIZE_MASK,
+                      byteorder_ntohs(frag->tag))) &&
+        gnrc_sixlowpan_frag_vrb_forward(pkt, frag_size, offset)) {
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+#endif
+
     rbuf_add(hdr, pkt, frag_size, offset);
 
     gnrc_pktbuf_release(pkt);
 }
 
+uint16_t gnrc_sixlowpan_frag_next_tag(void)
+{
+    return _tag++;
+}
+
+void gnrc_sixlowpan_frag_gc_rbuf(void)
+{
+    rbuf_gc();
+}
+
 /** @} */
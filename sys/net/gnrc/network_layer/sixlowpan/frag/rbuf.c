@@ -33,10 +33,27 @@
 #define RBUF_INT_SIZE   (GNRC_IPV6_NETIF_DEFAULT_MTU * RBUF_SIZE / 127)
 #endif
 
+#define RBUF_TIMEOUT_USEC   (RBUF_TIMEOUT * SEC_IN_USEC)
+
 static rbuf_int_t rbuf_int[RBUF_INT_SIZE];
 
 static rbuf_t rbuf[RBUF_SIZE];
 
+/* hash buckets of used entries, chained by rbuf_t::next */
+static rbuf_t *_buckets[RBUF_BUCKETS];
+/* free entries, chained by rbuf_t::next */
+static rbuf_t *_free;
+/* used entries, least recently updated first */
+static rbuf_t *_age;
+/* free intervals, chained by rbuf_int_t::next */
+static rbuf_int_t *_free_ints;
+
+/* timer for garbage collection of timed out entries */
+static xtimer_t _gc_timer;
+static msg_t _gc_msg = { .type = GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF };
+static kernel_pid_t _gc_pid = KERNEL_PID_UNDEF;
+static volatile bool _gc_armed = false;
+
 #if ENABLE_DEBUG
 static char l2addr_str[3 * RBUF_L2ADDR_MAX_LEN];
 #endif
@@ -44,16 +61,27 @@ static char l2addr_str[3 * RBUF_L2ADDR_MAX_LEN];
 /* ------------------------------------
  * internal function definitions
  * ------------------------------------*/
-/* checks whether start and end are in given interval i */
-static inline bool _rbuf_int_in(rbuf_int_t *i, uint16_t start, uint16_t end);
-/* gets a free entry from interval buffer */
-static rbuf_int_t *_rbuf_int_get_free(void);
-/* remove entry from reassembly buffer */
+/* initializes the free lists on first use */
+static void _rbuf_init(void);
+/* gets the hash bucket for an entry identified by its tupel */
+static inline rbuf_t **_rbuf_bucket(const uint8_t *src, size_t src_len,
+                                    const uint8_t *dst, size_t dst_len,
+                                    size_t size, uint16_t tag);
+/* remove entry from reassembly buffer, rbuf_t::pkt must still be valid */
 static void _rbuf_rem(rbuf_t *entry);
-/* update interval buffer of entry */
-static bool _rbuf_update_ints(rbuf_t *entry, uint16_t offset, size_t frag_size);
-/* checks timeouts and removes entries if necessary (oldest if full) */
-static void _rbuf_gc(void);
+/* remove entry from reassembly buffer and release its packet */
+static void _rbuf_drop(rbuf_t *entry);
+/* update interval buffer of entry, returns -1 on overlap and if no interval
+ * is left */
+static int _rbuf_update_ints(rbuf_t *entry, uint16_t offset, size_t frag_size);
+/* schedules garbage collection for the oldest entry */
+static void _rbuf_gc_arm(uint32_t now);
+/* timer callback, sends the garbage collection message */
+static void _rbuf_gc_timeout(void *arg);
+/* finds an existing entry identified by its tupel */
+static rbuf_t *_rbuf_find(rbuf_t **bucket, const void *src, size_t src_len,
+                          const void *dst, size_t dst_len,
+                          size_t size, uint16_t tag);
 /* gets an entry identified by its tupel */
 static rbuf_t *_rbuf_get(const void *src, size_t src_len,
                          const void *dst, size_t dst_len,
@@ -67,10 +95,8 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
     /* cppcheck-suppress variableScope */
     unsigned int data_offset = 0;
     sixlowpan_frag_t *frag = pkt->data;
-    rbuf_int_t *ptr;
     uint8_t *data = ((uint8_t *)pkt->data) + sizeof(sixlowpan_frag_t);
 
-    _rbuf_gc();
     entry = _rbuf_get(gnrc_netif_hdr_get_src_addr(netif_hdr), netif_hdr->src_l2addr_len,
                       gnrc_netif_hdr_get_dst_addr(netif_hdr), netif_hdr->dst_l2addr_len,
                       byteorder_ntohs(frag->disp_size) & SIXLOWPAN_FRAG_SIZE_MASK,
@@ -81,8 +107,6 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
         return;
     }
 
-    ptr = entry->ints;
-
     /* dispatches in the first fragment are ignored */
     if (offset == 0) {
         if (data[0] == SIXLOWPAN_UNCOMP) {
@@ -91,19 +115,20 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
         }
 #ifdef MODULE_GNRC_SIXLOWPAN_IPHC
         else if (sixlowpan_iphc_is(data)) {
-            size_t iphc_len;
+            size_t iphc_len, nh_len;
             iphc_len = gnrc_sixlowpan_iphc_decode(entry->pkt, pkt, entry->pkt->size,
-                                                  sizeof(sixlowpan_frag_t));
+                                                  sizeof(sixlowpan_frag_t), &nh_len);
             if (iphc_len == 0) {
                 DEBUG("6lo rfrag: could not decode IPHC dispatch\n");
-                gnrc_pktbuf_release(entry->pkt);
-                _rbuf_rem(entry);
+                _rbuf_drop(entry);
                 return;
             }
             data += iphc_len;       /* take remaining data as data */
             frag_size -= iphc_len;  /* and reduce frag size by IPHC dispatch length */
-            frag_size += sizeof(ipv6_hdr_t);    /* but add IPv6 header length */
-            data_offset += sizeof(ipv6_hdr_t);  /* start copying after IPv6 header */
+            /* but add length of decompressed headers */
+            frag_size += sizeof(ipv6_hdr_t) + nh_len;
+            /* start copying after decompressed headers */
+            data_offset += sizeof(ipv6_hdr_t) + nh_len;
         }
 #endif
     }
@@ -113,28 +138,20 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
 
     if ((offset + frag_size) > entry->pkt->size) {
         DEBUG("6lo rfrag: fragment too big for resulting datagram, discarding datagram\n");
-        gnrc_pktbuf_release(entry->pkt);
-        _rbuf_rem(entry);
+        _rbuf_drop(entry);
         return;
     }
 
-    while (ptr != NULL) {
-        if (_rbuf_int_in(ptr, offset, offset + frag_size - 1)) {
-            DEBUG("6lo rfrag: overlapping or same intervals, discarding datagram\n");
-            gnrc_pktbuf_release(entry->pkt);
-            _rbuf_rem(entry);
-            return;
-        }
-
-        ptr = ptr->next;
+    if (_rbuf_update_ints(entry, offset, frag_size) < 0) {
+        /* the datagram can not be completed anymore */
+        _rbuf_drop(entry);
+        return;
     }
 
-    if (_rbuf_update_ints(entry, offset, frag_size)) {
-        DEBUG("6lo rbuf: add fragment data\n");
-        entry->cur_size += (uint16_t)frag_size;
-        memcpy(((uint8_t *)entry->pkt->data) + offset + data_offset, data,
-               frag_size - data_offset);
-    }
+    DEBUG("6lo rbuf: add fragment data\n");
+    entry->cur_size += (uint16_t)frag_size;
+    memcpy(((uint8_t *)entry->pkt->data) + offset + data_offset, data,
+           frag_size - data_offset);
 
     if (entry->cur_size == entry->pkt->size) {
         gnrc_pktsnip_t *netif = gnrc_netif_hdr_build(entry->src, entry->src_len,
@@ -142,8 +159,7 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
 
         if (netif == NULL) {
             DEBUG("6lo rbuf: error allocating netif header\n");
-            gnrc_pktbuf_release(entry->pkt);
-            _rbuf_rem(entry);
+            _rbuf_drop(entry);
             return;
         }
 
@@ -158,165 +174,272 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
         new_netif_hdr->rssi = netif_hdr->rssi;
         LL_APPEND(entry->pkt, netif);
 
+        /* the receivers own the packet once it is dispatched */
+        gnrc_pktsnip_t *reass = entry->pkt;
+        _rbuf_rem(entry);
+
         if (!gnrc_netapi_dispatch_receive(GNRC_NETTYPE_IPV6, GNRC_NETREG_DEMUX_CTX_ALL,
-                                          entry->pkt)) {
+                                          reass)) {
             DEBUG("6lo rbuf: No receivers for this packet found\n");
-            gnrc_pktbuf_release(entry->pkt);
+            gnrc_pktbuf_release(reass);
         }
-
-        _rbuf_rem(entry);
     }
 }
 
-static inline bool _rbuf_int_in(rbuf_int_t *i, uint16_t start, uint16_t end)
+bool rbuf_exists(gnrc_netif_hdr_t *netif_hdr, size_t size, uint16_t tag)
 {
-    return (((i->start < start) && (start <= i->end)) ||
-            ((start < i->start) && (i->start <= end)) ||
-            ((i->start == start) && (i->end == end)));
+    uint8_t *src = gnrc_netif_hdr_get_src_addr(netif_hdr);
+    uint8_t *dst = gnrc_netif_hdr_get_dst_addr(netif_hdr);
+    rbuf_t **bucket = _rbuf_bucket(src, netif_hdr->src_l2addr_len,
+                                   dst, netif_hdr->dst_l2addr_len, size, tag);
+
+    return _rbuf_find(bucket, src, netif_hdr->src_l2addr_len,
+                      dst, netif_hdr->dst_l2addr_len, size, tag) != NULL;
 }
 
-static rbuf_int_t *_rbuf_int_get_free(void)
+void rbuf_gc(void)
 {
+    uint32_t now = xtimer_now();
+
+    _gc_armed = false;
+    /* entries are sorted by age, so stop at the first one still alive */
+    while ((_age != NULL) && ((now - _age->arrival) >= RBUF_TIMEOUT_USEC)) {
+        DEBUG("6lo rfrag: entry (%s, ", gnrc_netif_addr_to_str(l2addr_str,
+                sizeof(l2addr_str), _age->src, _age->src_len));
+        DEBUG("%s, %u, %u) timed out\n",
+              gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str), _age->dst,
+                                     _age->dst_len),
+              (unsigned)_age->pkt->size, _age->tag);
+
+        _rbuf_drop(_age);
+    }
+    _rbuf_gc_arm(now);
+}
+
+static void _rbuf_init(void)
+{
+    static bool initialized = false;
+
+    if (initialized) {
+        return;
+    }
+    for (unsigned int i = 0; i < RBUF_SIZE; i++) {
+        LL_PREPEND(_free, &rbuf[i]);
+    }
     for (unsigned int i = 0; i < RBUF_INT_SIZE; i++) {
-        if (rbuf_int[i].end == 0) { /* start must be smaller than end anyways*/
-            return rbuf_int + i;
-        }
+        LL_PREPEND(_free_ints, &rbuf_int[i]);
     }
+    initialized = true;
+}
 
-    return NULL;
+static inline rbuf_t **_rbuf_bucket(const uint8_t *src, size_t src_len,
+                                    const uint8_t *dst, size_t dst_len,
+                                    size_t size, uint16_t tag)
+{
+    unsigned int hash = tag ^ size;
+
+    for (size_t i = 0; i < src_len; i++) {
+        hash = (hash * 31) ^ src[i];
+    }
+    for (size_t i = 0; i < dst_len; i++) {
+        hash = (hash * 31) ^ dst[i];
+    }
+
+    return &_buckets[(hash ^ (hash >> 8)) & (RBUF_BUCKETS - 1)];
 }
 
 static void _rbuf_rem(rbuf_t *entry)
 {
+    rbuf_t **bucket = _rbuf_bucket(entry->src, entry->src_len,
+                                   entry->dst, entry->dst_len,
+                                   entry->pkt->size, entry->tag);
+
     while (entry->ints != NULL) {
         rbuf_int_t *next = entry->ints->next;
 
-        entry->ints->start = 0;
-        entry->ints->end = 0;
-        entry->ints->next = NULL;
+        LL_PREPEND(_free_ints, entry->ints);
         entry->ints = next;
     }
 
+    LL_DELETE(*bucket, entry);
+    DL_DELETE2(_age, entry, age_prev, age_next);
     entry->pkt = NULL;
+    LL_PREPEND(_free, entry);
 }
 
-static bool _rbuf_update_ints(rbuf_t *entry, uint16_t offset, size_t frag_size)
+static void _rbuf_drop(rbuf_t *entry)
 {
-    rbuf_int_t *new;
-    uint16_t end = (uint16_t)(offset + frag_size - 1);
+    gnrc_pktsnip_t *pkt = entry->pkt;
 
-    new = _rbuf_int_get_free();
+    _rbuf_rem(entry);
+    gnrc_pktbuf_release(pkt);
+}
+
+static int _rbuf_update_ints(rbuf_t *entry, uint16_t offset, size_t frag_size)
+{
+    rbuf_int_t *prev = NULL, *next = entry->ints;
+    uint16_t end = (uint16_t)(offset + frag_size - 1);
 
-    if (new == NULL) {
-        DEBUG("6lo rfrag: no space left in rbuf interval buffer.\n");
-        return false;
+    /* find the first interval not ending before the new one */
+    while ((next != NULL) && (next->end < offset)) {
+        prev = next;
+        next = next->next;
     }
 
-    new->start = offset;
-    new->end = end;
+    if ((next != NULL) && (next->start <= end)) {
+        DEBUG("6lo rfrag: overlapping or same intervals, discarding datagram\n");
+        return -1;
+    }
 
     DEBUG("6lo rfrag: add interval (%" PRIu16 ", %" PRIu16 ") to entry (%s, ",
-          new->start, new->end, gnrc_netif_addr_to_str(l2addr_str,
+          offset, end, gnrc_netif_addr_to_str(l2addr_str,
                   sizeof(l2addr_str), entry->src, entry->src_len));
     DEBUG("%s, %u, %u)\n", gnrc_netif_addr_to_str(l2addr_str,
             sizeof(l2addr_str), entry->dst, entry->dst_len),
           (unsigned)entry->pkt->size, entry->tag);
 
-    LL_PREPEND(entry->ints, new);
-
-    return true;
-}
-
-static void _rbuf_gc(void)
-{
-    rbuf_t *oldest = NULL;
-    uint32_t now_sec = xtimer_now() / SEC_IN_USEC;
-    unsigned int i;
+    if ((prev != NULL) && ((prev->end + 1) == offset)) {
+        if ((next != NULL) && ((end + 1) == next->start)) {
+            /* closes the gap between prev and next */
+            prev->end = next->end;
+            prev->next = next->next;
+            LL_PREPEND(_free_ints, next);
+        }
+        else {
+            prev->end = end;
+        }
+    }
+    else if ((next != NULL) && ((end + 1) == next->start)) {
+        next->start = offset;
+    }
+    else {
+        rbuf_int_t *new = _free_ints;
 
-    for (i = 0; i < RBUF_SIZE; i++) {
-        if (rbuf[i].pkt == NULL) { /* leave GC early if there is still room */
-            return;
+        if (new == NULL) {
+            DEBUG("6lo rfrag: no space left in rbuf interval buffer.\n");
+            return -1;
         }
-        else if ((rbuf[i].pkt != NULL) &&
-                 ((now_sec - rbuf[i].arrival) > RBUF_TIMEOUT)) {
-            DEBUG("6lo rfrag: entry (%s, ", gnrc_netif_addr_to_str(l2addr_str,
-                    sizeof(l2addr_str), rbuf[i].src, rbuf[i].src_len));
-            DEBUG("%s, %u, %u) timed out\n",
-                  gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str), rbuf[i].dst,
-                                         rbuf[i].dst_len),
-                  (unsigned)rbuf[i].pkt->size, rbuf[i].tag);
-
-            gnrc_pktbuf_release(rbuf[i].pkt);
-            _rbuf_rem(&(rbuf[i]));
+        _free_ints = new->next;
+        new->start = offset;
+        new->end = end;
+        new->next = next;
+        if (prev == NULL) {
+            entry->ints = new;
         }
-        else if ((oldest == NULL) || (rbuf[i].arrival < oldest->arrival)) {
-            oldest = &(rbuf[i]);
+        else {
+            prev->next = new;
         }
     }
 
-    if ((i >= RBUF_SIZE) && (oldest != NULL) && (oldest->pkt != NULL)) {
-        DEBUG("6lo rfrag: reassembly buffer full, remove oldest entry\n");
-        gnrc_pktbuf_release(oldest->pkt);
-        _rbuf_rem(oldest);
+    return 0;
+}
+
+static void _rbuf_gc_arm(uint32_t now)
+{
+    uint32_t age;
+
+    if (_gc_armed || (_age == NULL)) {
+        return;
     }
+    /* if the oldest entry gets updated in the meantime, the timer fires too
+     * early and is just set again */
+    age = now - _age->arrival;
+    _gc_armed = true;
+    _gc_pid = thread_getpid();
+    _gc_timer.callback = _rbuf_gc_timeout;
+    _gc_timer.arg = NULL;
+    xtimer_set(&_gc_timer, (age < RBUF_TIMEOUT_USEC) ? (RBUF_TIMEOUT_USEC - age) : 0);
 }
 
-static rbuf_t *_rbuf_get(const void *src, size_t src_len,
-                         const void *dst, size_t dst_len,
-                         size_t size, uint16_t tag)
+static void _rbuf_gc_timeout(void *arg)
 {
-    rbuf_t *res = NULL;
-    uint32_t now_sec = xtimer_now() / SEC_IN_USEC;
+    (void)arg;
+    if (msg_send_int(&_gc_msg, _gc_pid) <= 0) {
+        /* the message queue is full, so rbuf_gc() will not run: let the next
+         * fragment arm the timer again */
+        DEBUG("6lo rfrag: unable to send garbage collection message\n");
+        _gc_armed = false;
+    }
+}
 
-    for (unsigned int i = 0; i < RBUF_SIZE; i++) {
-        /* check first if entry already available */
-        if ((rbuf[i].pkt != NULL) && (rbuf[i].pkt->size == size) &&
-            (rbuf[i].tag == tag) && (rbuf[i].src_len == src_len) &&
-            (rbuf[i].dst_len == dst_len) &&
-            (memcmp(rbuf[i].src, src, src_len) == 0) &&
-            (memcmp(rbuf[i].dst, dst, dst_len) == 0)) {
-            DEBUG("6lo rfrag: entry %p (%s, ", (void *)(&rbuf[i]),
+static rbuf_t *_rbuf_find(rbuf_t **bucket, const void *src, size_t src_len,
+                          const void *dst, size_t dst_len,
+                          size_t size, uint16_t tag)
+{
+    rbuf_t *res;
+
+    LL_FOREACH(*bucket, res) {
+        if ((res->pkt->size == size) && (res->tag == tag) &&
+            (res->src_len == src_len) && (res->dst_len == dst_len) &&
+            (memcmp(res->src, src, src_len) == 0) &&
+            (memcmp(res->dst, dst, dst_len) == 0)) {
+            DEBUG("6lo rfrag: entry %p (%s, ", (void *)res,
                   gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str),
-                                         rbuf[i].src, rbuf[i].src_len));
+                                         res->src, res->src_len));
             DEBUG("%s, %u, %u) found\n",
                   gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str),
-                                         rbuf[i].dst, rbuf[i].dst_len),
-                  (unsigned)rbuf[i].pkt->size, rbuf[i].tag);
-            rbuf[i].arrival = now_sec;
-            return &(rbuf[i]);
+                                         res->dst, res->dst_len),
+                  (unsigned)res->pkt->size, res->tag);
+            return res;
         }
+    }
 
-        /* if there is a free spot: remember it */
-        if ((res == NULL) && (rbuf[i].pkt == NULL)) {
-            res = &(rbuf[i]);
-        }
+    return NULL;
+}
+
+static rbuf_t *_rbuf_get(const void *src, size_t src_len,
+                         const void *dst, size_t dst_len,
+                         size_t size, uint16_t tag)
+{
+    rbuf_t *res;
+    rbuf_t **bucket = _rbuf_bucket(src, src_len, dst, dst_len, size, tag);
+    uint32_t now = xtimer_now();
+
+    _rbuf_init();
+
+    /* check first if entry already available */
+    if ((res = _rbuf_find(bucket, src, src_len, dst, dst_len, size, tag)) != NULL) {
+        res->arrival = now;
+        /* move to the young end of the age list */
+        DL_DELETE2(_age, res, age_prev, age_next);
+        DL_APPEND2(_age, res, age_prev, age_next);
+        return res;
     }
 
-    if (res != NULL) { /* entry not in buffer but found empty spot */
-        res->pkt = gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_SIXLOWPAN);
-        if (res->pkt == NULL) {
-            DEBUG("6lo rfrag: can not allocate reassembly buffer space.\n");
-            return NULL;
-        }
+    if (_free == NULL) {
+        DEBUG("6lo rfrag: reassembly buffer full, remove oldest entry\n");
+        _rbuf_drop(_age);
+    }
 
-        *((uint64_t *)res->pkt->data) = 0;  /* clean first few bytes for later
-                                             * look-ups */
-        res->arrival = now_sec;
-        memcpy(res->src, src, src_len);
-        memcpy(res->dst, dst, dst_len);
-        res->src_len = src_len;
-        res->dst_len = dst_len;
-        res->tag = tag;
-        res->cur_size = 0;
-
-        DEBUG("6lo rfrag: entry %p (%s, ", (void *)res,
-              gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str), res->src,
-                                     res->src_len));
-        DEBUG("%s, %u, %u) created\n",
-              gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str), res->dst,
-                                     res->dst_len), (unsigned)res->pkt->size,
-              res->tag);
+    res = _free;
+    res->pkt = gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_SIXLOWPAN);
+    if (res->pkt == NULL) {
+        DEBUG("6lo rfrag: can not allocate reassembly buffer space.\n");
+        return NULL;
     }
+    _free = res->next;
+
+    *((uint64_t *)res->pkt->data) = 0;  /* clean first few bytes for later
+                                         * look-ups */
+    res->arrival = now;
+    memcpy(res->src, src, src_len);
+    memcpy(res->dst, dst, dst_len);
+    res->src_len = src_len;
+    res->dst_len = dst_len;
+    res->tag = tag;
+    res->cur_size = 0;
+    res->ints = NULL;
+    LL_PREPEND(*bucket, res);
+    DL_APPEND2(_age, res, age_prev, age_next);
+    _rbuf_gc_arm(now);
+
+    DEBUG("6lo rfrag: entry %p (%s, ", (void *)res,
+          gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str), res->src,
+                                 res->src_len));
+    DEBUG("%s, %u, %u) created\n",
+          gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str), res->dst,
+                                 res->dst_len), (unsigned)res->pkt->size,
+          res->tag);
 
     return res;
 }
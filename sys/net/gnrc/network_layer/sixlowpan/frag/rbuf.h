@@ -20,6 +20,7 @@
 #define GNRC_SIXLOWPAN_FRAG_RBUF_H_
 
 #include <inttypes.h>
+#include <stdbool.h>
 
 #include "net/gnrc/netif/hdr.h"
 #include "net/gnrc/pkt.h"
@@ -31,12 +32,25 @@ extern "C" {
 #endif
 
 #define RBUF_L2ADDR_MAX_LEN (8U)    /**< maximum length for link-layer addresses */
+#ifndef RBUF_SIZE
 #define RBUF_SIZE           (4U)    /**< size of the reassembly buffer */
+#endif
+#ifndef RBUF_BUCKETS
+/**
+ * @brief   number of hash buckets to look up reassembly buffer entries,
+ *          must be a power of two
+ */
+#define RBUF_BUCKETS        (4U)
+#endif
 #define RBUF_TIMEOUT        (3U)    /**< timeout for reassembly in seconds */
 
 /**
  * @brief   Fragment intervals to identify limits of fragments.
  *
+ * @details The intervals of a datagram are kept sorted by
+ *          rbuf_int_t::start, adjacent intervals are merged. A datagram
+ *          received in order thus only ever needs one interval.
+ *
  * @note    Fragments MUST NOT overlap and overlapping fragments are to be
  *          discarded
  *
@@ -70,11 +84,14 @@ typedef struct rbuf_int {
  *
  * @internal
  */
-typedef struct {
+typedef struct rbuf {
+    struct rbuf *next;                  /**< next entry in hash bucket or free list */
+    struct rbuf *age_prev;              /**< previous entry in age list */
+    struct rbuf *age_next;              /**< next entry in age list */
     rbuf_int_t *ints;                   /**< intervals of the fragment */
     gnrc_pktsnip_t *pkt;                /**< the reassembled packet in packet buffer */
-    uint32_t arrival;                   /**< time in seconds of arrival of last
-                                         *   received fragment */
+    uint32_t arrival;                   /**< time in microseconds of arrival of
+                                         *   last received fragment */
     uint8_t src[RBUF_L2ADDR_MAX_LEN];   /**< source address */
     uint8_t dst[RBUF_L2ADDR_MAX_LEN];   /**< destination address */
     uint8_t src_len;                    /**< length of source address */
@@ -100,6 +117,30 @@ typedef struct {
 void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *frag,
               size_t frag_size, size_t offset);
 
+/**
+ * @brief   Checks if a datagram is already being reassembled.
+ *
+ * @param[in] netif_hdr     The interface header of a fragment of the datagram.
+ * @param[in] size          The datagram's size.
+ * @param[in] tag           The datagram's tag.
+ *
+ * @return  true, if the reassembly buffer has an entry for the datagram.
+ * @return  false, otherwise.
+ *
+ * @internal
+ */
+bool rbuf_exists(gnrc_netif_hdr_t *netif_hdr, size_t size, uint16_t tag);
+
+/**
+ * @brief   Removes all entries from the reassembly buffer that timed out.
+ *
+ * @details Called on @ref GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF, which the
+ *          reassembly buffer schedules to the calling thread by itself.
+ *
+ * @internal
+ */
+void rbuf_gc(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,319 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <string.h>
+
+#include "byteorder.h"
+#include "utlist.h"
+#include "xtimer.h"
+#include "net/ipv6/hdr.h"
+#include "net/gnrc/ipv6/netif.h"
+#include "net/gnrc/netapi.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/sixlowpan/frag.h"
+#include "net/gnrc/sixlowpan/frag/vrb.h"
+#include "net/gnrc/sixlowpan/iphc.h"
+#include "net/gnrc/sixlowpan/nd.h"
+#include "net/gnrc/sixlowpan/netif.h"
+#include "net/sixlowpan.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+static gnrc_sixlowpan_frag_vrb_t _vrb[GNRC_SIXLOWPAN_FRAG_VRB_SIZE];
+
+static inline bool _expired(const gnrc_sixlowpan_frag_vrb_t *entry, uint32_t now)
+{
+    return (now - entry->arrival) > GNRC_SIXLOWPAN_FRAG_VRB_TIMEOUT;
+}
+
+gnrc_sixlowpan_frag_vrb_t *gnrc_sixlowpan_frag_vrb_add(const uint8_t *src, size_t src_len,
+                                                       uint16_t datagram_size, uint16_t tag,
+                                                       kernel_pid_t out_iface,
+                                                       const uint8_t *out_dst,
+                                                       size_t out_dst_len)
+{
+    gnrc_sixlowpan_frag_vrb_t *res = NULL;
+    uint32_t now = xtimer_now();
+
+    if ((src_len > GNRC_SIXLOWPAN_FRAG_VRB_L2ADDR_MAX) ||
+        (out_dst_len > GNRC_SIXLOWPAN_FRAG_VRB_L2ADDR_MAX)) {
+        return NULL;
+    }
+    for (unsigned i = 0; i < GNRC_SIXLOWPAN_FRAG_VRB_SIZE; i++) {
+        if ((_vrb[i].out_iface == KERNEL_PID_UNDEF) || _expired(&_vrb[i], now)) {
+            res = &_vrb[i];
+            break;
+        }
+    }
+    if (res == NULL) {
+        DEBUG("6lo vrb: virtual reassembly buffer full\n");
+        return NULL;
+    }
+    memcpy(res->src, src, src_len);
+    memcpy(res->out_dst, out_dst, out_dst_len);
+    res->arrival = now;
+    res->out_iface = out_iface;
+    res->datagram_size = datagram_size;
+    res->tag = tag;
+    res->out_tag = gnrc_sixlowpan_frag_next_tag();
+    res->forwarded = 0;
+    res->src_len = src_len;
+    res->out_dst_len = out_dst_len;
+
+    return res;
+}
+
+gnrc_sixlowpan_frag_vrb_t *gnrc_sixlowpan_frag_vrb_get(const uint8_t *src, size_t src_len,
+                                                       uint16_t datagram_size, uint16_t tag)
+{
+    uint32_t now = xtimer_now();
+
+    for (unsigned i = 0; i < GNRC_SIXLOWPAN_FRAG_VRB_SIZE; i++) {
+        gnrc_sixlowpan_frag_vrb_t *entry = &_vrb[i];
+
+        if ((entry->out_iface != KERNEL_PID_UNDEF) && (entry->tag == tag) &&
+            (entry->datagram_size == datagram_size) && (entry->src_len == src_len) &&
+            (memcmp(entry->src, src, src_len) == 0)) {
+            if (_expired(entry, now)) {
+                gnrc_sixlowpan_frag_vrb_rm(entry);
+                return NULL;
+            }
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static gnrc_pktsnip_t *_build_netif_hdr(kernel_pid_t iface, uint8_t *dst, uint8_t dst_len)
+{
+    gnrc_pktsnip_t *netif = gnrc_netif_hdr_build(NULL, 0, dst, dst_len);
+
+    if (netif != NULL) {
+        ((gnrc_netif_hdr_t *)netif->data)->if_pid = iface;
+    }
+
+    return netif;
+}
+
+static void _send(gnrc_sixlowpan_frag_vrb_t *entry, gnrc_pktsnip_t *netif,
+                  size_t frag_size)
+{
+    entry->arrival = xtimer_now();
+    entry->forwarded += frag_size;
+    if (gnrc_netapi_send(entry->out_iface, netif) < 1) {
+        DEBUG("6lo vrb: unable to forward fragment\n");
+        gnrc_pktbuf_release(netif);
+    }
+    if (entry->forwarded >= entry->datagram_size) {
+        DEBUG("6lo vrb: datagram forwarded completely\n");
+        gnrc_sixlowpan_frag_vrb_rm(entry);
+    }
+}
+
+static bool _forward_nth(gnrc_sixlowpan_frag_vrb_t *entry, gnrc_pktsnip_t *pkt,
+                         size_t frag_size)
+{
+    gnrc_pktsnip_t *netif, *frag;
+
+    netif = _build_netif_hdr(entry->out_iface, entry->out_dst, entry->out_dst_len);
+    if (netif == NULL) {
+        return false;
+    }
+    frag = gnrc_pktbuf_add(NULL, pkt->data, pkt->size, GNRC_NETTYPE_SIXLOWPAN);
+    if (frag == NULL) {
+        gnrc_pktbuf_release(netif);
+        return false;
+    }
+    ((sixlowpan_frag_n_t *)frag->data)->tag = byteorder_htons(entry->out_tag);
+    LL_PREPEND(frag, netif);
+
+    DEBUG("6lo vrb: forward subsequent fragment (tag %u -> %u)\n",
+          (unsigned)entry->tag, (unsigned)entry->out_tag);
+    _send(entry, netif, frag_size);
+
+    return true;
+}
+
+static inline bool _is_local(const ipv6_addr_t *dst)
+{
+    ipv6_addr_t *out;
+
+    return ipv6_addr_is_multicast(dst) || ipv6_addr_is_link_local(dst) ||
+           (gnrc_ipv6_netif_find_by_addr(&out, dst) != KERNEL_PID_UNDEF);
+}
+
+/* compresses the IPv6 header in netif->next for the outgoing interface */
+static bool _compress(gnrc_sixlowpan_netif_t *out_if, gnrc_pktsnip_t *netif)
+{
+    gnrc_pktsnip_t *disp;
+
+    if (out_if->iphc_enabled) {
+        return gnrc_sixlowpan_iphc_encode(netif);
+    }
+    disp = gnrc_pktbuf_add(netif->next, NULL, sizeof(uint8_t), GNRC_NETTYPE_SIXLOWPAN);
+    if (disp == NULL) {
+        return false;
+    }
+    *((uint8_t *)disp->data) = SIXLOWPAN_UNCOMP;
+    netif->next = disp;
+
+    return true;
+}
+
+static bool _forward_first(gnrc_pktsnip_t *pkt, size_t frag_size,
+                           uint16_t datagram_size, uint16_t tag)
+{
+    gnrc_netif_hdr_t *netif_hdr = pkt->next->data;
+    gnrc_ipv6_netif_t *in_if = gnrc_ipv6_netif_get(netif_hdr->if_pid);
+    gnrc_sixlowpan_netif_t *in_sixlo_if = gnrc_sixlowpan_netif_get(netif_hdr->if_pid);
+    gnrc_sixlowpan_netif_t *out_if;
+    gnrc_sixlowpan_frag_vrb_t *entry;
+    gnrc_pktsnip_t *ipv6, *netif, *payload, *frag;
+    sixlowpan_frag_t *frag_hdr;
+    ipv6_hdr_t *hdr;
+    uint8_t *data = ((uint8_t *)pkt->data) + sizeof(sixlowpan_frag_t);
+    uint8_t l2addr[GNRC_SIXLOWPAN_FRAG_VRB_L2ADDR_MAX];
+    uint8_t l2addr_len = sizeof(l2addr);
+    kernel_pid_t out_iface;
+    size_t iphc_len, nh_len, len;
+
+    if ((in_if == NULL) || (in_sixlo_if == NULL) ||
+        !(in_if->flags & GNRC_IPV6_NETIF_FLAGS_ROUTER) || (frag_size == 0) ||
+        !sixlowpan_iphc_is(data)) {
+        return false;
+    }
+    ipv6 = gnrc_pktbuf_add(NULL, NULL, GNRC_SIXLOWPAN_IPHC_HDR_MAX, GNRC_NETTYPE_IPV6);
+    if (ipv6 == NULL) {
+        return false;
+    }
+    iphc_len = gnrc_sixlowpan_iphc_decode(ipv6, pkt, datagram_size,
+                                          sizeof(sixlowpan_frag_t), &nh_len);
+    hdr = ipv6->data;
+    if ((iphc_len == 0) || (iphc_len > frag_size) || (hdr->hl <= 1) ||
+        _is_local(&hdr->dst)) {
+        gnrc_pktbuf_release(ipv6);
+        return false;
+    }
+    out_iface = gnrc_sixlowpan_nd_next_hop_l2addr(l2addr, &l2addr_len, KERNEL_PID_UNDEF,
+                                                  &hdr->dst);
+    if ((out_iface <= KERNEL_PID_UNDEF) ||
+        ((out_if = gnrc_sixlowpan_netif_get(out_iface)) == NULL) ||
+        /* subsequent fragments are forwarded as they are */
+        (out_if->max_frag_size < in_sixlo_if->max_frag_size)) {
+        DEBUG("6lo vrb: can not forward to next hop\n");
+        gnrc_pktbuf_release(ipv6);
+        return false;
+    }
+    hdr->hl--;
+
+    if ((netif = _build_netif_hdr(out_iface, l2addr, l2addr_len)) == NULL) {
+        gnrc_pktbuf_release(ipv6);
+        return false;
+    }
+    payload = gnrc_pktbuf_add(NULL, data + iphc_len, frag_size - iphc_len,
+                              GNRC_NETTYPE_UNDEF);
+    if (payload == NULL) {
+        gnrc_pktbuf_release(ipv6);
+        gnrc_pktbuf_release(netif);
+        return false;
+    }
+    if (nh_len > 0) {
+        /* the decompressed next header goes into a snip of its own to be
+         * compressed again */
+        gnrc_pktsnip_t *nh = gnrc_pktbuf_add(payload,
+                                             ((uint8_t *)ipv6->data) + sizeof(ipv6_hdr_t),
+                                             nh_len, GNRC_NETTYPE_UNDEF);
+
+        if (nh == NULL) {
+            gnrc_pktbuf_release(payload);
+            gnrc_pktbuf_release(ipv6);
+            gnrc_pktbuf_release(netif);
+            return false;
+        }
+        payload = nh;
+        gnrc_pktbuf_realloc_data(ipv6, sizeof(ipv6_hdr_t));
+    }
+    ipv6->next = payload;
+    netif->next = ipv6;
+    if (!_compress(out_if, netif)) {
+        gnrc_pktbuf_release(netif);
+        return false;
+    }
+    len = gnrc_pkt_len(netif->next);
+    if ((sizeof(sixlowpan_frag_t) + len) > out_if->max_frag_size) {
+        DEBUG("6lo vrb: first fragment too big for next hop\n");
+        gnrc_pktbuf_release(netif);
+        return false;
+    }
+    entry = gnrc_sixlowpan_frag_vrb_add(gnrc_netif_hdr_get_src_addr(netif_hdr),
+                                        netif_hdr->src_l2addr_len,
+                                        datagram_size, tag, out_iface,
+                                        l2addr, l2addr_len);
+    if (entry == NULL) {
+        gnrc_pktbuf_release(netif);
+        return false;
+    }
+    frag = gnrc_pktbuf_add(NULL, NULL, sizeof(sixlowpan_frag_t) + len,
+                           GNRC_NETTYPE_SIXLOWPAN);
+    if (frag == NULL) {
+        gnrc_sixlowpan_frag_vrb_rm(entry);
+        gnrc_pktbuf_release(netif);
+        return false;
+    }
+    frag_hdr = frag->data;
+    frag_hdr->disp_size = byteorder_htons(datagram_size);
+    frag_hdr->disp_size.u8[0] |= SIXLOWPAN_FRAG_1_DISP;
+    frag_hdr->tag = byteorder_htons(entry->out_tag);
+    data = (uint8_t *)(frag_hdr + 1);
+    for (gnrc_pktsnip_t *ptr = netif->next; ptr != NULL; ptr = ptr->next) {
+        memcpy(data, ptr->data, ptr->size);
+        data += ptr->size;
+    }
+    gnrc_pktbuf_release(netif->next);
+    netif->next = frag;
+
+    DEBUG("6lo vrb: forward first fragment (tag %u -> %u)\n",
+          (unsigned)tag, (unsigned)entry->out_tag);
+    /* the first fragment covers the uncompressed header */
+    _send(entry, netif, frag_size - iphc_len + sizeof(ipv6_hdr_t) + nh_len);
+
+    return true;
+}
+
+bool gnrc_sixlowpan_frag_vrb_forward(gnrc_pktsnip_t *pkt, size_t frag_size,
+                                     uint16_t offset)
+{
+    gnrc_netif_hdr_t *netif_hdr = pkt->next->data;
+    sixlowpan_frag_t *frag = pkt->data;
+    uint16_t datagram_size = byteorder_ntohs(frag->disp_size) & SIXLOWPAN_FRAG_SIZE_MASK;
+    uint16_t tag = byteorder_ntohs(frag->tag);
+    gnrc_sixlowpan_frag_vrb_t *entry;
+
+    if ((frag->disp_size.u8[0] & SIXLOWPAN_FRAG_DISP_MASK) == SIXLOWPAN_FRAG_1_DISP) {
+        return _forward_first(pkt, frag_size, datagram_size, tag);
+    }
+    entry = gnrc_sixlowpan_frag_vrb_get(gnrc_netif_hdr_get_src_addr(netif_hdr),
+                                        netif_hdr->src_l2addr_len,
+                                        datagram_size, tag);
+    if (entry == NULL) {
+        return false;
+    }
+    (void)offset;
+
+    return _forward_nth(entry, pkt, frag_size);
+}
+
+/** @} */
@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <string.h>
+
+#include "net/gnrc/ipv6/nc.h"
+#include "net/gnrc/sixlowpan/ghc.h"
+#include "net/gnrc/sixlowpan/netif.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+/**
+ * @name    GHC bytecodes
+ * @see <a href="https://tools.ietf.org/html/rfc7400#section-2">
+ *          RFC 7400, section 2
+ *      </a>
+ * @{
+ */
+#define GHC_LITERAL_MAX     (0x5f)  /**< 0kkkkkkk: k literal bytes (k < 96) */
+#define GHC_ZEROS           (0x80)  /**< 1000nnnn: n + 2 zero bytes */
+#define GHC_ZEROS_MASK      (0xf0)
+#define GHC_STOP            (0x90)  /**< 10010000: end of compressed data */
+#define GHC_EXT             (0xa0)  /**< 101nssss: extends next backreference */
+#define GHC_EXT_MASK        (0xe0)
+#define GHC_EXT_N           (0x10)
+#define GHC_EXT_S_MAX       (0x0f)
+#define GHC_BACKREF         (0xc0)  /**< 11nnnkkk: copy n bytes from s bytes back */
+#define GHC_BACKREF_MASK    (0xc0)
+/** @} */
+
+#define ZEROS_MIN           (2U)
+#define ZEROS_MAX           (ZEROS_MIN + 15U)
+#define BACKREF_MIN         (2U)
+
+/* static part of the dictionary, RFC 7400, section 3 */
+static const uint8_t _static_dict[] = {
+    0x16, 0xfe, 0xfd, 0x17, 0xfe, 0xfd, 0x00, 0x01,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00
+};
+
+static void _dict_init(uint8_t *dict, const ipv6_hdr_t *ipv6_hdr)
+{
+    memcpy(dict, &ipv6_hdr->src, sizeof(ipv6_addr_t));
+    memcpy(dict + sizeof(ipv6_addr_t), &ipv6_hdr->dst, sizeof(ipv6_addr_t));
+    memcpy(dict + (2 * sizeof(ipv6_addr_t)), _static_dict, sizeof(_static_dict));
+}
+
+/* byte i of the dictionary followed by data */
+static inline uint8_t _hist(const uint8_t *dict, const uint8_t *data, size_t i)
+{
+    return (i < GNRC_SIXLOWPAN_GHC_DICT_LEN) ? dict[i] : data[i - GNRC_SIXLOWPAN_GHC_DICT_LEN];
+}
+
+/* number of extension bytes a backreference of length n from s bytes back
+ * needs */
+static inline size_t _backref_ext(size_t n, size_t s)
+{
+    size_t na = (n - BACKREF_MIN) >> 3, sa = (((s - n) >> 3) + GHC_EXT_S_MAX - 1) / GHC_EXT_S_MAX;
+
+    return (na > sa) ? na : sa;
+}
+
+static size_t _put_literals(uint8_t *out, size_t out_size, size_t res,
+                            const uint8_t *data, size_t len)
+{
+    while (len > 0) {
+        size_t k = (len > GHC_LITERAL_MAX) ? GHC_LITERAL_MAX : len;
+
+        if ((res + 1 + k) > out_size) {
+            return 0;
+        }
+        out[res++] = (uint8_t)k;
+        memcpy(&out[res], data, k);
+        res += k;
+        data += k;
+        len -= k;
+    }
+
+    return res;
+}
+
+static size_t _put_backref(uint8_t *out, size_t out_size, size_t res, size_t n, size_t s)
+{
+    size_t na = (n - BACKREF_MIN) >> 3, sa = (s - n) >> 3;
+
+    if ((res + 1 + _backref_ext(n, s)) > out_size) {
+        return 0;
+    }
+    while ((na > 0) || (sa > 0)) {
+        size_t ssss = (sa > GHC_EXT_S_MAX) ? GHC_EXT_S_MAX : sa;
+
+        out[res++] = GHC_EXT | ((na > 0) ? GHC_EXT_N : 0) | (uint8_t)ssss;
+        na -= (na > 0) ? 1 : 0;
+        sa -= ssss;
+    }
+    out[res++] = GHC_BACKREF | (uint8_t)(((n - BACKREF_MIN) & 0x7) << 3) |
+                 (uint8_t)((s - n) & 0x7);
+
+    return res;
+}
+
+size_t gnrc_sixlowpan_ghc_compress(uint8_t *out, size_t out_size, const ipv6_hdr_t *ipv6_hdr,
+                                   const uint8_t *data, size_t len)
+{
+    uint8_t dict[GNRC_SIXLOWPAN_GHC_DICT_LEN];
+    size_t res = 0, lit = 0, i = 0;
+
+    _dict_init(dict, ipv6_hdr);
+    while (i < len) {
+        size_t zeros = 0, best_n = 0, best_s = 0, pos = GNRC_SIXLOWPAN_GHC_DICT_LEN + i;
+        /* splitting a run of literals costs another literal byte */
+        int min_gain = (lit < i) ? 2 : 1, best_gain = 0;
+
+        while (((i + zeros) < len) && (zeros < ZEROS_MAX) && (data[i + zeros] == 0)) {
+            zeros++;
+        }
+        if (zeros >= ZEROS_MIN) {
+            best_gain = (int)zeros - 1;
+        }
+        /* nearest match first, it needs the fewest extension bytes */
+        for (size_t j = pos - BACKREF_MIN + 1; j-- > 0;) {
+            size_t n = 0;
+            int g;
+
+            while (((i + n) < len) && ((j + n) < pos) &&
+                   (_hist(dict, data, j + n) == data[i + n])) {
+                n++;
+            }
+            if (n < BACKREF_MIN) {
+                continue;
+            }
+            g = (int)n - 1 - (int)_backref_ext(n, pos - j);
+            if ((g > best_gain) || ((g == best_gain) && (n > best_n))) {
+                best_gain = g;
+                best_n = n;
+                best_s = pos - j;
+            }
+        }
+        if (best_gain < min_gain) {
+            i++;
+            continue;
+        }
+        if ((i > lit) && ((res = _put_literals(out, out_size, res, &data[lit], i - lit)) == 0)) {
+            return 0;
+        }
+        if (best_n == 0) {
+            if ((res + 1) > out_size) {
+                return 0;
+            }
+            out[res++] = GHC_ZEROS | (uint8_t)(zeros - ZEROS_MIN);
+            i += zeros;
+        }
+        else {
+            if ((res = _put_backref(out, out_size, res, best_n, best_s)) == 0) {
+                return 0;
+            }
+            i += best_n;
+        }
+        lit = i;
+    }
+    if ((lit < len) && ((res = _put_literals(out, out_size, res, &data[lit], len - lit)) == 0)) {
+        return 0;
+    }
+
+    return res;
+}
+
+size_t gnrc_sixlowpan_ghc_decompress(uint8_t *out, size_t out_size, const ipv6_hdr_t *ipv6_hdr,
+                                     const uint8_t *in, size_t in_len)
+{
+    uint8_t dict[GNRC_SIXLOWPAN_GHC_DICT_LEN];
+    size_t res = 0, i = 0, na = 0, sa = 0;
+
+    _dict_init(dict, ipv6_hdr);
+    while (i < in_len) {
+        uint8_t code = in[i++];
+
+        if (code <= GHC_LITERAL_MAX) {
+            if (((i + code) > in_len) || ((res + code) > out_size)) {
+                DEBUG("6lo ghc: literal out of bounds\n");
+                return 0;
+            }
+            memcpy(&out[res], &in[i], code);
+            i += code;
+            res += code;
+        }
+        else if ((code & GHC_BACKREF_MASK) == GHC_BACKREF) {
+            size_t n = na + ((code >> 3) & 0x7) + BACKREF_MIN;
+            size_t s = (code & 0x7) + sa + n;
+
+            if ((s > (GNRC_SIXLOWPAN_GHC_DICT_LEN + res)) || ((res + n) > out_size)) {
+                DEBUG("6lo ghc: backreference out of bounds\n");
+                return 0;
+            }
+            for (size_t j = GNRC_SIXLOWPAN_GHC_DICT_LEN + res - s; n > 0; j++, n--) {
+                out[res++] = _hist(dict, out, j);
+            }
+            na = 0;
+            sa = 0;
+        }
+        else if ((code & GHC_EXT_MASK) == GHC_EXT) {
+            na += (code & GHC_EXT_N) ? 8 : 0;
+            sa += (code & GHC_EXT_S_MAX) << 3;
+        }
+        else if ((code & GHC_ZEROS_MASK) == GHC_ZEROS) {
+            size_t n = (code & ~GHC_ZEROS_MASK) + ZEROS_MIN;
+
+            if ((res + n) > out_size) {
+                DEBUG("6lo ghc: zeros out of bounds\n");
+                return 0;
+            }
+            memset(&out[res], 0, n);
+            res += n;
+        }
+        else if (code == GHC_STOP) {
+            break;
+        }
+        else {
+            DEBUG("6lo ghc: reserved bytecode 0x%02x\n", code);
+            return 0;
+        }
+    }
+
+    return res;
+}
+
+bool gnrc_sixlowpan_ghc_supported(const gnrc_netif_hdr_t *netif_hdr,
+                                  const ipv6_hdr_t *ipv6_hdr)
+{
+    if ((netif_hdr->flags & (GNRC_NETIF_HDR_FLAGS_BROADCAST | GNRC_NETIF_HDR_FLAGS_MULTICAST)) ||
+        ipv6_addr_is_multicast(&ipv6_hdr->dst)) {
+        gnrc_sixlowpan_netif_t *iface = gnrc_sixlowpan_netif_get(netif_hdr->if_pid);
+
+        return (iface != NULL) && iface->ghc_mcast;
+    }
+#ifdef MODULE_GNRC_IPV6_NC
+    /* the link-layer receiver decompresses, so look for its entry */
+    uint8_t *l2 = gnrc_netif_hdr_get_dst_addr((gnrc_netif_hdr_t *)netif_hdr);
+    gnrc_ipv6_nc_t *nc_entry = gnrc_ipv6_nc_get(netif_hdr->if_pid, &ipv6_hdr->dst);
+
+    if ((nc_entry == NULL) || (nc_entry->l2_addr_len != netif_hdr->dst_l2addr_len) ||
+        (memcmp(nc_entry->l2_addr, l2, netif_hdr->dst_l2addr_len) != 0)) {
+        for (nc_entry = gnrc_ipv6_nc_get_next(NULL); nc_entry != NULL;
+             nc_entry = gnrc_ipv6_nc_get_next(nc_entry)) {
+            if ((nc_entry->iface == netif_hdr->if_pid) &&
+                (nc_entry->l2_addr_len == netif_hdr->dst_l2addr_len) &&
+                (memcmp(nc_entry->l2_addr, l2, netif_hdr->dst_l2addr_len) == 0)) {
+                break;
+            }
+        }
+    }
+    return (nc_entry != NULL) && (nc_entry->flags & GNRC_IPV6_NC_SIXLOWPAN_GHC);
+#else
+    return false;
+#endif
+}
+
+/** @} */
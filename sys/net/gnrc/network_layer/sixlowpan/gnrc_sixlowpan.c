@@ -12,6 +12,8 @@
  * @file
  */
 
+#include <string.h>
+
 #include "kernel_types.h"
 #include "net/gnrc.h"
 #include "thread.h"
@@ -60,6 +62,37 @@ kernel_pid_t gnrc_sixlowpan_init(void)
     return _pid;
 }
 
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC
+/* replaces the first disp_len bytes of pkt by the nh_len bytes at nh */
+static bool _replace_dispatch(gnrc_pktsnip_t *pkt, size_t disp_len, const uint8_t *nh,
+                              size_t nh_len)
+{
+    size_t size = pkt->size;
+
+    if (disp_len > nh_len) {
+        gnrc_pktsnip_t *sixlowpan = gnrc_pktbuf_mark(pkt, disp_len - nh_len,
+                                                     GNRC_NETTYPE_SIXLOWPAN);
+
+        /* a frame without payload can not be marked */
+        if ((sixlowpan == NULL) || (sixlowpan == pkt)) {
+            return false;
+        }
+        gnrc_pktbuf_remove_snip(pkt, sixlowpan);
+    }
+    else if (disp_len < nh_len) {
+        /* the dispatch was shorter than the decompressed next header */
+        if (gnrc_pktbuf_realloc_data(pkt, size + nh_len - disp_len) != 0) {
+            return false;
+        }
+        memmove(((uint8_t *)pkt->data) + nh_len, ((uint8_t *)pkt->data) + disp_len,
+                size - disp_len);
+    }
+    memcpy(pkt->data, nh, nh_len);
+
+    return true;
+}
+#endif
+
 static void _receive(gnrc_pktsnip_t *pkt)
 {
     gnrc_pktsnip_t *payload;
@@ -124,12 +157,11 @@ static void _receive(gnrc_pktsnip_t *pkt)
 #endif
 #ifdef MODULE_GNRC_SIXLOWPAN_IPHC
     else if (sixlowpan_iphc_is(dispatch)) {
-        size_t dispatch_size;
-        gnrc_pktsnip_t *sixlowpan;
-        gnrc_pktsnip_t *ipv6 = gnrc_pktbuf_add(NULL, NULL, sizeof(ipv6_hdr_t),
+        size_t dispatch_size, nh_len;
+        gnrc_pktsnip_t *ipv6 = gnrc_pktbuf_add(NULL, NULL, GNRC_SIXLOWPAN_IPHC_HDR_MAX,
                                                GNRC_NETTYPE_IPV6);
         if ((ipv6 == NULL) ||
-            (dispatch_size = gnrc_sixlowpan_iphc_decode(ipv6, pkt, 0, 0)) == 0) {
+            (dispatch_size = gnrc_sixlowpan_iphc_decode(ipv6, pkt, 0, 0, &nh_len)) == 0) {
             DEBUG("6lo: error on IPHC decoding\n");
             if (ipv6 != NULL) {
                 gnrc_pktbuf_release(ipv6);
@@ -137,16 +169,15 @@ static void _receive(gnrc_pktsnip_t *pkt)
             gnrc_pktbuf_release(pkt);
             return;
         }
-        sixlowpan = gnrc_pktbuf_mark(pkt, dispatch_size, GNRC_NETTYPE_SIXLOWPAN);
-        if (sixlowpan == NULL) {
-            DEBUG("6lo: error on marking IPHC dispatch\n");
+        /* Replace IPHC dispatch by decompressed next header */
+        if (!_replace_dispatch(pkt, dispatch_size, ((uint8_t *)ipv6->data) + sizeof(ipv6_hdr_t),
+                               nh_len)) {
+            DEBUG("6lo: error on removing IPHC dispatch\n");
             gnrc_pktbuf_release(ipv6);
             gnrc_pktbuf_release(pkt);
             return;
         }
-
-        /* Remove IPHC dispatch */
-        gnrc_pktbuf_remove_snip(pkt, sixlowpan);
+        gnrc_pktbuf_realloc_data(ipv6, sizeof(ipv6_hdr_t));
         /* Insert IPv6 header instead */
         ipv6->next = pkt->next;
         pkt->next = ipv6;
@@ -321,6 +352,18 @@ static void *_event_loop(void *args)
                 _send((gnrc_pktsnip_t *)msg.content.ptr);
                 break;
 
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG
+            case GNRC_SIXLOWPAN_MSG_FRAG_SND:
+                DEBUG("6lo: send next fragment\n");
+                gnrc_sixlowpan_frag_send_next((gnrc_sixlowpan_frag_msg_t *)msg.content.ptr);
+                break;
+
+            case GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF:
+                DEBUG("6lo: garbage collect reassembly buffer\n");
+                gnrc_sixlowpan_frag_gc_rbuf();
+                break;
+#endif
+
             case GNRC_NETAPI_MSG_TYPE_GET:
             case GNRC_NETAPI_MSG_TYPE_SET:
                 DEBUG("6lo: reply to unsupported get/set\n");
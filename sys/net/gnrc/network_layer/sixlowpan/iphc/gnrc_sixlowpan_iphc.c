@@ -13,14 +13,20 @@
  */
 
 #include <stdbool.h>
+#include <string.h>
 
 #include "byteorder.h"
 #include "net/ieee802154.h"
 #include "net/ipv6/hdr.h"
 #include "net/gnrc.h"
 #include "net/gnrc/sixlowpan/ctx.h"
+#include "net/gnrc/sixlowpan/ghc.h"
+#include "net/gnrc/sixlowpan/netif.h"
+#include "net/protnum.h"
 #include "net/sixlowpan.h"
+#include "net/udp.h"
 #include "utlist.h"
+#include "xtimer.h"
 
 #include "net/gnrc/sixlowpan/iphc.h"
 
@@ -38,44 +44,102 @@
 #define IPHC_TF_ECN_DSCP            (0x10)
 #define IPHC_TF_ECN_ELIDE           (0x18)
 
-/* compression values for hop limit */
+/* compression value for a hop limit carried inline */
 #define IPHC_HL_INLINE              (0x00)
-#define IPHC_HL_1                   (0x01)
-#define IPHC_HL_64                  (0x02)
-#define IPHC_HL_255                 (0x03)
-
-/* compression values for source address */
-#define IPHC_SAC_SAM_FULL           (0x00)
-#define IPHC_SAC_SAM_64             (0x10)
-#define IPHC_SAC_SAM_16             (0x20)
-#define IPHC_SAC_SAM_L2             (0x30)
-#define IPHC_SAC_SAM_UNSPEC         (0x40)
-#define IPHC_SAC_SAM_CTX_64         (0x50)
-#define IPHC_SAC_SAM_CTX_16         (0x60)
-#define IPHC_SAC_SAM_CTX_L2         (0x70)
-
-/* compression values for destination address */
-#define IPHC_M_DAC_DAM_U_FULL       (0x00)
-#define IPHC_M_DAC_DAM_U_64         (0x01)
-#define IPHC_M_DAC_DAM_U_16         (0x02)
-#define IPHC_M_DAC_DAM_U_L2         (0x03)
-#define IPHC_M_DAC_DAM_U_UNSPEC     (0x04)
-#define IPHC_M_DAC_DAM_U_CTX_64     (0x05)
-#define IPHC_M_DAC_DAM_U_CTX_16     (0x06)
-#define IPHC_M_DAC_DAM_U_CTX_L2     (0x07)
-#define IPHC_M_DAC_DAM_M_FULL       (0x08)
-#define IPHC_M_DAC_DAM_M_48         (0x09)
-#define IPHC_M_DAC_DAM_M_32         (0x0a)
-#define IPHC_M_DAC_DAM_M_8          (0x0b)
-#define IPHC_M_DAC_DAM_M_UC_PREFIX  (0x0c)
-
-static inline bool _context_overlaps_iid(gnrc_sixlowpan_ctx_t *ctx,
-                                         ipv6_addr_t *addr,
-                                         eui64_t *iid)
+
+/* compression values of the SAM and DAM fields for unicast addresses */
+#define IPHC_ADDR_FULL              (0x00)
+#define IPHC_ADDR_64                (0x01)
+#define IPHC_ADDR_16                (0x02)
+#define IPHC_ADDR_L2                (0x03)
+#define IPHC_SAM_POS                (4U)
+
+/* compression values of the DAM field for multicast addresses */
+#define IPHC_M_FULL                 (0x00)
+#define IPHC_M_48                   (0x01)
+#define IPHC_M_32                   (0x02)
+#define IPHC_M_8                    (0x03)
+
+/* inline length of a unicast prefix based multicast address (RFC 3306) */
+#define IPHC_M_UC_PREFIX_LEN        (6U)
+
+/* NHC for UDP (RFC 6282, section 4.3.3) */
+#define NHC_UDP_ID                  (0xf0)
+#define NHC_UDP_ID_MASK             (0xf8)
+#define NHC_UDP_C_ELIDED            (0x04)
+#define NHC_UDP_PP_MASK             (0x03)
+#define NHC_UDP_SD_INL              (0x00)
+#define NHC_UDP_S_INL               (0x01)
+#define NHC_UDP_D_INL               (0x02)
+#define NHC_UDP_SD_ELIDED           (0x03)
+#define NHC_UDP_8BIT_PORT           (0xf000)
+#define NHC_UDP_8BIT_MASK           (0xff00)
+#define NHC_UDP_4BIT_PORT           (0xf0b0)
+#define NHC_UDP_4BIT_MASK           (0xfff0)
+#define NHC_UDP_MAX_LEN             (1U + 4U + 2U)
+
+/* dispatch, CID, traffic class and flow label, next header, hop limit and
+ * both addresses inline, plus NHC UDP (which is longer than the GHC dispatch) */
+#define IPHC_MAX_LEN                (SIXLOWPAN_IPHC_HDR_LEN + SIXLOWPAN_IPHC_CID_EXT_LEN + \
+                                     4U + 1U + 1U + (2U * sizeof(ipv6_addr_t)) + \
+                                     NHC_UDP_MAX_LEN)
+
+/* hop limits that can be elided, indexed by the HLIM field */
+static const uint8_t _hl[] = { 0, 1, 64, 255 };
+
+/* length of the inline part of a unicast address, indexed by SAM or DAM.
+ * The inline part is always the tail of the address. */
+static const uint8_t _addr_inline_len[] = { 16, 8, 2, 0 };
+
+/* length of the inline part of a multicast address, indexed by DAM */
+static const uint8_t _mcast_inline_len[] = { 16, 6, 4, 1 };
+
+#if GNRC_SIXLOWPAN_IPHC_FLOWS
+/* everything the compressed headers of a packet are derived from, except the
+ * UDP checksum */
+typedef struct {
+    ipv6_addr_t src;
+    ipv6_addr_t dst;
+    network_uint32_t v_tc_fl;
+    network_uint16_t src_port;
+    network_uint16_t dst_port;
+    uint8_t src_l2addr[8];
+    uint8_t dst_l2addr[8];
+    kernel_pid_t iface;
+    uint8_t src_l2addr_len;
+    uint8_t dst_l2addr_len;
+    uint8_t nh;
+    uint8_t hl;
+    uint8_t udp;
+    uint8_t ghc;
+} _flow_key_t;
+
+/* a compression template for the packets of one flow */
+typedef struct {
+    _flow_key_t key;
+    uint32_t created;           /* xtimer_now() when the template was made */
+    uint16_t ctx_generation;    /* gnrc_sixlowpan_ctx_generation() back then */
+    uint8_t len;                /* length of tmpl, 0 if entry is unused */
+    uint8_t tmpl[IPHC_MAX_LEN];
+} _flow_t;
+
+/* only used from the 6LoWPAN thread */
+static _flow_t _flows[GNRC_SIXLOWPAN_IPHC_FLOWS];
+#endif
+
+#ifdef MODULE_GNRC_SIXLOWPAN_GHC
+/* ICMPv6 message before and after GHC, only used from the 6LoWPAN thread */
+static uint8_t _ghc_in[GNRC_SIXLOWPAN_GHC_MAX_LEN];
+static uint8_t _ghc_out[GNRC_SIXLOWPAN_GHC_MAX_LEN];
+#endif
+
+static inline bool _context_overlaps_iid(const gnrc_sixlowpan_ctx_t *ctx,
+                                         const ipv6_addr_t *addr,
+                                         const eui64_t *iid)
 {
     uint8_t byte_mask[] = {0xff, 0x7f, 0x3f, 0x1f, 0x0f, 0x07, 0x03, 0x01};
 
-    if ((ctx == NULL) || (ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_COMP)) {
+    if ((ctx == NULL) || !(ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_COMP)) {
         return false;
     }
 
@@ -90,586 +154,768 @@ static inline bool _context_overlaps_iid(gnrc_sixlowpan_ctx_t *ctx,
              (iid->uint8[(ctx->prefix_len / 8) - 8] & byte_mask[ctx->prefix_len % 8])));
 }
 
+/* returns ctx if it may be used for compression, NULL otherwise */
+static inline gnrc_sixlowpan_ctx_t *_comp_ctx(gnrc_sixlowpan_ctx_t *ctx)
+{
+    if ((ctx == NULL) || !(ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_COMP)) {
+        return NULL;
+    }
+    return ctx;
+}
+
+static bool _decode_addr(ipv6_addr_t *addr, unsigned mode, const gnrc_sixlowpan_ctx_t *ctx,
+                         const uint8_t *inl, uint8_t *l2addr, size_t l2addr_len)
+{
+    switch (mode) {
+        case IPHC_ADDR_FULL:
+            memcpy(addr, inl, sizeof(ipv6_addr_t));
+            return true;
+
+        case IPHC_ADDR_64:
+            memcpy(&addr->u64[1], inl, sizeof(network_uint64_t));
+            break;
+
+        case IPHC_ADDR_16:
+            addr->u32[2] = byteorder_htonl(0x000000ff);
+            addr->u16[6] = byteorder_htons(0xfe00);
+            memcpy(&addr->u16[7], inl, sizeof(network_uint16_t));
+            break;
+
+        default:
+            /* the address is derived from the link-layer address */
+            if (ieee802154_get_iid((eui64_t *)&addr->u64[1], l2addr, l2addr_len) == NULL) {
+                DEBUG("6lo iphc: can not derive IID from link-layer address\n");
+                return false;
+            }
+            break;
+    }
+    if (ctx == NULL) {
+        ipv6_addr_set_link_local_prefix(addr);
+    }
+    else {
+        /* context bits take precedence over those of the IID */
+        addr->u64[0].u64 = 0;
+        ipv6_addr_init_prefix(addr, &ctx->prefix, ctx->prefix_len);
+    }
+    return true;
+}
+
+static void _decode_mcast(ipv6_addr_t *addr, unsigned mode, const uint8_t *inl)
+{
+    uint8_t len = _mcast_inline_len[mode];
+
+    if (mode == IPHC_M_FULL) {
+        memcpy(addr, inl, sizeof(ipv6_addr_t));
+        return;
+    }
+    ipv6_addr_set_unspecified(addr);
+    addr->u8[0] = 0xff;
+    if (mode == IPHC_M_8) {
+        /* ff02::00XX */
+        addr->u8[1] = 0x02;
+        addr->u8[15] = inl[0];
+        return;
+    }
+    /* ffXX::00XX:XXXX:XXXX or ffXX::00XX:XXXX */
+    addr->u8[1] = inl[0];
+    memcpy(&addr->u8[sizeof(ipv6_addr_t) - (len - 1)], inl + 1, len - 1);
+}
+
+/* ffXX:XXLL:PPPP:PPPP:PPPP:PPPP:XXXX:XXXX with LL and P from the context */
+static void _decode_mcast_uc_prefix(ipv6_addr_t *addr, const gnrc_sixlowpan_ctx_t *ctx,
+                                    const uint8_t *inl)
+{
+    ipv6_addr_t prefix = IPV6_ADDR_UNSPECIFIED;
+    uint8_t prefix_len = (ctx->prefix_len > 64) ? 64 : ctx->prefix_len;
+
+    ipv6_addr_init_prefix(&prefix, &ctx->prefix, prefix_len);
+    addr->u8[0] = 0xff;
+    addr->u8[1] = inl[0];
+    addr->u8[2] = inl[1];
+    addr->u8[3] = prefix_len;
+    memcpy(&addr->u8[4], &prefix, sizeof(network_uint64_t));
+    memcpy(&addr->u8[12], inl + 2, sizeof(network_uint32_t));
+}
+
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+static size_t _decode_nhc_udp(udp_hdr_t *udp_hdr, const uint8_t *nhc)
+{
+    size_t pos = 1;
+
+    if (nhc[0] & NHC_UDP_C_ELIDED) {
+        /* would need the complete datagram to recalculate */
+        DEBUG("6lo iphc: elided UDP checksum is not supported\n");
+        return 0;
+    }
+    switch (nhc[0] & NHC_UDP_PP_MASK) {
+        case NHC_UDP_SD_INL:
+            memcpy(&udp_hdr->src_port, nhc + pos, sizeof(network_uint16_t));
+            memcpy(&udp_hdr->dst_port, nhc + pos + 2, sizeof(network_uint16_t));
+            pos += 4;
+            break;
+
+        case NHC_UDP_S_INL:
+            memcpy(&udp_hdr->src_port, nhc + pos, sizeof(network_uint16_t));
+            udp_hdr->dst_port = byteorder_htons(NHC_UDP_8BIT_PORT | nhc[pos + 2]);
+            pos += 3;
+            break;
+
+        case NHC_UDP_D_INL:
+            udp_hdr->src_port = byteorder_htons(NHC_UDP_8BIT_PORT | nhc[pos]);
+            memcpy(&udp_hdr->dst_port, nhc + pos + 1, sizeof(network_uint16_t));
+            pos += 3;
+            break;
+
+        case NHC_UDP_SD_ELIDED:
+            udp_hdr->src_port = byteorder_htons(NHC_UDP_4BIT_PORT | (nhc[pos] >> 4));
+            udp_hdr->dst_port = byteorder_htons(NHC_UDP_4BIT_PORT | (nhc[pos] & 0x0f));
+            pos++;
+            break;
+    }
+    memcpy(&udp_hdr->checksum, nhc + pos, sizeof(network_uint16_t));
+
+    return pos + sizeof(network_uint16_t);
+}
+#endif
+
+#ifdef MODULE_GNRC_SIXLOWPAN_GHC
+/* decompresses the ICMPv6 message behind the GHC dispatch at ghc into the
+ * space behind the IPv6 header, which is grown for that */
+static size_t _decode_ghc(gnrc_pktsnip_t *ipv6, const uint8_t *ghc, size_t ghc_len,
+                          size_t *nh_len)
+{
+    ipv6_hdr_t *ipv6_hdr;
+
+    if (gnrc_pktbuf_realloc_data(ipv6, sizeof(ipv6_hdr_t) + GNRC_SIXLOWPAN_GHC_MAX_LEN) != 0) {
+        DEBUG("6lo iphc: no space for ICMPv6 message compressed with GHC\n");
+        return 0;
+    }
+    ipv6_hdr = ipv6->data;
+    *nh_len = gnrc_sixlowpan_ghc_decompress((uint8_t *)(ipv6_hdr + 1),
+                                            GNRC_SIXLOWPAN_GHC_MAX_LEN, ipv6_hdr,
+                                            ghc + 1, ghc_len - 1);
+    if (*nh_len == 0) {
+        return 0;
+    }
+    ipv6_hdr->nh = PROTNUM_ICMPV6;
+
+    /* GHC takes up the rest of the frame */
+    return ghc_len;
+}
+#endif
+
 size_t gnrc_sixlowpan_iphc_decode(gnrc_pktsnip_t *ipv6, gnrc_pktsnip_t *pkt, size_t datagram_size,
-                                  size_t offset)
+                                  size_t offset, size_t *nh_len)
 {
     gnrc_netif_hdr_t *netif_hdr = pkt->next->data;
     ipv6_hdr_t *ipv6_hdr;
     uint8_t *iphc_hdr = pkt->data;
     size_t payload_offset = SIXLOWPAN_IPHC_HDR_LEN;
     gnrc_sixlowpan_ctx_t *ctx = NULL;
+    uint32_t fl = 0;
+    uint8_t tc = 0, cid = 0;
+    unsigned sam, dam;
 
     assert(ipv6 != NULL);
     assert(ipv6->size >= sizeof(ipv6_hdr_t));
 
     ipv6_hdr = ipv6->data;
     iphc_hdr += offset;
+    *nh_len = 0;
 
     if (iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_CID_EXT) {
+        cid = iphc_hdr[CID_EXT_IDX];
         payload_offset++;
     }
 
-    ipv6_hdr_set_version(ipv6_hdr);
-
+    /* traffic class is carried as ECN + DSCP, but is DSCP + ECN (RFC 3168) */
     switch (iphc_hdr[IPHC1_IDX] & SIXLOWPAN_IPHC1_TF) {
         case IPHC_TF_ECN_DSCP_FL:
-            ipv6_hdr_set_tc(ipv6_hdr, iphc_hdr[payload_offset++]);
-            ipv6_hdr->v_tc_fl.u8[1] |= iphc_hdr[payload_offset++] & 0x0f;
-            ipv6_hdr->v_tc_fl.u8[2] |= iphc_hdr[payload_offset++];
-            ipv6_hdr->v_tc_fl.u8[3] |= iphc_hdr[payload_offset++];
+            tc = (uint8_t)((iphc_hdr[payload_offset] << 2) | (iphc_hdr[payload_offset] >> 6));
+            payload_offset++;
+            /* the 4-bit pad is ignored */
+            fl = ((uint32_t)(iphc_hdr[payload_offset] & 0x0f)) << 16;
+            payload_offset++;
             break;
 
         case IPHC_TF_ECN_FL:
-            ipv6_hdr_set_tc_ecn(ipv6_hdr, iphc_hdr[payload_offset] >> 6);
-            ipv6_hdr_set_tc_dscp(ipv6_hdr, 0);
-            ipv6_hdr->v_tc_fl.u8[1] |= iphc_hdr[payload_offset++] & 0x0f;
-            ipv6_hdr->v_tc_fl.u8[2] |= iphc_hdr[payload_offset++];
-            ipv6_hdr->v_tc_fl.u8[3] |= iphc_hdr[payload_offset++];
+            tc = iphc_hdr[payload_offset] >> 6;
+            fl = ((uint32_t)(iphc_hdr[payload_offset] & 0x0f)) << 16;
+            payload_offset++;
             break;
 
         case IPHC_TF_ECN_DSCP:
-            ipv6_hdr_set_tc(ipv6_hdr, iphc_hdr[payload_offset++]);
-            ipv6_hdr_set_fl(ipv6_hdr, 0);
+            tc = (uint8_t)((iphc_hdr[payload_offset] << 2) | (iphc_hdr[payload_offset] >> 6));
+            payload_offset++;
             break;
 
-        case IPHC_TF_ECN_ELIDE:
-            ipv6_hdr_set_tc(ipv6_hdr, 0);
-            ipv6_hdr_set_fl(ipv6_hdr, 0);
+        default:
             break;
     }
+    if (!(iphc_hdr[IPHC1_IDX] & SIXLOWPAN_IPHC1_TF & IPHC_TF_ECN_DSCP)) {
+        /* remaining bytes of flow label */
+        fl |= ((uint32_t)iphc_hdr[payload_offset] << 8) | iphc_hdr[payload_offset + 1];
+        payload_offset += 2;
+    }
+    ipv6_hdr->v_tc_fl = byteorder_htonl(0x60000000 | ((uint32_t)tc << 20) | fl);
 
     if (!(iphc_hdr[IPHC1_IDX] & SIXLOWPAN_IPHC1_NH)) {
         ipv6_hdr->nh = iphc_hdr[payload_offset++];
     }
 
-    switch (iphc_hdr[IPHC1_IDX] & SIXLOWPAN_IPHC1_HL) {
-        case IPHC_HL_INLINE:
-            ipv6_hdr->hl = iphc_hdr[payload_offset++];
-            break;
-
-        case IPHC_HL_1:
-            ipv6_hdr->hl = 1;
-            break;
-
-        case IPHC_HL_64:
-            ipv6_hdr->hl = 64;
-            break;
-
-        case IPHC_HL_255:
-            ipv6_hdr->hl = 255;
-            break;
+    if ((iphc_hdr[IPHC1_IDX] & SIXLOWPAN_IPHC1_HL) == IPHC_HL_INLINE) {
+        ipv6_hdr->hl = iphc_hdr[payload_offset++];
+    }
+    else {
+        ipv6_hdr->hl = _hl[iphc_hdr[IPHC1_IDX] & SIXLOWPAN_IPHC1_HL];
     }
 
+    sam = (iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_SAM) >> IPHC_SAM_POS;
     if (iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_SAC) {
-        uint8_t sci = 0;
-
-        if (iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_CID_EXT) {
-            sci = iphc_hdr[CID_EXT_IDX] >> 4;
+        if (sam == IPHC_ADDR_FULL) {
+            ipv6_addr_set_unspecified(&ipv6_hdr->src);
+            sam = IPHC_ADDR_L2; /* nothing inline */
         }
+        else if ((ctx = gnrc_sixlowpan_ctx_lookup_id(cid >> 4)) == NULL) {
+            DEBUG("6lo iphc: could not find source context\n");
+            return 0;
+        }
+    }
+    if ((ctx != NULL) || !(iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_SAC)) {
+        if (!_decode_addr(&ipv6_hdr->src, sam, ctx, iphc_hdr + payload_offset,
+                          gnrc_netif_hdr_get_src_addr(netif_hdr),
+                          netif_hdr->src_l2addr_len)) {
+            return 0;
+        }
+    }
+    payload_offset += _addr_inline_len[sam];
 
-        if (iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_SAM) {
-            ctx = gnrc_sixlowpan_ctx_lookup_id(sci);
-
-            if (ctx == NULL) {
-                DEBUG("6lo iphc: could not find source context\n");
+    dam = iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_DAM;
+    ctx = NULL;
+    if (iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_DAC) {
+        if (dam == IPHC_ADDR_FULL) {
+            /* reserved for unicast, unicast prefix based multicast otherwise */
+            if (!(iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_M)) {
+                DEBUG("6lo iphc: reserved DAC, DAM combination\n");
                 return 0;
             }
         }
+        else if (iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_M) {
+            DEBUG("6lo iphc: reserved M, DAC, DAM combination\n");
+            return 0;
+        }
+        if ((ctx = gnrc_sixlowpan_ctx_lookup_id(cid & 0x0f)) == NULL) {
+            DEBUG("6lo iphc: could not find destination context\n");
+            return 0;
+        }
     }
-
-    switch (iphc_hdr[IPHC2_IDX] & (SIXLOWPAN_IPHC2_SAC | SIXLOWPAN_IPHC2_SAM)) {
-
-        case IPHC_SAC_SAM_FULL:
-            /* take full 128 from inline */
-            memcpy(&(ipv6_hdr->src), iphc_hdr + payload_offset, 16);
-            payload_offset += 16;
-            break;
-
-        case IPHC_SAC_SAM_64:
-            ipv6_addr_set_link_local_prefix(&ipv6_hdr->src);
-            memcpy(ipv6_hdr->src.u8 + 8, iphc_hdr + payload_offset, 8);
-            payload_offset += 8;
-            break;
-
-        case IPHC_SAC_SAM_16:
-            ipv6_addr_set_link_local_prefix(&ipv6_hdr->src);
-            ipv6_hdr->src.u32[2] = byteorder_htonl(0x000000ff);
-            ipv6_hdr->src.u16[6] = byteorder_htons(0xfe00);
-            memcpy(ipv6_hdr->src.u8 + 14, iphc_hdr + payload_offset, 2);
-            payload_offset += 2;
-            break;
-
-        case IPHC_SAC_SAM_L2:
-            ieee802154_get_iid((eui64_t *)(&ipv6_hdr->src.u64[1]),
-                               gnrc_netif_hdr_get_src_addr(netif_hdr),
-                               netif_hdr->src_l2addr_len);
-            ipv6_addr_set_link_local_prefix(&ipv6_hdr->src);
-            break;
-
-        case IPHC_SAC_SAM_UNSPEC:
-            ipv6_addr_set_unspecified(&ipv6_hdr->src);
-            break;
-
-        case IPHC_SAC_SAM_CTX_64:
-            assert(ctx != NULL);
-            memcpy(ipv6_hdr->src.u8 + 8, iphc_hdr + payload_offset, 8);
-            ipv6_addr_init_prefix(&ipv6_hdr->src, &ctx->prefix,
-                                  ctx->prefix_len);
-            payload_offset += 8;
-            break;
-
-        case IPHC_SAC_SAM_CTX_16:
-            assert(ctx != NULL);
-            ipv6_hdr->src.u32[2] = byteorder_htonl(0x000000ff);
-            ipv6_hdr->src.u16[6] = byteorder_htons(0xfe00);
-            memcpy(ipv6_hdr->src.u8 + 14, iphc_hdr + payload_offset, 2);
-            ipv6_addr_init_prefix(&ipv6_hdr->src, &ctx->prefix,
-                                  ctx->prefix_len);
-            payload_offset += 2;
-            break;
-
-        case IPHC_SAC_SAM_CTX_L2:
-            assert(ctx != NULL);
-            ieee802154_get_iid((eui64_t *)(&ipv6_hdr->src.u64[1]),
-                               gnrc_netif_hdr_get_src_addr(netif_hdr),
-                               netif_hdr->src_l2addr_len);
-            ipv6_addr_init_prefix(&ipv6_hdr->src, &ctx->prefix,
-                                  ctx->prefix_len);
-            break;
+    if (!(iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_M)) {
+        if (!_decode_addr(&ipv6_hdr->dst, dam, ctx, iphc_hdr + payload_offset,
+                          gnrc_netif_hdr_get_dst_addr(netif_hdr),
+                          netif_hdr->dst_l2addr_len)) {
+            return 0;
+        }
+        payload_offset += _addr_inline_len[dam];
+    }
+    else if (ctx != NULL) {
+        _decode_mcast_uc_prefix(&ipv6_hdr->dst, ctx, iphc_hdr + payload_offset);
+        payload_offset += IPHC_M_UC_PREFIX_LEN;
+    }
+    else {
+        _decode_mcast(&ipv6_hdr->dst, dam, iphc_hdr + payload_offset);
+        payload_offset += _mcast_inline_len[dam];
     }
 
-    if (iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_DAC) {
-        uint8_t dci = 0;
+    if (iphc_hdr[IPHC1_IDX] & SIXLOWPAN_IPHC1_NH) {
+        size_t nhc_len = 0;
 
-        if (iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_CID_EXT) {
-            dci = iphc_hdr[CID_EXT_IDX] & 0x0f;
+        if ((offset + payload_offset) >= pkt->size) {
+            DEBUG("6lo iphc: frame too short for next header compression\n");
+            return 0;
         }
-
-        if (iphc_hdr[IPHC2_IDX] & SIXLOWPAN_IPHC2_DAM) {
-            ctx = gnrc_sixlowpan_ctx_lookup_id(dci);
-
-            if (ctx == NULL) {
-                DEBUG("6lo iphc: could not find destination context\n");
+#ifdef MODULE_GNRC_SIXLOWPAN_GHC
+        if (iphc_hdr[payload_offset] == SIXLOWPAN_NHC_GHC_ICMPV6) {
+            if (datagram_size != 0) {
+                DEBUG("6lo iphc: GHC in fragmented datagram is not supported\n");
                 return 0;
             }
+            if ((nhc_len = _decode_ghc(ipv6, iphc_hdr + payload_offset,
+                                       pkt->size - offset - payload_offset, nh_len)) == 0) {
+                return 0;
+            }
+            ipv6_hdr = ipv6->data;
         }
-    }
-
-    switch (iphc_hdr[IPHC2_IDX] & (SIXLOWPAN_IPHC2_M | SIXLOWPAN_IPHC2_DAC |
-                                   SIXLOWPAN_IPHC2_DAM)) {
-        case IPHC_M_DAC_DAM_U_FULL:
-        case IPHC_M_DAC_DAM_M_FULL:
-            memcpy(&(ipv6_hdr->dst.u8), iphc_hdr + payload_offset, 16);
-            payload_offset += 16;
-            break;
-
-        case IPHC_M_DAC_DAM_U_64:
-            ipv6_addr_set_link_local_prefix(&ipv6_hdr->dst);
-            memcpy(ipv6_hdr->dst.u8 + 8, iphc_hdr + payload_offset, 8);
-            payload_offset += 8;
-            break;
-
-        case IPHC_M_DAC_DAM_U_16:
-            ipv6_addr_set_link_local_prefix(&ipv6_hdr->dst);
-            ipv6_hdr->dst.u32[2] = byteorder_htonl(0x000000ff);
-            ipv6_hdr->dst.u16[6] = byteorder_htons(0xfe00);
-            memcpy(ipv6_hdr->dst.u8 + 14, iphc_hdr + payload_offset, 2);
-            payload_offset += 2;
-            break;
-
-        case IPHC_M_DAC_DAM_U_L2:
-            ieee802154_get_iid((eui64_t *)(&ipv6_hdr->dst.u64[1]),
-                               gnrc_netif_hdr_get_dst_addr(netif_hdr),
-                               netif_hdr->dst_l2addr_len);
-            ipv6_addr_set_link_local_prefix(&ipv6_hdr->dst);
-            break;
-
-        case IPHC_M_DAC_DAM_U_CTX_64:
-            memcpy(ipv6_hdr->dst.u8 + 8, iphc_hdr + payload_offset, 8);
-            ipv6_addr_init_prefix(&ipv6_hdr->dst, &ctx->prefix,
-                                  ctx->prefix_len);
-            payload_offset += 8;
-            break;
-
-        case IPHC_M_DAC_DAM_U_CTX_16:
-            ipv6_hdr->dst.u32[2] = byteorder_htonl(0x000000ff);
-            ipv6_hdr->dst.u16[6] = byteorder_htons(0xfe00);
-            memcpy(ipv6_hdr->dst.u8 + 14, iphc_hdr + payload_offset, 2);
-            ipv6_addr_init_prefix(&ipv6_hdr->dst, &ctx->prefix,
-                                  ctx->prefix_len);
-            payload_offset += 2;
-            break;
-
-        case IPHC_M_DAC_DAM_U_CTX_L2:
-            ieee802154_get_iid((eui64_t *)(&ipv6_hdr->dst.u64[1]),
-                               gnrc_netif_hdr_get_dst_addr(netif_hdr),
-                               netif_hdr->dst_l2addr_len);
-            ipv6_addr_init_prefix(&ipv6_hdr->dst, &ctx->prefix,
-                                  ctx->prefix_len);
-            break;
-
-        case IPHC_M_DAC_DAM_M_48:
-            /* ffXX::00XX:XXXX:XXXX */
-            ipv6_addr_set_unspecified(&ipv6_hdr->dst);
-            ipv6_hdr->dst.u8[0] = 0xff;
-            ipv6_hdr->dst.u8[1] = iphc_hdr[payload_offset++];
-            ipv6_hdr->dst.u8[11] = iphc_hdr[payload_offset++];
-            ipv6_hdr->dst.u8[12] = iphc_hdr[payload_offset++];
-            ipv6_hdr->dst.u8[13] = iphc_hdr[payload_offset++];
-            ipv6_hdr->dst.u8[14] = iphc_hdr[payload_offset++];
-            ipv6_hdr->dst.u8[15] = iphc_hdr[payload_offset++];
-            break;
-
-        case IPHC_M_DAC_DAM_M_32:
-            /* ffXX::00XX:XXXX */
-            ipv6_addr_set_unspecified(&ipv6_hdr->dst);
-            ipv6_hdr->dst.u8[0] = 0xff;
-            ipv6_hdr->dst.u8[1] = iphc_hdr[payload_offset++];
-            ipv6_hdr->dst.u8[13] = iphc_hdr[payload_offset++];
-            ipv6_hdr->dst.u8[14] = iphc_hdr[payload_offset++];
-            ipv6_hdr->dst.u8[15] = iphc_hdr[payload_offset++];
-            break;
-
-        case IPHC_M_DAC_DAM_M_8:
-            /* ff02::XX: */
-            ipv6_addr_set_unspecified(&ipv6_hdr->dst);
-            ipv6_hdr->dst.u8[0] = 0xff;
-            ipv6_hdr->dst.u8[1] = 0x02;
-            ipv6_hdr->dst.u8[15] = iphc_hdr[payload_offset++];
-            break;
-
-        case IPHC_M_DAC_DAM_M_UC_PREFIX:
-            do {
-                uint8_t orig_ctx_len = ctx->prefix_len;
-
-                ipv6_addr_set_unspecified(&ipv6_hdr->dst);
-
-                if (ctx->prefix_len > 64) {
-                    ctx->prefix_len = 64;
-                }
-
-                ipv6_hdr->dst.u8[0] = 0xff;
-                ipv6_hdr->dst.u8[1] = iphc_hdr[payload_offset++];
-                ipv6_hdr->dst.u8[2] = iphc_hdr[payload_offset++];
-                ipv6_hdr->dst.u8[3] = ctx->prefix_len;
-                ipv6_addr_init_prefix((ipv6_addr_t *)ipv6_hdr->dst.u8 + 4,
-                                      &ctx->prefix, ctx->prefix_len);
-                memcpy(ipv6_hdr->dst.u8 + 12, iphc_hdr + payload_offset + 2, 4);
-
-                payload_offset += 4;
-
-                ctx->prefix_len = orig_ctx_len;
-            } while (0);    /* ANSI-C compatible block creation for orig_ctx_len allocation */
-            break;
-
-        default:
-            DEBUG("6lo iphc: unspecified or reserved M, DAC, DAM combination\n");
+#endif
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+        if (((iphc_hdr[payload_offset] & NHC_UDP_ID_MASK) == NHC_UDP_ID) &&
+            (ipv6->size >= (sizeof(ipv6_hdr_t) + sizeof(udp_hdr_t)))) {
+            if ((nhc_len = _decode_nhc_udp((udp_hdr_t *)(ipv6_hdr + 1),
+                                           iphc_hdr + payload_offset)) == 0) {
+                return 0;
+            }
+            ipv6_hdr->nh = PROTNUM_UDP;
+            *nh_len = sizeof(udp_hdr_t);
+        }
+#endif
+        if (nhc_len == 0) {
+            DEBUG("6lo iphc: unsupported next header compression\n");
             return 0;
-
+        }
+        payload_offset += nhc_len;
     }
 
-    /* TODO: add next header decoding */
+    if ((offset + payload_offset) > pkt->size) {
+        DEBUG("6lo iphc: frame too short for its dispatch\n");
+        return 0;
+    }
 
     /* set IPv6 header payload length field to the length of whatever is left
      * after removing the 6LoWPAN header */
     if (datagram_size == 0) {
-        ipv6_hdr->len = byteorder_htons((uint16_t)(pkt->size - payload_offset));
+        ipv6_hdr->len = byteorder_htons((uint16_t)(pkt->size - offset - payload_offset +
+                                                   *nh_len));
     }
     else {
         ipv6_hdr->len = byteorder_htons((uint16_t)(datagram_size - sizeof(ipv6_hdr_t)));
     }
-
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+    if (*nh_len > 0) {
+        ((udp_hdr_t *)(ipv6_hdr + 1))->length = ipv6_hdr->len;
+    }
+#endif
 
     return payload_offset;
 }
 
-bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
+/* the IID compression of addr, given the IID that can be derived from the
+ * link-layer address (if any) */
+static unsigned _iid_mode(const ipv6_addr_t *addr, const eui64_t *iid,
+                          const gnrc_sixlowpan_ctx_t *ctx)
 {
-    gnrc_netif_hdr_t *netif_hdr = pkt->data;
-    ipv6_hdr_t *ipv6_hdr = pkt->next->data;
-    uint8_t *iphc_hdr;
-    uint16_t inline_pos = SIXLOWPAN_IPHC_HDR_LEN;
-    bool addr_comp = false;
-    gnrc_sixlowpan_ctx_t *src_ctx = NULL, *dst_ctx = NULL;
-    gnrc_pktsnip_t *dispatch = gnrc_pktbuf_add(NULL, NULL, pkt->next->size,
-                                               GNRC_NETTYPE_SIXLOWPAN);
+    if ((iid != NULL) && ((addr->u64[1].u64 == iid->uint64.u64) ||
+                          _context_overlaps_iid(ctx, addr, iid))) {
+        return IPHC_ADDR_L2;
+    }
+    if ((byteorder_ntohl(addr->u32[2]) == 0x000000ff) &&
+        (byteorder_ntohs(addr->u16[6]) == 0xfe00)) {
+        return IPHC_ADDR_16;
+    }
+    return IPHC_ADDR_64;
+}
 
-    if (dispatch == NULL) {
-        DEBUG("6lo iphc: error allocating dispatch space\n");
-        return false;
+static eui64_t *_src_iid(eui64_t *iid, gnrc_netif_hdr_t *netif_hdr)
+{
+    /* prefer to create IID from netif header if available */
+    if (ieee802154_get_iid(iid, gnrc_netif_hdr_get_src_addr(netif_hdr),
+                           netif_hdr->src_l2addr_len) != NULL) {
+        return iid;
     }
+    /* but take from driver otherwise */
+    if (gnrc_netapi_get(netif_hdr->if_pid, NETOPT_IPV6_IID, 0, iid, sizeof(eui64_t)) < 0) {
+        return NULL;
+    }
+    return iid;
+}
 
-    iphc_hdr = dispatch->data;
+/* the DAM for a multicast address, IPHC_M_FULL if it can not be compressed */
+static unsigned _mcast_mode(const ipv6_addr_t *addr)
+{
+    unsigned i = 2;
+
+    /* find the first non-zero byte after flags and scope */
+    while ((i < (sizeof(ipv6_addr_t) - 1)) && (addr->u8[i] == 0)) {
+        i++;
+    }
+    if ((i == (sizeof(ipv6_addr_t) - 1)) && (addr->u8[1] == 0x02)) {
+        return IPHC_M_8;
+    }
+    for (unsigned mode = IPHC_M_32; mode > IPHC_M_FULL; mode--) {
+        if (i >= (sizeof(ipv6_addr_t) - (_mcast_inline_len[mode] - 1))) {
+            return mode;
+        }
+    }
+    return IPHC_M_FULL;
+}
+
+/* the context of a unicast prefix based multicast address (RFC 3306), if
+ * its prefix can be elided */
+static gnrc_sixlowpan_ctx_t *_mcast_uc_prefix_ctx(const ipv6_addr_t *addr)
+{
+    ipv6_addr_t prefix = IPV6_ADDR_UNSPECIFIED, expected = IPV6_ADDR_UNSPECIFIED;
+    gnrc_sixlowpan_ctx_t *ctx;
+
+    memcpy(&prefix, &addr->u8[4], sizeof(network_uint64_t));
+    ctx = _comp_ctx(gnrc_sixlowpan_ctx_lookup_addr(&prefix));
+    if ((ctx == NULL) || (ctx->prefix_len > 64) || (ctx->prefix_len != addr->u8[3])) {
+        return NULL;
+    }
+    /* bits behind the prefix length are not carried */
+    ipv6_addr_init_prefix(&expected, &ctx->prefix, ctx->prefix_len);
+    if (memcmp(&expected, &prefix, sizeof(network_uint64_t)) != 0) {
+        return NULL;
+    }
+    return ctx;
+}
+
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+/* encodes NHC dispatch and ports, but not the checksum */
+static size_t _encode_nhc_udp(uint8_t *nhc, const udp_hdr_t *udp_hdr)
+{
+    uint16_t src_port = byteorder_ntohs(udp_hdr->src_port);
+    uint16_t dst_port = byteorder_ntohs(udp_hdr->dst_port);
+    size_t pos = 1;
+
+    if (((src_port & NHC_UDP_4BIT_MASK) == NHC_UDP_4BIT_PORT) &&
+        ((dst_port & NHC_UDP_4BIT_MASK) == NHC_UDP_4BIT_PORT)) {
+        nhc[0] = NHC_UDP_ID | NHC_UDP_SD_ELIDED;
+        nhc[pos++] = (uint8_t)(((src_port & 0x0f) << 4) | (dst_port & 0x0f));
+    }
+    else if ((dst_port & NHC_UDP_8BIT_MASK) == NHC_UDP_8BIT_PORT) {
+        nhc[0] = NHC_UDP_ID | NHC_UDP_S_INL;
+        memcpy(nhc + pos, &udp_hdr->src_port, sizeof(network_uint16_t));
+        nhc[pos + 2] = (uint8_t)dst_port;
+        pos += 3;
+    }
+    else if ((src_port & NHC_UDP_8BIT_MASK) == NHC_UDP_8BIT_PORT) {
+        nhc[0] = NHC_UDP_ID | NHC_UDP_D_INL;
+        nhc[pos] = (uint8_t)src_port;
+        memcpy(nhc + pos + 1, &udp_hdr->dst_port, sizeof(network_uint16_t));
+        pos += 3;
+    }
+    else {
+        nhc[0] = NHC_UDP_ID | NHC_UDP_SD_INL;
+        memcpy(nhc + pos, &udp_hdr->src_port, sizeof(network_uint16_t));
+        memcpy(nhc + pos + 2, &udp_hdr->dst_port, sizeof(network_uint16_t));
+        pos += 4;
+    }
+    return pos;
+}
+#endif
+
+/* writes the compressed headers without the UDP checksum to iphc_hdr, ending
+ * with the GHC dispatch if ghc is set */
+static size_t _encode(uint8_t *iphc_hdr, gnrc_netif_hdr_t *netif_hdr,
+                      const ipv6_hdr_t *ipv6_hdr, const udp_hdr_t *udp_hdr, bool ghc)
+{
+    gnrc_sixlowpan_ctx_t *src_ctx = NULL, *dst_ctx = NULL;
+    size_t inline_pos = SIXLOWPAN_IPHC_HDR_LEN;
+    uint32_t fl = ipv6_hdr_get_fl(ipv6_hdr);
+    uint8_t tc = ipv6_hdr_get_tc(ipv6_hdr);
+    /* traffic class is DSCP + ECN (RFC 3168), but carried as ECN + DSCP */
+    uint8_t tc_inl = (uint8_t)((tc << 6) | (tc >> 2));
+    uint8_t cid = 0;
+    unsigned mode;
 
     /* set initial dispatch value*/
     iphc_hdr[IPHC1_IDX] = SIXLOWPAN_IPHC1_DISP;
     iphc_hdr[IPHC2_IDX] = 0;
 
-    /* check for available contexts */
+    /* check for available contexts, the CID extension precedes all inline
+     * fields */
     if (!ipv6_addr_is_unspecified(&(ipv6_hdr->src))) {
-        src_ctx = gnrc_sixlowpan_ctx_lookup_addr(&(ipv6_hdr->src));
+        src_ctx = _comp_ctx(gnrc_sixlowpan_ctx_lookup_addr(&(ipv6_hdr->src)));
     }
-
-    if (!ipv6_addr_is_multicast(&ipv6_hdr->dst)) {
-        dst_ctx = gnrc_sixlowpan_ctx_lookup_addr(&(ipv6_hdr->dst));
+    if (ipv6_addr_is_multicast(&ipv6_hdr->dst)) {
+        dst_ctx = _mcast_uc_prefix_ctx(&ipv6_hdr->dst);
     }
-
-    /* if contexts available and both != 0 */
-    /* since this moves inline_pos we have to do this ahead*/
-    if (((src_ctx != NULL) &&
-         ((src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0) &&
-         (src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_COMP)) ||
-        ((dst_ctx != NULL) &&
-         ((dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0) &&
-         (dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_COMP))) {
+    else {
+        dst_ctx = _comp_ctx(gnrc_sixlowpan_ctx_lookup_addr(&(ipv6_hdr->dst)));
+    }
+    if (src_ctx != NULL) {
+        cid |= (src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) << 4;
+    }
+    if (dst_ctx != NULL) {
+        cid |= (dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
+    }
+    if (cid != 0) {
         /* add context identifier extension */
         iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_CID_EXT;
-        iphc_hdr[CID_EXT_IDX] = 0;
-
-        /* move position to behind CID extension */
-        inline_pos += SIXLOWPAN_IPHC_CID_EXT_LEN;
+        iphc_hdr[inline_pos++] = cid;
     }
 
     /* compress flow label and traffic class */
-    if (ipv6_hdr_get_fl(ipv6_hdr) == 0) {
-        if (ipv6_hdr_get_tc(ipv6_hdr) == 0) {
+    if (fl == 0) {
+        if (tc == 0) {
             /* elide both traffic class and flow label */
             iphc_hdr[IPHC1_IDX] |= IPHC_TF_ECN_ELIDE;
         }
         else {
             /* elide flow label, traffic class (ECN + DSCP) inline (1 byte) */
             iphc_hdr[IPHC1_IDX] |= IPHC_TF_ECN_DSCP;
-            iphc_hdr[inline_pos++] = ipv6_hdr_get_tc(ipv6_hdr);
+            iphc_hdr[inline_pos++] = tc_inl;
         }
     }
     else {
-        if (ipv6_hdr_get_tc_dscp(ipv6_hdr) == 0) {
+        if ((tc >> 2) == 0) {
             /* elide DSCP, ECN + 2-bit pad + flow label inline (3 byte) */
             iphc_hdr[IPHC1_IDX] |= IPHC_TF_ECN_FL;
-            iphc_hdr[inline_pos++] = (uint8_t)((ipv6_hdr_get_tc_ecn(ipv6_hdr) << 6) |
-                                               ((ipv6_hdr_get_fl(ipv6_hdr) & 0x000f0000) >> 16));
+            iphc_hdr[inline_pos++] = (uint8_t)((tc_inl & 0xc0) | ((fl & 0x000f0000) >> 16));
         }
         else {
             /* ECN + DSCP + 4-bit pad + flow label (4 bytes) */
             iphc_hdr[IPHC1_IDX] |= IPHC_TF_ECN_DSCP_FL;
-            iphc_hdr[inline_pos++] = ipv6_hdr_get_tc(ipv6_hdr);
-            iphc_hdr[inline_pos++] = (uint8_t)((ipv6_hdr_get_fl(ipv6_hdr) & 0x000f0000) >> 16);
+            iphc_hdr[inline_pos++] = tc_inl;
+            iphc_hdr[inline_pos++] = (uint8_t)((fl & 0x000f0000) >> 16);
         }
 
-        /* copy remaining byteos of flow label */
-        iphc_hdr[inline_pos++] = (uint8_t)((ipv6_hdr_get_fl(ipv6_hdr) & 0x0000ff00) >> 8);
-        iphc_hdr[inline_pos++] = (uint8_t)((ipv6_hdr_get_fl(ipv6_hdr) & 0x000000ff) >> 8);
+        /* copy remaining bytes of flow label */
+        iphc_hdr[inline_pos++] = (uint8_t)((fl & 0x0000ff00) >> 8);
+        iphc_hdr[inline_pos++] = (uint8_t)(fl & 0x000000ff);
     }
 
     /* compress next header */
-    switch (ipv6_hdr->nh) {
-        /* TODO: add next header compression and set NH bit */
-        default:
-            iphc_hdr[inline_pos++] = ipv6_hdr->nh;
-            break;
+    if ((udp_hdr != NULL) || ghc) {
+        iphc_hdr[IPHC1_IDX] |= SIXLOWPAN_IPHC1_NH;
+    }
+    else {
+        iphc_hdr[inline_pos++] = ipv6_hdr->nh;
     }
 
     /* compress hop limit */
-    switch (ipv6_hdr->hl) {
-        case 1:
-            iphc_hdr[IPHC1_IDX] |= IPHC_HL_1;
-            break;
-
-        case 64:
-            iphc_hdr[IPHC1_IDX] |= IPHC_HL_64;
-            break;
-
-        case 255:
-            iphc_hdr[IPHC1_IDX] |= IPHC_HL_255;
-            break;
-
-        default:
-            iphc_hdr[IPHC1_IDX] |= IPHC_HL_INLINE;
-            iphc_hdr[inline_pos++] = ipv6_hdr->hl;
+    for (mode = SIXLOWPAN_IPHC1_HL; mode > IPHC_HL_INLINE; mode--) {
+        if (_hl[mode] == ipv6_hdr->hl) {
             break;
+        }
+    }
+    iphc_hdr[IPHC1_IDX] |= mode;
+    if (mode == IPHC_HL_INLINE) {
+        iphc_hdr[inline_pos++] = ipv6_hdr->hl;
     }
 
     if (ipv6_addr_is_unspecified(&(ipv6_hdr->src))) {
-        iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_UNSPEC;
+        iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_SAC;
     }
     else {
-        if ((src_ctx != NULL) && (src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_COMP)) {
-            /* stateful source address compression */
-            iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_SAC;
-
-            if (((src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0)) {
-                iphc_hdr[CID_EXT_IDX] |= ((src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) << 4);
-            }
-        }
-
+        mode = IPHC_ADDR_FULL;
         if ((src_ctx != NULL) || ipv6_addr_is_link_local(&(ipv6_hdr->src))) {
             eui64_t iid;
-            iid.uint64.u64 = 0;
-
-            if ((netif_hdr->src_l2addr_len == 2) ||
-                (netif_hdr->src_l2addr_len == 4) ||
-                (netif_hdr->src_l2addr_len == 8)) {
-                /* prefer to create IID from netif header if available */
-                ieee802154_get_iid(&iid, gnrc_netif_hdr_get_src_addr(netif_hdr),
-                                   netif_hdr->src_l2addr_len);
-            }
-            else {
-                /* but take from driver otherwise */
-                gnrc_netapi_get(netif_hdr->if_pid, NETOPT_IPV6_IID, 0, &iid,
-                                sizeof(eui64_t));
-            }
 
-            if ((ipv6_hdr->src.u64[1].u64 == iid.uint64.u64) ||
-                _context_overlaps_iid(src_ctx, &ipv6_hdr->src, &iid)) {
-                /* 0 bits. The address is derived from link-layer address */
-                iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_L2;
-                addr_comp = true;
-            }
-            else if ((byteorder_ntohl(ipv6_hdr->src.u32[2]) == 0x000000ff) &&
-                     (byteorder_ntohs(ipv6_hdr->src.u16[6]) == 0xfe00)) {
-                /* 16 bits. The address is derived using 16 bits carried inline */
-                iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_16;
-                memcpy(iphc_hdr + inline_pos, ipv6_hdr->src.u16 + 7, 2);
-                inline_pos += 2;
-                addr_comp = true;
-            }
-            else {
-                /* 64 bits. The address is derived using 64 bits carried inline */
-                iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_64;
-                memcpy(iphc_hdr + inline_pos, ipv6_hdr->src.u64 + 1, 8);
-                inline_pos += 8;
-                addr_comp = true;
+            mode = _iid_mode(&ipv6_hdr->src, _src_iid(&iid, netif_hdr), src_ctx);
+            if (src_ctx != NULL) {
+                /* stateful source address compression */
+                iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_SAC;
             }
         }
-
-        if (!addr_comp) {
-            /* full address is carried inline */
-            iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_FULL;
-            memcpy(iphc_hdr + inline_pos, &ipv6_hdr->src, 16);
-            inline_pos += 16;
-        }
+        iphc_hdr[IPHC2_IDX] |= mode << IPHC_SAM_POS;
+        memcpy(iphc_hdr + inline_pos,
+               &ipv6_hdr->src.u8[sizeof(ipv6_addr_t) - _addr_inline_len[mode]],
+               _addr_inline_len[mode]);
+        inline_pos += _addr_inline_len[mode];
     }
 
-    addr_comp = false;
-
-    /* M: Multicast compression */
     if (ipv6_addr_is_multicast(&(ipv6_hdr->dst))) {
         iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_M;
+        if (dst_ctx != NULL) {
+            /* Unicast prefix based IPv6 multicast address
+             * (https://tools.ietf.org/html/rfc3306) with given context
+             * for unicast prefix -> context based compression */
+            iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_DAC;
+            iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[1];
+            iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[2];
+            memcpy(iphc_hdr + inline_pos, &ipv6_hdr->dst.u8[12], sizeof(network_uint32_t));
+            inline_pos += sizeof(network_uint32_t);
+        }
+        else {
+            uint8_t len;
 
-        /* if multicast address is of format ffXX::XXXX:XXXX:XXXX */
-        if ((ipv6_hdr->dst.u16[1].u16 == 0) &&
-            (ipv6_hdr->dst.u32[1].u32 == 0) &&
-            (ipv6_hdr->dst.u16[4].u16 == 0)) {
-            /* if multicast address is of format ff02::XX */
-            if ((ipv6_hdr->dst.u8[1] == 0x02) &&
-                (ipv6_hdr->dst.u32[2].u32 == 0) &&
-                (ipv6_hdr->dst.u16[6].u16 == 0) &&
-                (ipv6_hdr->dst.u8[14] == 0)) {
-                /* 8 bits. The address is derived using 8 bits carried inline */
-                iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_M_8;
-                iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[15];
-                addr_comp = true;
-            }
-            /* if multicast address is of format ffXX::XX:XXXX */
-            else if ((ipv6_hdr->dst.u16[5].u16 == 0) &&
-                     (ipv6_hdr->dst.u8[12] == 0)) {
-                /* 32 bits. The address is derived using 32 bits carried inline */
-                iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_M_32;
+            mode = _mcast_mode(&ipv6_hdr->dst);
+            len = _mcast_inline_len[mode];
+            iphc_hdr[IPHC2_IDX] |= mode;
+            if ((mode != IPHC_M_FULL) && (mode != IPHC_M_8)) {
+                /* flags and scope precede the tail of the address */
                 iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[1];
-                memcpy(iphc_hdr + inline_pos, ipv6_hdr->dst.u8 + 13, 3);
-                inline_pos += 3;
-                addr_comp = true;
-            }
-            /* if multicast address is of format ffXX::XX:XXXX:XXXX */
-            else if (ipv6_hdr->dst.u8[10] == 0) {
-                /* 48 bits. The address is derived using 48 bits carried inline */
-                iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_M_48;
-                iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[1];
-                memcpy(iphc_hdr + inline_pos, ipv6_hdr->dst.u8 + 11, 5);
-                inline_pos += 5;
-                addr_comp = true;
+                len--;
             }
+            memcpy(iphc_hdr + inline_pos, &ipv6_hdr->dst.u8[sizeof(ipv6_addr_t) - len], len);
+            inline_pos += len;
         }
-        /* try unicast prefix based compression */
-        else {
-            gnrc_sixlowpan_ctx_t *ctx;
-            ipv6_addr_t unicast_prefix;
-            unicast_prefix.u16[0] = ipv6_hdr->dst.u16[2];
-            unicast_prefix.u16[1] = ipv6_hdr->dst.u16[3];
-            unicast_prefix.u16[2] = ipv6_hdr->dst.u16[4];
-            unicast_prefix.u16[3] = ipv6_hdr->dst.u16[5];
-
-            ctx = gnrc_sixlowpan_ctx_lookup_addr(&unicast_prefix);
-
-            if ((ctx != NULL) && (ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_COMP) &&
-                (ctx->prefix_len == ipv6_hdr->dst.u8[3])) {
-                /* Unicast prefix based IPv6 multicast address
-                 * (https://tools.ietf.org/html/rfc3306) with given context
-                 * for unicast prefix -> context based compression */
+    }
+    else {
+        mode = IPHC_ADDR_FULL;
+        if ((dst_ctx != NULL) || ipv6_addr_is_link_local(&ipv6_hdr->dst)) {
+            eui64_t iid;
+
+            mode = _iid_mode(&ipv6_hdr->dst,
+                             ieee802154_get_iid(&iid, gnrc_netif_hdr_get_dst_addr(netif_hdr),
+                                                netif_hdr->dst_l2addr_len),
+                             dst_ctx);
+            if (dst_ctx != NULL) {
+                /* stateful destination address compression */
                 iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_DAC;
-                if ((ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0) {
-                    iphc_hdr[CID_EXT_IDX] |= (ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
-                }
-                iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[1];
-                iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[2];
-                memcpy(iphc_hdr + inline_pos, ipv6_hdr->dst.u16 + 6, 4);
-                inline_pos += 4;
-                addr_comp = true;
             }
         }
+        iphc_hdr[IPHC2_IDX] |= mode;
+        memcpy(iphc_hdr + inline_pos,
+               &ipv6_hdr->dst.u8[sizeof(ipv6_addr_t) - _addr_inline_len[mode]],
+               _addr_inline_len[mode]);
+        inline_pos += _addr_inline_len[mode];
     }
-    else if ((((dst_ctx != NULL) && (dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_COMP)) ||
-              ipv6_addr_is_link_local(&ipv6_hdr->dst)) && (netif_hdr->dst_l2addr_len > 0)) {
-        eui64_t iid;
 
-        if (dst_ctx != NULL) {
-            /* stateful destination address compression */
-            iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_DAC;
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+    if (udp_hdr != NULL) {
+        inline_pos += _encode_nhc_udp(iphc_hdr + inline_pos, udp_hdr);
+    }
+#endif
+    if (ghc) {
+        iphc_hdr[inline_pos++] = SIXLOWPAN_NHC_GHC_ICMPV6;
+    }
 
-            if (((dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0)) {
-                iphc_hdr[CID_EXT_IDX] |= (dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
-            }
-        }
+    return inline_pos;
+}
+
+#if GNRC_SIXLOWPAN_IPHC_FLOWS
+static inline unsigned _flow_idx(const _flow_key_t *key)
+{
+    return (key->src.u8[15] ^ key->dst.u8[15] ^ key->src_port.u8[1] ^
+            key->dst_port.u8[1] ^ key->nh) & (GNRC_SIXLOWPAN_IPHC_FLOWS - 1);
+}
 
-        ieee802154_get_iid(&iid, gnrc_netif_hdr_get_dst_addr(netif_hdr),
-                           netif_hdr->dst_l2addr_len);
+/* like _encode(), but reuses the template of an earlier packet of the flow */
+static size_t _encode_flow(uint8_t *iphc_hdr, gnrc_netif_hdr_t *netif_hdr,
+                           const ipv6_hdr_t *ipv6_hdr, const udp_hdr_t *udp_hdr, bool ghc)
+{
+    _flow_key_t key;
+    _flow_t *flow;
+    uint32_t now = xtimer_now();
+    uint16_t ctx_generation = gnrc_sixlowpan_ctx_generation();
+    size_t len;
+
+    if ((netif_hdr->src_l2addr_len > sizeof(key.src_l2addr)) ||
+        (netif_hdr->dst_l2addr_len > sizeof(key.dst_l2addr))) {
+        return _encode(iphc_hdr, netif_hdr, ipv6_hdr, udp_hdr, ghc);
+    }
+    /* padding must compare equal, too */
+    memset(&key, 0, sizeof(key));
+    key.src = ipv6_hdr->src;
+    key.dst = ipv6_hdr->dst;
+    key.v_tc_fl = ipv6_hdr->v_tc_fl;
+    if (udp_hdr != NULL) {
+        key.src_port = udp_hdr->src_port;
+        key.dst_port = udp_hdr->dst_port;
+        key.udp = 1;
+    }
+    key.ghc = ghc;
+    memcpy(key.src_l2addr, gnrc_netif_hdr_get_src_addr(netif_hdr), netif_hdr->src_l2addr_len);
+    memcpy(key.dst_l2addr, gnrc_netif_hdr_get_dst_addr(netif_hdr), netif_hdr->dst_l2addr_len);
+    key.iface = netif_hdr->if_pid;
+    key.src_l2addr_len = netif_hdr->src_l2addr_len;
+    key.dst_l2addr_len = netif_hdr->dst_l2addr_len;
+    key.nh = ipv6_hdr->nh;
+    key.hl = ipv6_hdr->hl;
+
+    flow = &_flows[_flow_idx(&key)];
+    if ((flow->len > 0) && (flow->ctx_generation == ctx_generation) &&
+        ((now - flow->created) < GNRC_SIXLOWPAN_IPHC_FLOW_LIFETIME) &&
+        (memcmp(&flow->key, &key, sizeof(key)) == 0)) {
+        memcpy(iphc_hdr, flow->tmpl, flow->len);
+        return flow->len;
+    }
+    len = _encode(iphc_hdr, netif_hdr, ipv6_hdr, udp_hdr, ghc);
+    flow->key = key;
+    flow->created = now;
+    flow->ctx_generation = ctx_generation;
+    flow->len = (uint8_t)len;
+    memcpy(flow->tmpl, iphc_hdr, len);
+    return len;
+}
+#endif
 
-        if ((ipv6_hdr->dst.u64[1].u64 == iid.uint64.u64) ||
-            _context_overlaps_iid(dst_ctx, &(ipv6_hdr->dst), &iid)) {
-            /* 0 bits. The address is derived using the link-layer address */
-            iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_U_L2;
-            addr_comp = true;
-        }
-        else if ((byteorder_ntohl(ipv6_hdr->dst.u32[2]) == 0x000000ff) &&
-                 (byteorder_ntohs(ipv6_hdr->dst.u16[6]) == 0xfe00)) {
-            /* 16 bits. The address is derived using 16 bits carried inline */
-            iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_U_16;
-            memcpy(&(iphc_hdr[inline_pos]), &(ipv6_hdr->dst.u16[7]), 2);
-            inline_pos += 2;
-            addr_comp = true;
-        }
-        else {
-            /* 64 bits. The address is derived using 64 bits carried inline */
-            iphc_hdr[IPHC2_IDX] |= IPHC_M_DAC_DAM_U_64;
-            memcpy(&(iphc_hdr[inline_pos]), &(ipv6_hdr->dst.u8[8]), 8);
-            inline_pos += 8;
-            addr_comp = true;
-        }
+#ifdef MODULE_GNRC_SIXLOWPAN_GHC
+/* compresses the ICMPv6 message behind ipv6 into _ghc_out, returns 0 if it
+ * does not get shorter */
+static size_t _encode_ghc(gnrc_pktsnip_t *ipv6)
+{
+    size_t len = gnrc_pkt_len(ipv6->next), pos = 0;
+
+    /* a forwarded first fragment does not carry all of the message */
+    if ((len < 2) || (len > sizeof(_ghc_in)) ||
+        (len != byteorder_ntohs(((ipv6_hdr_t *)ipv6->data)->len))) {
+        return 0;
     }
+    for (gnrc_pktsnip_t *ptr = ipv6->next; ptr != NULL; ptr = ptr->next) {
+        memcpy(&_ghc_in[pos], ptr->data, ptr->size);
+        pos += ptr->size;
+    }
+    /* the GHC dispatch replaces the next header byte, so any saved byte
+     * counts */
+    return gnrc_sixlowpan_ghc_compress(_ghc_out, len - 1, ipv6->data, _ghc_in, len);
+}
+#endif
 
-    if (!addr_comp) {
-        /* full destination address is carried inline */
-        iphc_hdr[IPHC2_IDX] |= IPHC_SAC_SAM_FULL;
-        memcpy(iphc_hdr + inline_pos, &ipv6_hdr->dst, 16);
-        inline_pos += 16;
+static inline size_t _encode_hdrs(uint8_t *iphc_hdr, gnrc_netif_hdr_t *netif_hdr,
+                                  const ipv6_hdr_t *ipv6_hdr, const udp_hdr_t *udp_hdr,
+                                  bool ghc)
+{
+#if GNRC_SIXLOWPAN_IPHC_FLOWS
+    return _encode_flow(iphc_hdr, netif_hdr, ipv6_hdr, udp_hdr, ghc);
+#else
+    return _encode(iphc_hdr, netif_hdr, ipv6_hdr, udp_hdr, ghc);
+#endif
+}
+
+bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
+{
+    gnrc_netif_hdr_t *netif_hdr = pkt->data;
+    gnrc_pktsnip_t *ipv6 = pkt->next, *udp = NULL, *dispatch;
+    ipv6_hdr_t *ipv6_hdr = ipv6->data;
+    udp_hdr_t *udp_hdr = NULL;
+    uint8_t iphc_hdr[IPHC_MAX_LEN];
+    size_t len, ghc_len = 0;
+
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+    /* only a UDP header in a snip of its own is compressed */
+    if ((ipv6_hdr->nh == PROTNUM_UDP) && (ipv6->next != NULL) &&
+        (ipv6->next->size == sizeof(udp_hdr_t))) {
+        udp = ipv6->next;
+        udp_hdr = udp->data;
+    }
+#endif
+
+#ifdef MODULE_GNRC_SIXLOWPAN_GHC
+    if ((ipv6_hdr->nh == PROTNUM_ICMPV6) && (ipv6->next != NULL) &&
+        gnrc_sixlowpan_ghc_supported(netif_hdr, ipv6_hdr)) {
+        ghc_len = _encode_ghc(ipv6);
+    }
+#endif
+    len = _encode_hdrs(iphc_hdr, netif_hdr, ipv6_hdr, udp_hdr, (ghc_len > 0));
+#ifdef MODULE_GNRC_SIXLOWPAN_GHC
+    if (ghc_len > 0) {
+        gnrc_sixlowpan_netif_t *iface = gnrc_sixlowpan_netif_get(netif_hdr->if_pid);
+
+        /* a receiver can not decompress GHC in a fragmented datagram */
+        if ((iface == NULL) || ((len + ghc_len) > iface->max_frag_size)) {
+            ghc_len = 0;
+            len = _encode_hdrs(iphc_hdr, netif_hdr, ipv6_hdr, udp_hdr, false);
+        }
+    }
+#endif
+    if (udp_hdr != NULL) {
+        /* the checksum is always carried inline */
+        memcpy(iphc_hdr + len, &udp_hdr->checksum, sizeof(network_uint16_t));
+        len += sizeof(network_uint16_t);
     }
 
-    /* shrink dispatch allocation to final size */
-    /* NOTE: Since this only shrinks the data nothing bad SHOULD happen ;-) */
-    gnrc_pktbuf_realloc_data(dispatch, (size_t)inline_pos);
+    dispatch = gnrc_pktbuf_add(NULL, NULL, len + ghc_len, GNRC_NETTYPE_SIXLOWPAN);
+    if (dispatch == NULL) {
+        DEBUG("6lo iphc: error allocating dispatch space\n");
+        return false;
+    }
+    memcpy(dispatch->data, iphc_hdr, len);
 
-    /* remove IPv6 header */
-    pkt = gnrc_pktbuf_remove_snip(pkt, pkt->next);
+    /* remove UDP and IPv6 header */
+    if (udp != NULL) {
+        gnrc_pktbuf_remove_snip(pkt, udp);
+    }
+#ifdef MODULE_GNRC_SIXLOWPAN_GHC
+    if (ghc_len > 0) {
+        /* the ICMPv6 message is carried by the dispatch */
+        memcpy(((uint8_t *)dispatch->data) + len, _ghc_out, ghc_len);
+        while (ipv6->next != NULL) {
+            gnrc_pktbuf_remove_snip(pkt, ipv6->next);
+        }
+    }
+#endif
+    pkt = gnrc_pktbuf_remove_snip(pkt, ipv6);
 
     /* insert dispatch into packet */
     dispatch->next = pkt->next;
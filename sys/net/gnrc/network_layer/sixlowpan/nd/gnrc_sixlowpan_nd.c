@@ -390,6 +390,44 @@ bool gnrc_sixlowpan_nd_opt_6ctx_handle(uint8_t icmpv6_type, sixlowpan_nd_opt_6ct
     return true;
 }
 
+#ifdef MODULE_GNRC_SIXLOWPAN_GHC
+gnrc_pktsnip_t *gnrc_sixlowpan_nd_opt_6cio_build(gnrc_pktsnip_t *next)
+{
+    gnrc_pktsnip_t *pkt = gnrc_ndp_opt_build(NDP_OPT_6CIO, sizeof(sixlowpan_nd_opt_6cio_t),
+                                             next);
+
+    if (pkt != NULL) {
+        sixlowpan_nd_opt_6cio_t *cio_opt = pkt->data;
+        cio_opt->flags = byteorder_htons(SIXLOWPAN_ND_OPT_6CIO_FLAGS_G);
+        memset(cio_opt->resv, 0, sizeof(cio_opt->resv));
+    }
+
+    return pkt;
+}
+
+void gnrc_sixlowpan_nd_opt_6cio_handle(kernel_pid_t iface, const ipv6_addr_t *src,
+                                       const sixlowpan_nd_opt_6cio_t *cio_opt)
+{
+    gnrc_ipv6_nc_t *nc_entry;
+
+    if (cio_opt->len < SIXLOWPAN_ND_OPT_6CIO_LEN) {
+        DEBUG("6lo nd: invalid 6LoWPAN capability indication option received\n");
+        return;
+    }
+    if (ipv6_addr_is_unspecified(src) ||
+        ((nc_entry = gnrc_ipv6_nc_get(iface, src)) == NULL)) {
+        /* no neighbor to remember the capability for */
+        return;
+    }
+    if (byteorder_ntohs(cio_opt->flags) & SIXLOWPAN_ND_OPT_6CIO_FLAGS_G) {
+        nc_entry->flags |= GNRC_IPV6_NC_SIXLOWPAN_GHC;
+    }
+    else {
+        nc_entry->flags &= ~GNRC_IPV6_NC_SIXLOWPAN_GHC;
+    }
+}
+#endif
+
 void gnrc_sixlowpan_nd_wakeup(void)
 {
     gnrc_ipv6_nc_t *router = gnrc_ipv6_nc_get_next_router(NULL);
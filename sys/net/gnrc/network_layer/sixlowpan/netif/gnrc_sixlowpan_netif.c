@@ -15,6 +15,7 @@
 #include "kernel_types.h"
 
 #include "net/gnrc/netif.h"
+#include "net/gnrc/sixlowpan/ghc.h"
 #include "net/gnrc/sixlowpan/netif.h"
 
 #define ENABLE_DEBUG    (0)
@@ -54,6 +55,9 @@ void gnrc_sixlowpan_netif_add(kernel_pid_t pid, uint16_t max_frag_size)
     free_entry->max_frag_size = max_frag_size;
 #ifdef MODULE_GNRC_SIXLOWPAN_IPHC
     free_entry->iphc_enabled = true;
+#endif
+#ifdef MODULE_GNRC_SIXLOWPAN_GHC
+    free_entry->ghc_mcast = GNRC_SIXLOWPAN_GHC_MCAST;
 #endif
     return;
 }
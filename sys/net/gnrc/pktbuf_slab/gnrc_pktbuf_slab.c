@@ -0,0 +1,496 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup net_gnrc_pktbuf
+ * @{
+ *
+ * @file
+ * @brief   Packet buffer implementation based on fixed-size slab pools
+ *
+ * Every size class keeps its chunks in a singly linked free list, so
+ * allocation and release are O(1). A chunk's class is derived from its
+ * address, so no per-chunk header is needed.
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "mutex.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/nettype.h"
+#include "net/gnrc/pkt.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define _ALIGNMENT_MASK     (sizeof(void *) - 1)
+#define _ALIGN(size)        (((size) + _ALIGNMENT_MASK) & ~(_ALIGNMENT_MASK))
+
+#define _SNIP_SIZE          _ALIGN(sizeof(gnrc_pktsnip_t))
+#define _SMALL_SIZE         _ALIGN(GNRC_PKTBUF_SLAB_SMALL_SIZE)
+#define _LARGE_SIZE         _ALIGN(GNRC_PKTBUF_SLAB_LARGE_SIZE)
+
+typedef struct _chunk {
+    struct _chunk *next;
+} _chunk_t;
+
+/**
+ * @brief   A size class
+ */
+typedef struct {
+    uint8_t *mem;           /**< first chunk of the class */
+    _chunk_t *free;         /**< list of unused chunks */
+    size_t chunk_size;      /**< size of a single chunk */
+    unsigned numof;         /**< number of chunks */
+    unsigned used;          /**< number of chunks currently allocated */
+    unsigned max_used;      /**< high-water mark of used chunks */
+    unsigned exhausted;     /**< times the class was found empty */
+} _slab_t;
+
+static mutex_t _mutex = MUTEX_INIT;
+
+static void *_snip_mem[(GNRC_PKTBUF_SLAB_SNIP_NUMOF * _SNIP_SIZE) / sizeof(void *)];
+static void *_small_mem[(GNRC_PKTBUF_SLAB_SMALL_NUMOF * _SMALL_SIZE) / sizeof(void *)];
+static void *_large_mem[(GNRC_PKTBUF_SLAB_LARGE_NUMOF * _LARGE_SIZE) / sizeof(void *)];
+
+/* ordered by chunk size */
+static _slab_t _slabs[] = {
+    { (uint8_t *)_snip_mem, NULL, _SNIP_SIZE, GNRC_PKTBUF_SLAB_SNIP_NUMOF, 0, 0, 0 },
+    { (uint8_t *)_small_mem, NULL, _SMALL_SIZE, GNRC_PKTBUF_SLAB_SMALL_NUMOF, 0, 0, 0 },
+    { (uint8_t *)_large_mem, NULL, _LARGE_SIZE, GNRC_PKTBUF_SLAB_LARGE_NUMOF, 0, 0, 0 },
+};
+
+#define _SLABS_NUMOF        (sizeof(_slabs) / sizeof(_slabs[0]))
+
+typedef struct {
+    gnrc_pktsnip_t *pkt;            /**< snip referring to external data */
+    gnrc_pktbuf_release_cb_t cb;    /**< hands the data back to its owner */
+    void *arg;                      /**< argument for _ext_t::cb */
+} _ext_t;
+
+static _ext_t _ext[GNRC_PKTBUF_EXT_NUMOF];
+static unsigned _ext_numof;
+
+/* internal gnrc_pktbuf functions */
+static gnrc_pktsnip_t *_create_snip(gnrc_pktsnip_t *next, void *data, size_t size,
+                                    gnrc_nettype_t type);
+static void *_pktbuf_alloc(size_t size);
+static void _ext_release(gnrc_pktsnip_t *pkt);
+static void _pktbuf_free(void *data);
+
+static inline _slab_t *_slab_of(const void *ptr)
+{
+    for (unsigned i = 0; i < _SLABS_NUMOF; i++) {
+        if ((size_t)((uint8_t *)ptr - _slabs[i].mem) <
+            (_slabs[i].chunk_size * _slabs[i].numof)) {
+            return &_slabs[i];
+        }
+    }
+    return NULL;
+}
+
+static inline uint8_t *_chunk_of(_slab_t *slab, const void *ptr)
+{
+    size_t offset = (uint8_t *)ptr - slab->mem;
+    return slab->mem + (offset - (offset % slab->chunk_size));
+}
+
+/* number of bytes usable from ptr up to the end of its chunk */
+static inline size_t _capacity(const void *ptr)
+{
+    _slab_t *slab = _slab_of(ptr);
+    if (slab == NULL) {
+        return 0;
+    }
+    return (_chunk_of(slab, ptr) + slab->chunk_size) - (uint8_t *)ptr;
+}
+
+void gnrc_pktbuf_init(void)
+{
+    mutex_lock(&_mutex);
+    for (unsigned i = 0; i < _SLABS_NUMOF; i++) {
+        _slab_t *slab = &_slabs[i];
+        _chunk_t *next = NULL;
+        /* build the list back to front so it starts at the first chunk */
+        for (unsigned j = slab->numof; j > 0; j--) {
+            _chunk_t *chunk = (_chunk_t *)(slab->mem + ((j - 1) * slab->chunk_size));
+            chunk->next = next;
+            next = chunk;
+        }
+        slab->free = next;
+        slab->used = 0;
+        slab->max_used = 0;
+        slab->exhausted = 0;
+    }
+    memset(_ext, 0, sizeof(_ext));
+    _ext_numof = 0;
+    mutex_unlock(&_mutex);
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_add(gnrc_pktsnip_t *next, void *data, size_t size,
+                                gnrc_nettype_t type)
+{
+    gnrc_pktsnip_t *pkt;
+    if ((size == 0) || (size > _LARGE_SIZE)) {
+        DEBUG("pktbuf: size (%u) == 0 || size > GNRC_PKTBUF_SLAB_LARGE_SIZE (%u)\n",
+              (unsigned)size, (unsigned)_LARGE_SIZE);
+        return NULL;
+    }
+    mutex_lock(&_mutex);
+    pkt = _create_snip(next, data, size, type);
+    mutex_unlock(&_mutex);
+    return pkt;
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_add_ext(gnrc_pktsnip_t *next, void *data, size_t size,
+                                    gnrc_nettype_t type, gnrc_pktbuf_release_cb_t cb,
+                                    void *arg)
+{
+    gnrc_pktsnip_t *pkt;
+    _ext_t *ext = NULL;
+    if ((data == NULL) || (size == 0)) {
+        DEBUG("pktbuf: data == NULL (was %p) or size == 0\n", data);
+        return NULL;
+    }
+    mutex_lock(&_mutex);
+    if (cb != NULL) {
+        for (unsigned i = 0; i < GNRC_PKTBUF_EXT_NUMOF; i++) {
+            if (_ext[i].pkt == NULL) {
+                ext = &_ext[i];
+                break;
+            }
+        }
+        if (ext == NULL) {
+            DEBUG("pktbuf: no space left for release callback\n");
+            mutex_unlock(&_mutex);
+            return NULL;
+        }
+    }
+    pkt = _pktbuf_alloc(sizeof(gnrc_pktsnip_t));
+    if (pkt == NULL) {
+        DEBUG("pktbuf: error allocating new packet snip\n");
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    pkt->next = next;
+    pkt->size = size;
+    pkt->data = data;   /* not in the packet buffer, so it will not be freed */
+    pkt->type = type;
+    pkt->users = 1;
+    if (ext != NULL) {
+        ext->pkt = pkt;
+        ext->cb = cb;
+        ext->arg = arg;
+        _ext_numof++;
+    }
+    mutex_unlock(&_mutex);
+    return pkt;
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_mark(gnrc_pktsnip_t *pkt, size_t size, gnrc_nettype_t type)
+{
+    gnrc_pktsnip_t *marked_snip;
+    void *marked_data;
+    mutex_lock(&_mutex);
+    if ((size == 0) || (pkt == NULL) || (size > pkt->size) || (pkt->data == NULL)) {
+        DEBUG("pktbuf: size == 0 (was %u) or pkt == NULL (was %p) or "
+              "size > pkt->size (was %u) or pkt->data == NULL (was %p)\n",
+              (unsigned)size, (void *)pkt, (pkt ? (unsigned)pkt->size : 0),
+              (pkt ? pkt->data : NULL));
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    else if (size == pkt->size) {
+        pkt->type = type;
+        mutex_unlock(&_mutex);
+        return pkt;
+    }
+    marked_snip = _pktbuf_alloc(sizeof(gnrc_pktsnip_t));
+    if (marked_snip == NULL) {
+        DEBUG("pktbuf: could not reallocate marked section.\n");
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    /* a chunk can only have one owner: copy the marked section into a chunk
+     * of its own and let the remainder keep the tail of the original chunk */
+    marked_data = _pktbuf_alloc(size);
+    if (marked_data == NULL) {
+        DEBUG("pktbuf: could not reallocate marked section.\n");
+        _pktbuf_free(marked_snip);
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    memcpy(marked_data, pkt->data, size);
+    pkt->data = ((uint8_t *)pkt->data) + size;
+    pkt->size -= size;
+    marked_snip->next = pkt->next;
+    marked_snip->data = marked_data;
+    marked_snip->size = size;
+    marked_snip->type = type;
+    marked_snip->users = 1;
+    pkt->next = marked_snip;
+    mutex_unlock(&_mutex);
+    return marked_snip;
+}
+
+int gnrc_pktbuf_realloc_data(gnrc_pktsnip_t *pkt, size_t size)
+{
+    mutex_lock(&_mutex);
+    assert((pkt != NULL) && (pkt->data != NULL) && (_slab_of(pkt->data) != NULL));
+    if (size == 0) {
+        DEBUG("pktbuf: size == 0\n");
+        mutex_unlock(&_mutex);
+        return ENOMEM;
+    }
+    if (size > _capacity(pkt->data)) {
+        void *new_data = _pktbuf_alloc(size);
+        if (new_data == NULL) {
+            DEBUG("pktbuf: error allocating new data section\n");
+            mutex_unlock(&_mutex);
+            return ENOMEM;
+        }
+        memcpy(new_data, pkt->data, pkt->size);
+        _pktbuf_free(pkt->data);
+        pkt->data = new_data;
+    }
+    pkt->size = size;
+    mutex_unlock(&_mutex);
+    return 0;
+}
+
+void gnrc_pktbuf_hold(gnrc_pktsnip_t *pkt, unsigned int num)
+{
+    mutex_lock(&_mutex);
+    while (pkt) {
+        pkt->users += num;
+        pkt = pkt->next;
+    }
+    mutex_unlock(&_mutex);
+}
+
+void gnrc_pktbuf_release(gnrc_pktsnip_t *pkt)
+{
+    mutex_lock(&_mutex);
+    while (pkt) {
+        gnrc_pktsnip_t *tmp;
+        assert(_slab_of(pkt) != NULL);
+        tmp = pkt->next;
+        if (pkt->users == 1) {
+            pkt->users = 0; /* not necessary but to be on the safe side */
+            if (_ext_numof > 0) {
+                _ext_release(pkt);
+            }
+            _pktbuf_free(pkt->data);
+            _pktbuf_free(pkt);
+        }
+        else {
+            pkt->users--;
+        }
+        pkt = tmp;
+    }
+    mutex_unlock(&_mutex);
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_start_write(gnrc_pktsnip_t *pkt)
+{
+    mutex_lock(&_mutex);
+    if ((pkt == NULL) || (pkt->size == 0)) {
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    if (pkt->users > 1) {
+        gnrc_pktsnip_t *new;
+        new = _create_snip(pkt->next, pkt->data, pkt->size, pkt->type);
+        if (new != NULL) {
+            pkt->users--;
+        }
+        mutex_unlock(&_mutex);
+        return new;
+    }
+    mutex_unlock(&_mutex);
+    return pkt;
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_get_iovec(gnrc_pktsnip_t *pkt, size_t *len)
+{
+    size_t length;
+    gnrc_pktsnip_t *head;
+    struct iovec *vec;
+
+    if (pkt == NULL) {
+        *len = 0;
+        return NULL;
+    }
+
+    /* count the number of snips in the packet and allocate the IOVEC */
+    length = gnrc_pkt_count(pkt);
+    head = gnrc_pktbuf_add(pkt, NULL, (length * sizeof(struct iovec)),
+                           GNRC_NETTYPE_IOVEC);
+    if (head == NULL) {
+        *len = 0;
+        return NULL;
+    }
+    vec = (struct iovec *)(head->data);
+    /* fill the IOVEC */
+    while (pkt != NULL) {
+        vec->iov_base = pkt->data;
+        vec->iov_len = pkt->size;
+        ++vec;
+        pkt = pkt->next;
+    }
+    *len = length;
+    return head;
+}
+
+#ifdef DEVELHELP
+void gnrc_pktbuf_stats(void)
+{
+    static const char *names[] = { "snip", "small", "large" };
+
+    mutex_lock(&_mutex);
+    puts("packet buffer (slab):");
+    for (unsigned i = 0; i < _SLABS_NUMOF; i++) {
+        _slab_t *slab = &_slabs[i];
+        printf("  %-5s: chunk size: %4u, used: %3u/%3u, max: %3u, exhausted: %u\n",
+               names[i], (unsigned)slab->chunk_size, slab->used, slab->numof,
+               slab->max_used, slab->exhausted);
+    }
+    mutex_unlock(&_mutex);
+}
+#endif
+
+#ifdef TEST_SUITES
+bool gnrc_pktbuf_is_empty(void)
+{
+    for (unsigned i = 0; i < _SLABS_NUMOF; i++) {
+        if (_slabs[i].used != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool gnrc_pktbuf_is_sane(void)
+{
+    /* Invariants of this implementation:
+     *  - forall slabs: every element of the free list lies on a chunk boundary
+     *    within the slab's memory
+     *  - forall slabs: length of the free list == numof - used
+     *  - forall slabs: used <= max_used <= numof
+     */
+    for (unsigned i = 0; i < _SLABS_NUMOF; i++) {
+        _slab_t *slab = &_slabs[i];
+        unsigned unused = 0;
+
+        for (_chunk_t *ptr = slab->free; ptr != NULL; ptr = ptr->next) {
+            if (_slab_of(ptr) != slab) {
+                return false;
+            }
+            if (((uint8_t *)ptr - slab->mem) % slab->chunk_size) {
+                return false;
+            }
+            if (++unused > slab->numof) {
+                return false;
+            }
+        }
+        if ((unused != (slab->numof - slab->used)) ||
+            (slab->used > slab->max_used) || (slab->max_used > slab->numof)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+#endif
+
+static gnrc_pktsnip_t *_create_snip(gnrc_pktsnip_t *next, void *data, size_t size,
+                                    gnrc_nettype_t type)
+{
+    gnrc_pktsnip_t *pkt = _pktbuf_alloc(sizeof(gnrc_pktsnip_t));
+    void *_data;
+    if (pkt == NULL) {
+        DEBUG("pktbuf: error allocating new packet snip\n");
+        return NULL;
+    }
+    _data = _pktbuf_alloc(size);
+    if (_data == NULL) {
+        DEBUG("pktbuf: error allocating data for new packet snip\n");
+        _pktbuf_free(pkt);
+        return NULL;
+    }
+    pkt->next = next;
+    pkt->size = size;
+    pkt->data = _data;
+    pkt->type = type;
+    pkt->users = 1;
+    if (data != NULL) {
+        memcpy(_data, data, size);
+    }
+    return pkt;
+}
+
+static void _ext_release(gnrc_pktsnip_t *pkt)
+{
+    for (unsigned i = 0; i < GNRC_PKTBUF_EXT_NUMOF; i++) {
+        if (_ext[i].pkt == pkt) {
+            _ext[i].pkt = NULL;
+            _ext_numof--;
+            _ext[i].cb(_ext[i].arg);
+            return;
+        }
+    }
+}
+
+static void *_pktbuf_alloc(size_t size)
+{
+    /* take the smallest fitting class; if it is exhausted borrow from the
+     * next larger one */
+    for (unsigned i = 0; i < _SLABS_NUMOF; i++) {
+        _slab_t *slab = &_slabs[i];
+        _chunk_t *chunk;
+
+        if (size > slab->chunk_size) {
+            continue;
+        }
+        if (slab->free == NULL) {
+            slab->exhausted++;
+            continue;
+        }
+        chunk = slab->free;
+        slab->free = chunk->next;
+        if (++slab->used > slab->max_used) {
+            slab->max_used = slab->used;
+        }
+        return chunk;
+    }
+    DEBUG("pktbuf: no space left in packet buffer\n");
+    return NULL;
+}
+
+static void _pktbuf_free(void *data)
+{
+    _slab_t *slab = _slab_of(data);
+    _chunk_t *chunk;
+    if (slab == NULL) {
+        return;
+    }
+    /* data may have been moved into the chunk by gnrc_pktbuf_mark() */
+    chunk = (_chunk_t *)_chunk_of(slab, data);
+    chunk->next = slab->free;
+    slab->free = chunk;
+    slab->used--;
+}
+
+/** @} */
@@ -34,21 +34,34 @@
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
-#define _ALIGNMENT_MASK    (sizeof(void *) - 1)
-
 typedef struct _unused {
     struct _unused *next;
     unsigned int size;
 } _unused_t;
 
+/* Chunks are multiples of the size of the marker of an unused chunk (which
+ * is a power of 2 and pointer-aligned), so that no hole between chunks
+ * can end up too small to be tracked */
+#define _ALIGNMENT_MASK    (sizeof(_unused_t) - 1)
+
 static mutex_t _mutex = MUTEX_INIT;
 static uint8_t _pktbuf[GNRC_PKTBUF_SIZE];
 static _unused_t *_first_unused;
 
+typedef struct {
+    gnrc_pktsnip_t *pkt;            /**< snip referring to external data */
+    gnrc_pktbuf_release_cb_t cb;    /**< hands the data back to its owner */
+    void *arg;                      /**< argument for _ext_t::cb */
+} _ext_t;
+
+static _ext_t _ext[GNRC_PKTBUF_EXT_NUMOF];
+static unsigned _ext_numof;
+
 /* internal gnrc_pktbuf functions */
 static gnrc_pktsnip_t *_create_snip(gnrc_pktsnip_t *next, void *data, size_t size,
                                     gnrc_nettype_t type);
 static void *_pktbuf_alloc(size_t size);
+static void _ext_release(gnrc_pktsnip_t *pkt);
 static void _pktbuf_free(void *data, size_t size);
 
 static inline bool _pktbuf_contains(void *ptr)
@@ -69,6 +82,8 @@ void gnrc_pktbuf_init(void)
     _first_unused = (_unused_t *)_pktbuf;
     _first_unused->next = NULL;
     _first_unused->size = sizeof(_pktbuf);
+    memset(_ext, 0, sizeof(_ext));
+    _ext_numof = 0;
     mutex_unlock(&_mutex);
 }
 
@@ -87,6 +102,51 @@ gnrc_pktsnip_t *gnrc_pktbuf_add(gnrc_pktsnip_t *next, void *data, size_t size,
     return pkt;
 }
 
+gnrc_pktsnip_t *gnrc_pktbuf_add_ext(gnrc_pktsnip_t *next, void *data, size_t size,
+                                    gnrc_nettype_t type, gnrc_pktbuf_release_cb_t cb,
+                                    void *arg)
+{
+    gnrc_pktsnip_t *pkt;
+    _ext_t *ext = NULL;
+    if ((data == NULL) || (size == 0)) {
+        DEBUG("pktbuf: data == NULL (was %p) or size == 0\n", data);
+        return NULL;
+    }
+    mutex_lock(&_mutex);
+    if (cb != NULL) {
+        for (unsigned i = 0; i < GNRC_PKTBUF_EXT_NUMOF; i++) {
+            if (_ext[i].pkt == NULL) {
+                ext = &_ext[i];
+                break;
+            }
+        }
+        if (ext == NULL) {
+            DEBUG("pktbuf: no space left for release callback\n");
+            mutex_unlock(&_mutex);
+            return NULL;
+        }
+    }
+    pkt = _pktbuf_alloc(sizeof(gnrc_pktsnip_t));
+    if (pkt == NULL) {
+        DEBUG("pktbuf: error allocating new packet snip\n");
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    pkt->next = next;
+    pkt->size = size;
+    pkt->data = data;   /* not in the packet buffer, so it will not be freed */
+    pkt->type = type;
+    pkt->users = 1;
+    if (ext != NULL) {
+        ext->pkt = pkt;
+        ext->cb = cb;
+        ext->arg = arg;
+        _ext_numof++;
+    }
+    mutex_unlock(&_mutex);
+    return pkt;
+}
+
 gnrc_pktsnip_t *gnrc_pktbuf_mark(gnrc_pktsnip_t *pkt, size_t size, gnrc_nettype_t type)
 {
     gnrc_pktsnip_t *marked_snip;
@@ -167,7 +227,7 @@ int gnrc_pktbuf_realloc_data(gnrc_pktsnip_t *pkt, size_t size)
         return 0;
     }
     if ((size > pkt->size) ||                               /* new size does not fit */
-        ((pkt->size - aligned_size) < sizeof(_unused_t))) { /* resulting hole would not fit marker */
+        (pkt->size < (aligned_size + sizeof(_unused_t)))) { /* resulting hole would not fit marker */
         void *new_data = _pktbuf_alloc(size);
         if (new_data == NULL) {
             DEBUG("pktbuf: error allocating new data section\n");
@@ -206,6 +266,9 @@ void gnrc_pktbuf_release(gnrc_pktsnip_t *pkt)
         tmp = pkt->next;
         if (pkt->users == 1) {
             pkt->users = 0; /* not necessary but to be on the safe side */
+            if (_ext_numof > 0) {
+                _ext_release(pkt);
+            }
             _pktbuf_free(pkt->data, pkt->size);
             _pktbuf_free(pkt, sizeof(gnrc_pktsnip_t));
         }
@@ -391,6 +454,18 @@ static gnrc_pktsnip_t *_create_snip(gnrc_pktsnip_t *next, void *data, size_t siz
     return pkt;
 }
 
+static void _ext_release(gnrc_pktsnip_t *pkt)
+{
+    for (unsigned i = 0; i < GNRC_PKTBUF_EXT_NUMOF; i++) {
+        if (_ext[i].pkt == pkt) {
+            _ext[i].pkt = NULL;
+            _ext_numof--;
+            _ext[i].cb(_ext[i].arg);
+            return;
+        }
+    }
+}
+
 static void *_pktbuf_alloc(size_t size)
 {
     _unused_t *prev = NULL, *ptr = _first_unused;
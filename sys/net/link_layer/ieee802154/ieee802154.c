@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <errno.h>
+
+#include "net/ieee802154.h"
+
+#define _PAN_LEN        (2U)
+#define _DST_PAN_POS    (3U)
+
+/* length of an address in the header, by its addressing mode */
+static int _addr_len(uint8_t mode)
+{
+    switch (mode) {
+        case IEEE802154_FCF_DST_ADDR_VOID:
+            return 0;
+        case IEEE802154_FCF_DST_ADDR_SHORT:
+            return 2;
+        case IEEE802154_FCF_DST_ADDR_LONG:
+            return 8;
+        default:
+            return -EINVAL;
+    }
+}
+
+static inline int _dst_len(const uint8_t *mhr)
+{
+    return _addr_len(mhr[1] & IEEE802154_FCF_DST_ADDR_MASK);
+}
+
+static inline int _src_len(const uint8_t *mhr)
+{
+    /* the source addressing mode is 4 bits above the destination one */
+    return _addr_len((mhr[1] & IEEE802154_FCF_SRC_ADDR_MASK) >> 4);
+}
+
+/* copies an address between header and network byte order */
+static void _swap_addr(uint8_t *to, const uint8_t *from, int len)
+{
+    for (int i = 0; i < len; i++) {
+        to[i] = from[len - i - 1];
+    }
+}
+
+size_t ieee802154_set_frame_hdr(uint8_t *buf, const uint8_t *src, size_t src_len,
+                                const uint8_t *dst, size_t dst_len,
+                                le_uint16_t pan, uint8_t flags, uint8_t seq)
+{
+    size_t pos = _DST_PAN_POS;
+
+    buf[0] = flags;
+    buf[1] = 0;
+    buf[2] = seq;
+
+    /* fill in destination PAN ID and address */
+    if (dst_len == 8) {
+        buf[1] |= IEEE802154_FCF_DST_ADDR_LONG;
+    }
+    else if (dst_len == 2) {
+        buf[1] |= IEEE802154_FCF_DST_ADDR_SHORT;
+    }
+    else if (dst_len != 0) {
+        return 0;
+    }
+    if (dst_len > 0) {
+        buf[pos++] = pan.u8[0];
+        buf[pos++] = pan.u8[1];
+        _swap_addr(&buf[pos], dst, dst_len);
+        pos += dst_len;
+    }
+    else {
+        /* without destination PAN ID there is nothing to compress against */
+        buf[0] &= ~IEEE802154_FCF_PAN_COMP;
+    }
+
+    /* fill in source PAN ID (if applicable) and address */
+    if (src_len == 8) {
+        buf[1] |= IEEE802154_FCF_SRC_ADDR_LONG;
+    }
+    else if (src_len == 2) {
+        buf[1] |= IEEE802154_FCF_SRC_ADDR_SHORT;
+    }
+    else if (src_len != 0) {
+        return 0;
+    }
+    if (src_len > 0) {
+        if (!(buf[0] & IEEE802154_FCF_PAN_COMP)) {
+            buf[pos++] = pan.u8[0];
+            buf[pos++] = pan.u8[1];
+        }
+        _swap_addr(&buf[pos], src, src_len);
+        pos += src_len;
+    }
+
+    /* return actual header length */
+    return pos;
+}
+
+size_t ieee802154_get_frame_hdr_len(const uint8_t *mhr)
+{
+    int dst_len = _dst_len(mhr), src_len = _src_len(mhr);
+    size_t len = _DST_PAN_POS;
+
+    if ((dst_len < 0) || (src_len < 0)) {
+        return 0;
+    }
+    if (dst_len > 0) {
+        len += _PAN_LEN + dst_len;
+    }
+    if (src_len > 0) {
+        if (!(mhr[0] & IEEE802154_FCF_PAN_COMP)) {
+            len += _PAN_LEN;
+        }
+        len += src_len;
+    }
+    return len;
+}
+
+int ieee802154_get_src(const uint8_t *mhr, uint8_t *src)
+{
+    int dst_len = _dst_len(mhr), src_len = _src_len(mhr);
+    size_t pos = _DST_PAN_POS;
+
+    if ((dst_len < 0) || (src_len < 0)) {
+        return -EINVAL;
+    }
+    if (dst_len > 0) {
+        pos += _PAN_LEN + dst_len;
+    }
+    if (!(mhr[0] & IEEE802154_FCF_PAN_COMP)) {
+        pos += _PAN_LEN;
+    }
+    _swap_addr(src, &mhr[pos], src_len);
+    return src_len;
+}
+
+int ieee802154_get_dst(const uint8_t *mhr, uint8_t *dst)
+{
+    int dst_len = _dst_len(mhr);
+
+    if (dst_len < 0) {
+        return -EINVAL;
+    }
+    _swap_addr(dst, &mhr[_DST_PAN_POS + _PAN_LEN], dst_len);
+    return dst_len;
+}
+
+/** @} */
@@ -19,11 +19,14 @@
  * @}
  */
 
+#include <assert.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
 #include <errno.h>
+#include "kernel_macros.h"
 #include "thread.h"
 #include "mutex.h"
 #include "msg.h"
@@ -64,6 +67,260 @@ static void fib_lifetime_to_absolute(uint32_t ms, uint64_t *target)
     *target = xtimer_now64() + (ms * 1000);
 }
 
+/**
+ * @brief length of a trie key in bits, the address size byte included
+ */
+#define FIB_TRIE_KEY_LEN(prefix_bits)   (8 + (prefix_bits))
+
+/**
+ * @brief returns the number of significant bits of an address,
+ *        i.e. everything up to and including its lowest set bit
+ *        (the prefix length universal_address_compare() derives)
+ */
+static unsigned fib_addr_prefix_len(const uint8_t *addr, size_t addr_size)
+{
+    for (size_t i = addr_size; i > 0; --i) {
+        if (addr[i - 1] != 0) {
+            unsigned j = 0;
+
+            while (!((addr[i - 1] >> j) & 0x01)) {
+                j++;
+            }
+            return ((i - 1) << 3) + (8 - j);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief returns bit `pos` of the trie key made of `addr_size` and `addr`
+ */
+static inline unsigned fib_trie_bit(const uint8_t *addr, size_t addr_size,
+                                    unsigned pos)
+{
+    if (pos < 8) {
+        return (addr_size >> (7 - pos)) & 0x01;
+    }
+    pos -= 8;
+
+    return (addr[pos >> 3] >> (7 - (pos & 7))) & 0x01;
+}
+
+/**
+ * @brief returns the position of the first bit the keys of `a` and `b`
+ *        differ in, or `limit` if their first `limit` bits are equal
+ */
+static unsigned fib_trie_mismatch(const uint8_t *a, size_t a_size,
+                                  const uint8_t *b, size_t b_size,
+                                  unsigned limit)
+{
+    unsigned pos = 0;
+    uint8_t diff = (uint8_t)(a_size ^ b_size);
+
+    for (size_t i = 0; !diff && (pos < limit); ++i) {
+        pos += 8;
+        if (pos < limit) {
+            diff = a[i] ^ b[i];
+        }
+    }
+
+    if (diff) {
+        while (!(diff & 0x80)) {
+            diff <<= 1;
+            pos++;
+        }
+    }
+
+    return (pos < limit) ? pos : limit;
+}
+
+/**
+ * @brief returns the entry owning a keyed trie node
+ */
+static inline fib_entry_t *fib_trie_entry(fib_trie_node_t *node)
+{
+    return container_of(node, fib_entry_t, node);
+}
+
+/**
+ * @brief returns any entry below `node`, all of them share the first
+ *        `node->bit` key bits
+ */
+static fib_entry_t *fib_trie_any_entry(fib_trie_node_t *node)
+{
+    /* branching nodes always have two children */
+    while (!node->keyed) {
+        node = node->child[0];
+    }
+
+    return fib_trie_entry(node);
+}
+
+/**
+ * @brief resets the lookup trie and hands all spare nodes to the free list
+ */
+static void fib_trie_init(fib_table_t *table)
+{
+    table->trie_root = NULL;
+    table->trie_free = NULL;
+    table->generation++;
+
+    if (table->table_type == FIB_TABLE_TYPE_SR) {
+        return;
+    }
+
+    for (size_t i = 0; i < table->size; ++i) {
+        table->data.entries[i].glue.child[0] = table->trie_free;
+        table->trie_free = &table->data.entries[i].glue;
+    }
+}
+
+/**
+ * @brief adds a new entry to the lookup trie of the table
+ *
+ * @param[in] table  the FIB table the entry belongs to
+ * @param[in] entry  the entry, with fib_entry_t::global set and no
+ *                   other entry for the same destination in the trie
+ */
+static void fib_trie_insert(fib_table_t *table, fib_entry_t *entry)
+{
+    uint8_t *key = entry->global->address;
+    size_t key_size = entry->global->address_size;
+    unsigned len = FIB_TRIE_KEY_LEN(fib_addr_prefix_len(key, key_size));
+    fib_trie_node_t *node = table->trie_root;
+    fib_trie_node_t **link = &table->trie_root;
+    fib_entry_t *near;
+    unsigned pos;
+
+    table->generation++;
+    entry->node.child[0] = NULL;
+    entry->node.child[1] = NULL;
+    entry->node.bit = len;
+    entry->node.keyed = 1;
+
+    if (node == NULL) {
+        /* all spare nodes are free in an empty trie */
+        fib_trie_init(table);
+        table->trie_root = &entry->node;
+        return;
+    }
+
+    /* find the closest existing key, the new one diverges from it at `pos` */
+    while ((node->bit < len) && node->child[fib_trie_bit(key, key_size, node->bit)]) {
+        node = node->child[fib_trie_bit(key, key_size, node->bit)];
+    }
+    near = fib_trie_any_entry(node);
+    pos = fib_trie_mismatch(key, key_size, near->global->address,
+                            near->global->address_size,
+                            (len < near->node.bit) ? len : near->node.bit);
+
+    /* descend to the link the new node belongs to */
+    while ((*link != NULL) && (((*link)->bit < pos) ||
+                               (((*link)->bit == pos) && (pos < len)))) {
+        link = &(*link)->child[fib_trie_bit(key, key_size, (*link)->bit)];
+    }
+    node = *link;
+
+    if (node == NULL) {
+        /* continues a keyed node */
+        *link = &entry->node;
+    }
+    else if ((pos == len) && (node->bit == len)) {
+        /* a branching node sits exactly at the new key, take its place */
+        assert(!node->keyed);
+        entry->node.child[0] = node->child[0];
+        entry->node.child[1] = node->child[1];
+        *link = &entry->node;
+        node->child[0] = table->trie_free;
+        table->trie_free = node;
+    }
+    else if (pos == len) {
+        /* the new key is a prefix of all keys below `node` */
+        entry->node.child[fib_trie_bit(near->global->address,
+                                       near->global->address_size, len)] = node;
+        *link = &entry->node;
+    }
+    else {
+        /* the new key and the keys below `node` diverge at `pos` */
+        fib_trie_node_t *glue = table->trie_free;
+        unsigned dir = fib_trie_bit(key, key_size, pos);
+
+        assert(glue != NULL);
+        table->trie_free = glue->child[0];
+        glue->bit = pos;
+        glue->keyed = 0;
+        glue->child[dir] = &entry->node;
+        glue->child[!dir] = node;
+        *link = glue;
+    }
+}
+
+/**
+ * @brief removes an entry from the lookup trie of the table
+ *
+ * @param[in] table  the FIB table the entry belongs to
+ * @param[in] entry  the entry, with fib_entry_t::global still set
+ */
+static void fib_trie_remove(fib_table_t *table, fib_entry_t *entry)
+{
+    uint8_t *key = entry->global->address;
+    size_t key_size = entry->global->address_size;
+    fib_trie_node_t **link = &table->trie_root;
+    fib_trie_node_t **parent_link = NULL;
+    fib_trie_node_t *node = &entry->node;
+
+    table->generation++;
+    while ((*link != NULL) && (*link != node) && ((*link)->bit < node->bit)) {
+        parent_link = link;
+        link = &(*link)->child[fib_trie_bit(key, key_size, (*link)->bit)];
+    }
+
+    if (*link != node) {
+        /* not indexed */
+        return;
+    }
+
+    if (node->child[0] && node->child[1]) {
+        /* still branches, hand over to a spare node */
+        fib_trie_node_t *glue = table->trie_free;
+
+        assert(glue != NULL);
+        table->trie_free = glue->child[0];
+        *glue = *node;
+        glue->keyed = 0;
+        *link = glue;
+    }
+    else if (node->child[0] || node->child[1]) {
+        *link = node->child[0] ? node->child[0] : node->child[1];
+    }
+    else {
+        *link = NULL;
+
+        /* a branching parent with a single child is not needed anymore */
+        if ((parent_link != NULL) && !(*parent_link)->keyed) {
+            fib_trie_node_t *glue = *parent_link;
+
+            *parent_link = glue->child[0] ? glue->child[0] : glue->child[1];
+            glue->child[0] = table->trie_free;
+            table->trie_free = glue;
+        }
+    }
+
+    node->child[0] = NULL;
+    node->child[1] = NULL;
+}
+
+/**
+ * @brief checks if the lifetime of an entry expired
+ */
+static inline bool fib_entry_expired(fib_entry_t *entry, uint64_t now)
+{
+    return (entry->lifetime != FIB_LIFETIME_NO_EXPIRE) && (entry->lifetime < now);
+}
+
+static int fib_remove(fib_table_t *table, fib_entry_t *entry);
+
 /**
  * @brief returns pointer to the entry for the given destination address
  *
@@ -81,74 +338,69 @@ static void fib_lifetime_to_absolute(uint32_t ms, uint64_t *target)
 static int fib_find_entry(fib_table_t *table, uint8_t *dst, size_t dst_size,
                           fib_entry_t **entry_arr, size_t *entry_arr_size) {
     uint64_t now = xtimer_now64();
-
-    size_t count = 0;
-    size_t prefix_size = 0;
-    size_t match_size = dst_size << 3;
-    int ret = -EHOSTUNREACH;
-    bool is_all_zeros_addr = true;
-
-    for (size_t i = 0; i < dst_size; ++i) {
-        if (dst[i] != 0) {
-            is_all_zeros_addr = false;
+    /* bits of dst after its lowest set bit are zero, longer keys can not match */
+    unsigned len = FIB_TRIE_KEY_LEN(fib_addr_prefix_len(dst, dst_size));
+    fib_trie_node_t *node;
+    fib_entry_t *deepest;
+    unsigned match_len;
+    int ret;
+
+restart:
+    *entry_arr_size = 0;
+    ret = -EHOSTUNREACH;
+
+    /* the candidates are the keyed nodes on the path of dst */
+    deepest = NULL;
+    for (node = table->trie_root; (node != NULL) && (node->bit <= len);
+         node = node->child[fib_trie_bit(dst, dst_size, node->bit)]) {
+        if (node->keyed) {
+            deepest = fib_trie_entry(node);
+        }
+        if (node->bit == len) {
             break;
         }
     }
 
-    for (size_t i = 0; i < table->size; ++i) {
+    if (deepest == NULL) {
+        return ret;
+    }
 
-        /* autoinvalidate if the entry lifetime is not set to not expire */
-        if (table->data.entries[i].lifetime != FIB_LIFETIME_NO_EXPIRE) {
+    /* path compression skipped bits, so only the candidates above the
+     * first bit dst differs from the deepest one in are prefixes of dst */
+    match_len = fib_trie_mismatch(dst, dst_size, deepest->global->address,
+                                  deepest->global->address_size,
+                                  deepest->node.bit);
 
-            /* check if the lifetime expired */
-            if (table->data.entries[i].lifetime < now) {
-                /* remove this entry if its lifetime expired */
-                table->data.entries[i].lifetime = 0;
-                table->data.entries[i].global_flags = 0;
-                table->data.entries[i].next_hop_flags = 0;
-                table->data.entries[i].iface_id = KERNEL_PID_UNDEF;
-
-                if (table->data.entries[i].global != NULL) {
-                    universal_address_rem(table->data.entries[i].global);
-                    table->data.entries[i].global = NULL;
-                }
+    for (node = table->trie_root; (node != NULL) && (node->bit <= match_len);
+         node = node->child[fib_trie_bit(dst, dst_size, node->bit)]) {
+        if (node->keyed) {
+            fib_entry_t *entry = fib_trie_entry(node);
 
-                if (table->data.entries[i].next_hop != NULL) {
-                    universal_address_rem(table->data.entries[i].next_hop);
-                    table->data.entries[i].next_hop = NULL;
-                }
+            if (fib_entry_expired(entry, now)) {
+                /* remove this entry if its lifetime expired */
+                fib_remove(table, entry);
+                goto restart;
             }
-        }
-
-        if ((prefix_size < (dst_size<<3)) && (table->data.entries[i].global != NULL)) {
 
-            int ret_comp = universal_address_compare(table->data.entries[i].global, dst, &match_size);
-            /* If we found an exact match */
-            if (ret_comp == 0 || (is_all_zeros_addr && match_size == 0)) {
-                entry_arr[0] = &(table->data.entries[i]);
+            if (node->bit == len) {
+                /* we found an exact match */
+                entry_arr[0] = entry;
                 *entry_arr_size = 1;
-                /* we will not find a better one so we return */
                 return 1;
             }
-            else {
-                /* we try to find the most fitting prefix */
-                if ((ret_comp == 1)
-                    && (table->data.entries[i].global_flags & FIB_FLAG_NET_PREFIX)) {
-                    if ((prefix_size == 0) || (match_size > prefix_size)) {
-                        entry_arr[0] = &(table->data.entries[i]);
-                        /* we could find a better one so we move on */
-                        ret = 0;
-
-                        prefix_size = match_size;
-                        count = 1;
-                    }
-                }
-                match_size = dst_size<<3;
+
+            if (entry->global_flags & FIB_FLAG_NET_PREFIX) {
+                /* a longer prefix, we could find a better one so we move on */
+                entry_arr[0] = entry;
+                *entry_arr_size = 1;
+                ret = 0;
             }
         }
+        if (node->bit == len) {
+            break;
+        }
     }
 
-    *entry_arr_size = count;
     return ret;
 }
 
@@ -209,7 +461,15 @@ static int fib_create_entry(fib_table_t *table, kernel_pid_t iface_id,
                             uint8_t *next_hop, size_t next_hop_size, uint32_t
                             next_hop_flags, uint32_t lifetime)
 {
+    uint64_t now = xtimer_now64();
+
     for (size_t i = 0; i < table->size; ++i) {
+        /* reclaim entries that expired without being looked up again */
+        if ((table->data.entries[i].lifetime != 0)
+            && fib_entry_expired(&table->data.entries[i], now)) {
+            fib_remove(table, &table->data.entries[i]);
+        }
+
         if (table->data.entries[i].lifetime == 0) {
 
             table->data.entries[i].global = universal_address_add(dst, dst_size);
@@ -231,8 +491,16 @@ static int fib_create_entry(fib_table_t *table, kernel_pid_t iface_id,
                     table->data.entries[i].lifetime = FIB_LIFETIME_NO_EXPIRE;
                 }
 
+                fib_trie_insert(table, &table->data.entries[i]);
                 return 0;
             }
+
+            /* do not leave a half filled entry behind */
+            universal_address_rem(table->data.entries[i].global);
+            table->data.entries[i].global = NULL;
+            table->data.entries[i].global_flags = 0;
+            table->data.entries[i].next_hop_flags = 0;
+            return -ENOMEM;
         }
     }
 
@@ -242,13 +510,15 @@ static int fib_create_entry(fib_table_t *table, kernel_pid_t iface_id,
 /**
  * @brief removes the given entry
  *
+ * @param[in] table the FIB table the entry belongs to
  * @param[in] entry the entry to be removed
  *
  * @return 0 on success
  */
-static int fib_remove(fib_entry_t *entry)
+static int fib_remove(fib_table_t *table, fib_entry_t *entry)
 {
     if (entry->global != NULL) {
+        fib_trie_remove(table, entry);
         universal_address_rem(entry->global);
     }
 
@@ -367,6 +637,7 @@ int fib_add_entry(fib_table_t *table,
     if (ret == 1) {
         /* we must take the according entry and update the values */
         ret = fib_upd_entry(entry[0], next_hop, next_hop_size, next_hop_flags, lifetime);
+        table->generation++;
     }
     else {
         ret = fib_create_entry(table, iface_id, dst, dst_size, dst_flags,
@@ -397,6 +668,7 @@ int fib_update_entry(fib_table_t *table, uint8_t *dst, size_t dst_size,
         DEBUG("[fib_update_entry] found entry: %p\n", (void *)(entry[0]));
         /* we must take the according entry and update the values */
         ret = fib_upd_entry(entry[0], next_hop, next_hop_size, next_hop_flags, lifetime);
+        table->generation++;
     }
     else {
         /* we have ambiguous entries, i.e. count > 1
@@ -420,7 +692,7 @@ void fib_remove_entry(fib_table_t *table, uint8_t *dst, size_t dst_size)
 
     if (ret == 1) {
         /* we must take the according entry and update the values */
-        fib_remove(entry[0]);
+        fib_remove(table, entry[0]);
     }
     else {
         /* we have ambiguous entries, i.e. count > 1
@@ -545,6 +817,7 @@ void fib_init(fib_table_t *table)
     else {
         memset(table->data.entries, 0, (table->size * sizeof(fib_entry_t)));
     }
+    fib_trie_init(table);
     universal_address_init();
     mutex_unlock(&(table->mtx_access));
 }
@@ -570,6 +843,7 @@ void fib_deinit(fib_table_t *table)
     else {
         memset(table->data.entries, 0, (table->size * sizeof(fib_entry_t)));
     }
+    fib_trie_init(table);
     universal_address_reset();
     mutex_unlock(&(table->mtx_access));
 }
@@ -604,9 +878,12 @@ int fib_get_num_used_entries(fib_table_t *table)
 {
     mutex_lock(&(table->mtx_access));
     size_t used_entries = 0;
+    uint64_t now = xtimer_now64();
 
     for (size_t i = 0; i < table->size; ++i) {
-        used_entries += (size_t)(table->data.entries[i].global != NULL);
+        /* expired entries are only reclaimed when looked up or reused */
+        used_entries += (size_t)((table->data.entries[i].global != NULL)
+                                 && !fib_entry_expired(&table->data.entries[i], now));
     }
 
     mutex_unlock(&(table->mtx_access));
@@ -29,14 +29,14 @@
 #include "pipe.h"
 #include "sched.h"
 
-typedef unsigned (*ringbuffer_op_t)(ringbuffer_t *restrict rb, char *buf, unsigned n);
+typedef int (*tsrb_op_t)(tsrb_t *rb, char *buf, size_t n);
 
-static ssize_t pipe_rw(ringbuffer_t *rb,
+static ssize_t pipe_rw(tsrb_t *rb,
                        void *buf,
                        size_t n,
                        tcb_t **other_op_blocked,
                        tcb_t **this_op_blocked,
-                       ringbuffer_op_t ringbuffer_op)
+                       tsrb_op_t tsrb_op)
 {
     if (n == 0) {
         return 0;
@@ -45,7 +45,7 @@ static ssize_t pipe_rw(ringbuffer_t *rb,
     while (1) {
         unsigned old_state = disableIRQ();
 
-        unsigned count = ringbuffer_op(rb, buf, n);
+        unsigned count = tsrb_op(rb, buf, n);
 
         if (count > 0) {
             tcb_t *other_thread = *other_op_blocked;
@@ -81,16 +81,16 @@ static ssize_t pipe_rw(ringbuffer_t *rb,
 ssize_t pipe_read(pipe_t *pipe, void *buf, size_t n)
 {
     return pipe_rw(pipe->rb, (char *) buf, n,
-                   &pipe->write_blocked, &pipe->read_blocked, ringbuffer_get);
+                   &pipe->write_blocked, &pipe->read_blocked, tsrb_get);
 }
 
 ssize_t pipe_write(pipe_t *pipe, const void *buf, size_t n)
 {
     return pipe_rw(pipe->rb, (char *) buf, n,
-                   &pipe->read_blocked, &pipe->write_blocked, (ringbuffer_op_t) ringbuffer_add);
+                   &pipe->read_blocked, &pipe->write_blocked, (tsrb_op_t) tsrb_add);
 }
 
-void pipe_init(pipe_t *pipe, ringbuffer_t *rb, void (*free)(void *))
+void pipe_init(pipe_t *pipe, tsrb_t *rb, void (*free)(void *))
 {
     *pipe = (pipe_t) {
         .rb = rb,
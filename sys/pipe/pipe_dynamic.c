@@ -36,7 +36,7 @@
 struct mallocd_pipe
 {
     pipe_t pipe;
-    ringbuffer_t rb;
+    tsrb_t rb;
     char buffer[1];
 };
 
@@ -44,7 +44,7 @@ pipe_t *pipe_malloc(unsigned size)
 {
     struct mallocd_pipe *m_pipe = malloc(sizeof (*m_pipe) + size);
     if (m_pipe) {
-        ringbuffer_init(&m_pipe->rb, m_pipe->buffer, size);
+        tsrb_init(&m_pipe->rb, m_pipe->buffer, size);
         pipe_init(&m_pipe->pipe, &m_pipe->rb, free);
     }
     return &m_pipe->pipe;
@@ -132,8 +132,8 @@ int _gnrc_6ctx_del(char *cmd_str, char *ctx_str)
     else if (del_timer[cid].callback == NULL) {
         ctx = gnrc_sixlowpan_ctx_lookup_id(cid);
         if (ctx != NULL) {
-            ctx->flags_id &= ~GNRC_SIXLOWPAN_CTX_FLAGS_COMP;
-            ctx->ltime = 0;
+            /* a lifetime of 0 only keeps the context for decompression */
+            gnrc_sixlowpan_ctx_update(cid, &ctx->prefix, ctx->prefix_len, 0, false);
             del_timer[cid].callback = _del_cb;
             del_timer[cid].arg = ctx;
             xtimer_set(&del_timer[cid], GNRC_SIXLOWPAN_ND_RTR_MIN_CTX_DELAY * SEC_IN_USEC);
@@ -17,22 +17,61 @@
  * @}
  */
 
+#include <string.h>
+
 #include "tsrb.h"
 
+/* Keeps the compiler from moving buffer accesses across index updates.
+ * The indices are only ever written by one side (reads by the consumer,
+ * writes by the producer), so on a single core this is all the ordering
+ * needed to use a tsrb lock-free from ISR and thread context. */
+#define _BARRIER()  __asm__ volatile ("" : : : "memory")
+
 static void _push(tsrb_t *rb, char c)
 {
-    rb->buf[rb->writes++ & (rb->size - 1)] = c;
+    rb->buf[rb->writes & (rb->size - 1)] = c;
+    _BARRIER();
+    rb->writes++;
 }
 
 static char _pop(tsrb_t *rb)
 {
-    return rb->buf[rb->reads++ & (rb->size - 1)];
+    char c = rb->buf[rb->reads & (rb->size - 1)];
+    _BARRIER();
+    rb->reads++;
+    return c;
+}
+
+/* copies n <= tsrb_avail() bytes starting at the read position to dst */
+static void _copy_out(const tsrb_t *rb, char *dst, size_t n)
+{
+    unsigned pos = rb->reads & (rb->size - 1);
+    size_t chunk = rb->size - pos;
+
+    if (chunk > n) {
+        chunk = n;
+    }
+    memcpy(dst, &rb->buf[pos], chunk);
+    memcpy(dst + chunk, rb->buf, n - chunk);
+}
+
+/* copies n <= tsrb_free() bytes from src to the write position */
+static void _copy_in(tsrb_t *rb, const char *src, size_t n)
+{
+    unsigned pos = rb->writes & (rb->size - 1);
+    size_t chunk = rb->size - pos;
+
+    if (chunk > n) {
+        chunk = n;
+    }
+    memcpy(&rb->buf[pos], src, chunk);
+    memcpy(rb->buf, src + chunk, n - chunk);
 }
 
 int tsrb_get_one(tsrb_t *rb)
 {
     if (!tsrb_empty(rb)) {
-        return _pop(rb);
+        return (unsigned char)_pop(rb);
     }
     else {
         return -1;
@@ -41,12 +80,37 @@ int tsrb_get_one(tsrb_t *rb)
 
 int tsrb_get(tsrb_t *rb, char *dst, size_t n)
 {
-    size_t tmp = n;
-    while (tmp && !tsrb_empty(rb)) {
-        *dst++ = _pop(rb);
-        tmp--;
+    unsigned avail = tsrb_avail(rb);
+
+    if (n > avail) {
+        n = avail;
+    }
+    _copy_out(rb, dst, n);
+    _BARRIER();
+    rb->reads += n;
+    return n;
+}
+
+int tsrb_peek(const tsrb_t *rb, char *dst, size_t n)
+{
+    unsigned avail = tsrb_avail(rb);
+
+    if (n > avail) {
+        n = avail;
     }
-    return (n - tmp);
+    _copy_out(rb, dst, n);
+    return n;
+}
+
+int tsrb_drop(tsrb_t *rb, size_t n)
+{
+    unsigned avail = tsrb_avail(rb);
+
+    if (n > avail) {
+        n = avail;
+    }
+    rb->reads += n;
+    return n;
 }
 
 int tsrb_add_one(tsrb_t *rb, char c)
@@ -62,10 +126,13 @@ int tsrb_add_one(tsrb_t *rb, char c)
 
 int tsrb_add(tsrb_t *rb, const char *src, size_t n)
 {
-    size_t tmp = n;
-    while (tmp && !tsrb_full(rb)) {
-        _push(rb, *src++);
-        tmp--;
+    unsigned space = tsrb_free(rb);
+
+    if (n > space) {
+        n = space;
     }
-    return (n - tmp);
+    _copy_in(rb, src, n);
+    _BARRIER();
+    rb->writes += n;
+    return n;
 }
@@ -28,6 +28,10 @@
 
 static volatile int _in_handler = 0;
 
+#ifdef MODULE_XTIMER_STATS
+volatile uint32_t xtimer_isr_count = 0;
+#endif
+
 static volatile uint32_t _long_cnt = 0;
 #if XTIMER_MASK
 volatile uint32_t _high_cnt = 0;
@@ -39,6 +43,7 @@ static xtimer_t *long_list_head = NULL;
 
 static void _add_timer_to_list(xtimer_t **list_head, xtimer_t *timer);
 static void _add_timer_to_long_list(xtimer_t **list_head, xtimer_t *timer);
+static xtimer_t *_pop_timer_from_list(xtimer_t **list_head);
 static void _shoot(xtimer_t *timer);
 static inline void _lltimer_set(uint32_t target);
 static uint32_t _time_left(uint32_t target, uint32_t reference);
@@ -131,9 +136,41 @@ void xtimer_set(xtimer_t *timer, uint32_t offset)
     }
 }
 
+void xtimer_set_slack(xtimer_t *timer, uint32_t offset, uint32_t slack)
+{
+    uint32_t now = xtimer_now();
+    uint32_t target = now + offset;
+    uint32_t limit = target + slack;
+
+    if ((offset < XTIMER_BACKOFF) || (slack < XTIMER_ISR_BACKOFF) ||
+        (limit < target) || !timer->callback) {
+        xtimer_set(timer, offset);
+        return;
+    }
+
+    /* Clear all bits of limit below the highest bit it differs from target
+     * in. The result stays within [target, limit] and is the same for all
+     * timers whose windows share that bit. */
+    uint32_t diff = target ^ limit;
+    diff |= diff >> 1;
+    diff |= diff >> 2;
+    diff |= diff >> 4;
+    diff |= diff >> 8;
+    diff |= diff >> 16;
+    limit &= ~(diff >> 1);
+
+    DEBUG("xtimer_set_slack(): target=%" PRIu32 " coalesced=%" PRIu32 "\n", target, limit);
+
+    xtimer_remove(timer);
+    _xtimer_set_absolute(timer, limit);
+}
+
 static void _periph_timer_callback(int chan)
 {
     (void)chan;
+#ifdef MODULE_XTIMER_STATS
+    xtimer_isr_count++;
+#endif
     _timer_callback();
 }
 
@@ -204,6 +241,125 @@ int _xtimer_set_absolute(xtimer_t *timer, uint32_t target)
     return res;
 }
 
+#ifdef MODULE_XTIMER_HEAP
+/**
+ * @brief meld two pairing heaps, return the new root
+ *
+ * Both a and b must be roots, i.e., have prev == next == NULL.
+ */
+static xtimer_t *_heap_meld(xtimer_t *a, xtimer_t *b)
+{
+    if (!a) {
+        return b;
+    }
+    if (!b) {
+        return a;
+    }
+    if (b->target < a->target) {
+        xtimer_t *tmp = a;
+        a = b;
+        b = tmp;
+    }
+
+    /* make b the first child of a */
+    b->prev = a;
+    b->next = a->child;
+    if (a->child) {
+        a->child->prev = b;
+    }
+    a->child = b;
+
+    return a;
+}
+
+/**
+ * @brief two-pass pairing of a list of sibling heaps, return the new root
+ */
+static xtimer_t *_heap_merge_pairs(xtimer_t *first)
+{
+    xtimer_t *pairs = NULL;
+
+    /* first pass: meld siblings pairwise, left to right */
+    while (first) {
+        xtimer_t *a = first;
+        xtimer_t *b = a->next;
+
+        first = b ? b->next : NULL;
+        a->prev = a->next = NULL;
+        if (b) {
+            b->prev = b->next = NULL;
+        }
+        a = _heap_meld(a, b);
+        a->next = pairs;
+        pairs = a;
+    }
+
+    /* second pass: meld the pairs, right to left */
+    xtimer_t *root = NULL;
+    while (pairs) {
+        xtimer_t *next = pairs->next;
+        pairs->next = NULL;
+        root = _heap_meld(root, pairs);
+        pairs = next;
+    }
+
+    return root;
+}
+
+/**
+ * @brief cut a non-root timer out of whichever heap it is in
+ */
+static void _heap_cut(xtimer_t *timer)
+{
+    xtimer_t *prev = timer->prev;
+    xtimer_t *next = timer->next;
+    xtimer_t *replace = _heap_merge_pairs(timer->child);
+
+    /* the timer's children are all >= its parent, so their merged heap can
+     * take its place */
+    if (replace) {
+        replace->prev = prev;
+        replace->next = next;
+        if (next) {
+            next->prev = replace;
+        }
+    }
+    else {
+        replace = next;
+        if (next) {
+            next->prev = prev;
+        }
+    }
+
+    if (prev->child == timer) {
+        prev->child = replace;
+    }
+    else {
+        prev->next = replace;
+    }
+
+    timer->prev = timer->next = timer->child = NULL;
+    timer->in_heap = 0;
+}
+
+static void _add_timer_to_list(xtimer_t **list_head, xtimer_t *timer)
+{
+    timer->prev = timer->next = timer->child = NULL;
+    timer->in_heap = 1;
+    *list_head = _heap_meld(*list_head, timer);
+}
+
+static xtimer_t *_pop_timer_from_list(xtimer_t **list_head)
+{
+    xtimer_t *timer = *list_head;
+
+    *list_head = _heap_merge_pairs(timer->child);
+    timer->child = NULL;
+    timer->in_heap = 0;
+
+    return timer;
+}
+#else
 static void _add_timer_to_list(xtimer_t **list_head, xtimer_t *timer)
 {
     while (*list_head && (*list_head)->target <= timer->target) {
@@ -214,8 +370,23 @@ static void _add_timer_to_list(xtimer_t **list_head, xtimer_t *timer)
     *list_head = timer;
 }
 
+static xtimer_t *_pop_timer_from_list(xtimer_t **list_head)
+{
+    xtimer_t *timer = *list_head;
+
+    *list_head = timer->next;
+
+    return timer;
+}
+#endif
+
 static void _add_timer_to_long_list(xtimer_t **list_head, xtimer_t *timer)
 {
+#ifdef MODULE_XTIMER_HEAP
+    /* long list timers are no heap nodes, see xtimer_remove() */
+    timer->prev = timer->child = NULL;
+    timer->in_heap = 0;
+#endif
     while (*list_head
             && (*list_head)->long_target <= timer->long_target
             && (*list_head)->target <= timer->target) {
@@ -249,7 +420,7 @@ int xtimer_remove(xtimer_t *timer)
     int res = 0;
     if (timer_list_head == timer) {
         uint32_t next;
-        timer_list_head = timer->next;
+        _pop_timer_from_list(&timer_list_head);
         if (timer_list_head) {
             /* schedule callback on next timer target time */
             next = timer_list_head->target - XTIMER_OVERHEAD;
@@ -260,9 +431,25 @@ int xtimer_remove(xtimer_t *timer)
         _lltimer_set(next);
     }
     else {
+#ifdef MODULE_XTIMER_HEAP
+        if (overflow_list_head == timer) {
+            _pop_timer_from_list(&overflow_list_head);
+            res = 1;
+        }
+        else if (timer->in_heap) {
+            /* both roots were checked, so the timer has a parent or
+             * previous sibling */
+            _heap_cut(timer);
+            res = 1;
+        }
+        else {
+            res = _remove_timer_from_list(&long_list_head, timer);
+        }
+#else
         res = _remove_timer_from_list(&timer_list_head, timer) ||
             _remove_timer_from_list(&overflow_list_head, timer) ||
             _remove_timer_from_list(&long_list_head, timer);
+#endif
     }
 
     timer->target = 0;
@@ -317,6 +504,19 @@ static inline xtimer_t *_compare(xtimer_t *a, xtimer_t *b)
 /**
  * @brief merge two timer lists, return head of new list
  */
+#ifdef MODULE_XTIMER_HEAP
+static xtimer_t *_merge_lists(xtimer_t *head_a, xtimer_t *head_b)
+{
+    /* head_b is a sorted singly linked list of long timers */
+    while (head_b) {
+        xtimer_t *next = head_b->next;
+        _add_timer_to_list(&head_a, head_b);
+        head_b = next;
+    }
+
+    return head_a;
+}
+#else
 static xtimer_t *_merge_lists(xtimer_t *head_a, xtimer_t *head_b)
 {
     xtimer_t *result_head = _compare(head_a, head_b);
@@ -340,6 +540,7 @@ static xtimer_t *_merge_lists(xtimer_t *head_a, xtimer_t *head_b)
 
     return result_head;
 }
+#endif
 
 /**
  * @brief parse long timers list and copy those that will expire in the current
@@ -369,6 +570,11 @@ static void _select_long_timers(void)
     }
 
     /* merge "current timer list" and "selected long timer list" */
+#ifdef MODULE_XTIMER_HEAP
+    if (select_list_last) {
+        timer_list_head = _merge_lists(timer_list_head, select_list_start);
+    }
+#else
     if (timer_list_head) {
         if (select_list_last) {
             /* both lists are non-empty. merge. */
@@ -386,6 +592,7 @@ static void _select_long_timers(void)
             timer_list_head = select_list_start;
         }
     }
+#endif
 }
 
 /**
@@ -454,11 +661,8 @@ overflow:
         /* make sure we don't fire too early */
         while (_time_left(_lltimer_mask(timer_list_head->target), reference));
 
-        /* pick first timer in list */
-        xtimer_t *timer = timer_list_head;
-
-        /* advance list */
-        timer_list_head = timer->next;
+        /* pick first timer in list and advance list */
+        xtimer_t *timer = _pop_timer_from_list(&timer_list_head);
 
         /* make sure timer is recognized as being already fired */
         timer->target = 0;
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Compares a server of CONNS UDP connections with one thread per
+ *              connection to one with a single thread and a
+ *              @ref gnrc_conn_mux_t
+ *
+ * The datagrams are handed to @ref net_gnrc_netreg as gnrc_udp would, so
+ * the time measured is that from the registry to the data in the server.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+#include "thread.h"
+#include "xtimer.h"
+#include "net/af.h"
+#include "net/conn/udp.h"
+#include "net/gnrc.h"
+#include "net/gnrc/conn.h"
+#include "net/ipv6/hdr.h"
+#include "net/protnum.h"
+#include "net/udp.h"
+
+#define ROUNDS              (1000U)
+#define PORT_BASE           (5683U)
+#define PAYLOAD_SIZE        (32U)
+#define SERVER_STACKSIZE    (THREAD_STACKSIZE_DEFAULT)
+#define SERVER_PRIO         (THREAD_PRIORITY_MAIN - 1)
+#define SERVER_QUEUE_SIZE   (4U)
+#define MUX_QUEUE_SIZE      (8U)
+
+/* one thread per connection */
+static char stacks[CONNS][SERVER_STACKSIZE];
+static msg_t queues[CONNS][SERVER_QUEUE_SIZE];
+static conn_udp_t conns[CONNS];
+
+/* one thread for all connections */
+static char mux_stack[SERVER_STACKSIZE];
+static msg_t mux_queue[MUX_QUEUE_SIZE];
+static gnrc_conn_mux_t mux;
+static conn_udp_t mux_conns[CONNS];
+
+static unsigned received;
+static uint32_t latency_max;
+
+static void _got(const uint8_t *data, int len)
+{
+    uint32_t sent, latency;
+
+    if (len != PAYLOAD_SIZE) {
+        return;
+    }
+    memcpy(&sent, data, sizeof(sent));
+    latency = xtimer_now() - sent;
+    if (latency > latency_max) {
+        latency_max = latency;
+    }
+    received++;
+}
+
+static void *_server(void *arg)
+{
+    conn_udp_t *conn = arg;
+    ipv6_addr_t addr = IPV6_ADDR_UNSPECIFIED;
+    uint8_t buf[PAYLOAD_SIZE];
+    unsigned i = conn - conns;
+
+    msg_init_queue(queues[i], SERVER_QUEUE_SIZE);
+    conn_udp_create(conn, &addr, sizeof(addr), AF_INET6, PORT_BASE + i);
+    while (1) {
+        _got(buf, conn_udp_recvfrom(conn, buf, sizeof(buf), NULL, NULL, NULL));
+    }
+    return NULL;
+}
+
+static void *_mux_server(void *arg)
+{
+    ipv6_addr_t addr = IPV6_ADDR_UNSPECIFIED;
+    uint8_t buf[PAYLOAD_SIZE];
+    void *ready[CONNS];
+
+    (void)arg;
+    msg_init_queue(mux_queue, MUX_QUEUE_SIZE);
+    gnrc_conn_mux_init(&mux);
+    for (unsigned i = 0; i < CONNS; i++) {
+        conn_udp_create(&mux_conns[i], &addr, sizeof(addr), AF_INET6, PORT_BASE + i);
+        gnrc_conn_async(&mux_conns[i], &mux, NULL, NULL);
+    }
+    while (1) {
+        msg_t msg;
+        int num = gnrc_conn_mux_poll(&mux, ready, CONNS, &msg);
+
+        for (int i = 0; i < num; i++) {
+            int res;
+
+            while ((res = conn_udp_recvfrom(ready[i], buf, sizeof(buf), NULL, NULL,
+                                            NULL)) != -EAGAIN) {
+                _got(buf, res);
+            }
+        }
+    }
+    return NULL;
+}
+
+/* hands a datagram to the registry like gnrc_udp does */
+static void _send(uint16_t port)
+{
+    ipv6_hdr_t ipv6;
+    udp_hdr_t udp;
+    uint8_t payload[PAYLOAD_SIZE];
+    gnrc_pktsnip_t *pkt;
+    uint32_t now;
+
+    memset(&ipv6, 0, sizeof(ipv6));
+    ipv6_hdr_set_version(&ipv6);
+    ipv6.len = byteorder_htons(sizeof(udp) + sizeof(payload));
+    ipv6.nh = PROTNUM_UDP;
+    ipv6_addr_set_loopback(&ipv6.src);
+    ipv6_addr_set_loopback(&ipv6.dst);
+    udp.src_port = byteorder_htons(PORT_BASE - 1);
+    udp.dst_port = byteorder_htons(port);
+    udp.length = ipv6.len;
+    udp.checksum = byteorder_htons(0);
+    memset(payload, 0, sizeof(payload));
+
+    /* in receive order: payload first */
+    pkt = gnrc_pktbuf_add(NULL, &ipv6, sizeof(ipv6), GNRC_NETTYPE_IPV6);
+    if (pkt != NULL) {
+        gnrc_pktsnip_t *hdr = gnrc_pktbuf_add(pkt, &udp, sizeof(udp), GNRC_NETTYPE_UDP);
+
+        if (hdr == NULL) {
+            gnrc_pktbuf_release(pkt);
+            return;
+        }
+        pkt = hdr;
+        now = xtimer_now();
+        memcpy(payload, &now, sizeof(now));
+        hdr = gnrc_pktbuf_add(pkt, payload, sizeof(payload), GNRC_NETTYPE_UNDEF);
+        if (hdr == NULL) {
+            gnrc_pktbuf_release(pkt);
+            return;
+        }
+        pkt = hdr;
+    }
+    if ((pkt != NULL) && (gnrc_netapi_dispatch_receive(GNRC_NETTYPE_UDP, port, pkt) == 0)) {
+        gnrc_pktbuf_release(pkt);
+    }
+}
+
+static void _run(const char *name)
+{
+    uint32_t start, time;
+
+    received = 0;
+    latency_max = 0;
+    start = xtimer_now();
+    for (unsigned r = 0; r < ROUNDS; r++) {
+        for (unsigned i = 0; i < CONNS; i++) {
+            _send(PORT_BASE + i);
+        }
+    }
+    time = xtimer_now() - start;
+    printf("%-8s %u of %u datagrams, %lu ns/datagram, max latency %lu us\n", name,
+           received, ROUNDS * CONNS, (unsigned long)((time * 1000UL) / (ROUNDS * CONNS)),
+           (unsigned long)latency_max);
+}
+
+int main(void)
+{
+    unsigned used = 0;
+
+    puts("Start.");
+    printf("%u connections, conn_udp_t has %u bytes\n", (unsigned)CONNS,
+           (unsigned)sizeof(conn_udp_t));
+
+    /* the servers run before main, so they are ready once created */
+    for (unsigned i = 0; i < CONNS; i++) {
+        thread_create(stacks[i], sizeof(stacks[i]), SERVER_PRIO, CREATE_STACKTEST,
+                      _server, &conns[i], "server");
+    }
+    _run("threads:");
+    for (unsigned i = 0; i < CONNS; i++) {
+        unsigned tmp = SERVER_STACKSIZE - thread_measure_stack_free(stacks[i]);
+
+        used = (tmp > used) ? tmp : used;
+        conn_udp_close(&conns[i]);
+    }
+    printf("         RAM %u bytes: %u x (%u stack + %u queue + %u conn), "
+           "stack used %u\n",
+           (unsigned)(sizeof(stacks) + sizeof(queues) + sizeof(conns)), (unsigned)CONNS,
+           (unsigned)SERVER_STACKSIZE, (unsigned)sizeof(queues[0]),
+           (unsigned)sizeof(conn_udp_t), used);
+
+    thread_create(mux_stack, sizeof(mux_stack), SERVER_PRIO, CREATE_STACKTEST,
+                  _mux_server, NULL, "mux");
+    _run("mux:");
+    used = SERVER_STACKSIZE - thread_measure_stack_free(mux_stack);
+    printf("         RAM %u bytes: %u stack + %u queue + %u mux + %u x %u conn, "
+           "stack used %u\n",
+           (unsigned)(sizeof(mux_stack) + sizeof(mux_queue) + sizeof(mux) +
+                      sizeof(mux_conns)),
+           (unsigned)SERVER_STACKSIZE, (unsigned)sizeof(mux_queue), (unsigned)sizeof(mux),
+           (unsigned)CONNS, (unsigned)sizeof(conn_udp_t), used);
+
+    puts("Done.");
+    return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Counts the payload bytes copied into the packet buffer by
+ *              conn_udp_sendto() and gnrc_conn_udp_sendto_iov()
+ *
+ * The application registers itself for IPv6 packets next to gnrc_ipv6, so it
+ * sees every datagram in the form the network layer gets it.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#include "msg.h"
+#include "net/af.h"
+#include "net/conn/udp.h"
+#include "net/gnrc.h"
+#include "net/gnrc/conn.h"
+
+#define PAYLOAD_SIZE    (96U)
+#define QUEUE_SIZE      (8U)
+#define PORT            (61616U)
+
+static msg_t queue[QUEUE_SIZE];
+static uint8_t header[12];
+static uint8_t payload[PAYLOAD_SIZE];
+static volatile unsigned released;
+
+static void _release(void *arg)
+{
+    (void)arg;
+    released++;
+}
+
+static bool _is_app_data(const void *data)
+{
+    const uint8_t *ptr = data;
+    return ((ptr >= header) && (ptr < header + sizeof(header))) ||
+           ((ptr >= payload) && (ptr < payload + sizeof(payload)));
+}
+
+/* receives the datagram handed to IPv6 and counts copied payload bytes */
+static void _measure(const char *name)
+{
+    msg_t msg;
+    gnrc_pktsnip_t *pkt, *snip;
+    unsigned copied = 0, total = 0;
+
+    msg_receive(&msg);
+    if (msg.type != GNRC_NETAPI_MSG_TYPE_SND) {
+        printf("%s: unexpected message type 0x%04x\n", name, msg.type);
+        return;
+    }
+    pkt = (gnrc_pktsnip_t *)msg.content.ptr;
+    LL_SEARCH_SCALAR(pkt, snip, type, GNRC_NETTYPE_UDP);
+    for (snip = (snip != NULL) ? snip->next : NULL; snip != NULL; snip = snip->next) {
+        if (!_is_app_data(snip->data)) {
+            copied += snip->size;
+        }
+        total += snip->size;
+    }
+    gnrc_pktbuf_release(pkt);
+    printf("+ %s: %u of %u payload bytes copied, released: %u\n", name, copied,
+           total, released);
+}
+
+int main(void)
+{
+    gnrc_netreg_entry_t me = { NULL, GNRC_NETREG_DEMUX_CTX_ALL, KERNEL_PID_UNDEF };
+    ipv6_addr_t dst = { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 } };
+    struct iovec vector[] = {
+        { header, sizeof(header) },
+        { payload, sizeof(payload) },
+    };
+    uint8_t buf[sizeof(header) + sizeof(payload)];
+
+    msg_init_queue(queue, QUEUE_SIZE);
+    me.pid = sched_active_pid;
+    gnrc_netreg_register(GNRC_NETTYPE_IPV6, &me);
+
+    memset(header, 'h', sizeof(header));
+    memset(payload, 'p', sizeof(payload));
+    memcpy(buf, header, sizeof(header));
+    memcpy(buf + sizeof(header), payload, sizeof(payload));
+
+    puts("Start.");
+    conn_udp_sendto(buf, sizeof(buf), NULL, 0, &dst, sizeof(dst), AF_INET6,
+                    PORT, PORT);
+    _measure("conn_udp_sendto()");
+    gnrc_conn_udp_sendto_iov(vector, sizeof(vector) / sizeof(vector[0]), NULL, 0,
+                             &dst, sizeof(dst), AF_INET6, PORT, PORT, _release,
+                             NULL);
+    _measure("gnrc_conn_udp_sendto_iov()");
+    puts("Done.");
+
+    return 0;
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measures the latency of the IPv6 send path, with and without
+ *              @ref net_gnrc_ipv6_dc
+ *
+ * Packets to a few destinations behind a router are handed to the IPv6
+ * thread one at a time and taken off by a dummy interface. The packets carry
+ * no source address and the interface has a link-local, a site-local and two
+ * global addresses, so the IPv6 layer selects a source address for each one.
+ * With @ref net_gnrc_udp the packets are UDP datagrams handed to the UDP
+ * thread instead.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdio.h>
+
+#include "byteorder.h"
+#include "msg.h"
+#include "thread.h"
+#include "xtimer.h"
+#include "net/fib.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6.h"
+#include "net/gnrc/ipv6/dc.h"
+#include "net/gnrc/ipv6/nc.h"
+#include "net/gnrc/ipv6/netif.h"
+#include "net/gnrc/udp.h"
+
+#define ROUTES          (32U)
+#define DESTINATIONS    (4U)
+#define SENDS           (10000U)
+#define PAYLOAD_SIZE    (32U)
+#define PORT            (5683U)
+#define MSG_QUEUE_SIZE  (8U)
+
+static char _netif_stack[THREAD_STACKSIZE_DEFAULT];
+static msg_t _main_msg_queue[MSG_QUEUE_SIZE];
+static kernel_pid_t _main_pid;
+
+/* takes packets off the IPv6 thread and reports each one to main */
+static void *_dummy_netif(void *arg)
+{
+    msg_t msg, reply, msg_queue[MSG_QUEUE_SIZE];
+    msg_t done = { 0 };
+
+    (void)arg;
+    msg_init_queue(msg_queue, MSG_QUEUE_SIZE);
+    reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+    reply.content.value = -ENOTSUP;
+    while (1) {
+        msg_receive(&msg);
+        switch (msg.type) {
+            case GNRC_NETAPI_MSG_TYPE_SND:
+                gnrc_pktbuf_release((gnrc_pktsnip_t *)msg.content.ptr);
+                msg_send(&done, _main_pid);
+                break;
+            case GNRC_NETAPI_MSG_TYPE_GET:
+            case GNRC_NETAPI_MSG_TYPE_SET:
+                msg_reply(&msg, &reply);
+                break;
+            default:
+                break;
+        }
+    }
+
+    return NULL;
+}
+
+static void _setup(kernel_pid_t iface)
+{
+    ipv6_addr_t addrs[] = {
+        {{ 0xfe, 0x80, [15] = 0x01 }},
+        {{ 0xfe, 0xc0, [15] = 0x01 }},
+        {{ 0x20, 0x01, 0x0d, 0xb8, [15] = 0x01 }},
+        {{ 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x01, [15] = 0x01 }},
+    };
+    ipv6_addr_t router = {{ 0xfe, 0x80, [15] = 0x02 }};
+    ipv6_addr_t prefix = {{ 0x20, 0x01, 0x0d, 0xb8, 0x01 }};
+    uint8_t router_l2[] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x02 };
+
+    gnrc_netif_add(iface);
+    gnrc_ipv6_netif_add(iface);
+    for (unsigned i = 0; i < sizeof(addrs) / sizeof(addrs[0]); i++) {
+        gnrc_ipv6_netif_add_addr(iface, &addrs[i], 64, GNRC_IPV6_NETIF_ADDR_FLAGS_UNICAST);
+    }
+    gnrc_ipv6_nc_add(iface, &router, router_l2, sizeof(router_l2),
+                     GNRC_IPV6_NC_STATE_REACHABLE << GNRC_IPV6_NC_STATE_POS);
+
+    /* a routing table with one /48 per route, all via the same router */
+    for (unsigned i = 0; i < ROUTES; i++) {
+        prefix.u8[5] = (uint8_t)i;
+        fib_add_entry(&gnrc_ipv6_fib_table, iface, prefix.u8, sizeof(prefix),
+                      FIB_FLAG_NET_PREFIX, router.u8, sizeof(router), 0,
+                      (uint32_t)FIB_LIFETIME_NO_EXPIRE);
+    }
+}
+
+static int _send(const ipv6_addr_t *dst)
+{
+    gnrc_pktsnip_t *payload, *pkt;
+    msg_t done;
+
+    payload = gnrc_pktbuf_add(NULL, NULL, PAYLOAD_SIZE, GNRC_NETTYPE_UNDEF);
+    if (payload == NULL) {
+        return -ENOMEM;
+    }
+#ifdef MODULE_GNRC_UDP
+    network_uint16_t port = byteorder_htons(PORT);
+
+    pkt = gnrc_udp_hdr_build(payload, port.u8, sizeof(port), port.u8, sizeof(port));
+    if (pkt == NULL) {
+        gnrc_pktbuf_release(payload);
+        return -ENOMEM;
+    }
+    payload = pkt;
+#endif
+    pkt = gnrc_ipv6_hdr_build(payload, NULL, 0, (uint8_t *)dst, sizeof(*dst));
+    if (pkt == NULL) {
+        gnrc_pktbuf_release(payload);
+        return -ENOMEM;
+    }
+#ifdef MODULE_GNRC_UDP
+    if (!gnrc_netapi_dispatch_send(GNRC_NETTYPE_UDP, GNRC_NETREG_DEMUX_CTX_ALL, pkt)) {
+#else
+    if (gnrc_netapi_send(gnrc_ipv6_pid, pkt) < 1) {
+#endif
+        gnrc_pktbuf_release(pkt);
+        return -EHOSTUNREACH;
+    }
+    msg_receive(&done);
+
+    return 0;
+}
+
+int main(void)
+{
+    ipv6_addr_t dst[DESTINATIONS];
+    kernel_pid_t iface;
+    uint32_t start, duration;
+
+    _main_pid = thread_getpid();
+    msg_init_queue(_main_msg_queue, MSG_QUEUE_SIZE);
+    iface = thread_create(_netif_stack, sizeof(_netif_stack),
+                          THREAD_PRIORITY_MAIN - 1, CREATE_STACKTEST,
+                          _dummy_netif, NULL, "dummy_netif");
+    _setup(iface);
+
+    /* hosts spread over the routed prefixes */
+    for (unsigned i = 0; i < DESTINATIONS; i++) {
+        ipv6_addr_t tmp = {{ 0x20, 0x01, 0x0d, 0xb8, 0x01, (uint8_t)(i * 7), [15] = 0x0a }};
+
+        dst[i] = tmp;
+    }
+
+#ifdef MODULE_GNRC_UDP
+    puts("UDP send path benchmark");
+#else
+    puts("IPv6 send path benchmark");
+#endif
+    start = xtimer_now();
+    for (unsigned n = 0; n < SENDS; n++) {
+        if (_send(&dst[n % DESTINATIONS]) < 0) {
+            puts("error: unable to send");
+            return 1;
+        }
+    }
+    duration = xtimer_now() - start;
+
+    printf("%u routes, %u destinations: %lu ns/packet\n", ROUTES, DESTINATIONS,
+           (unsigned long)(((uint64_t)duration * 1000) / SENDS));
+#ifdef MODULE_GNRC_IPV6_DC
+    printf("destination cache: %lu hits, %lu misses\n",
+           (unsigned long)gnrc_ipv6_dc_stats()->hits,
+           (unsigned long)gnrc_ipv6_dc_stats()->misses);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,42 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2016 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+"""Floods a TAP interface with broadcast frames of the local experimental
+ethertype 0x88b5."""
+
+import socket
+import sys
+import time
+
+ETHERTYPE = 0x88b5
+PAYLOAD_LEN = 64
+
+
+def main():
+    if len(sys.argv) < 2:
+        print("usage: %s <tap> [seconds]" % sys.argv[0])
+        sys.exit(1)
+    duration = float(sys.argv[2]) if len(sys.argv) > 2 else 10.0
+    sock = socket.socket(socket.AF_PACKET, socket.SOCK_RAW)
+    sock.bind((sys.argv[1], 0))
+    frame = (b"\xff" * 6) + sock.getsockname()[4][:6] + \
+        ETHERTYPE.to_bytes(2, "big") + bytes(PAYLOAD_LEN)
+    sent = 0
+    end = time.time() + duration
+    while time.time() < end:
+        for _ in range(100):
+            try:
+                sock.send(frame)
+                sent += 1
+            except OSError:
+                pass
+    print("sent %d frames (%d frames/s)" % (sent, sent / duration))
+
+
+if __name__ == "__main__":
+    main()
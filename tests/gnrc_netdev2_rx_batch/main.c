@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measures the receive throughput of gnrc_netdev2 on a TAP
+ *              interface
+ *
+ * The main thread takes all frames of unknown ethertype from the
+ * auto-initialized netdev2 thread and prints every second how many it got and
+ * in how many batches the netdev2 thread passed them on. See README.md for how to flood the interface.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "msg.h"
+#include "thread.h"
+#include "xtimer.h"
+#include "net/gnrc.h"
+#include "net/gnrc/gnrc_netdev2.h"
+#include "net/gnrc/netif.h"
+
+#define MSG_QUEUE_SIZE  (32U)
+#define INTERVAL        (1U * SEC_IN_USEC)
+
+static msg_t _msg_queue[MSG_QUEUE_SIZE];
+
+int main(void)
+{
+    gnrc_netreg_entry_t sink = { NULL, GNRC_NETREG_DEMUX_CTX_ALL, thread_getpid() };
+    gnrc_netdev2_stats_t last = { 0, 0 };
+    uint32_t frames = 0, start;
+    msg_t msgs[MSG_QUEUE_SIZE];
+    kernel_pid_t ifs[GNRC_NETIF_NUMOF];
+
+    puts("gnrc_netdev2 receive benchmark");
+    msg_init_queue(_msg_queue, MSG_QUEUE_SIZE);
+    gnrc_netreg_register(GNRC_NETTYPE_UNDEF, &sink);
+    if (gnrc_netif_get(ifs) == 0) {
+        puts("error: no network interface");
+        return 1;
+    }
+    printf("passing on up to %u frames at once, waiting for frames\n",
+           (unsigned)GNRC_NETDEV2_RX_BATCH);
+
+    start = xtimer_now();
+    while (1) {
+        int n = msg_receive_batch(msgs, MSG_QUEUE_SIZE);
+        uint32_t now;
+
+        for (int i = 0; i < n; i++) {
+            if (msgs[i].type == GNRC_NETAPI_MSG_TYPE_RCV) {
+                gnrc_pktbuf_release((gnrc_pktsnip_t *)msgs[i].content.ptr);
+                frames++;
+            }
+        }
+        /* there is nothing to print without frames anyway */
+        now = xtimer_now();
+        if ((now - start) >= INTERVAL) {
+            gnrc_netdev2_stats_t stats;
+            uint32_t pkts, batches, avg;
+
+            if (gnrc_netapi_get(ifs[0], NETOPT_RX_BATCH_STATS, 0, &stats,
+                                sizeof(stats)) < 0) {
+                puts("error: unable to read receive counters");
+                return 1;
+            }
+            pkts = stats.rx_pkts - last.rx_pkts;
+            batches = stats.rx_batches - last.rx_batches;
+            avg = (batches == 0) ? 0 : (pkts * 100) / batches;
+
+            printf("%lu frames/s, %lu.%02lu frames per batch\n",
+                   (unsigned long)(((uint64_t)frames * SEC_IN_USEC) / (now - start)),
+                   (unsigned long)(avg / 100), (unsigned long)(avg % 100));
+            last = stats;
+            frames = 0;
+            start = now;
+        }
+    }
+
+    return 0;
+}
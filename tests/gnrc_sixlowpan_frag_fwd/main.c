@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measures the per-hop latency of a 6LoWPAN router for
+ *              fragmented datagrams, with and without
+ *              @ref net_gnrc_sixlowpan_frag_vrb
+ *
+ * The fragments of a datagram to a host behind the router are received on
+ * one dummy interface and taken off by a second one. For every datagram the
+ * time from the first incoming fragment to the first and to the last
+ * outgoing fragment is measured.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "msg.h"
+#include "thread.h"
+#include "xtimer.h"
+#include "net/fib.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6.h"
+#include "net/gnrc/ipv6/nc.h"
+#include "net/gnrc/ipv6/netif.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/sixlowpan/netif.h"
+#include "net/protnum.h"
+#include "net/sixlowpan.h"
+
+#define ROUNDS          (1000U)
+#define MAX_FRAG_SIZE   (102U)
+#define DATAGRAM_SIZE   (320U)
+#define PAYLOAD_SIZE    (DATAGRAM_SIZE - sizeof(ipv6_hdr_t))
+/* uncompressed bytes in the first fragment */
+#define FRAG1_SIZE      (96U)
+#define FRAGN_SIZE      (64U)
+#define MSG_QUEUE_SIZE  (8U)
+
+/* IPHC: traffic class and flow label elided, next header inline, hop limit 64,
+ * addresses inline */
+#define IPHC_LEN        (2U + 1U + (2U * sizeof(ipv6_addr_t)))
+
+static char _in_stack[THREAD_STACKSIZE_DEFAULT];
+static char _out_stack[THREAD_STACKSIZE_DEFAULT];
+static msg_t _main_msg_queue[MSG_QUEUE_SIZE];
+static kernel_pid_t _main_pid, _in_iface, _out_iface;
+static volatile uint32_t _first_out;
+
+static uint8_t _sender_l2[] = { 0x02, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x01 };
+static uint8_t _router_l2[] = { 0x02, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x02 };
+static uint8_t _next_hop_l2[] = { 0x02, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x03 };
+static uint8_t _payload[PAYLOAD_SIZE];
+
+/* reports the outgoing fragments of the router to main */
+static void _handle_snd(gnrc_pktsnip_t *pkt)
+{
+    uint8_t *data;
+
+    if ((pkt->next == NULL) || (pkt->next->size < sizeof(sixlowpan_frag_n_t))) {
+        return;
+    }
+    data = pkt->next->data;
+    if (((data[0] & SIXLOWPAN_FRAG_DISP_MASK) == SIXLOWPAN_FRAG_1_DISP) &&
+        (_first_out == 0)) {
+        _first_out = xtimer_now();
+    }
+    else if ((data[0] & SIXLOWPAN_FRAG_DISP_MASK) == SIXLOWPAN_FRAG_N_DISP) {
+        sixlowpan_frag_n_t *hdr = (sixlowpan_frag_n_t *)data;
+        uint16_t size = byteorder_ntohs(hdr->disp_size) & SIXLOWPAN_FRAG_SIZE_MASK;
+
+        if (((hdr->offset * 8U) + pkt->next->size - sizeof(*hdr)) >= size) {
+            msg_t done;
+
+            done.content.value = xtimer_now();
+            msg_send(&done, _main_pid);
+        }
+    }
+}
+
+static void *_dummy_netif(void *arg)
+{
+    msg_t msg, reply, msg_queue[MSG_QUEUE_SIZE];
+    bool out = (arg != NULL);
+
+    msg_init_queue(msg_queue, MSG_QUEUE_SIZE);
+    reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+    reply.content.value = -ENOTSUP;
+    while (1) {
+        msg_receive(&msg);
+        switch (msg.type) {
+            case GNRC_NETAPI_MSG_TYPE_SND:
+                if (out) {
+                    _handle_snd((gnrc_pktsnip_t *)msg.content.ptr);
+                }
+                gnrc_pktbuf_release((gnrc_pktsnip_t *)msg.content.ptr);
+                break;
+            case GNRC_NETAPI_MSG_TYPE_GET:
+            case GNRC_NETAPI_MSG_TYPE_SET:
+                msg_reply(&msg, &reply);
+                break;
+            default:
+                break;
+        }
+    }
+
+    return NULL;
+}
+
+static void _add_iface(kernel_pid_t iface)
+{
+    gnrc_ipv6_netif_t *ipv6_if;
+
+    gnrc_netif_add(iface);
+    gnrc_ipv6_netif_add(iface);
+    gnrc_sixlowpan_netif_add(iface, MAX_FRAG_SIZE);
+    ipv6_if = gnrc_ipv6_netif_get(iface);
+    /* no router advertisements to the dummy interfaces */
+    ipv6_if->flags |= GNRC_IPV6_NETIF_FLAGS_SIXLOWPAN | GNRC_IPV6_NETIF_FLAGS_ROUTER;
+}
+
+static void _setup(void)
+{
+    ipv6_addr_t next_hop = {{ 0xfe, 0x80, [8] = 0x00, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x03 }};
+    ipv6_addr_t prefix = {{ 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x02 }};
+
+    _in_iface = thread_create(_in_stack, sizeof(_in_stack), THREAD_PRIORITY_MAIN - 1,
+                              CREATE_STACKTEST, _dummy_netif, NULL, "in_netif");
+    _out_iface = thread_create(_out_stack, sizeof(_out_stack), THREAD_PRIORITY_MAIN - 1,
+                               CREATE_STACKTEST, _dummy_netif, &_out_iface, "out_netif");
+    _add_iface(_in_iface);
+    _add_iface(_out_iface);
+    gnrc_ipv6_nc_add(_out_iface, &next_hop, _next_hop_l2, sizeof(_next_hop_l2),
+                     GNRC_IPV6_NC_STATE_REACHABLE << GNRC_IPV6_NC_STATE_POS);
+    fib_add_entry(&gnrc_ipv6_fib_table, _out_iface, prefix.u8, sizeof(prefix),
+                  FIB_FLAG_NET_PREFIX, next_hop.u8, sizeof(next_hop), 0,
+                  (uint32_t)FIB_LIFETIME_NO_EXPIRE);
+    for (unsigned i = 0; i < PAYLOAD_SIZE; i++) {
+        _payload[i] = (uint8_t)i;
+    }
+}
+
+static int _inject(const void *hdr, size_t hdr_len, const void *data, size_t data_len)
+{
+    gnrc_pktsnip_t *netif, *frag;
+
+    netif = gnrc_netif_hdr_build(_sender_l2, sizeof(_sender_l2),
+                                 _router_l2, sizeof(_router_l2));
+    if (netif == NULL) {
+        return -ENOMEM;
+    }
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = _in_iface;
+    frag = gnrc_pktbuf_add(netif, NULL, hdr_len + data_len, GNRC_NETTYPE_SIXLOWPAN);
+    if (frag == NULL) {
+        gnrc_pktbuf_release(netif);
+        return -ENOMEM;
+    }
+    memcpy(frag->data, hdr, hdr_len);
+    memcpy(((uint8_t *)frag->data) + hdr_len, data, data_len);
+    if (gnrc_netapi_dispatch_receive(GNRC_NETTYPE_SIXLOWPAN,
+                                     GNRC_NETREG_DEMUX_CTX_ALL, frag) == 0) {
+        gnrc_pktbuf_release(frag);
+        return -ENOTSUP;
+    }
+
+    return 0;
+}
+
+static int _send_datagram(uint16_t tag)
+{
+    ipv6_addr_t src = {{ 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x01, [15] = 0x01 }};
+    ipv6_addr_t dst = {{ 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x02, [15] = 0x0a }};
+    uint8_t frag1[sizeof(sixlowpan_frag_t) + IPHC_LEN];
+    sixlowpan_frag_n_t fragn;
+    uint16_t offset = FRAG1_SIZE;
+    int res;
+
+    /* first fragment: header and IPHC */
+    ((sixlowpan_frag_t *)frag1)->disp_size = byteorder_htons(DATAGRAM_SIZE);
+    frag1[0] |= SIXLOWPAN_FRAG_1_DISP;
+    ((sixlowpan_frag_t *)frag1)->tag = byteorder_htons(tag);
+    frag1[4] = SIXLOWPAN_IPHC1_DISP | SIXLOWPAN_IPHC1_TF | 0x02;
+    frag1[5] = 0x00;
+    frag1[6] = PROTNUM_UDP;
+    memcpy(&frag1[7], &src, sizeof(src));
+    memcpy(&frag1[7 + sizeof(src)], &dst, sizeof(dst));
+    if ((res = _inject(frag1, sizeof(frag1), _payload,
+                       FRAG1_SIZE - sizeof(ipv6_hdr_t))) < 0) {
+        return res;
+    }
+
+    fragn.disp_size = byteorder_htons(DATAGRAM_SIZE);
+    fragn.disp_size.u8[0] |= SIXLOWPAN_FRAG_N_DISP;
+    fragn.tag = byteorder_htons(tag);
+    while (offset < DATAGRAM_SIZE) {
+        size_t len = DATAGRAM_SIZE - offset;
+
+        if (len > FRAGN_SIZE) {
+            len = FRAGN_SIZE;
+        }
+        fragn.offset = (uint8_t)(offset / 8);
+        if ((res = _inject(&fragn, sizeof(fragn),
+                           &_payload[offset - sizeof(ipv6_hdr_t)], len)) < 0) {
+            return res;
+        }
+        offset += len;
+    }
+
+    return 0;
+}
+
+int main(void)
+{
+    uint64_t first = 0, last = 0;
+    msg_t done;
+
+    _main_pid = thread_getpid();
+    msg_init_queue(_main_msg_queue, MSG_QUEUE_SIZE);
+    _setup();
+
+    puts("6LoWPAN fragment forwarding benchmark");
+    for (unsigned n = 0; n < ROUNDS; n++) {
+        uint32_t start;
+
+        _first_out = 0;
+        start = xtimer_now();
+        if (_send_datagram((uint16_t)n) < 0) {
+            puts("error: unable to inject fragments");
+            return 1;
+        }
+        if (xtimer_msg_receive_timeout(&done, SEC_IN_USEC) < 0) {
+            printf("error: datagram %u was not forwarded\n", n);
+            return 1;
+        }
+        first += _first_out - start;
+        last += done.content.value - start;
+    }
+
+    printf("%u-byte datagrams: first fragment after %lu us, last fragment "
+           "after %lu us\n", (unsigned)DATAGRAM_SIZE,
+           (unsigned long)(first / ROUNDS), (unsigned long)(last / ROUNDS));
+
+    return 0;
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Shows that a small packet is not held back by a fragmented
+ *              datagram
+ *
+ * A 1280-byte datagram and a small packet are handed to the 6LoWPAN thread
+ * right after each other. A dummy interface records the order in which the
+ * frames leave and when.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdio.h>
+
+#include "msg.h"
+#include "thread.h"
+#include "utlist.h"
+#include "xtimer.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6/hdr.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/sixlowpan.h"
+#include "net/gnrc/sixlowpan/frag.h"
+#include "net/gnrc/sixlowpan/netif.h"
+#include "net/sixlowpan.h"
+
+#define MAX_FRAG_SIZE   (102U)
+#define LARGE_SIZE      (1280U - sizeof(ipv6_hdr_t))
+#define SMALL_SIZE      (16U)
+#define MSG_QUEUE_SIZE  (32U)
+
+static char _netif_stack[THREAD_STACKSIZE_DEFAULT];
+static char _sender_stack[THREAD_STACKSIZE_DEFAULT];
+static kernel_pid_t _iface, _main_pid;
+static msg_t _main_msg_queue[MSG_QUEUE_SIZE];
+
+static unsigned _frames, _small_frame;
+static uint32_t _start, _small_time;
+
+/* records the frames the 6LoWPAN thread sends */
+static void *_dummy_netif(void *arg)
+{
+    msg_t msg, reply, msg_queue[MSG_QUEUE_SIZE];
+
+    (void)arg;
+    msg_init_queue(msg_queue, MSG_QUEUE_SIZE);
+    reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+    reply.content.value = -ENOTSUP;
+    while (1) {
+        msg_receive(&msg);
+        switch (msg.type) {
+            case GNRC_NETAPI_MSG_TYPE_SND: {
+                gnrc_pktsnip_t *pkt = (gnrc_pktsnip_t *)msg.content.ptr;
+                uint8_t *data = pkt->next->data;
+
+                _frames++;
+                if (data[0] == SIXLOWPAN_UNCOMP) {
+                    _small_frame = _frames;
+                    _small_time = xtimer_now() - _start;
+                }
+                gnrc_pktbuf_release(pkt);
+                msg_send(&msg, _main_pid);
+                break;
+            }
+            case GNRC_NETAPI_MSG_TYPE_GET:
+            case GNRC_NETAPI_MSG_TYPE_SET:
+                msg_reply(&msg, &reply);
+                break;
+            default:
+                break;
+        }
+    }
+
+    return NULL;
+}
+
+static int _send(size_t size)
+{
+    ipv6_addr_t src = {{ 0xfe, 0x80, [15] = 0x01 }};
+    ipv6_addr_t dst = {{ 0xfe, 0x80, [15] = 0x02 }};
+    gnrc_pktsnip_t *payload, *ipv6, *netif;
+
+    payload = gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_UNDEF);
+    if (payload == NULL) {
+        return -ENOMEM;
+    }
+    ipv6 = gnrc_ipv6_hdr_build(payload, src.u8, sizeof(src), dst.u8, sizeof(dst));
+    if (ipv6 == NULL) {
+        gnrc_pktbuf_release(payload);
+        return -ENOMEM;
+    }
+    netif = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
+    if (netif == NULL) {
+        gnrc_pktbuf_release(ipv6);
+        return -ENOMEM;
+    }
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = _iface;
+    LL_PREPEND(ipv6, netif);
+    if (gnrc_netapi_dispatch_send(GNRC_NETTYPE_SIXLOWPAN, GNRC_NETREG_DEMUX_CTX_ALL,
+                                  netif) == 0) {
+        gnrc_pktbuf_release(netif);
+        return -ENOTSUP;
+    }
+
+    return 0;
+}
+
+/* runs above the 6LoWPAN thread so both packets are queued before it runs */
+static void *_sender(void *arg)
+{
+    (void)arg;
+    _start = xtimer_now();
+    if ((_send(LARGE_SIZE) < 0) || (_send(SMALL_SIZE) < 0)) {
+        puts("error: unable to send");
+    }
+
+    return NULL;
+}
+
+int main(void)
+{
+    const gnrc_sixlowpan_frag_stats_t *stats = gnrc_sixlowpan_frag_stats();
+    msg_t msg;
+
+    _main_pid = thread_getpid();
+    msg_init_queue(_main_msg_queue, MSG_QUEUE_SIZE);
+    _iface = thread_create(_netif_stack, sizeof(_netif_stack), THREAD_PRIORITY_MAIN - 1,
+                           CREATE_STACKTEST, _dummy_netif, NULL, "dummy_netif");
+    gnrc_netif_add(_iface);
+    gnrc_sixlowpan_netif_add(_iface, MAX_FRAG_SIZE);
+
+    puts("6LoWPAN fragmentation sender test");
+    thread_create(_sender_stack, sizeof(_sender_stack), GNRC_SIXLOWPAN_PRIO - 1,
+                  CREATE_STACKTEST, _sender, NULL, "sender");
+
+    /* wait until no frame left for a second */
+    while (xtimer_msg_receive_timeout(&msg, SEC_IN_USEC) >= 0) {}
+
+    printf("small packet sent as frame %u of %u after %lu us\n", _small_frame,
+           _frames, (unsigned long)_small_time);
+    printf("%lu datagrams, %lu fragments, %u in flight (max %u), %lu sent in one go\n",
+           (unsigned long)stats->datagrams, (unsigned long)stats->fragments,
+           stats->in_flight, stats->in_flight_max, (unsigned long)stats->sync);
+    if ((_small_frame == 0) || (_small_frame == _frames) || (stats->in_flight != 0)) {
+        puts("FAILURE");
+        return 1;
+    }
+    puts("SUCCESS");
+
+    return 0;
+}
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Stress test for the 6LoWPAN reassembly buffer
+ *
+ * Fragments of datagrams from many senders are handed to the 6LoWPAN
+ * thread interleaved and in random order. Every datagram must be
+ * reassembled with its original content. Afterwards incomplete datagrams
+ * must time out.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "msg.h"
+#include "thread.h"
+#include "xtimer.h"
+#include "net/gnrc.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/sixlowpan/frag.h"
+#include "net/ipv6/hdr.h"
+#include "net/sixlowpan.h"
+
+#define SENDERS         (16U)
+#define ROUNDS          (32U)
+#define DATAGRAM_SIZE   (320U)
+#define FRAG_SIZE       (64U)   /* must be a multiple of 8 */
+#define FRAGS           (DATAGRAM_SIZE / FRAG_SIZE)
+#define RBUF_TIMEOUT_US (3U * SEC_IN_USEC)
+#define MSG_QUEUE_SIZE  (8U)
+
+static msg_t _main_msg_queue[MSG_QUEUE_SIZE];
+static uint8_t _frag_buf[sizeof(sixlowpan_frag_n_t) + 1 + FRAG_SIZE];
+static uint16_t _order[SENDERS * FRAGS];
+static uint32_t _rand = 0x2545f491;
+static uint16_t _tag;   /* all datagrams of a round share a tag */
+static unsigned _received, _corrupted;
+
+static uint32_t _xorshift(void)
+{
+    _rand ^= _rand << 13;
+    _rand ^= _rand >> 17;
+    _rand ^= _rand << 5;
+    return _rand;
+}
+
+static inline uint8_t _datagram_byte(unsigned sender, uint16_t tag, unsigned i)
+{
+    return (uint8_t)(sender * 31 + tag * 7 + i);
+}
+
+/* hands fragment `idx` of the datagram `tag` of `sender` to 6LoWPAN */
+static int _inject(unsigned sender, uint16_t tag, unsigned idx)
+{
+    uint8_t src[] = { 0x00, (uint8_t)sender };
+    uint8_t dst[] = { 0x00, 0xff };
+    gnrc_pktsnip_t *netif, *frag;
+    uint8_t *data;
+    size_t hdr_len;
+
+    if (idx == 0) {
+        sixlowpan_frag_t *hdr = (sixlowpan_frag_t *)_frag_buf;
+
+        hdr->disp_size = byteorder_htons(DATAGRAM_SIZE);
+        hdr->disp_size.u8[0] |= SIXLOWPAN_FRAG_1_DISP;
+        hdr->tag = byteorder_htons(tag);
+        hdr_len = sizeof(sixlowpan_frag_t);
+        _frag_buf[hdr_len++] = SIXLOWPAN_UNCOMP;
+    }
+    else {
+        sixlowpan_frag_n_t *hdr = (sixlowpan_frag_n_t *)_frag_buf;
+
+        hdr->disp_size = byteorder_htons(DATAGRAM_SIZE);
+        hdr->disp_size.u8[0] |= SIXLOWPAN_FRAG_N_DISP;
+        hdr->tag = byteorder_htons(tag);
+        hdr->offset = (uint8_t)((idx * FRAG_SIZE) >> 3);
+        hdr_len = sizeof(sixlowpan_frag_n_t);
+    }
+    data = &_frag_buf[hdr_len];
+    for (unsigned i = 0; i < FRAG_SIZE; i++) {
+        data[i] = _datagram_byte(sender, tag, (idx * FRAG_SIZE) + i);
+    }
+
+    netif = gnrc_netif_hdr_build(src, sizeof(src), dst, sizeof(dst));
+    if (netif == NULL) {
+        return -1;
+    }
+    frag = gnrc_pktbuf_add(netif, _frag_buf, hdr_len + FRAG_SIZE,
+                           GNRC_NETTYPE_SIXLOWPAN);
+    if (frag == NULL) {
+        gnrc_pktbuf_release(netif);
+        return -1;
+    }
+    if (!gnrc_netapi_dispatch_receive(GNRC_NETTYPE_SIXLOWPAN,
+                                      GNRC_NETREG_DEMUX_CTX_ALL, frag)) {
+        gnrc_pktbuf_release(frag);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* checks all datagrams 6LoWPAN handed up so far */
+static void _collect(void)
+{
+    msg_t msg;
+
+    while (msg_try_receive(&msg) == 1) {
+        gnrc_pktsnip_t *pkt = (gnrc_pktsnip_t *)msg.content.ptr;
+        gnrc_netif_hdr_t *hdr;
+        uint8_t *data = pkt->data;
+        unsigned sender;
+
+        if (msg.type != GNRC_NETAPI_MSG_TYPE_RCV) {
+            continue;
+        }
+        _received++;
+        if ((pkt->size != DATAGRAM_SIZE) || (pkt->next == NULL) ||
+            (pkt->next->type != GNRC_NETTYPE_NETIF)) {
+            _corrupted++;
+            gnrc_pktbuf_release(pkt);
+            continue;
+        }
+        hdr = pkt->next->data;
+        sender = gnrc_netif_hdr_get_src_addr(hdr)[1];
+        for (unsigned i = 0; i < DATAGRAM_SIZE; i++) {
+            if (data[i] != _datagram_byte(sender, _tag, i)) {
+                _corrupted++;
+                break;
+            }
+        }
+        gnrc_pktbuf_release(pkt);
+    }
+}
+
+static void _shuffle(void)
+{
+    for (unsigned i = 0; i < SENDERS * FRAGS; i++) {
+        _order[i] = i;
+    }
+    for (unsigned i = (SENDERS * FRAGS) - 1; i > 0; i--) {
+        unsigned j = _xorshift() % (i + 1);
+        uint16_t tmp = _order[i];
+
+        _order[i] = _order[j];
+        _order[j] = tmp;
+    }
+}
+
+int main(void)
+{
+    gnrc_netreg_entry_t me = { NULL, GNRC_NETREG_DEMUX_CTX_ALL, KERNEL_PID_UNDEF };
+    uint32_t start, duration;
+    unsigned expected;
+
+    msg_init_queue(_main_msg_queue, MSG_QUEUE_SIZE);
+    me.pid = thread_getpid();
+    gnrc_netreg_register(GNRC_NETTYPE_IPV6, &me);
+
+    puts("6LoWPAN reassembly stress test");
+
+    /* interleaved, out of order fragments of SENDERS datagrams at a time */
+    start = xtimer_now();
+    for (_tag = 0; _tag < ROUNDS; _tag++) {
+        _shuffle();
+        for (unsigned i = 0; i < SENDERS * FRAGS; i++) {
+            if (_inject(_order[i] / FRAGS, _tag, _order[i] % FRAGS) < 0) {
+                puts("error: unable to inject fragment");
+                return 1;
+            }
+            _collect();
+        }
+    }
+    duration = xtimer_now() - start;
+    expected = SENDERS * ROUNDS;
+    printf("%u/%u datagrams reassembled, %u corrupted, %lu us/fragment\n",
+           _received, expected, _corrupted,
+           (unsigned long)(duration / (expected * FRAGS)));
+    if ((_received != expected) || (_corrupted != 0)) {
+        puts("FAILURE");
+        return 1;
+    }
+
+    /* all but the last fragment, then wait for the datagrams to expire */
+    for (unsigned s = 0; s < SENDERS; s++) {
+        for (unsigned idx = 0; idx < (FRAGS - 1); idx++) {
+            _inject(s, _tag, idx);
+        }
+    }
+    xtimer_usleep(RBUF_TIMEOUT_US + SEC_IN_USEC);
+    _received = 0;
+    for (unsigned s = 0; s < SENDERS; s++) {
+        _inject(s, _tag, FRAGS - 1);
+    }
+    _collect();
+    printf("%u datagrams reassembled after timeout\n", _received);
+    if (_received != 0) {
+        puts("FAILURE");
+        return 1;
+    }
+
+    puts("SUCCESS");
+    return 0;
+}
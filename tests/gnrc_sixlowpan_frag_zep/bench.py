@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+# Copyright (C) 2016 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+"""Measures the round-trip time of fragmented datagrams over a forwarding node.
+
+Starts three native instances on the TAP interfaces <tap>0 to <tap>2, sets
+them up as a ring of ZEP links and lets node 1 send datagrams of each size to
+node 3 through node 2. Prints the round-trip times node 1 took.
+"""
+
+import argparse
+import os
+import pty
+import subprocess
+import sys
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+NODES = 3
+
+
+class Node(object):
+    def __init__(self, elf, tap):
+        # on a terminal, the node flushes every line
+        self.master, slave = pty.openpty()
+        self.proc = subprocess.Popen([elf, tap], stdin=subprocess.PIPE, stdout=slave)
+        os.close(slave)
+        self.rest = b""
+
+    def cmd(self, line):
+        self.proc.stdin.write(line.encode() + b"\n")
+        self.proc.stdin.flush()
+
+    def expect(self, prefix, timeout):
+        end = time.time() + timeout
+        while time.time() < end:
+            lines = self.rest.split(b"\n")
+            self.rest = lines.pop()
+            for line in lines:
+                line = line.decode(errors="replace").strip().lstrip("> ")
+                if line.startswith("error"):
+                    sys.exit(line)
+                if line.startswith(prefix):
+                    return line
+            try:
+                self.rest += os.read(self.master, 4096)
+            except OSError:
+                break
+        sys.exit("no \"%s\" within %.0f s" % (prefix, timeout))
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__)
+    p.add_argument("--tap", default="tap", help="name base of the TAP interfaces")
+    p.add_argument("--count", type=int, default=100, help="datagrams per size")
+    p.add_argument("--sizes", default="64,256,512,1024", help="UDP payload sizes")
+    p.add_argument("--elf", default=os.path.join(HERE, "bin", "native",
+                                                 "gnrc_sixlowpan_frag_zep.elf"))
+    args = p.parse_args()
+
+    nodes = [Node(args.elf, "%s%u" % (args.tap, i)) for i in range(NODES)]
+    try:
+        print(nodes[0].expect("6LoWPAN fragment forwarding", 10))
+        for i, node in enumerate(nodes):
+            node.cmd("setup %u" % (i + 1))
+            node.expect("node %u ready" % (i + 1), 10)
+        # neighbor discovery on the TAP interfaces
+        nodes[0].cmd("bench 3 8")
+        nodes[0].expect("bench:", 10)
+        for size in args.sizes.split(","):
+            nodes[0].cmd("bench %u %s" % (args.count, size))
+            print(nodes[0].expect("bench:", args.count * 2 + 10))
+    finally:
+        for node in nodes:
+            node.proc.kill()
+        for node in nodes:
+            node.proc.wait()
+
+
+if __name__ == "__main__":
+    main()
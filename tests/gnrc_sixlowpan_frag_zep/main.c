@@ -0,0 +1,334 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       A node of the end-to-end benchmark of 6LoWPAN fragment
+ *              forwarding over ZEP, with and without
+ *              @ref net_gnrc_sixlowpan_frag_vrb
+ *
+ * Three nodes form a ring of ZEP links over their TAP interfaces: node 1
+ * sends to node 2, node 2 to node 3 and node 3 back to node 1. Node 1 sends
+ * fragmented UDP datagrams to node 3, which are forwarded by node 2. Node 3
+ * answers each one with a short datagram straight to node 1, which takes the
+ * round-trip time. bench.py sets the nodes up and runs the benchmark.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "msg.h"
+#include "shell.h"
+#include "thread.h"
+#include "utlist.h"
+#include "xtimer.h"
+#include "net/fib.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6.h"
+#include "net/gnrc/ipv6/netif.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/nomac.h"
+#include "net/gnrc/udp.h"
+#include "net/gnrc/zep.h"
+
+#define NODES           (3U)
+#define SOURCE          (1U)
+#define SINK            (3U)
+#define PORT            (61616U)
+#define REPLY_TIMEOUT   (SEC_IN_USEC)
+#define MSG_QUEUE_SIZE  (8U)
+
+/* sequence number and send time */
+typedef struct {
+    uint32_t seq;
+    uint32_t time;
+} bench_hdr_t;
+
+static gnrc_zep_t _zep;
+static char _zep_stack[THREAD_STACKSIZE_DEFAULT];
+static char _sink_stack[THREAD_STACKSIZE_DEFAULT];
+static msg_t _main_msg_queue[MSG_QUEUE_SIZE];
+static gnrc_netreg_entry_t _bench_reg = { NULL, PORT, KERNEL_PID_UNDEF };
+
+/* fd00::<node> on the TAP interfaces */
+static void _tap_addr(ipv6_addr_t *addr, unsigned node)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->u8[0] = 0xfd;
+    addr->u8[15] = (uint8_t)node;
+}
+
+/* the EUI-64 of a node's ZEP interface is 00:00:00:00:00:00:00:<node> */
+static void _zep_l2addr(uint8_t *l2addr, unsigned node)
+{
+    memset(l2addr, 0, sizeof(eui64_t));
+    l2addr[sizeof(eui64_t) - 1] = (uint8_t)node;
+}
+
+/* the addresses of a node's ZEP interface are fe80::200:0:0:<node> and
+ * 2001:db8:<node>::200:0:0:<node> */
+static void _zep_addr(ipv6_addr_t *addr, unsigned node, bool global)
+{
+    memset(addr, 0, sizeof(*addr));
+    if (global) {
+        addr->u8[0] = 0x20;
+        addr->u8[1] = 0x01;
+        addr->u8[2] = 0x0d;
+        addr->u8[3] = 0xb8;
+        addr->u8[5] = (uint8_t)node;
+    }
+    else {
+        ipv6_addr_set_link_local_prefix(addr);
+    }
+    addr->u8[8] = 0x02;
+    addr->u8[15] = (uint8_t)node;
+}
+
+static void _echo(gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *ipv6, *reply, *hdr;
+    network_uint16_t port = byteorder_htons(PORT);
+
+    LL_SEARCH_SCALAR(pkt, ipv6, type, GNRC_NETTYPE_IPV6);
+    if ((ipv6 == NULL) || (pkt->size < sizeof(bench_hdr_t))) {
+        return;
+    }
+    reply = gnrc_pktbuf_add(NULL, pkt->data, sizeof(bench_hdr_t), GNRC_NETTYPE_UNDEF);
+    if (reply == NULL) {
+        return;
+    }
+    hdr = gnrc_udp_hdr_build(reply, port.u8, sizeof(port), port.u8, sizeof(port));
+    if (hdr == NULL) {
+        gnrc_pktbuf_release(reply);
+        return;
+    }
+    reply = hdr;
+    hdr = gnrc_ipv6_hdr_build(reply, NULL, 0, ((ipv6_hdr_t *)ipv6->data)->src.u8,
+                              sizeof(ipv6_addr_t));
+    if (hdr == NULL) {
+        gnrc_pktbuf_release(reply);
+        return;
+    }
+    reply = hdr;
+    if (!gnrc_netapi_dispatch_send(GNRC_NETTYPE_UDP, GNRC_NETREG_DEMUX_CTX_ALL, reply)) {
+        gnrc_pktbuf_release(reply);
+    }
+}
+
+/* answers every datagram of node 1 */
+static void *_sink(void *arg)
+{
+    msg_t msg, msg_queue[MSG_QUEUE_SIZE];
+    gnrc_netreg_entry_t reg = { NULL, PORT, KERNEL_PID_UNDEF };
+
+    (void)arg;
+    msg_init_queue(msg_queue, MSG_QUEUE_SIZE);
+    reg.pid = thread_getpid();
+    gnrc_netreg_register(GNRC_NETTYPE_UDP, &reg);
+    while (1) {
+        msg_receive(&msg);
+        if (msg.type == GNRC_NETAPI_MSG_TYPE_RCV) {
+            _echo((gnrc_pktsnip_t *)msg.content.ptr);
+            gnrc_pktbuf_release((gnrc_pktsnip_t *)msg.content.ptr);
+        }
+    }
+
+    return NULL;
+}
+
+static int _setup(int argc, char **argv)
+{
+    kernel_pid_t ifs[GNRC_NETIF_NUMOF], tap, zep;
+    ipv6_addr_t addr, next_hop;
+    uint8_t l2addr[sizeof(eui64_t)];
+    unsigned node, next;
+
+    if ((argc < 2) || ((node = (unsigned)atoi(argv[1])) < 1) || (node > NODES)) {
+        printf("usage: %s <1-%u>\n", argv[0], NODES);
+        return 1;
+    }
+    if (gnrc_netif_get(ifs) != 1) {
+        puts("error: set up already or no TAP interface");
+        return 1;
+    }
+    tap = ifs[0];
+    next = (node % NODES) + 1;
+
+    /* the ZEP link to the next node of the ring */
+    _tap_addr(&addr, node);
+    if (gnrc_ipv6_netif_add_addr(tap, &addr, 64, GNRC_IPV6_NETIF_ADDR_FLAGS_UNICAST |
+                                 GNRC_IPV6_NETIF_ADDR_FLAGS_NDP_ON_LINK) == NULL) {
+        puts("error: unable to add address to TAP interface");
+        return 1;
+    }
+    _tap_addr(&addr, next);
+    if ((gnrc_zep_init(&_zep, GNRC_ZEP_DEFAULT_PORT, &addr, GNRC_ZEP_DEFAULT_PORT) < 0) ||
+        ((zep = gnrc_nomac_init(_zep_stack, sizeof(_zep_stack), THREAD_PRIORITY_MAIN - 3,
+                                "zep_l2", (gnrc_netdev_t *)&_zep)) < 0)) {
+        puts("error: unable to start ZEP");
+        return 1;
+    }
+    _zep_l2addr(l2addr, node);
+    gnrc_netapi_set(zep, NETOPT_ADDRESS_LONG, 0, l2addr, sizeof(l2addr));
+    gnrc_ipv6_netif_init_by_dev();
+
+    /* the datagrams go to the prefix of node 3, its replies to that of node 1 */
+    _zep_addr(&addr, node, true);
+    if (gnrc_ipv6_netif_add_addr(zep, &addr, 64, GNRC_IPV6_NETIF_ADDR_FLAGS_UNICAST) == NULL) {
+        puts("error: unable to add address to ZEP interface");
+        return 1;
+    }
+    _zep_addr(&addr, (node == SINK) ? SOURCE : SINK, true);
+    _zep_addr(&next_hop, next, false);
+    fib_add_entry(&gnrc_ipv6_fib_table, zep, addr.u8, sizeof(addr), FIB_FLAG_NET_PREFIX,
+                  next_hop.u8, sizeof(next_hop), 0, (uint32_t)FIB_LIFETIME_NO_EXPIRE);
+
+    if ((node == SINK) &&
+        (thread_create(_sink_stack, sizeof(_sink_stack), THREAD_PRIORITY_MAIN - 1,
+                       CREATE_STACKTEST, _sink, NULL, "sink") <= KERNEL_PID_UNDEF)) {
+        puts("error: unable to start sink");
+        return 1;
+    }
+    printf("node %u ready\n", node);
+
+    return 0;
+}
+
+static int _send(uint32_t seq, size_t size)
+{
+    gnrc_pktsnip_t *payload, *pkt;
+    network_uint16_t port = byteorder_htons(PORT);
+    ipv6_addr_t dst;
+    bench_hdr_t *hdr;
+
+    payload = gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_UNDEF);
+    if (payload == NULL) {
+        return -ENOMEM;
+    }
+    memset(payload->data, 0, size);
+    pkt = gnrc_udp_hdr_build(payload, port.u8, sizeof(port), port.u8, sizeof(port));
+    if (pkt == NULL) {
+        gnrc_pktbuf_release(payload);
+        return -ENOMEM;
+    }
+    payload = pkt;
+    _zep_addr(&dst, SINK, true);
+    pkt = gnrc_ipv6_hdr_build(payload, NULL, 0, dst.u8, sizeof(dst));
+    if (pkt == NULL) {
+        gnrc_pktbuf_release(payload);
+        return -ENOMEM;
+    }
+    hdr = payload->next->data;
+    hdr->seq = seq;
+    hdr->time = xtimer_now();
+    if (!gnrc_netapi_dispatch_send(GNRC_NETTYPE_UDP, GNRC_NETREG_DEMUX_CTX_ALL, pkt)) {
+        gnrc_pktbuf_release(pkt);
+        return -EHOSTUNREACH;
+    }
+
+    return 0;
+}
+
+/* returns the round-trip time of datagram @p seq or -1 if its reply got lost */
+static int32_t _wait_reply(uint32_t seq)
+{
+    msg_t msg;
+
+    while (xtimer_msg_receive_timeout(&msg, REPLY_TIMEOUT) >= 0) {
+        gnrc_pktsnip_t *pkt = (gnrc_pktsnip_t *)msg.content.ptr;
+        bench_hdr_t hdr;
+
+        if (msg.type != GNRC_NETAPI_MSG_TYPE_RCV) {
+            continue;
+        }
+        if (pkt->size < sizeof(hdr)) {
+            gnrc_pktbuf_release(pkt);
+            continue;
+        }
+        memcpy(&hdr, pkt->data, sizeof(hdr));
+        gnrc_pktbuf_release(pkt);
+        if (hdr.seq == seq) {
+            return (int32_t)(xtimer_now() - hdr.time);
+        }
+    }
+
+    return -1;
+}
+
+static int _bench(int argc, char **argv)
+{
+    unsigned count, size, replies = 0;
+    uint32_t min = UINT32_MAX, max = 0;
+    uint64_t sum = 0;
+
+    if ((argc < 3) || ((count = (unsigned)atoi(argv[1])) == 0) ||
+        ((size = (unsigned)atoi(argv[2])) < sizeof(bench_hdr_t))) {
+        printf("usage: %s <count> <payload size, at least %u>\n", argv[0],
+               (unsigned)sizeof(bench_hdr_t));
+        return 1;
+    }
+    if (_bench_reg.pid == KERNEL_PID_UNDEF) {
+        _bench_reg.pid = thread_getpid();
+        gnrc_netreg_register(GNRC_NETTYPE_UDP, &_bench_reg);
+    }
+
+    for (unsigned n = 0; n < count; n++) {
+        int32_t rtt;
+
+        if (_send(n, size) < 0) {
+            puts("error: unable to send");
+            return 1;
+        }
+        if ((rtt = _wait_reply(n)) < 0) {
+            continue;
+        }
+        replies++;
+        sum += (uint32_t)rtt;
+        min = ((uint32_t)rtt < min) ? (uint32_t)rtt : min;
+        max = ((uint32_t)rtt > max) ? (uint32_t)rtt : max;
+    }
+
+    if (replies == 0) {
+        printf("bench: 0 of %u replies, %u-byte payload\n", count, size);
+        return 1;
+    }
+    printf("bench: %u of %u replies, %u-byte payload: rtt min %lu us, avg %lu us, "
+           "max %lu us\n", replies, count, size, (unsigned long)min,
+           (unsigned long)(sum / replies), (unsigned long)max);
+
+    return 0;
+}
+
+static const shell_command_t shell_commands[] = {
+    { "setup", "sets up this node of the ZEP ring", _setup },
+    { "bench", "sends datagrams to node 3 and takes their round-trip time", _bench },
+    { NULL, NULL, NULL }
+};
+
+int main(void)
+{
+    char line_buf[SHELL_DEFAULT_BUFSIZE];
+
+    msg_init_queue(_main_msg_queue, MSG_QUEUE_SIZE);
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_VRB
+    puts("6LoWPAN fragment forwarding over ZEP, virtual reassembly");
+#else
+    puts("6LoWPAN fragment forwarding over ZEP, reassembly");
+#endif
+    shell_run(shell_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
+
+    return 0;
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Compares the airtime of RPL control messages with and without
+ *              6LoWPAN-GHC
+ *
+ * The messages are laid out like the ones gnrc_rpl sends in a non-storing
+ * network: a root multicasts DIOs, a node one hop away sends its DAO to the
+ * root and gets a DAO-ACK back. Each message is compressed once with IPHC
+ * only and once with GHC, and the frame with GHC is decompressed again.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "thread.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6/hdr.h"
+#include "net/gnrc/ipv6/nc.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/sixlowpan/ghc.h"
+#include "net/gnrc/sixlowpan/iphc.h"
+#include "net/gnrc/sixlowpan/netif.h"
+#include "net/protnum.h"
+
+#define MAX_FRAG_SIZE   (102U)
+/* IEEE 802.15.4 in the 2.4 GHz band: 250 kbit/s */
+#define USEC_PER_BYTE   (32U)
+
+typedef struct {
+    const char *name;
+    const uint8_t *icmpv6;
+    size_t len;
+    const ipv6_addr_t *src;
+    const ipv6_addr_t *dst;
+    const uint8_t *src_l2;
+    const uint8_t *dst_l2;      /* NULL for multicast */
+} _msg_t;
+
+static kernel_pid_t _iface;
+
+static const uint8_t _root_l2[] = { 0x00, 0x11, 0x22, 0xff, 0xfe, 0x33, 0x44, 0x55 };
+static const uint8_t _node_l2[] = { 0x00, 0x11, 0x22, 0xff, 0xfe, 0x33, 0x44, 0x66 };
+static const uint8_t _bcast_l2[] = { 0xff, 0xff };
+
+static const ipv6_addr_t _root_ll = {{ 0xfe, 0x80, [8] = 0x02, 0x11, 0x22, 0xff,
+                                       0xfe, 0x33, 0x44, 0x55 }};
+static const ipv6_addr_t _root = {{ 0x20, 0x01, 0x0d, 0xb8, [8] = 0x02, 0x11, 0x22, 0xff,
+                                    0xfe, 0x33, 0x44, 0x55 }};
+static const ipv6_addr_t _node = {{ 0x20, 0x01, 0x0d, 0xb8, [8] = 0x02, 0x11, 0x22, 0xff,
+                                    0xfe, 0x33, 0x44, 0x66 }};
+static const ipv6_addr_t _all_rpl_nodes = {{ 0xff, 0x02, [15] = 0x1a }};
+
+/* DIO with DODAG configuration and prefix information option */
+static const uint8_t _dio[] = {
+    0x9b, 0x01, 0x7a, 0x5f,                         /* ICMPv6 */
+    0x00, 0xf1, 0x01, 0x00, 0x88, 0x00, 0x00, 0x00, /* instance, version, rank, MOP... */
+    0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, /* DODAG ID */
+    0x02, 0x11, 0x22, 0xff, 0xfe, 0x33, 0x44, 0x55,
+    0x04, 0x0e, 0x00, 0x08, 0x0c, 0x0a, 0x07, 0x00, /* DODAG configuration */
+    0x01, 0x00, 0x00, 0x01, 0x00, 0xff, 0xff, 0xff,
+    0x08, 0x1e, 0x40, 0x40, 0xff, 0xff, 0xff, 0xff, /* prefix information */
+    0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00,
+    0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+/* DAO with target and transit information option */
+static const uint8_t _dao[] = {
+    0x9b, 0x02, 0x3c, 0x81,                         /* ICMPv6 */
+    0x00, 0x40, 0x00, 0xf2,                         /* instance, D flag, sequence */
+    0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, /* DODAG ID */
+    0x02, 0x11, 0x22, 0xff, 0xfe, 0x33, 0x44, 0x55,
+    0x05, 0x12, 0x00, 0x80,                         /* target */
+    0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00,
+    0x02, 0x11, 0x22, 0xff, 0xfe, 0x33, 0x44, 0x66,
+    0x06, 0x14, 0x00, 0x00, 0x00, 0xff,             /* transit information */
+    0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00,
+    0x02, 0x11, 0x22, 0xff, 0xfe, 0x33, 0x44, 0x55,
+};
+
+/* DAO-ACK */
+static const uint8_t _dao_ack[] = {
+    0x9b, 0x03, 0x5e, 0x1d,                         /* ICMPv6 */
+    0x00, 0x80, 0xf2, 0x00,                         /* instance, D flag, sequence, status */
+    0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, /* DODAG ID */
+    0x02, 0x11, 0x22, 0xff, 0xfe, 0x33, 0x44, 0x55,
+};
+
+static const _msg_t _msgs[] = {
+    { "DIO", _dio, sizeof(_dio), &_root_ll, &_all_rpl_nodes, _root_l2, NULL },
+    { "DAO", _dao, sizeof(_dao), &_node, &_root, _node_l2, _root_l2 },
+    { "DAO-ACK", _dao_ack, sizeof(_dao_ack), &_root, &_node, _root_l2, _node_l2 },
+};
+
+/* builds [netif][ipv6][icmpv6] as gnrc_ipv6 hands it to 6LoWPAN and
+ * compresses it */
+static gnrc_pktsnip_t *_encode(const _msg_t *msg)
+{
+    gnrc_pktsnip_t *icmpv6, *ipv6, *netif;
+    ipv6_hdr_t *ipv6_hdr;
+
+    icmpv6 = gnrc_pktbuf_add(NULL, (void *)msg->icmpv6, msg->len, GNRC_NETTYPE_UNDEF);
+    if (icmpv6 == NULL) {
+        return NULL;
+    }
+    ipv6 = gnrc_ipv6_hdr_build(icmpv6, (uint8_t *)msg->src, sizeof(ipv6_addr_t),
+                               (uint8_t *)msg->dst, sizeof(ipv6_addr_t));
+    if (ipv6 == NULL) {
+        gnrc_pktbuf_release(icmpv6);
+        return NULL;
+    }
+    ipv6_hdr = ipv6->data;
+    ipv6_hdr->nh = PROTNUM_ICMPV6;
+    ipv6_hdr->hl = 255;
+    ipv6_hdr->len = byteorder_htons((uint16_t)msg->len);
+    if (msg->dst_l2 == NULL) {
+        netif = gnrc_netif_hdr_build((uint8_t *)msg->src_l2, 8, NULL, 0);
+    }
+    else {
+        netif = gnrc_netif_hdr_build((uint8_t *)msg->src_l2, 8, (uint8_t *)msg->dst_l2, 8);
+    }
+    if (netif == NULL) {
+        gnrc_pktbuf_release(ipv6);
+        return NULL;
+    }
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = _iface;
+    if (msg->dst_l2 == NULL) {
+        ((gnrc_netif_hdr_t *)netif->data)->flags |= GNRC_NETIF_HDR_FLAGS_MULTICAST;
+    }
+    netif->next = ipv6;
+    if (!gnrc_sixlowpan_iphc_encode(netif)) {
+        gnrc_pktbuf_release(netif);
+        return NULL;
+    }
+
+    return netif;
+}
+
+/* decompresses a frame compressed with GHC and compares it to msg */
+static bool _decode(const _msg_t *msg, gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *netif, *frame, *ipv6;
+    uint8_t *data;
+    size_t nh_len;
+    bool ok;
+
+    netif = (msg->dst_l2 == NULL) ?
+            gnrc_netif_hdr_build((uint8_t *)msg->src_l2, 8, (uint8_t *)_bcast_l2,
+                                 sizeof(_bcast_l2)) :
+            gnrc_netif_hdr_build((uint8_t *)msg->src_l2, 8, (uint8_t *)msg->dst_l2, 8);
+    if (netif == NULL) {
+        return false;
+    }
+    frame = gnrc_pktbuf_add(netif, NULL, gnrc_pkt_len(pkt->next), GNRC_NETTYPE_SIXLOWPAN);
+    ipv6 = gnrc_pktbuf_add(NULL, NULL, GNRC_SIXLOWPAN_IPHC_HDR_MAX, GNRC_NETTYPE_IPV6);
+    if ((frame == NULL) || (ipv6 == NULL)) {
+        gnrc_pktbuf_release((frame == NULL) ? netif : frame);
+        if (ipv6 != NULL) {
+            gnrc_pktbuf_release(ipv6);
+        }
+        return false;
+    }
+    data = frame->data;
+    for (gnrc_pktsnip_t *ptr = pkt->next; ptr != NULL; ptr = ptr->next) {
+        memcpy(data, ptr->data, ptr->size);
+        data += ptr->size;
+    }
+    ok = (gnrc_sixlowpan_iphc_decode(ipv6, frame, 0, 0, &nh_len) == frame->size) &&
+         (nh_len == msg->len) &&
+         ipv6_addr_equal(&((ipv6_hdr_t *)ipv6->data)->src, msg->src) &&
+         ipv6_addr_equal(&((ipv6_hdr_t *)ipv6->data)->dst, msg->dst) &&
+         (memcmp(((uint8_t *)ipv6->data) + sizeof(ipv6_hdr_t), msg->icmpv6, msg->len) == 0);
+    gnrc_pktbuf_release(ipv6);
+    gnrc_pktbuf_release(frame);
+
+    return ok;
+}
+
+/* lets the receiver of msg indicate that it understands GHC (or not) */
+static void _ghc_enable(const _msg_t *msg, bool enable)
+{
+    gnrc_sixlowpan_netif_t *iface = gnrc_sixlowpan_netif_get(_iface);
+
+    if (msg->dst_l2 == NULL) {
+        iface->ghc_mcast = enable;
+    }
+    else {
+        /* as if the receiver sent a 6CIO with the G flag */
+        gnrc_ipv6_nc_t *nc_entry = gnrc_ipv6_nc_get(_iface, msg->dst);
+
+        if (nc_entry == NULL) {
+            nc_entry = gnrc_ipv6_nc_add(_iface, msg->dst, msg->dst_l2, 8, 0);
+        }
+        if (enable) {
+            nc_entry->flags |= GNRC_IPV6_NC_SIXLOWPAN_GHC;
+        }
+        else {
+            nc_entry->flags &= ~GNRC_IPV6_NC_SIXLOWPAN_GHC;
+        }
+    }
+}
+
+int main(void)
+{
+    unsigned total_iphc = 0, total_ghc = 0;
+
+    _iface = thread_getpid();
+    gnrc_sixlowpan_netif_add(_iface, MAX_FRAG_SIZE);
+
+    puts("6LoWPAN-GHC airtime test");
+    for (unsigned i = 0; i < sizeof(_msgs) / sizeof(_msgs[0]); i++) {
+        const _msg_t *msg = &_msgs[i];
+        gnrc_pktsnip_t *iphc, *ghc;
+        unsigned iphc_len, ghc_len;
+
+        _ghc_enable(msg, false);
+        iphc = _encode(msg);
+        _ghc_enable(msg, true);
+        ghc = _encode(msg);
+        if ((iphc == NULL) || (ghc == NULL)) {
+            puts("error: unable to compress message");
+            return 1;
+        }
+        iphc_len = gnrc_pkt_len(iphc->next);
+        ghc_len = gnrc_pkt_len(ghc->next);
+        printf("%-8s %3u bytes: IPHC %3u bytes (%4u us), GHC %3u bytes (%4u us)\n",
+               msg->name, (unsigned)(sizeof(ipv6_hdr_t) + msg->len),
+               iphc_len, iphc_len * USEC_PER_BYTE, ghc_len, ghc_len * USEC_PER_BYTE);
+        if ((ghc_len >= iphc_len) || !_decode(msg, ghc)) {
+            printf("FAILURE: %s not compressed or decompressed correctly\n", msg->name);
+            return 1;
+        }
+        total_iphc += iphc_len;
+        total_ghc += ghc_len;
+        gnrc_pktbuf_release(iphc);
+        gnrc_pktbuf_release(ghc);
+    }
+    printf("total: IPHC %u bytes, GHC %u bytes (%u%% of the airtime)\n",
+           total_iphc, total_ghc, (total_ghc * 100) / total_iphc);
+    puts("SUCCESS");
+
+    return 0;
+}
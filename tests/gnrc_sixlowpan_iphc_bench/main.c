@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measures how many packets per second IPHC compresses and
+ *              decompresses
+ *
+ * A UDP packet between two addresses of a context is compressed over and over
+ * again, as the 6LoWPAN thread would do for a sender. The source link-layer
+ * address is left out like gnrc_ipv6 does, so the interface identifier has to
+ * be asked from a dummy interface. The compressed headers are then
+ * decompressed the same number of times.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "msg.h"
+#include "thread.h"
+#include "xtimer.h"
+#include "net/eui64.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6/hdr.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/sixlowpan/ctx.h"
+#include "net/gnrc/sixlowpan/iphc.h"
+#include "net/protnum.h"
+#include "net/udp.h"
+
+#define ROUNDS          (10000U)
+#define PAYLOAD_SIZE    (32U)
+#define MSG_QUEUE_SIZE  (8U)
+
+static char _netif_stack[THREAD_STACKSIZE_DEFAULT];
+static kernel_pid_t _iface;
+
+static const eui64_t _iid = { .uint8 = { 0x00, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x01 } };
+static uint8_t _dst_l2[] = { 0x00, 0x02 };
+static uint8_t _payload[PAYLOAD_SIZE];
+
+/* answers the encoder's requests for the interface identifier */
+static void *_dummy_netif(void *arg)
+{
+    msg_t msg, reply, msg_queue[MSG_QUEUE_SIZE];
+
+    (void)arg;
+    msg_init_queue(msg_queue, MSG_QUEUE_SIZE);
+    reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+    while (1) {
+        msg_receive(&msg);
+        switch (msg.type) {
+            case GNRC_NETAPI_MSG_TYPE_GET: {
+                gnrc_netapi_opt_t *opt = (gnrc_netapi_opt_t *)msg.content.ptr;
+
+                if ((opt->opt == NETOPT_IPV6_IID) && (opt->data_len >= sizeof(_iid))) {
+                    memcpy(opt->data, &_iid, sizeof(_iid));
+                    reply.content.value = sizeof(_iid);
+                }
+                else {
+                    reply.content.value = -ENOTSUP;
+                }
+                msg_reply(&msg, &reply);
+                break;
+            }
+            case GNRC_NETAPI_MSG_TYPE_SET:
+                reply.content.value = -ENOTSUP;
+                msg_reply(&msg, &reply);
+                break;
+            default:
+                break;
+        }
+    }
+
+    return NULL;
+}
+
+/* builds [netif][ipv6][udp][payload] as gnrc_ipv6 hands it to 6LoWPAN */
+static gnrc_pktsnip_t *_build(void)
+{
+    ipv6_addr_t src = {{ 0x20, 0x01, 0x0d, 0xb8, [11] = 0xff, 0xfe, 0x00, 0x00, 0x01 }};
+    ipv6_addr_t dst = {{ 0x20, 0x01, 0x0d, 0xb8, [11] = 0xff, 0xfe, 0x00, 0x00, 0x02 }};
+    gnrc_pktsnip_t *payload, *udp, *ipv6, *netif;
+    udp_hdr_t *udp_hdr;
+
+    payload = gnrc_pktbuf_add(NULL, _payload, sizeof(_payload), GNRC_NETTYPE_UNDEF);
+    if (payload == NULL) {
+        return NULL;
+    }
+    udp = gnrc_pktbuf_add(payload, NULL, sizeof(udp_hdr_t), GNRC_NETTYPE_UNDEF);
+    if (udp == NULL) {
+        gnrc_pktbuf_release(payload);
+        return NULL;
+    }
+    udp_hdr = udp->data;
+    udp_hdr->src_port = byteorder_htons(0xf0b1);
+    udp_hdr->dst_port = byteorder_htons(5683);
+    udp_hdr->length = byteorder_htons(sizeof(udp_hdr_t) + sizeof(_payload));
+    udp_hdr->checksum = byteorder_htons(0x1234);
+    ipv6 = gnrc_ipv6_hdr_build(udp, src.u8, sizeof(src), dst.u8, sizeof(dst));
+    if (ipv6 == NULL) {
+        gnrc_pktbuf_release(udp);
+        return NULL;
+    }
+    ((ipv6_hdr_t *)ipv6->data)->nh = PROTNUM_UDP;
+    ((ipv6_hdr_t *)ipv6->data)->hl = 64;
+    ((ipv6_hdr_t *)ipv6->data)->len = udp_hdr->length;
+    netif = gnrc_netif_hdr_build(NULL, 0, _dst_l2, sizeof(_dst_l2));
+    if (netif == NULL) {
+        gnrc_pktbuf_release(ipv6);
+        return NULL;
+    }
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = _iface;
+    netif->next = ipv6;
+
+    return netif;
+}
+
+/* time in microseconds to build and release ROUNDS packets, with
+ * compression if encode is true */
+static uint32_t _run_encode(bool encode)
+{
+    uint32_t start = xtimer_now();
+
+    for (unsigned i = 0; i < ROUNDS; i++) {
+        gnrc_pktsnip_t *pkt = _build();
+
+        if ((pkt == NULL) || (encode && !gnrc_sixlowpan_iphc_encode(pkt))) {
+            puts("error: unable to compress packet");
+            return 0;
+        }
+        gnrc_pktbuf_release(pkt);
+    }
+
+    return xtimer_now() - start;
+}
+
+/* turns a compressed packet into a received frame */
+static gnrc_pktsnip_t *_frame(gnrc_pktsnip_t *pkt)
+{
+    gnrc_netif_hdr_t *hdr = pkt->data;
+    gnrc_pktsnip_t *netif, *frame;
+    uint8_t src_l2[] = { _iid.uint8[6], _iid.uint8[7] };
+    uint8_t *data;
+
+    netif = gnrc_netif_hdr_build(src_l2, sizeof(src_l2), gnrc_netif_hdr_get_dst_addr(hdr),
+                                 hdr->dst_l2addr_len);
+    if (netif == NULL) {
+        return NULL;
+    }
+    frame = gnrc_pktbuf_add(netif, NULL, gnrc_pkt_len(pkt->next), GNRC_NETTYPE_SIXLOWPAN);
+    if (frame == NULL) {
+        gnrc_pktbuf_release(netif);
+        return NULL;
+    }
+    data = frame->data;
+    for (gnrc_pktsnip_t *ptr = pkt->next; ptr != NULL; ptr = ptr->next) {
+        memcpy(data, ptr->data, ptr->size);
+        data += ptr->size;
+    }
+
+    return frame;
+}
+
+static unsigned long _pps(uint32_t usec)
+{
+    return (usec == 0) ? 0 : (unsigned long)(((uint64_t)ROUNDS * SEC_IN_USEC) / usec);
+}
+
+int main(void)
+{
+    ipv6_addr_t prefix = {{ 0x20, 0x01, 0x0d, 0xb8 }};
+    gnrc_pktsnip_t *pkt, *ref, *frame, *ipv6;
+    uint32_t base, time;
+    size_t hdr_len, nh_len;
+    bool ok;
+
+    _iface = thread_create(_netif_stack, sizeof(_netif_stack), THREAD_PRIORITY_MAIN - 1,
+                           CREATE_STACKTEST, _dummy_netif, NULL, "dummy_netif");
+    gnrc_sixlowpan_ctx_update(0, &prefix, 64, UINT16_MAX, true);
+    for (unsigned i = 0; i < sizeof(_payload); i++) {
+        _payload[i] = (uint8_t)i;
+    }
+
+    puts("6LoWPAN IPHC benchmark");
+    ref = _build();
+    pkt = _build();
+    ipv6 = gnrc_pktbuf_add(NULL, NULL, GNRC_SIXLOWPAN_IPHC_HDR_MAX, GNRC_NETTYPE_IPV6);
+    if ((ref == NULL) || (pkt == NULL) || (ipv6 == NULL) ||
+        !gnrc_sixlowpan_iphc_encode(pkt) || ((frame = _frame(pkt)) == NULL)) {
+        puts("error: unable to set up packets");
+        return 1;
+    }
+    hdr_len = pkt->next->size;
+    gnrc_pktbuf_release(pkt);
+
+    /* check that the headers survive the round trip */
+    ok = (gnrc_sixlowpan_iphc_decode(ipv6, frame, 0, 0, &nh_len) == hdr_len) &&
+         (memcmp(ipv6->data, ref->next->data, sizeof(ipv6_hdr_t)) == 0);
+    if (nh_len > 0) {
+        ok = ok && (memcmp(((uint8_t *)ipv6->data) + sizeof(ipv6_hdr_t),
+                           ref->next->next->data, nh_len) == 0);
+    }
+    gnrc_pktbuf_release(ref);
+    if (!ok) {
+        puts("FAILURE: decompressed headers differ");
+        return 1;
+    }
+    printf("%u bytes of IPv6 and UDP header compressed to %u bytes\n",
+           (unsigned)(sizeof(ipv6_hdr_t) + sizeof(udp_hdr_t)),
+           (unsigned)(frame->size - sizeof(_payload)));
+
+    base = _run_encode(false);
+    time = _run_encode(true);
+    if ((time == 0) || (time < base)) {
+        puts("error: unable to measure compression");
+        return 1;
+    }
+    printf("encode: %lu packets/s\n", _pps(time - base));
+
+    time = xtimer_now();
+    for (unsigned i = 0; i < ROUNDS; i++) {
+        if (gnrc_sixlowpan_iphc_decode(ipv6, frame, 0, 0, &nh_len) != hdr_len) {
+            puts("error: unable to decompress packet");
+            return 1;
+        }
+    }
+    time = xtimer_now() - time;
+    printf("decode: %lu packets/s\n", _pps(time));
+
+    gnrc_pktbuf_release(ipv6);
+    gnrc_pktbuf_release(frame);
+    puts("SUCCESS");
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Compares msg_send()/msg_receive() with msg_send_batch()/
+ *              msg_receive_batch() in terms of context switches and time
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "msg.h"
+#include "sched.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define MSG_NUM         (10000U)
+#define BATCH_NUM       (8U)
+#define QUEUE_SIZE      (16U)
+
+static char stack[THREAD_STACKSIZE_MAIN];
+static msg_t queue[QUEUE_SIZE];
+
+static volatile unsigned received;
+static volatile int use_batch;
+
+static void *_consumer(void *arg)
+{
+    (void)arg;
+    msg_t msgs[BATCH_NUM];
+
+    msg_init_queue(queue, QUEUE_SIZE);
+
+    while (1) {
+        if (use_batch) {
+            received += msg_receive_batch(msgs, BATCH_NUM);
+        }
+        else {
+            msg_receive(msgs);
+            received++;
+        }
+    }
+
+    return NULL;
+}
+
+static void run(kernel_pid_t pid, int batch)
+{
+    msg_t msgs[BATCH_NUM];
+    unsigned sent = 0;
+    unsigned schedules = sched_pidlist[pid].schedules;
+
+    received = 0;
+    use_batch = batch;
+    uint32_t start = xtimer_now();
+
+    while (sent < MSG_NUM) {
+        if (batch) {
+            for (unsigned i = 0; i < BATCH_NUM; i++) {
+                msgs[i].content.value = sent + i;
+            }
+            /* the consumer has a higher priority and drains the queue, so
+             * all messages of a batch fit */
+            sent += msg_send_batch(msgs, BATCH_NUM, pid);
+        }
+        else {
+            msgs[0].content.value = sent;
+            msg_send(msgs, pid);
+            sent++;
+        }
+    }
+
+    uint32_t diff = xtimer_now() - start;
+    schedules = sched_pidlist[pid].schedules - schedules;
+
+    printf("+ %s: %u msgs received, %u consumer switches, %lu us\n",
+           batch ? "batched   " : "single msg", received, schedules,
+           (unsigned long)diff);
+}
+
+int main(void)
+{
+    puts("Start.");
+
+    kernel_pid_t pid = thread_create(stack, sizeof(stack),
+                                     THREAD_PRIORITY_MAIN - 1,
+                                     CREATE_STACKTEST, _consumer, NULL,
+                                     "consumer");
+
+    run(pid, 0);
+    run(pid, 1);
+
+    puts("Done.");
+    return 0;
+}
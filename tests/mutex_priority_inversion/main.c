@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Reproduces a priority inversion on a mutex and measures how
+ *              long the high priority thread waits for it
+ *
+ * A low priority thread holds the mutex for LOW_WORK microseconds. While it
+ * does, a high priority thread blocks on the mutex and a medium priority
+ * thread starts to compute for MEDIUM_WORK microseconds. Without priority
+ * inheritance, the high priority thread waits for both, with inheritance only
+ * for the rest of LOW_WORK.
+ *
+ * The test runs this with a single mutex, and with the low priority thread
+ * holding two mutexes and releasing the one nobody waits for first. The low
+ * priority thread must keep the inherited priority until it releases the
+ * contended mutex, in either release order.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "mutex.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define LOW_WORK        (10U * MS_IN_USEC)
+#define MEDIUM_WORK     (50U * MS_IN_USEC)
+#define HIGH_DELAY      (1U * MS_IN_USEC)
+#define MEDIUM_DELAY    (2U * MS_IN_USEC)
+
+static char stack_low[THREAD_STACKSIZE_MAIN];
+static char stack_medium[THREAD_STACKSIZE_MAIN];
+static char stack_high[THREAD_STACKSIZE_MAIN];
+
+static mutex_t outer = MUTEX_INIT;
+static mutex_t inner = MUTEX_INIT;
+
+typedef struct {
+    const char *name;
+    mutex_t *contended;     /**< mutex the high priority thread waits for */
+    mutex_t *release_first; /**< mutex low releases after LOW_WORK / 2 */
+    mutex_t *release_last;  /**< mutex low releases after LOW_WORK, or NULL */
+} round_t;
+
+static const round_t rounds[] = {
+    { "single", &outer, &outer, NULL },
+    { "nested", &outer, &inner, &outer },
+    { "reverse", &inner, &outer, &inner },
+};
+
+static uint32_t waited;
+
+static void _busy_wait(uint32_t usec)
+{
+    uint32_t start = xtimer_now();
+
+    while ((xtimer_now() - start) < usec) {}
+}
+
+static void *_low(void *arg)
+{
+    const round_t *round = arg;
+
+    mutex_lock(&outer);
+    if (round->release_last != NULL) {
+        mutex_lock(&inner);
+    }
+    _busy_wait(LOW_WORK / 2);
+    mutex_unlock(round->release_first);
+    _busy_wait(LOW_WORK / 2);
+    if (round->release_last != NULL) {
+        mutex_unlock(round->release_last);
+    }
+
+    return NULL;
+}
+
+static void *_medium(void *arg)
+{
+    (void)arg;
+
+    xtimer_usleep(MEDIUM_DELAY);
+    _busy_wait(MEDIUM_WORK);
+
+    return NULL;
+}
+
+static void *_high(void *arg)
+{
+    const round_t *round = arg;
+
+    xtimer_usleep(HIGH_DELAY);
+
+    uint32_t start = xtimer_now();
+    mutex_lock(round->contended);
+    waited = xtimer_now() - start;
+    mutex_unlock(round->contended);
+
+    return NULL;
+}
+
+int main(void)
+{
+    unsigned failed = 0;
+
+    puts("Start.");
+
+    for (unsigned i = 0; i < sizeof(rounds) / sizeof(rounds[0]); i++) {
+        void *arg = (void *)&rounds[i];
+
+        /* high and medium go to sleep immediately, low takes the mutexes.
+         * main has the lowest priority, so it only continues once all of
+         * them are done. */
+        thread_create(stack_high, sizeof(stack_high), THREAD_PRIORITY_MAIN - 3,
+                      CREATE_STACKTEST, _high, arg, "high");
+        thread_create(stack_medium, sizeof(stack_medium), THREAD_PRIORITY_MAIN - 2,
+                      CREATE_STACKTEST, _medium, NULL, "medium");
+        thread_create(stack_low, sizeof(stack_low), THREAD_PRIORITY_MAIN - 1,
+                      CREATE_STACKTEST, _low, arg, "low");
+
+        printf("%s: high priority thread waited %lu us for the mutex\n",
+               rounds[i].name, (unsigned long)waited);
+        if (waited >= MEDIUM_WORK) {
+            failed++;
+        }
+    }
+
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+    puts((failed == 0) ? "[SUCCESS]" : "[FAILED]");
+#else
+    printf("(built without mutex_priority_inheritance, %u rounds inverted)\n", failed);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measures simulated seconds per wall-clock second of native
+ *
+ * See README.md for details.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "thread.h"
+#include "xtimer.h"
+
+#define REPORT_INTERVAL (10U * SEC_IN_USEC)
+#define REPORTS         (6U)
+
+typedef struct {
+    uint32_t period;
+    volatile unsigned wakeups;
+} periodic_t;
+
+static periodic_t _periodic[] = {
+    { 10U * MS_IN_USEC, 0 },
+    { 100U * MS_IN_USEC, 0 },
+    { SEC_IN_USEC, 0 },
+};
+
+#define PERIODIC_NUMOF  (sizeof(_periodic) / sizeof(_periodic[0]))
+
+static char _stacks[PERIODIC_NUMOF][THREAD_STACKSIZE_DEFAULT];
+
+static void *_thread(void *arg)
+{
+    periodic_t *periodic = arg;
+    uint32_t last = xtimer_now();
+
+    while (1) {
+        xtimer_usleep_until(&last, periodic->period);
+        periodic->wakeups++;
+    }
+
+    return NULL;
+}
+
+/* the clock of the host, native only */
+static uint64_t _wall_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * SEC_IN_USEC) + (ts.tv_nsec / 1000);
+}
+
+int main(void)
+{
+    uint32_t last;
+    uint64_t wall;
+
+    puts("native_vtime test");
+    for (unsigned i = 0; i < PERIODIC_NUMOF; i++) {
+        thread_create(_stacks[i], sizeof(_stacks[i]), THREAD_PRIORITY_MAIN - 1 - i,
+                      CREATE_STACKTEST, _thread, &_periodic[i], "periodic");
+    }
+
+    last = xtimer_now();
+    wall = _wall_usec();
+    for (unsigned report = 1; report <= REPORTS; report++) {
+        unsigned wakeups[PERIODIC_NUMOF];
+        uint64_t now, elapsed;
+
+        xtimer_usleep_until(&last, REPORT_INTERVAL);
+        now = _wall_usec();
+        elapsed = (now > wall) ? (now - wall) : 1;
+        wall = now;
+        for (unsigned i = 0; i < PERIODIC_NUMOF; i++) {
+            wakeups[i] = _periodic[i].wakeups;
+            _periodic[i].wakeups = 0;
+        }
+        printf("%u s simulated in %lu.%06lu s: %lu simulated s per s, "
+               "wake-ups %u %u %u\n",
+               (report * REPORT_INTERVAL) / SEC_IN_USEC,
+               (unsigned long)(elapsed / SEC_IN_USEC),
+               (unsigned long)(elapsed % SEC_IN_USEC),
+               (unsigned long)((REPORT_INTERVAL * (uint64_t)SEC_IN_USEC) / elapsed),
+               wakeups[0], wakeups[1], wakeups[2]);
+    }
+    puts("done");
+
+    return 0;
+}
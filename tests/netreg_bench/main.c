@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measures the cost of dispatching a packet through
+ *              @ref net_gnrc_netreg for different numbers of registrations
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "msg.h"
+#include "thread.h"
+#include "xtimer.h"
+#include "net/gnrc/netreg.h"
+
+#define ENTRIES_MAX     (64U)
+#define LOOKUPS         (10000U)
+/* demux contexts look like a block of UDP ports */
+#define PORT_BASE       (5683U)
+#define MSG_QUEUE_SIZE  (4U)
+
+static msg_t msg_queue[MSG_QUEUE_SIZE];
+static gnrc_netreg_entry_t entries[ENTRIES_MAX];
+
+static unsigned _dispatch(uint32_t demux_ctx)
+{
+    unsigned num = 0;
+    /* same walk as gnrc_netapi_dispatch() */
+    gnrc_netreg_entry_t *entry = gnrc_netreg_lookup(GNRC_NETTYPE_UNDEF,
+                                                    demux_ctx);
+
+    while (entry) {
+        num++;
+        entry = gnrc_netreg_getnext(entry);
+    }
+    return num;
+}
+
+static void bench(unsigned num)
+{
+    uint32_t start, hit_time, miss_time;
+    unsigned found = 0;
+
+    gnrc_netreg_init();
+    for (unsigned i = 0; i < num; i++) {
+        entries[i].demux_ctx = PORT_BASE + i;
+        entries[i].pid = thread_getpid();
+        gnrc_netreg_register(GNRC_NETTYPE_UNDEF, &entries[i]);
+    }
+
+    start = xtimer_now();
+    for (unsigned i = 0; i < LOOKUPS; i++) {
+        found += _dispatch(PORT_BASE + (i % num));
+    }
+    hit_time = xtimer_now() - start;
+
+    /* nobody listens on these */
+    start = xtimer_now();
+    for (unsigned i = 0; i < LOOKUPS; i++) {
+        found += _dispatch(PORT_BASE + num + (i % num));
+    }
+    miss_time = xtimer_now() - start;
+
+    printf("+ %3u registrations: hit %5lu ns/dispatch, miss %5lu ns/dispatch%s\n",
+           num, (unsigned long)((hit_time * 1000UL) / LOOKUPS),
+           (unsigned long)((miss_time * 1000UL) / LOOKUPS),
+           (found == LOOKUPS) ? "" : " (lookup error)");
+}
+
+int main(void)
+{
+    puts("Start.");
+    printf("buckets per type: %u\n", (unsigned)GNRC_NETREG_BUCKETS);
+
+    /* gnrc_netreg only accepts threads with a message queue */
+    msg_init_queue(msg_queue, MSG_QUEUE_SIZE);
+
+    bench(1);
+    bench(8);
+    bench(32);
+    bench(ENTRIES_MAX);
+
+    puts("Done.");
+    return 0;
+}
@@ -38,8 +38,8 @@
 
 static char stacks[2][THREAD_STACKSIZE_MAIN];
 
-static char pipe_bufs[2][6];
-static ringbuffer_t rbs[2];
+static char pipe_bufs[2][8];
+static tsrb_t rbs[2];
 
 static pipe_t pipes[2];
 
@@ -96,7 +96,7 @@ int main(void)
     puts("Start.");
 
     for (int i = 0; i < 2; ++i) {
-        ringbuffer_init(&rbs[i], pipe_bufs[i], sizeof (pipe_bufs[i]));
+        tsrb_init(&rbs[i], pipe_bufs[i], sizeof (pipe_bufs[i]));
         pipe_init(&pipes[i], &rbs[i], NULL);
     }
 
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark for the scheduler's context switch path
+ *
+ * Measures the number of context switches per second caused by
+ * thread_wakeup()/thread_sleep() and the round-trip latency of
+ * msg_send_receive()/msg_reply() between two threads.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "thread.h"
+#include "msg.h"
+#include "xtimer.h"
+
+#define TIMEOUT_S       (2ul)
+#define TIMEOUT         (TIMEOUT_S * SEC_IN_USEC)
+
+static char sleeper_stack[THREAD_STACKSIZE_MAIN];
+static char replier_stack[THREAD_STACKSIZE_MAIN];
+
+static volatile int done;
+static volatile unsigned long counter;
+
+static void _timeout_cb(void *arg)
+{
+    (void)arg;
+    done = 1;
+}
+
+static void _start_timeout(xtimer_t *timer)
+{
+    done = 0;
+    counter = 0;
+    timer->callback = _timeout_cb;
+    timer->arg = NULL;
+    xtimer_set(timer, TIMEOUT);
+}
+
+static void *_sleeper(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        counter++;
+        thread_sleep();
+    }
+
+    return NULL;
+}
+
+static void *_replier(void *arg)
+{
+    (void)arg;
+    msg_t m;
+
+    while (1) {
+        msg_receive(&m);
+        msg_reply(&m, &m);
+    }
+
+    return NULL;
+}
+
+static void bench_switches(void)
+{
+    xtimer_t timer = { 0 };
+    kernel_pid_t pid = thread_create(sleeper_stack, sizeof(sleeper_stack),
+                                     THREAD_PRIORITY_MAIN - 1,
+                                     CREATE_STACKTEST, _sleeper, NULL, "sleeper");
+
+    /* the sleeper ran once on creation */
+    _start_timeout(&timer);
+    while (!done) {
+        /* each wakeup switches to the sleeper and back */
+        thread_wakeup(pid);
+    }
+
+    printf("+ context switches: %lu per second\n", (2 * counter) / TIMEOUT_S);
+}
+
+static void bench_msg_roundtrip(void)
+{
+    xtimer_t timer = { 0 };
+    msg_t m;
+    unsigned long count = 0;
+    kernel_pid_t pid = thread_create(replier_stack, sizeof(replier_stack),
+                                     THREAD_PRIORITY_MAIN - 1,
+                                     CREATE_STACKTEST, _replier, NULL, "replier");
+
+    _start_timeout(&timer);
+    while (!done) {
+        msg_send_receive(&m, &m, pid);
+        count++;
+    }
+
+    printf("+ msg round trips: %lu per second (%lu ns each)\n",
+           count / TIMEOUT_S, (TIMEOUT * 1000ul) / (count ? count : 1));
+}
+
+int main(void)
+{
+    puts("Start.");
+
+    bench_switches();
+    bench_msg_roundtrip();
+
+    puts("Done.");
+    return 0;
+}
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+# Copyright (C) 2016 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+"""Measures how long RPL takes until all nodes of a grid joined the DODAG.
+
+Creates a medium, starts one native instance per node with node 0 as the root
+and prints when the last node got a parent, both in wall-clock time and in the
+time of the nodes. The latter is the simulated time if the application was
+built with VTIME=1.
+"""
+
+import argparse
+import os
+import pty
+import resource
+import selectors
+import subprocess
+import sys
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+TOOL = os.path.join(HERE, "..", "..", "dist", "tools", "shm_radio", "shm_radio.py")
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__)
+    p.add_argument("--nodes", type=int, default=100)
+    p.add_argument("--topology", default="grid", choices=("full", "line", "grid"))
+    p.add_argument("--prr", default="230", help="PRR of the links, in 1/255")
+    p.add_argument("--medium", default="/dev/shm/riot_shm_radio_rpl")
+    p.add_argument("--timeout", type=float, default=300)
+    p.add_argument("--elf", default=os.path.join(HERE, "bin", "native",
+                                                 "shm_radio_rpl.elf"))
+    args = p.parse_args()
+
+    subprocess.check_call([sys.executable, TOOL, "create", args.medium,
+                           str(args.nodes), args.topology, "--prr", args.prr,
+                           "--vtime"])
+    sel = selectors.DefaultSelector()
+    nodes = []
+    start = time.time()
+    for node in range(args.nodes):
+        # on a terminal, the nodes flush every line
+        master, slave = pty.openpty()
+        proc = subprocess.Popen([args.elf, "-i", str(node), "-r", args.medium],
+                                stdin=subprocess.DEVNULL, stdout=slave)
+        os.close(slave)
+        sel.register(master, selectors.EVENT_READ, [node, b""])
+        nodes.append(proc)
+    print("started %u nodes in %.2f s" % (args.nodes, time.time() - start))
+
+    joined = {}
+    joined_ms = {}
+    root = None
+    root_ms = 0
+    try:
+        while len(joined) < args.nodes - 1 and time.time() - start < args.timeout:
+            for key, _ in sel.select(timeout=1):
+                try:
+                    data = os.read(key.fd, 4096)
+                except OSError:
+                    data = b""
+                if not data:
+                    sel.unregister(key.fd)
+                    continue
+                node, rest = key.data
+                lines = (rest + data).split(b"\n")
+                key.data[1] = lines.pop()
+                for line in lines:
+                    if line.startswith(b"root"):
+                        root = time.time()
+                        root_ms = int(line.split()[-2])
+                    elif line.startswith(b"joined"):
+                        joined[node] = time.time()
+                        joined_ms[node] = int(line.split()[-2])
+                    elif line.startswith(b"error"):
+                        print("node %u: %s" % (node, line.decode(errors="replace").strip()))
+    finally:
+        for proc in nodes:
+            proc.kill()
+        for proc in nodes:
+            proc.wait()
+
+    if root is None:
+        sys.exit("the root did not come up")
+    times = sorted(t - root for t in joined.values())
+    node_times = sorted((t - root_ms) / 1000 for t in joined_ms.values())
+    usage = resource.getrusage(resource.RUSAGE_CHILDREN)
+    print("%u of %u nodes joined" % (len(times), args.nodes - 1))
+    if times:
+        print("median %.2f s, last %.2f s after the root came up"
+              % (times[len(times) // 2], times[-1]))
+        print("in the time of the nodes: median %.2f s, last %.2f s"
+              % (node_times[len(node_times) // 2], node_times[-1]))
+    print("host CPU time of all nodes: %.2f s user, %.2f s system"
+          % (usage.ru_utime, usage.ru_stime))
+    os.unlink(args.medium)
+    sys.exit(0 if len(times) == args.nodes - 1 else 1)
+
+
+if __name__ == "__main__":
+    main()
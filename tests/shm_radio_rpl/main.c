@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       A node of the RPL convergence benchmark on the shared memory
+ *              radio
+ *
+ * Node 0 becomes the root of a DODAG, all other nodes run RPL and print once
+ * they have a parent in it. bench.py starts the nodes and takes the time.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "shm_radio.h"
+#include "xtimer.h"
+#include "net/eui64.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6/netif.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/dodag.h"
+
+#define INSTANCE_ID     (1U)
+#define POLL_INTERVAL   (100U * MS_IN_USEC)
+
+static int _root(kernel_pid_t iface)
+{
+    ipv6_addr_t addr = {{ 0x20, 0x01, 0x0d, 0xb8 }};
+    eui64_t iid;
+
+    if (gnrc_netapi_get(iface, NETOPT_IPV6_IID, 0, &iid, sizeof(iid)) < 0) {
+        return -1;
+    }
+    ipv6_addr_set_aiid(&addr, iid.uint8);
+    if ((gnrc_ipv6_netif_add_addr(iface, &addr, 64, GNRC_IPV6_NETIF_ADDR_FLAGS_UNICAST) == NULL) ||
+        (gnrc_rpl_root_init(INSTANCE_ID, &addr, false, false) == NULL)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int main(void)
+{
+    kernel_pid_t ifs[GNRC_NETIF_NUMOF];
+    gnrc_rpl_instance_t *inst;
+
+    if (gnrc_netif_get(ifs) == 0) {
+        puts("error: no interface, start with -i <node> -r <medium>");
+        return 1;
+    }
+    gnrc_rpl_init(ifs[0]);
+    if (shm_radio.node == 0) {
+        if (_root(ifs[0]) < 0) {
+            puts("error: unable to become root");
+            return 1;
+        }
+        printf("root after %lu ms\n", (unsigned long)(xtimer_now() / MS_IN_USEC));
+        return 0;
+    }
+
+    while (((inst = gnrc_rpl_instance_get(INSTANCE_ID)) == NULL) ||
+           (inst->dodag.parents == NULL)) {
+        xtimer_usleep(POLL_INTERVAL);
+    }
+    printf("joined rank %u after %lu ms\n", (unsigned)inst->dodag.my_rank,
+           (unsigned long)(xtimer_now() / MS_IN_USEC));
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measures the throughput of ringbuffer and tsrb for different
+ *              chunk sizes
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "ringbuffer.h"
+#include "tsrb.h"
+#include "xtimer.h"
+
+#define TIMEOUT_S   (1ul)
+#define TIMEOUT     (TIMEOUT_S * SEC_IN_USEC)
+#define BUF_SIZE    (256U)
+
+static char rb_mem[BUF_SIZE];
+static char tsrb_mem[BUF_SIZE];
+static char chunk[BUF_SIZE / 2];
+static char out[BUF_SIZE / 2];
+
+static ringbuffer_t rb;
+static tsrb_t tsrb;
+
+static volatile int done;
+
+static void _timeout_cb(void *arg)
+{
+    (void)arg;
+    done = 1;
+}
+
+static unsigned _rb_xfer(size_t n)
+{
+    ringbuffer_add(&rb, chunk, n);
+    return ringbuffer_get(&rb, out, n);
+}
+
+static unsigned _tsrb_xfer(size_t n)
+{
+    tsrb_add(&tsrb, chunk, n);
+    return tsrb_get(&tsrb, out, n);
+}
+
+static void run_test(const char *name, unsigned (*xfer)(size_t), size_t n)
+{
+    xtimer_t timer = { 0 };
+    unsigned long bytes = 0;
+
+    ringbuffer_init(&rb, rb_mem, sizeof(rb_mem));
+    tsrb_init(&tsrb, tsrb_mem, sizeof(tsrb_mem));
+    /* keep some data in the buffers so transfers wrap around */
+    ringbuffer_add(&rb, chunk, 3);
+    tsrb_add(&tsrb, chunk, 3);
+
+    done = 0;
+    timer.callback = _timeout_cb;
+    timer.arg = NULL;
+    xtimer_set(&timer, TIMEOUT);
+
+    while (!done) {
+        bytes += xfer(n);
+    }
+
+    printf("+ %-10s chunk %3u: %lu bytes per second\n", name, (unsigned)n,
+           bytes / TIMEOUT_S);
+}
+
+int main(void)
+{
+    static const size_t sizes[] = { 1, 16, sizeof(chunk) };
+
+    puts("Start.");
+
+    for (unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        run_test("ringbuffer", _rb_xfer, sizes[i]);
+        run_test("tsrb", _tsrb_xfer, sizes[i]);
+    }
+
+    puts("Done.");
+    return 0;
+}
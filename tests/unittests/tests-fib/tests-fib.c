@@ -27,6 +27,18 @@ static fib_table_t test_fib_table = { .data.entries = _entries,
                                       .mtx_access = MUTEX_INIT,
                                       .notify_rp_pos = 0 };
 
+/* the routes share a few next hops, the use count of an address is 8 bit */
+#define TEST_FIB_BENCH_NEXT_HOPS (16U)
+/* one universal address per route plus the next hops */
+#define TEST_FIB_BENCH_SIZE (UNIVERSAL_ADDRESS_MAX_ENTRIES - TEST_FIB_BENCH_NEXT_HOPS)
+#define TEST_FIB_BENCH_LOOKUPS (10000U)
+static fib_entry_t _bench_entries[TEST_FIB_BENCH_SIZE];
+static fib_table_t test_fib_bench_table = { .data.entries = _bench_entries,
+                                            .table_type = FIB_TABLE_TYPE_SH,
+                                            .size = TEST_FIB_BENCH_SIZE,
+                                            .mtx_access = MUTEX_INIT,
+                                            .notify_rp_pos = 0 };
+
 /*
 * @brief helper to fill FIB with unique entries
 */
@@ -941,6 +953,129 @@ static void test_fib_20_replace_prefix(void)
     fib_deinit(&test_fib_table);
 }
 
+/*
+* @brief testing longest prefix match over nested prefixes
+* It is expected to always receive the next-hop of the longest prefix still
+* present, and the exact match before any prefix
+*/
+static void test_fib_21_longest_prefix_match(void)
+{
+    size_t add_buf_size = 16;
+    uint8_t addr_dst[16] = { 0x20, 0x01, 0x0d, 0xb8 };
+    uint8_t addr_nxt[16] = { 0xfe, 0x80 };
+    uint8_t addr_lookup[16] = { 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x01, 0x00, 0x02,
+                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03 };
+    uint8_t addr_nxt_hop[16];
+    /* prefix lengths in bytes, the last one is the lookup address itself */
+    static const size_t lens[] = { 4, 6, 8, 16 };
+    kernel_pid_t iface_id = KERNEL_PID_UNDEF;
+    uint32_t next_hop_flags = 0;
+
+    /* add them out of order to exercise splitting the trie */
+    for (size_t n = 0; n < 4; ++n) {
+        size_t i = (n * 3) % 4;
+
+        memset(addr_dst, 0, add_buf_size);
+        memcpy(addr_dst, addr_lookup, lens[i]);
+        addr_nxt[15] = i;
+        TEST_ASSERT_EQUAL_INT(0, fib_add_entry(&test_fib_table, 42, addr_dst,
+                                               add_buf_size,
+                                               (FIB_FLAG_NET_PREFIX | i),
+                                               addr_nxt, add_buf_size, i,
+                                               100000));
+    }
+    /* a sibling of the /64 that must never match */
+    addr_dst[7] = 0x04;
+    addr_dst[15] = 0;
+    TEST_ASSERT_EQUAL_INT(0, fib_add_entry(&test_fib_table, 42, addr_dst,
+                                           add_buf_size, FIB_FLAG_NET_PREFIX,
+                                           addr_nxt, add_buf_size, 0x99,
+                                           100000));
+
+    for (size_t i = 4; i > 0; --i) {
+        add_buf_size = 16;
+        TEST_ASSERT_EQUAL_INT(0, fib_get_next_hop(&test_fib_table, &iface_id,
+                                                  addr_nxt_hop, &add_buf_size,
+                                                  &next_hop_flags, addr_lookup,
+                                                  add_buf_size, 0x0));
+        TEST_ASSERT_EQUAL_INT(i - 1, next_hop_flags);
+
+        /* remove the current best match, the next shorter one takes over */
+        memset(addr_dst, 0, add_buf_size);
+        memcpy(addr_dst, addr_lookup, lens[i - 1]);
+        fib_remove_entry(&test_fib_table, addr_dst, add_buf_size);
+    }
+
+    add_buf_size = 16;
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH,
+                          fib_get_next_hop(&test_fib_table, &iface_id,
+                                           addr_nxt_hop, &add_buf_size,
+                                           &next_hop_flags, addr_lookup,
+                                           add_buf_size, 0x0));
+    TEST_ASSERT_EQUAL_INT(1, fib_get_num_used_entries(&test_fib_table));
+
+    fib_deinit(&test_fib_table);
+}
+
+static void _bench_lookup(size_t routes)
+{
+    size_t add_buf_size = 16;
+    /* host routes below one prefix, as on a RPL storing mode root */
+    uint8_t addr_dst[16] = { 0x20, 0x01, 0x0d, 0xb8, [13] = 0x01 };
+    uint8_t addr_nxt[16] = { 0xfe, 0x80 };
+    uint8_t addr_nxt_hop[16];
+    kernel_pid_t iface_id = KERNEL_PID_UNDEF;
+    uint32_t next_hop_flags = 0;
+    uint32_t start, duration;
+
+    for (size_t i = 0; i < routes; ++i) {
+        addr_dst[14] = (uint8_t)(i >> 8);
+        addr_dst[15] = (uint8_t)i;
+        addr_nxt[15] = (uint8_t)(i % TEST_FIB_BENCH_NEXT_HOPS);
+        TEST_ASSERT_EQUAL_INT(0, fib_add_entry(&test_fib_bench_table, 42,
+                                               addr_dst, add_buf_size, 0x0,
+                                               addr_nxt, add_buf_size, 0x0,
+                                               100000));
+    }
+
+    start = xtimer_now();
+    for (size_t n = 0; n < TEST_FIB_BENCH_LOOKUPS; ++n) {
+        size_t i = (n * 7919) % routes;
+
+        addr_nxt[15] = (uint8_t)(i % TEST_FIB_BENCH_NEXT_HOPS);
+        addr_dst[14] = (uint8_t)(i >> 8);
+        addr_dst[15] = (uint8_t)i;
+        add_buf_size = 16;
+        fib_get_next_hop(&test_fib_bench_table, &iface_id,
+                         addr_nxt_hop, &add_buf_size, &next_hop_flags,
+                         addr_dst, add_buf_size, 0x0);
+    }
+    duration = xtimer_now() - start;
+
+    printf("\nfib: %4u routes, %5lu ns/lookup", (unsigned)routes,
+           (unsigned long)(((uint64_t)duration * 1000) / TEST_FIB_BENCH_LOOKUPS));
+
+    TEST_ASSERT_EQUAL_INT(0, memcmp(addr_nxt, addr_nxt_hop, sizeof(addr_nxt)));
+    fib_deinit(&test_fib_bench_table);
+}
+
+/*
+* @brief measuring the lookup throughput for growing tables
+* The largest table only fits into the RAM of native
+*/
+static void test_fib_22_lookup_throughput(void)
+{
+    static const size_t routes[] = { 16, 128, 1024 };
+
+    fib_init(&test_fib_bench_table);
+    for (size_t i = 0; i < sizeof(routes) / sizeof(routes[0]); ++i) {
+        if (routes[i] <= TEST_FIB_BENCH_SIZE) {
+            _bench_lookup(routes[i]);
+        }
+    }
+    puts("");
+}
+
 Test *tests_fib_tests(void)
 {
     fib_init(&test_fib_table);
@@ -965,6 +1100,8 @@ Test *tests_fib_tests(void)
                         new_TestFixture(test_fib_18_get_next_hop_invalid_parameters),
                         new_TestFixture(test_fib_19_default_gateway),
                         new_TestFixture(test_fib_20_replace_prefix),
+                        new_TestFixture(test_fib_21_longest_prefix_match),
+                        new_TestFixture(test_fib_22_lookup_throughput),
     };
 
     EMB_UNIT_TESTCALLER(fib_tests, NULL, NULL, fixtures);
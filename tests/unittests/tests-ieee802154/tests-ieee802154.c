@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/ieee802154.h"
+
+#include "unittests-constants.h"
+#include "tests-ieee802154.h"
+
+#define TEST_SEQ    (0x42)
+
+static const uint8_t _short_src[] = { 0xab, 0xcd };
+static const uint8_t _long_dst[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
+static const le_uint16_t _pan = { .u8 = { 0x23, 0x00 } };
+
+static void test_ieee802154_set_frame_hdr__pan_comp(void)
+{
+    const uint8_t exp[] = { IEEE802154_FCF_TYPE_DATA | IEEE802154_FCF_PAN_COMP,
+                            IEEE802154_FCF_DST_ADDR_LONG | IEEE802154_FCF_SRC_ADDR_SHORT,
+                            TEST_SEQ, 0x23, 0x00,
+                            0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01,
+                            0xcd, 0xab };
+    uint8_t buf[IEEE802154_MAX_HDR_LEN];
+
+    TEST_ASSERT_EQUAL_INT(sizeof(exp),
+                          ieee802154_set_frame_hdr(buf, _short_src, sizeof(_short_src),
+                                                   _long_dst, sizeof(_long_dst), _pan,
+                                                   IEEE802154_FCF_TYPE_DATA |
+                                                   IEEE802154_FCF_PAN_COMP,
+                                                   TEST_SEQ));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(exp, buf, sizeof(exp)));
+    TEST_ASSERT_EQUAL_INT(sizeof(exp), ieee802154_get_frame_hdr_len(buf));
+}
+
+static void test_ieee802154_set_frame_hdr__src_pan(void)
+{
+    const uint8_t exp[] = { IEEE802154_FCF_TYPE_DATA | IEEE802154_FCF_ACK_REQ,
+                            IEEE802154_FCF_DST_ADDR_SHORT | IEEE802154_FCF_SRC_ADDR_SHORT,
+                            TEST_SEQ, 0x23, 0x00, 0xcd, 0xab, 0x23, 0x00, 0xcd, 0xab };
+    uint8_t buf[IEEE802154_MAX_HDR_LEN];
+
+    TEST_ASSERT_EQUAL_INT(sizeof(exp),
+                          ieee802154_set_frame_hdr(buf, _short_src, sizeof(_short_src),
+                                                   _short_src, sizeof(_short_src), _pan,
+                                                   IEEE802154_FCF_TYPE_DATA |
+                                                   IEEE802154_FCF_ACK_REQ,
+                                                   TEST_SEQ));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(exp, buf, sizeof(exp)));
+    TEST_ASSERT_EQUAL_INT(sizeof(exp), ieee802154_get_frame_hdr_len(buf));
+}
+
+static void test_ieee802154_set_frame_hdr__illegal_len(void)
+{
+    uint8_t buf[IEEE802154_MAX_HDR_LEN];
+
+    TEST_ASSERT_EQUAL_INT(0, ieee802154_set_frame_hdr(buf, _short_src, 1, _long_dst,
+                                                      sizeof(_long_dst), _pan,
+                                                      IEEE802154_FCF_TYPE_DATA,
+                                                      TEST_SEQ));
+    TEST_ASSERT_EQUAL_INT(0, ieee802154_set_frame_hdr(buf, _short_src,
+                                                      sizeof(_short_src), _long_dst,
+                                                      4, _pan,
+                                                      IEEE802154_FCF_TYPE_DATA,
+                                                      TEST_SEQ));
+}
+
+static void test_ieee802154_get_frame_hdr_len__illegal_mode(void)
+{
+    /* addressing mode 1 is reserved */
+    const uint8_t mhr[] = { IEEE802154_FCF_TYPE_DATA, 0x04, TEST_SEQ };
+
+    TEST_ASSERT_EQUAL_INT(0, ieee802154_get_frame_hdr_len(mhr));
+}
+
+static void test_ieee802154_get_src_dst(void)
+{
+    uint8_t buf[IEEE802154_MAX_HDR_LEN], addr[8];
+
+    for (int comp = 0; comp < 2; comp++) {
+        ieee802154_set_frame_hdr(buf, _short_src, sizeof(_short_src), _long_dst,
+                                 sizeof(_long_dst), _pan,
+                                 IEEE802154_FCF_TYPE_DATA |
+                                 (comp ? IEEE802154_FCF_PAN_COMP : 0), TEST_SEQ);
+        TEST_ASSERT_EQUAL_INT(sizeof(_short_src), ieee802154_get_src(buf, addr));
+        TEST_ASSERT_EQUAL_INT(0, memcmp(_short_src, addr, sizeof(_short_src)));
+        TEST_ASSERT_EQUAL_INT(sizeof(_long_dst), ieee802154_get_dst(buf, addr));
+        TEST_ASSERT_EQUAL_INT(0, memcmp(_long_dst, addr, sizeof(_long_dst)));
+    }
+}
+
+static void test_ieee802154_get_src_dst__void(void)
+{
+    uint8_t buf[IEEE802154_MAX_HDR_LEN], addr[8];
+
+    /* no destination PAN ID, so the source PAN ID is in the header */
+    TEST_ASSERT_EQUAL_INT(7, ieee802154_set_frame_hdr(buf, _short_src,
+                                                      sizeof(_short_src), NULL, 0,
+                                                      _pan, IEEE802154_FCF_TYPE_DATA |
+                                                      IEEE802154_FCF_PAN_COMP,
+                                                      TEST_SEQ));
+    TEST_ASSERT_EQUAL_INT(0, ieee802154_get_dst(buf, addr));
+    TEST_ASSERT_EQUAL_INT(sizeof(_short_src), ieee802154_get_src(buf, addr));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_short_src, addr, sizeof(_short_src)));
+    TEST_ASSERT_EQUAL_INT(7, ieee802154_get_frame_hdr_len(buf));
+}
+
+Test *tests_ieee802154_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_ieee802154_set_frame_hdr__pan_comp),
+        new_TestFixture(test_ieee802154_set_frame_hdr__src_pan),
+        new_TestFixture(test_ieee802154_set_frame_hdr__illegal_len),
+        new_TestFixture(test_ieee802154_get_frame_hdr_len__illegal_mode),
+        new_TestFixture(test_ieee802154_get_src_dst),
+        new_TestFixture(test_ieee802154_get_src_dst__void),
+    };
+
+    EMB_UNIT_TESTCALLER(ieee802154_tests, NULL, NULL, fixtures);
+
+    return (Test *)&ieee802154_tests;
+}
+
+void tests_ieee802154(void)
+{
+    TESTS_RUN(tests_ieee802154_tests());
+}
+/** @} */
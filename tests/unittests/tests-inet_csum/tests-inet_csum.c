@@ -12,15 +12,47 @@
  * @file
  */
 #include <errno.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "embUnit.h"
+#include "xtimer.h"
 
 #include "net/inet_csum.h"
 
 #include "unittests-constants.h"
 #include "tests-inet_csum.h"
 
+#define TEST_BUF_SIZE       (1280U)
+#define TEST_BENCH_ROUNDS   (200U)
+
+/* the 16-bit-at-a-time implementation the optimized one is checked against */
+static uint16_t _csum_ref(uint16_t sum, const uint8_t *buf, uint16_t len)
+{
+    uint32_t csum = sum;
+
+    for (int i = 0; i < (len >> 1); buf += 2, i++) {
+        csum += (*buf << 8) + *(buf + 1);
+    }
+    if (len & 1) {
+        csum += (*buf << 8);
+    }
+    while (csum >> 16) {
+        csum = (csum & 0xffff) + (csum >> 16);
+    }
+
+    return csum;
+}
+
+static void _fill(uint8_t *buf, size_t len, uint32_t seed)
+{
+    for (size_t i = 0; i < len; i++) {
+        seed = (seed * 1103515245) + 12345;
+        buf[i] = seed >> 16;
+    }
+}
+
 static void test_inet_csum__rfc_example(void)
 {
     /* source: https://tools.ietf.org/html/rfc1071#section-3 */
@@ -121,6 +153,138 @@ static void test_inet_csum__odd_len(void)
     TEST_ASSERT_EQUAL_INT(0xffff, inet_csum(17 + 39, data, sizeof(data)));
 }
 
+static void test_inet_csum__slices(void)
+{
+    /* same data as in test_inet_csum__odd_len, but split at odd offsets */
+    uint8_t data[] = {
+        0xc0, 0xa8, 0x01, 0x91, 0x4b, 0x4b, 0x4b, 0x4b, /* IPv4 source + dest*/
+        0xf6, 0xfb, 0x00, 0x35, 0x00, 0x27, 0xd1, 0xa2, /* UDP header */
+        0xa5, 0x6f, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, /* DNS payload */
+        0x00, 0x00, 0x00, 0x00, 0x09, 0x74, 0x65, 0x73,
+        0x74, 0x2d, 0x69, 0x70, 0x76, 0x36, 0x03, 0x63,
+        0x6f, 0x6d, 0x00, 0x00, 0x01, 0x00, 0x01,
+    };
+    uint16_t csum = 17 + 39;
+
+    csum = inet_csum_slice(csum, data, 5, 0);
+    csum = inet_csum_slice(csum, data + 5, 1, 5);
+    csum = inet_csum_slice(csum, data + 6, 19, 6);
+    csum = inet_csum_slice(csum, data + 25, sizeof(data) - 25, 25);
+    TEST_ASSERT_EQUAL_INT(0xffff, csum);
+}
+
+static void test_inet_csum__alignments(void)
+{
+    /* extra room to start at every offset of a 16-byte block */
+    static uint8_t data[TEST_BUF_SIZE + 16];
+
+    _fill(data, sizeof(data), TEST_UINT32);
+    for (unsigned offset = 0; offset < 16; offset++) {
+        for (uint16_t len = 0; len < 80; len++) {
+            TEST_ASSERT_EQUAL_INT(_csum_ref(TEST_UINT16, data + offset, len),
+                                  inet_csum(TEST_UINT16, data + offset, len));
+        }
+        TEST_ASSERT_EQUAL_INT(_csum_ref(0, data + offset, TEST_BUF_SIZE),
+                              inet_csum(0, data + offset, TEST_BUF_SIZE));
+        /* the same, split at an odd and at an even position */
+        uint16_t csum = inet_csum_slice(0, data + offset, 37, 0);
+        csum = inet_csum_slice(csum, data + offset + 37, 600, 37);
+        csum = inet_csum_slice(csum, data + offset + 637, TEST_BUF_SIZE - 637, 637);
+        TEST_ASSERT_EQUAL_INT(_csum_ref(0, data + offset, TEST_BUF_SIZE), csum);
+    }
+}
+
+static void test_inet_csum__all_ones(void)
+{
+    /* sums that wrap in every word, exercises carry propagation */
+    static uint8_t data[TEST_BUF_SIZE];
+
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        data[i] = 0xff;
+    }
+    TEST_ASSERT_EQUAL_INT(_csum_ref(0xffff, data, sizeof(data)),
+                          inet_csum(0xffff, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_INT(_csum_ref(0xffff, data + 1, sizeof(data) - 1),
+                          inet_csum(0xffff, data + 1, sizeof(data) - 1));
+}
+
+static void test_inet_csum__update(void)
+{
+    /* pseudo header and payload of test_inet_csum__ipv6_pseudo_hdr */
+    uint8_t data[] = {
+        0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* IPv6 source */
+        0x5a, 0x6d, 0x8f, 0xff, 0xfe, 0x56, 0x30, 0x09,
+        0xff, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* IPv6 destination */
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+        0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00, 0x3a, /* payload length + next header */
+        0x86, 0x00, 0xab, 0x32, 0x40, 0x58, 0x07, 0x08, /* ICMPv6 payload */
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x03, 0x04, 0x40, 0xc0, 0x00, 0x00, 0x00, 0x1e,
+        0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00,
+        0x20, 0x02, 0x18, 0x3d, 0xdb, 0xa4, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x01, 0x01, 0x58, 0x6d, 0x8f, 0x56, 0x30, 0x09
+    };
+    uint8_t new_src[] = {
+        0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00,
+        0x5a, 0x6d, 0x8f, 0xff, 0xfe, 0x56, 0x30, 0x09,
+    };
+    /* checksum field of the ICMPv6 header */
+    uint16_t csum = 0xab32;
+
+    /* replace the source address */
+    csum = inet_csum_update(csum, data, new_src, sizeof(new_src));
+    memcpy(data, new_src, sizeof(new_src));
+    data[42] = 0;
+    data[43] = 0;
+    TEST_ASSERT_EQUAL_INT((uint16_t)~inet_csum(0, data, sizeof(data)), csum);
+
+    /* change the low word of the retransmission timer of the router
+     * advertisement */
+    csum = inet_csum_update16(csum, 0x0000, 0x1234);
+    data[54] = 0x12;
+    data[55] = 0x34;
+    TEST_ASSERT_EQUAL_INT((uint16_t)~inet_csum(0, data, sizeof(data)), csum);
+}
+
+static void test_inet_csum__throughput(void)
+{
+    static uint8_t data[TEST_BUF_SIZE + 1];
+    uint32_t start, ref_time, time;
+    uint16_t ref_sum = 0, sum = 0;
+
+    _fill(data, sizeof(data), TEST_UINT32);
+
+    start = xtimer_now();
+    for (unsigned i = 0; i < TEST_BENCH_ROUNDS; i++) {
+        ref_sum = _csum_ref(ref_sum, data + (i & 1), TEST_BUF_SIZE);
+    }
+    ref_time = xtimer_now() - start;
+
+    start = xtimer_now();
+    for (unsigned i = 0; i < TEST_BENCH_ROUNDS; i++) {
+        sum = inet_csum(sum, data + (i & 1), TEST_BUF_SIZE);
+    }
+    time = xtimer_now() - start;
+
+    TEST_ASSERT_EQUAL_INT(ref_sum, sum);
+
+    ref_time = (ref_time) ? ref_time : 1;
+    time = (time) ? time : 1;
+    printf("\ninet_csum: %u byte, 16-bit loop %lu byte/ms, inet_csum %lu byte/ms",
+           TEST_BUF_SIZE,
+           (unsigned long)((TEST_BUF_SIZE * TEST_BENCH_ROUNDS * 1000ULL) / ref_time),
+           (unsigned long)((TEST_BUF_SIZE * TEST_BENCH_ROUNDS * 1000ULL) / time));
+#ifdef CLOCK_CORECLOCK
+    printf(" (%lu vs %lu byte/100 cycles)",
+           (unsigned long)((TEST_BUF_SIZE * TEST_BENCH_ROUNDS * 100ULL) /
+                           (((uint64_t)ref_time * CLOCK_CORECLOCK) / SEC_IN_USEC)),
+           (unsigned long)((TEST_BUF_SIZE * TEST_BENCH_ROUNDS * 100ULL) /
+                           (((uint64_t)time * CLOCK_CORECLOCK) / SEC_IN_USEC)));
+#endif
+    puts("");
+}
+
 Test *tests_inet_csum_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -130,6 +294,11 @@ Test *tests_inet_csum_tests(void)
         new_TestFixture(test_inet_csum__wraps_more_than_once),
         new_TestFixture(test_inet_csum__calculate_csum),
         new_TestFixture(test_inet_csum__odd_len),
+        new_TestFixture(test_inet_csum__slices),
+        new_TestFixture(test_inet_csum__alignments),
+        new_TestFixture(test_inet_csum__all_ones),
+        new_TestFixture(test_inet_csum__update),
+        new_TestFixture(test_inet_csum__throughput),
     };
 
     EMB_UNIT_TESTCALLER(inet_csum_tests, NULL, NULL, fixtures);
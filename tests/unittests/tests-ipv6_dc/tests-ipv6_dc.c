@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/ipv6/addr.h"
+#include "net/gnrc/ipv6/dc.h"
+#include "xtimer.h"
+
+#include "unittests-constants.h"
+#include "tests-ipv6_dc.h"
+
+/* default interface for testing */
+#define DEFAULT_TEST_NETIF      (TEST_UINT16)
+/* another interface for testing */
+#define OTHER_TEST_NETIF        (TEST_UINT16 + TEST_UINT8)
+/* default IPv6 addr for testing */
+#define DEFAULT_TEST_IPV6_ADDR  { { \
+            0x20, 0x01, 0x0d, 0xb8, 0x04, 0x05, 0x06, 0x07, \
+            0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f \
+        } \
+    }
+/* a source address for testing */
+#define SRC_TEST_IPV6_ADDR      { { \
+            0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, \
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 \
+        } \
+    }
+
+static void set_up(void)
+{
+    gnrc_ipv6_dc_init();
+}
+
+static void test_ipv6_dc_get__empty(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
+
+    TEST_ASSERT_NULL(gnrc_ipv6_dc_get(KERNEL_PID_UNDEF, &addr));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_dc_stats()->hits);
+    TEST_ASSERT_EQUAL_INT(1, gnrc_ipv6_dc_stats()->misses);
+}
+
+static void test_ipv6_dc_add__l2addr_too_long(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
+
+    TEST_ASSERT_NULL(gnrc_ipv6_dc_add(KERNEL_PID_UNDEF, &addr, DEFAULT_TEST_NETIF,
+                                      (uint8_t *)TEST_STRING8,
+                                      GNRC_IPV6_NC_L2_ADDR_MAX + 1));
+}
+
+static void test_ipv6_dc_add__success(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
+    gnrc_ipv6_dc_t *entry;
+
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_dc_add(KERNEL_PID_UNDEF, &addr, DEFAULT_TEST_NETIF,
+                                          (uint8_t *)TEST_STRING4, sizeof(TEST_STRING4)));
+    TEST_ASSERT_NOT_NULL((entry = gnrc_ipv6_dc_get(KERNEL_PID_UNDEF, &addr)));
+    TEST_ASSERT_EQUAL_INT(DEFAULT_TEST_NETIF, entry->next_hop_iface);
+    TEST_ASSERT_EQUAL_INT(sizeof(TEST_STRING4), entry->l2_addr_len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(TEST_STRING4, entry->l2_addr, sizeof(TEST_STRING4)));
+    TEST_ASSERT(!(entry->flags & GNRC_IPV6_DC_FLAGS_SRC));
+    TEST_ASSERT_EQUAL_INT(1, gnrc_ipv6_dc_stats()->hits);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_dc_stats()->misses);
+}
+
+static void test_ipv6_dc_get__different_if(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
+
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_dc_add(DEFAULT_TEST_NETIF, &addr, DEFAULT_TEST_NETIF,
+                                          (uint8_t *)TEST_STRING4, sizeof(TEST_STRING4)));
+    /* the interface the sender asked for is part of the key */
+    TEST_ASSERT_NULL(gnrc_ipv6_dc_get(OTHER_TEST_NETIF, &addr));
+    TEST_ASSERT_NULL(gnrc_ipv6_dc_get(KERNEL_PID_UNDEF, &addr));
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_dc_get(DEFAULT_TEST_NETIF, &addr));
+}
+
+static void test_ipv6_dc_get__different_addr(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
+
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_dc_add(KERNEL_PID_UNDEF, &addr, DEFAULT_TEST_NETIF,
+                                          (uint8_t *)TEST_STRING4, sizeof(TEST_STRING4)));
+    addr.u8[15]++;
+    TEST_ASSERT_NULL(gnrc_ipv6_dc_get(KERNEL_PID_UNDEF, &addr));
+}
+
+static void test_ipv6_dc_set_src(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
+    ipv6_addr_t src = SRC_TEST_IPV6_ADDR;
+    gnrc_ipv6_dc_t *entry;
+
+    TEST_ASSERT_NOT_NULL((entry = gnrc_ipv6_dc_add(KERNEL_PID_UNDEF, &addr,
+                                                   DEFAULT_TEST_NETIF,
+                                                   (uint8_t *)TEST_STRING4,
+                                                   sizeof(TEST_STRING4))));
+    gnrc_ipv6_dc_set_src(entry, &src);
+    TEST_ASSERT_NOT_NULL((entry = gnrc_ipv6_dc_get(KERNEL_PID_UNDEF, &addr)));
+    TEST_ASSERT(entry->flags & GNRC_IPV6_DC_FLAGS_SRC);
+    TEST_ASSERT(ipv6_addr_equal(&src, &entry->src));
+}
+
+static void test_ipv6_dc_flush(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
+
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_dc_add(KERNEL_PID_UNDEF, &addr, DEFAULT_TEST_NETIF,
+                                          (uint8_t *)TEST_STRING4, sizeof(TEST_STRING4)));
+    gnrc_ipv6_dc_flush();
+    TEST_ASSERT_NULL(gnrc_ipv6_dc_get(KERNEL_PID_UNDEF, &addr));
+    TEST_ASSERT_EQUAL_INT(1, gnrc_ipv6_dc_stats()->flushes);
+}
+
+static void test_ipv6_dc_get__expired(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
+
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_dc_add(KERNEL_PID_UNDEF, &addr, DEFAULT_TEST_NETIF,
+                                          (uint8_t *)TEST_STRING4, sizeof(TEST_STRING4)));
+    xtimer_usleep(2 * GNRC_IPV6_DC_LIFETIME);
+    TEST_ASSERT_NULL(gnrc_ipv6_dc_get(KERNEL_PID_UNDEF, &addr));
+}
+
+Test *tests_ipv6_dc_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_ipv6_dc_get__empty),
+        new_TestFixture(test_ipv6_dc_add__l2addr_too_long),
+        new_TestFixture(test_ipv6_dc_add__success),
+        new_TestFixture(test_ipv6_dc_get__different_if),
+        new_TestFixture(test_ipv6_dc_get__different_addr),
+        new_TestFixture(test_ipv6_dc_set_src),
+        new_TestFixture(test_ipv6_dc_flush),
+        new_TestFixture(test_ipv6_dc_get__expired),
+    };
+
+    EMB_UNIT_TESTCALLER(ipv6_dc_tests, set_up, NULL, fixtures);
+
+    return (Test *)&ipv6_dc_tests;
+}
+
+void tests_ipv6_dc(void)
+{
+    TESTS_RUN(tests_ipv6_dc_tests());
+}
+/** @} */
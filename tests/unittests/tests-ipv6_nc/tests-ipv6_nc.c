@@ -12,6 +12,7 @@
  * @file
  */
 #include <errno.h>
+#include <stdio.h>
 #include <stdlib.h>
 
 #include "embUnit.h"
@@ -19,6 +20,7 @@
 #include "net/ipv6/addr.h"
 #include "net/gnrc/ipv6/nc.h"
 #include "net/gnrc/ipv6/netif.h"
+#include "xtimer.h"
 
 #include "unittests-constants.h"
 #include "tests-ipv6_nc.h"
@@ -48,6 +50,9 @@
         } \
     }
 
+/* number of lookups per table size in the lookup benchmark */
+#define BENCH_LOOKUPS           (10000U)
+
 static void set_up(void)
 {
     gnrc_ipv6_nc_init();
@@ -110,6 +115,118 @@ static void test_ipv6_nc_add__full(void)
                                       sizeof(TEST_STRING4), 0));
 }
 
+static void test_ipv6_nc_add__full_evict_lru(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
+    ipv6_addr_t first = DEFAULT_TEST_IPV6_ADDR, second = DEFAULT_TEST_IPV6_ADDR;
+
+    for (int i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
+        TEST_ASSERT_NOT_NULL(gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr, TEST_STRING4,
+                                              sizeof(TEST_STRING4),
+                                              GNRC_IPV6_NC_STATE_STALE <<
+                                              GNRC_IPV6_NC_STATE_POS));
+        addr.u16[7].u16++;
+    }
+    second.u16[7].u16++;
+
+    /* use the first entry, so the second one is the least recently used */
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_nc_get(DEFAULT_TEST_NETIF, &first));
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr, TEST_STRING4,
+                                          sizeof(TEST_STRING4), 0));
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_nc_get(DEFAULT_TEST_NETIF, &addr));
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_nc_get(DEFAULT_TEST_NETIF, &first));
+    TEST_ASSERT_NULL(gnrc_ipv6_nc_get(DEFAULT_TEST_NETIF, &second));
+}
+
+static void test_ipv6_nc_touch__evicted_last(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
+    ipv6_addr_t first = DEFAULT_TEST_IPV6_ADDR;
+    gnrc_ipv6_nc_t *entry = NULL;
+
+    for (int i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
+        gnrc_ipv6_nc_t *tmp;
+
+        TEST_ASSERT_NOT_NULL((tmp = gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr, TEST_STRING4,
+                                                     sizeof(TEST_STRING4),
+                                                     GNRC_IPV6_NC_STATE_STALE <<
+                                                     GNRC_IPV6_NC_STATE_POS)));
+        if (entry == NULL) {
+            entry = tmp;
+        }
+        addr.u16[7].u16++;
+    }
+
+    /* like a destination cache hit, without a lookup */
+    gnrc_ipv6_nc_touch(entry);
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr, TEST_STRING4,
+                                          sizeof(TEST_STRING4), 0));
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_nc_get(DEFAULT_TEST_NETIF, &first));
+}
+
+static void test_ipv6_nc_get_by_l2_addr__used_last(void)
+{
+    ipv6_addr_t addr1 = DEFAULT_TEST_IPV6_ADDR;
+    ipv6_addr_t addr2 = OTHER_TEST_IPV6_ADDR;
+    gnrc_ipv6_nc_t *entry1, *entry2;
+
+    TEST_ASSERT_NOT_NULL((entry1 = gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr1, TEST_STRING4,
+                                                    sizeof(TEST_STRING4), 0)));
+    TEST_ASSERT_NOT_NULL((entry2 = gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr2, TEST_STRING4,
+                                                    sizeof(TEST_STRING4), 0)));
+    TEST_ASSERT(entry2 == gnrc_ipv6_nc_get_by_l2_addr(DEFAULT_TEST_NETIF,
+                                                      (uint8_t *)TEST_STRING4,
+                                                      sizeof(TEST_STRING4)));
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_nc_get(DEFAULT_TEST_NETIF, &addr1));
+    TEST_ASSERT(entry1 == gnrc_ipv6_nc_get_by_l2_addr(DEFAULT_TEST_NETIF,
+                                                      (uint8_t *)TEST_STRING4,
+                                                      sizeof(TEST_STRING4)));
+    TEST_ASSERT_NULL(gnrc_ipv6_nc_get_by_l2_addr(OTHER_TEST_NETIF, (uint8_t *)TEST_STRING4,
+                                                 sizeof(TEST_STRING4)));
+    TEST_ASSERT_NULL(gnrc_ipv6_nc_get_by_l2_addr(DEFAULT_TEST_NETIF, (uint8_t *)TEST_STRING8,
+                                                 sizeof(TEST_STRING8)));
+}
+
+static void test_ipv6_nc_add__full_evict_stale_first(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
+    ipv6_addr_t stale;
+    gnrc_ipv6_nc_t *entry;
+
+    for (int i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
+        TEST_ASSERT_NOT_NULL((entry = gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr,
+                                                       TEST_STRING4, sizeof(TEST_STRING4),
+                                                       GNRC_IPV6_NC_STATE_REACHABLE <<
+                                                       GNRC_IPV6_NC_STATE_POS)));
+        addr.u16[7].u16++;
+    }
+    /* the most recently used entry goes stale */
+    entry->flags = (GNRC_IPV6_NC_STATE_STALE << GNRC_IPV6_NC_STATE_POS);
+    stale = entry->ipv6_addr;
+
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr, TEST_STRING4,
+                                          sizeof(TEST_STRING4), 0));
+    TEST_ASSERT_NULL(gnrc_ipv6_nc_get(DEFAULT_TEST_NETIF, &stale));
+}
+
+static void test_ipv6_nc_add__full_no_evict_router(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
+
+    for (int i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
+        uint8_t flags = (i & 1) ? GNRC_IPV6_NC_IS_ROUTER : GNRC_IPV6_NC_TYPE_REGISTERED;
+
+        TEST_ASSERT_NOT_NULL(gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr, TEST_STRING4,
+                                              sizeof(TEST_STRING4),
+                                              flags | (GNRC_IPV6_NC_STATE_STALE <<
+                                                       GNRC_IPV6_NC_STATE_POS)));
+        addr.u16[7].u16++;
+    }
+
+    TEST_ASSERT_NULL(gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr, TEST_STRING4,
+                                      sizeof(TEST_STRING4), 0));
+}
+
 static void test_ipv6_nc_add__success(void)
 {
     ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
@@ -378,6 +495,42 @@ static void test_ipv6_nc_still_reachable__success(void)
     TEST_ASSERT(gnrc_ipv6_nc_is_reachable(entry));
 }
 
+static void _bench_get(unsigned entries)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
+    uint32_t start, duration;
+
+    gnrc_ipv6_nc_init();
+    for (unsigned i = 0; i < entries; i++) {
+        addr.u16[7].u16 = (uint16_t)i;
+        TEST_ASSERT_NOT_NULL(gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr, TEST_STRING4,
+                                              sizeof(TEST_STRING4), 0));
+    }
+
+    start = xtimer_now();
+    for (unsigned n = 0; n < BENCH_LOOKUPS; n++) {
+        addr.u16[7].u16 = (uint16_t)((n * 7919) % entries);
+        TEST_ASSERT_NOT_NULL(gnrc_ipv6_nc_get(DEFAULT_TEST_NETIF, &addr));
+    }
+    duration = xtimer_now() - start;
+
+    printf("\nipv6_nc: %4u entries, %5lu ns/lookup", entries,
+           (unsigned long)(((uint64_t)duration * 1000) / BENCH_LOOKUPS));
+}
+
+/*
+ * @brief measuring the lookup cost for growing caches
+ * Set GNRC_IPV6_NC_SIZE and GNRC_IPV6_NC_BUCKETS to see it at scale
+ */
+static void test_ipv6_nc_get__throughput(void)
+{
+    for (unsigned entries = 8; entries < GNRC_IPV6_NC_SIZE; entries *= 8) {
+        _bench_get(entries);
+    }
+    _bench_get(GNRC_IPV6_NC_SIZE);
+    puts("");
+}
+
 Test *tests_ipv6_nc_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -387,6 +540,11 @@ Test *tests_ipv6_nc_tests(void)
         new_TestFixture(test_ipv6_nc_add__addr_unspecified),
         new_TestFixture(test_ipv6_nc_add__l2addr_too_long),
         new_TestFixture(test_ipv6_nc_add__full),
+        new_TestFixture(test_ipv6_nc_add__full_evict_lru),
+        new_TestFixture(test_ipv6_nc_touch__evicted_last),
+        new_TestFixture(test_ipv6_nc_get_by_l2_addr__used_last),
+        new_TestFixture(test_ipv6_nc_add__full_evict_stale_first),
+        new_TestFixture(test_ipv6_nc_add__full_no_evict_router),
         new_TestFixture(test_ipv6_nc_add__success),
         new_TestFixture(test_ipv6_nc_add__address_update_despite_free_entry),
         new_TestFixture(test_ipv6_nc_remove__no_entry_pid),
@@ -409,6 +567,7 @@ Test *tests_ipv6_nc_tests(void)
         new_TestFixture(test_ipv6_nc_is_reachable__reachable),
         new_TestFixture(test_ipv6_nc_still_reachable__incomplete),
         new_TestFixture(test_ipv6_nc_still_reachable__success),
+        new_TestFixture(test_ipv6_nc_get__throughput),
     };
 
     EMB_UNIT_TESTCALLER(ipv6_nc_tests, set_up, NULL, fixtures);
@@ -476,6 +476,83 @@ static void test_ipv6_netif_find_best_src_addr__other_subnet(void)
     TEST_ASSERT_EQUAL_INT(true, ipv6_addr_equal(out, &addr1));
 }
 
+static void test_ipv6_netif_find_best_src_addr__addr_added(void)
+{
+    ipv6_addr_t ll_addr = IPV6_ADDR_UNSPECIFIED;
+    ipv6_addr_t global_addr = DEFAULT_TEST_IPV6_ADDR;
+    ipv6_addr_t dst = DEFAULT_TEST_IPV6_PREFIX64;
+    ipv6_addr_t *out = NULL;
+
+    ll_addr.u8[15] = 1;
+    ipv6_addr_set_link_local_prefix(&ll_addr);
+
+    test_ipv6_netif_add__success(); /* adds DEFAULT_TEST_NETIF as interface */
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_netif_add_addr(DEFAULT_TEST_NETIF, &ll_addr, 64, 0));
+
+    TEST_ASSERT_NOT_NULL((out = gnrc_ipv6_netif_find_best_src_addr(DEFAULT_TEST_NETIF, &dst)));
+    TEST_ASSERT_EQUAL_INT(true, ipv6_addr_equal(out, &ll_addr));
+
+    /* ranking must not survive a change of the addresses */
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_netif_add_addr(DEFAULT_TEST_NETIF, &global_addr, 64, 0));
+    TEST_ASSERT_NOT_NULL((out = gnrc_ipv6_netif_find_best_src_addr(DEFAULT_TEST_NETIF, &dst)));
+    TEST_ASSERT_EQUAL_INT(true, ipv6_addr_equal(out, &global_addr));
+
+    gnrc_ipv6_netif_remove_addr(DEFAULT_TEST_NETIF, &global_addr);
+    TEST_ASSERT_NOT_NULL((out = gnrc_ipv6_netif_find_best_src_addr(DEFAULT_TEST_NETIF, &dst)));
+    TEST_ASSERT_EQUAL_INT(true, ipv6_addr_equal(out, &ll_addr));
+}
+
+static void test_ipv6_netif_find_best_src_addr__addr_changed(void)
+{
+    ipv6_addr_t addr1 = DEFAULT_TEST_IPV6_ADDR;
+    ipv6_addr_t addr2 = DEFAULT_TEST_IPV6_ADDR;
+    ipv6_addr_t dst = DEFAULT_TEST_IPV6_ADDR;
+    ipv6_addr_t *out = NULL;
+
+    addr1.u8[15] = 0x01;
+    addr2.u8[15] = 0x02;
+    dst.u8[15] = 0x03;  /* longer common prefix with addr2 */
+
+    test_ipv6_netif_add__success(); /* adds DEFAULT_TEST_NETIF as interface */
+    TEST_ASSERT_NOT_NULL((out = gnrc_ipv6_netif_add_addr(DEFAULT_TEST_NETIF, &addr1, 64, 0)));
+    gnrc_ipv6_netif_addr_get(out)->preferred = 0;
+    TEST_ASSERT_NOT_NULL((out = gnrc_ipv6_netif_add_addr(DEFAULT_TEST_NETIF, &addr2, 64, 0)));
+    gnrc_ipv6_netif_addr_get(out)->preferred = 0;
+
+    TEST_ASSERT_NOT_NULL((out = gnrc_ipv6_netif_find_best_src_addr(DEFAULT_TEST_NETIF, &dst)));
+    TEST_ASSERT_EQUAL_INT(true, ipv6_addr_equal(out, &addr2));
+
+    /* addr2 is deprecated now, addr1 is not (rule 3) */
+    TEST_ASSERT_NOT_NULL((out = gnrc_ipv6_netif_find_addr(DEFAULT_TEST_NETIF, &addr1)));
+    gnrc_ipv6_netif_addr_get(out)->preferred = UINT32_MAX;
+    gnrc_ipv6_netif_addr_changed(DEFAULT_TEST_NETIF);
+
+    TEST_ASSERT_NOT_NULL((out = gnrc_ipv6_netif_find_best_src_addr(DEFAULT_TEST_NETIF, &dst)));
+    TEST_ASSERT_EQUAL_INT(true, ipv6_addr_equal(out, &addr1));
+}
+
+static void test_ipv6_netif_find_best_src_addr__rule1_addr_added(void)
+{
+    ipv6_addr_t addr1 = DEFAULT_TEST_IPV6_ADDR;
+    ipv6_addr_t addr2 = DEFAULT_TEST_IPV6_ADDR;
+    ipv6_addr_t *out = NULL;
+
+    addr1.u8[15] = 0x01;
+    addr2.u8[15] = 0x02;
+
+    test_ipv6_netif_add__success(); /* adds DEFAULT_TEST_NETIF as interface */
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_netif_add_addr(DEFAULT_TEST_NETIF, &addr1, 64, 0));
+
+    /* rule 1 answers without ranking */
+    TEST_ASSERT_NOT_NULL((out = gnrc_ipv6_netif_find_best_src_addr(DEFAULT_TEST_NETIF, &addr1)));
+    TEST_ASSERT_EQUAL_INT(true, ipv6_addr_equal(out, &addr1));
+
+    /* the candidates must not survive a change of the addresses either */
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_netif_add_addr(DEFAULT_TEST_NETIF, &addr2, 64, 0));
+    TEST_ASSERT_NOT_NULL((out = gnrc_ipv6_netif_find_best_src_addr(DEFAULT_TEST_NETIF, &addr2)));
+    TEST_ASSERT_EQUAL_INT(true, ipv6_addr_equal(out, &addr2));
+}
+
 static void test_ipv6_netif_addr_is_non_unicast__unicast(void)
 {
     ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
@@ -565,6 +642,9 @@ Test *tests_ipv6_netif_tests(void)
         new_TestFixture(test_ipv6_netif_find_best_src_addr__success),
         new_TestFixture(test_ipv6_netif_find_best_src_addr__multicast_input),
         new_TestFixture(test_ipv6_netif_find_best_src_addr__other_subnet),
+        new_TestFixture(test_ipv6_netif_find_best_src_addr__addr_added),
+        new_TestFixture(test_ipv6_netif_find_best_src_addr__addr_changed),
+        new_TestFixture(test_ipv6_netif_find_best_src_addr__rule1_addr_added),
         new_TestFixture(test_ipv6_netif_addr_is_non_unicast__unicast),
         new_TestFixture(test_ipv6_netif_addr_is_non_unicast__anycast),
         new_TestFixture(test_ipv6_netif_addr_is_non_unicast__multicast1),
@@ -139,6 +139,33 @@ void test_netreg_getnext__2_entries(void)
     TEST_ASSERT_NOT_NULL(gnrc_netreg_getnext(res));
 }
 
+void test_netreg_lookup__many_ctx(void)
+{
+    gnrc_netreg_entry_t many[4 * GNRC_NETREG_BUCKETS];
+    gnrc_netreg_entry_t *res;
+
+    for (unsigned i = 0; i < (sizeof(many) / sizeof(many[0])); i++) {
+        many[i].demux_ctx = TEST_UINT16 + (i / 2);  /* two entries per context */
+        many[i].pid = TEST_UINT8;
+        TEST_ASSERT_EQUAL_INT(0, gnrc_netreg_register(GNRC_NETTYPE_TEST, &many[i]));
+    }
+    for (unsigned i = 0; i < (sizeof(many) / sizeof(many[0])); i += 2) {
+        uint32_t ctx = TEST_UINT16 + (i / 2);
+
+        TEST_ASSERT_EQUAL_INT(2, gnrc_netreg_num(GNRC_NETTYPE_TEST, ctx));
+        TEST_ASSERT_NOT_NULL((res = gnrc_netreg_lookup(GNRC_NETTYPE_TEST, ctx)));
+        TEST_ASSERT_EQUAL_INT(ctx, res->demux_ctx);
+        TEST_ASSERT_NOT_NULL((res = gnrc_netreg_getnext(res)));
+        TEST_ASSERT_EQUAL_INT(ctx, res->demux_ctx);
+        TEST_ASSERT_NULL(gnrc_netreg_getnext(res));
+    }
+    for (unsigned i = 0; i < (sizeof(many) / sizeof(many[0])); i++) {
+        gnrc_netreg_unregister(GNRC_NETTYPE_TEST, &many[i]);
+        TEST_ASSERT_EQUAL_INT(((i & 1) ? 0 : 1),
+                              gnrc_netreg_num(GNRC_NETTYPE_TEST, many[i].demux_ctx));
+    }
+}
+
 Test *tests_netreg_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -155,6 +182,7 @@ Test *tests_netreg_tests(void)
         new_TestFixture(test_netreg_num__2_entries),
         new_TestFixture(test_netreg_getnext__NULL),
         new_TestFixture(test_netreg_getnext__2_entries),
+        new_TestFixture(test_netreg_lookup__many_ctx),
     };
 
     EMB_UNIT_TESTCALLER(netreg_tests, set_up, NULL, fixtures);
@@ -176,6 +176,8 @@ static void test_pktbuf_add__memfull(void)
     TEST_ASSERT(!gnrc_pktbuf_is_empty());
 }
 
+#ifdef MODULE_GNRC_PKTBUF_STATIC
+/* relies on the first-fit layout of gnrc_pktbuf_static */
 static void test_pktbuf_add__success(void)
 {
     gnrc_pktsnip_t *pkt, *pkt_prev = NULL;
@@ -199,6 +201,7 @@ static void test_pktbuf_add__success(void)
     }
     TEST_ASSERT(gnrc_pktbuf_is_sane());
 }
+#endif
 
 static void test_pktbuf_add__packed_struct(void)
 {
@@ -219,6 +222,7 @@ static void test_pktbuf_add__packed_struct(void)
     TEST_ASSERT_EQUAL_INT(data.s64, data_cpy->s64);
 }
 
+#ifdef MODULE_GNRC_PKTBUF_STATIC
 static void test_pktbuf_add__unaligned_in_aligned_hole(void)
 {
     gnrc_pktsnip_t *pkt1 = gnrc_pktbuf_add(NULL, NULL, 8, GNRC_NETTYPE_TEST);
@@ -237,6 +241,89 @@ static void test_pktbuf_add__unaligned_in_aligned_hole(void)
     gnrc_pktbuf_release(pkt4);
     TEST_ASSERT(gnrc_pktbuf_is_empty());
 }
+#endif
+
+static char _ext_data[] = TEST_STRING8;
+static unsigned _ext_released;
+
+static void _ext_release_cb(void *arg)
+{
+    TEST_ASSERT(arg == _ext_data);
+    _ext_released++;
+}
+
+static void test_pktbuf_add_ext__data_NULL(void)
+{
+    TEST_ASSERT_NULL(gnrc_pktbuf_add_ext(NULL, NULL, sizeof(_ext_data),
+                                         GNRC_NETTYPE_TEST, NULL, NULL));
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_pktbuf_add_ext__success(void)
+{
+    gnrc_pktsnip_t *pkt;
+
+    _ext_released = 0;
+    pkt = gnrc_pktbuf_add_ext(NULL, _ext_data, sizeof(_ext_data),
+                              GNRC_NETTYPE_TEST, _ext_release_cb, _ext_data);
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_NULL(pkt->next);
+    TEST_ASSERT(pkt->data == _ext_data);     /* not copied */
+    TEST_ASSERT_EQUAL_INT(sizeof(_ext_data), pkt->size);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_TEST, pkt->type);
+    TEST_ASSERT_EQUAL_INT(1, pkt->users);
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+
+    gnrc_pktbuf_hold(pkt, 1);
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT_EQUAL_INT(0, _ext_released);
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT_EQUAL_INT(1, _ext_released);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_pktbuf_add_ext__start_write(void)
+{
+    gnrc_pktsnip_t *pkt, *copy;
+
+    _ext_released = 0;
+    pkt = gnrc_pktbuf_add_ext(NULL, _ext_data, sizeof(_ext_data),
+                              GNRC_NETTYPE_TEST, _ext_release_cb, _ext_data);
+    TEST_ASSERT_NOT_NULL(pkt);
+    gnrc_pktbuf_hold(pkt, 1);
+    copy = gnrc_pktbuf_start_write(pkt);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT(copy != pkt);
+    TEST_ASSERT(copy->data != pkt->data);
+    TEST_ASSERT_EQUAL_STRING(TEST_STRING8, copy->data);
+    gnrc_pktbuf_release(copy);
+    TEST_ASSERT_EQUAL_INT(0, _ext_released);
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT_EQUAL_INT(1, _ext_released);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_pktbuf_add_ext__cb_full(void)
+{
+    gnrc_pktsnip_t *pkt = NULL;
+
+    for (unsigned i = 0; i < GNRC_PKTBUF_EXT_NUMOF; i++) {
+        pkt = gnrc_pktbuf_add_ext(pkt, _ext_data, sizeof(_ext_data),
+                                  GNRC_NETTYPE_TEST, _ext_release_cb, _ext_data);
+        TEST_ASSERT_NOT_NULL(pkt);
+    }
+    TEST_ASSERT_NULL(gnrc_pktbuf_add_ext(pkt, _ext_data, sizeof(_ext_data),
+                                         GNRC_NETTYPE_TEST, _ext_release_cb,
+                                         _ext_data));
+    /* no callback does not need a slot */
+    pkt = gnrc_pktbuf_add_ext(pkt, _ext_data, sizeof(_ext_data),
+                              GNRC_NETTYPE_TEST, NULL, NULL);
+    TEST_ASSERT_NOT_NULL(pkt);
+    _ext_released = 0;
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT_EQUAL_INT(GNRC_PKTBUF_EXT_NUMOF, _ext_released);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
 
 static void test_pktbuf_mark__pkt_NULL__size_0(void)
 {
@@ -703,6 +790,75 @@ static void test_pktbuf_get_iovec__null(void)
     TEST_ASSERT_EQUAL_INT(0, len);
 }
 
+#define STRESS_SLOTS    (16U)
+#define STRESS_ROUNDS   (1000U)
+#define STRESS_MTU      (1280U)
+
+static void test_pktbuf_stress__fragmentation(void)
+{
+    static const size_t sizes[] = { 4, 40, 100, 256, STRESS_MTU };
+    gnrc_pktsnip_t *pkts[STRESS_SLOTS] = { NULL };
+    gnrc_pktsnip_t *mtu_pkts[STRESS_SLOTS] = { NULL };
+    uint32_t rnd = 0xdeadbeef;
+    unsigned mtu_numof = 0;
+
+    /* mixed 6LoWPAN/IPv6-like traffic: random sizes, headers split off */
+    for (unsigned i = 0; i < STRESS_ROUNDS; i++) {
+        unsigned slot;
+
+        rnd = (rnd * 1103515245) + 12345;
+        slot = (rnd >> 16) % STRESS_SLOTS;
+        if (pkts[slot] != NULL) {
+            gnrc_pktbuf_release(pkts[slot]);
+            pkts[slot] = NULL;
+        }
+        else {
+            size_t size = sizes[(rnd >> 8) % (sizeof(sizes) / sizeof(sizes[0]))];
+
+            pkts[slot] = gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_TEST);
+            if ((pkts[slot] != NULL) && (size > 8)) {
+                gnrc_pktbuf_mark(pkts[slot], 8, GNRC_NETTYPE_UNDEF);
+            }
+        }
+        TEST_ASSERT(gnrc_pktbuf_is_sane());
+    }
+    for (unsigned i = 0; i < STRESS_SLOTS; i++) {
+        gnrc_pktbuf_release(pkts[i]);
+        pkts[i] = NULL;
+    }
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+
+    /* leave small packets with holes in between behind */
+    for (unsigned i = 0; i < STRESS_SLOTS; i++) {
+        pkts[i] = gnrc_pktbuf_add(NULL, NULL, 40, GNRC_NETTYPE_TEST);
+        TEST_ASSERT_NOT_NULL(pkts[i]);
+    }
+    for (unsigned i = 0; i < STRESS_SLOTS; i += 2) {
+        gnrc_pktbuf_release(pkts[i]);
+        pkts[i] = NULL;
+    }
+    while (mtu_numof < STRESS_SLOTS) {
+        mtu_pkts[mtu_numof] = gnrc_pktbuf_add(NULL, NULL, STRESS_MTU, GNRC_NETTYPE_TEST);
+        if (mtu_pkts[mtu_numof] == NULL) {
+            break;
+        }
+        mtu_numof++;
+    }
+    TEST_ASSERT(mtu_numof > 0);
+#ifdef MODULE_GNRC_PKTBUF_SLAB
+    /* size classes do not fragment: all large chunks are still usable */
+    TEST_ASSERT_EQUAL_INT(GNRC_PKTBUF_SLAB_LARGE_NUMOF, mtu_numof);
+#endif
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+
+    for (unsigned i = 0; i < STRESS_SLOTS; i++) {
+        gnrc_pktbuf_release(pkts[i]);
+        gnrc_pktbuf_release(mtu_pkts[i]);
+    }
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
 Test *tests_pktbuf_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -715,9 +871,17 @@ Test *tests_pktbuf_tests(void)
         new_TestFixture(test_pktbuf_add__pkt_NOT_NULL__data_NULL__size_not_0),
         new_TestFixture(test_pktbuf_add__pkt_NOT_NULL__data_NOT_NULL__size_not_0),
         new_TestFixture(test_pktbuf_add__memfull),
+#ifdef MODULE_GNRC_PKTBUF_STATIC
         new_TestFixture(test_pktbuf_add__success),
+#endif
         new_TestFixture(test_pktbuf_add__packed_struct),
+#ifdef MODULE_GNRC_PKTBUF_STATIC
         new_TestFixture(test_pktbuf_add__unaligned_in_aligned_hole),
+#endif
+        new_TestFixture(test_pktbuf_add_ext__data_NULL),
+        new_TestFixture(test_pktbuf_add_ext__success),
+        new_TestFixture(test_pktbuf_add_ext__start_write),
+        new_TestFixture(test_pktbuf_add_ext__cb_full),
         new_TestFixture(test_pktbuf_mark__pkt_NULL__size_0),
         new_TestFixture(test_pktbuf_mark__pkt_NULL__size_not_0),
         new_TestFixture(test_pktbuf_mark__pkt_NOT_NULL__size_0),
@@ -745,6 +909,7 @@ Test *tests_pktbuf_tests(void)
         new_TestFixture(test_pktbuf_get_iovec__1_elem),
         new_TestFixture(test_pktbuf_get_iovec__3_elem),
         new_TestFixture(test_pktbuf_get_iovec__null),
+        new_TestFixture(test_pktbuf_stress__fragmentation),
     };
 
     EMB_UNIT_TESTCALLER(gnrc_pktbuf_tests, set_up, NULL, fixtures);
@@ -13,12 +13,14 @@
  */
 #include <inttypes.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
 
 #include "embUnit.h"
 
 #include "net/ipv6/addr.h"
 #include "net/gnrc/sixlowpan/ctx.h"
+#include "xtimer.h"
 
 #include "unittests-constants.h"
 #include "tests-sixlowpan_ctx.h"
@@ -43,6 +45,9 @@
         } \
     }
 
+/* number of lookups per table size in the matching benchmark */
+#define BENCH_LOOKUPS           (10000U)
+
 static void tear_down(void)
 {
     gnrc_sixlowpan_ctx_reset();
@@ -195,6 +200,103 @@ static void test_sixlowpan_ctx_remove(void)
     TEST_ASSERT_NULL(gnrc_sixlowpan_ctx_lookup_addr(&addr));
 }
 
+static void test_sixlowpan_ctx_lookup_addr__longest_prefix(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_PREFIX;
+    gnrc_sixlowpan_ctx_t *ctx;
+
+    /* add the shorter prefix last so it is not found by order of insertion */
+    test_sixlowpan_ctx_update__success();
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(OTHER_TEST_ID, &addr, 32,
+                                                   TEST_UINT16, true));
+    TEST_ASSERT_NOT_NULL((ctx = gnrc_sixlowpan_ctx_lookup_addr(&addr)));
+    TEST_ASSERT_EQUAL_INT(GNRC_SIXLOWPAN_CTX_FLAGS_COMP | DEFAULT_TEST_ID, ctx->flags_id);
+}
+
+static void test_sixlowpan_ctx_lookup_addr__shorter_prefix(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_PREFIX;
+    ipv6_addr_t other = WRONG_TEST_PREFIX;
+    gnrc_sixlowpan_ctx_t *ctx;
+
+    test_sixlowpan_ctx_lookup_addr__longest_prefix();
+    /* only matches the first 32 bit */
+    TEST_ASSERT_NOT_NULL((ctx = gnrc_sixlowpan_ctx_lookup_addr(&other)));
+    TEST_ASSERT_EQUAL_INT(GNRC_SIXLOWPAN_CTX_FLAGS_COMP | OTHER_TEST_ID, ctx->flags_id);
+    gnrc_sixlowpan_ctx_remove(DEFAULT_TEST_ID);
+    TEST_ASSERT_NOT_NULL((ctx = gnrc_sixlowpan_ctx_lookup_addr(&addr)));
+    TEST_ASSERT_EQUAL_INT(GNRC_SIXLOWPAN_CTX_FLAGS_COMP | OTHER_TEST_ID, ctx->flags_id);
+}
+
+static void test_sixlowpan_ctx_update__prefix_len_changed(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_PREFIX;
+    ipv6_addr_t other = WRONG_TEST_PREFIX;
+    gnrc_sixlowpan_ctx_t *ctx;
+
+    test_sixlowpan_ctx_lookup_addr__longest_prefix();
+    /* shorten the longer prefix below the other one */
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(DEFAULT_TEST_ID, &addr, 16,
+                                                   TEST_UINT16, true));
+    TEST_ASSERT_NOT_NULL((ctx = gnrc_sixlowpan_ctx_lookup_addr(&other)));
+    TEST_ASSERT_EQUAL_INT(GNRC_SIXLOWPAN_CTX_FLAGS_COMP | OTHER_TEST_ID, ctx->flags_id);
+    /* bits after the prefix length are cleared */
+    ctx = gnrc_sixlowpan_ctx_lookup_id(DEFAULT_TEST_ID);
+    for (unsigned i = 2; i < sizeof(ipv6_addr_t); i++) {
+        TEST_ASSERT_EQUAL_INT(0, ctx->prefix.u8[i]);
+    }
+    other.u8[0] = 0xff;
+    TEST_ASSERT_NULL(gnrc_sixlowpan_ctx_lookup_addr(&other));
+}
+
+static void test_sixlowpan_ctx_update__generation(void)
+{
+    uint16_t generation = gnrc_sixlowpan_ctx_generation();
+
+    test_sixlowpan_ctx_update__success();
+    TEST_ASSERT(generation != gnrc_sixlowpan_ctx_generation());
+    generation = gnrc_sixlowpan_ctx_generation();
+    gnrc_sixlowpan_ctx_remove(DEFAULT_TEST_ID);
+    TEST_ASSERT(generation != gnrc_sixlowpan_ctx_generation());
+}
+
+/*
+ * @brief measuring address to context matching with a full context buffer
+ * Every address matches a /64 context and a /16 context covering all of them;
+ * the last address only matches the /16 context.
+ */
+static void test_sixlowpan_ctx_lookup_addr__throughput(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_PREFIX;
+    uint32_t start, duration;
+
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(0, &addr, 16, TEST_UINT16, true));
+    for (uint8_t id = 1; id < GNRC_SIXLOWPAN_CTX_SIZE; id++) {
+        addr.u8[7] = id;
+        TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(id, &addr, 64, TEST_UINT16, true));
+    }
+
+    start = xtimer_now();
+    for (unsigned n = 0; n < BENCH_LOOKUPS; n++) {
+        gnrc_sixlowpan_ctx_t *ctx;
+
+        addr.u8[7] = (uint8_t)(n % (GNRC_SIXLOWPAN_CTX_SIZE + 1));
+        TEST_ASSERT_NOT_NULL((ctx = gnrc_sixlowpan_ctx_lookup_addr(&addr)));
+        if ((addr.u8[7] > 0) && (addr.u8[7] < GNRC_SIXLOWPAN_CTX_SIZE)) {
+            TEST_ASSERT_EQUAL_INT(addr.u8[7],
+                                  ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
+        }
+        else {
+            TEST_ASSERT_EQUAL_INT(0, ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
+        }
+    }
+    duration = xtimer_now() - start;
+
+    printf("\nsixlowpan_ctx: %2u contexts, %5lu ns/lookup\n",
+           (unsigned)GNRC_SIXLOWPAN_CTX_SIZE,
+           (unsigned long)(((uint64_t)duration * 1000) / BENCH_LOOKUPS));
+}
+
 Test *tests_sixlowpan_ctx_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -211,6 +313,11 @@ Test *tests_sixlowpan_ctx_tests(void)
         new_TestFixture(test_sixlowpan_ctx_lookup_id__wrong_id),
         new_TestFixture(test_sixlowpan_ctx_lookup_id__success),
         new_TestFixture(test_sixlowpan_ctx_remove),
+        new_TestFixture(test_sixlowpan_ctx_lookup_addr__longest_prefix),
+        new_TestFixture(test_sixlowpan_ctx_lookup_addr__shorter_prefix),
+        new_TestFixture(test_sixlowpan_ctx_update__prefix_len_changed),
+        new_TestFixture(test_sixlowpan_ctx_update__generation),
+        new_TestFixture(test_sixlowpan_ctx_lookup_addr__throughput),
     };
 
     EMB_UNIT_TESTCALLER(sixlowpan_ctx_tests, NULL, tear_down, fixtures);
@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ *
+ * The expected headers are taken from RFC 6282. All packets are sent from
+ * fe80::1 to fe80::2 over the link-layer addresses below, unless noted.
+ */
+#include <stdint.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "byteorder.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/nettype.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/sixlowpan/ctx.h"
+#include "net/gnrc/sixlowpan/iphc.h"
+#include "net/ipv6/addr.h"
+#include "net/ipv6/hdr.h"
+
+#include "tests-sixlowpan_iphc.h"
+
+#define TEST_HL                 (64U)
+#define TEST_NH                 (0x3a)  /* ICMPv6 */
+
+#define TEST_LL_SRC             { { \
+            0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, \
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 \
+        } \
+    }
+#define TEST_LL_DST             { { \
+            0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, \
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 \
+        } \
+    }
+
+#define TEST_PREFIX             { { \
+            0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, \
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 \
+        } \
+    }
+#define TEST_PREFIX_LEN         (64U)
+#define TEST_LTIME              (60U)
+#define TEST_CID                (1U)
+/* ff3e:40:2001:db8::1234:5678, based on TEST_PREFIX */
+#define TEST_MCAST_UC_PREFIX    { { \
+            0xff, 0x3e, 0x00, 0x40, 0x20, 0x01, 0x0d, 0xb8, \
+            0x00, 0x00, 0x00, 0x00, 0x12, 0x34, 0x56, 0x78 \
+        } \
+    }
+
+static uint8_t _l2_src[] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 };
+static uint8_t _l2_dst[] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 };
+
+static void set_up(void)
+{
+    gnrc_pktbuf_init();
+}
+
+static void tear_down(void)
+{
+    gnrc_sixlowpan_ctx_reset();
+}
+
+static void _init_hdr(ipv6_hdr_t *hdr, uint8_t tc, uint32_t fl)
+{
+    ipv6_addr_t src = TEST_LL_SRC, dst = TEST_LL_DST;
+
+    memset(hdr, 0, sizeof(ipv6_hdr_t));
+    ipv6_hdr_set_version(hdr);
+    ipv6_hdr_set_tc(hdr, tc);
+    ipv6_hdr_set_fl(hdr, fl);
+    hdr->nh = TEST_NH;
+    hdr->hl = TEST_HL;
+    hdr->src = src;
+    hdr->dst = dst;
+}
+
+/* compresses hdr and compares the result with the expected IPHC header */
+static void _encode(ipv6_hdr_t *hdr, const uint8_t *exp, size_t exp_len)
+{
+    gnrc_pktsnip_t *netif, *ipv6;
+
+    ipv6 = gnrc_pktbuf_add(NULL, hdr, sizeof(ipv6_hdr_t), GNRC_NETTYPE_IPV6);
+    TEST_ASSERT_NOT_NULL(ipv6);
+    netif = gnrc_netif_hdr_build(_l2_src, sizeof(_l2_src), _l2_dst, sizeof(_l2_dst));
+    TEST_ASSERT_NOT_NULL(netif);
+    netif->next = ipv6;
+    TEST_ASSERT(gnrc_sixlowpan_iphc_encode(netif));
+    TEST_ASSERT_NOT_NULL(netif->next);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_SIXLOWPAN, netif->next->type);
+    TEST_ASSERT_EQUAL_INT(exp_len, netif->next->size);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(exp, netif->next->data, exp_len));
+    gnrc_pktbuf_release(netif);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+/* decodes the IPHC header in data into an IPv6 header filled with garbage */
+static void _decode(ipv6_hdr_t *hdr, uint8_t *data, size_t len)
+{
+    gnrc_pktsnip_t *netif, *pkt, *ipv6;
+    size_t nh_len;
+
+    netif = gnrc_netif_hdr_build(_l2_src, sizeof(_l2_src), _l2_dst, sizeof(_l2_dst));
+    TEST_ASSERT_NOT_NULL(netif);
+    pkt = gnrc_pktbuf_add(netif, data, len, GNRC_NETTYPE_SIXLOWPAN);
+    TEST_ASSERT_NOT_NULL(pkt);
+    ipv6 = gnrc_pktbuf_add(NULL, NULL, GNRC_SIXLOWPAN_IPHC_HDR_MAX, GNRC_NETTYPE_IPV6);
+    TEST_ASSERT_NOT_NULL(ipv6);
+    memset(ipv6->data, 0xff, ipv6->size);
+    TEST_ASSERT_EQUAL_INT(len, gnrc_sixlowpan_iphc_decode(ipv6, pkt, 0, 0, &nh_len));
+    TEST_ASSERT_EQUAL_INT(0, nh_len);
+    memcpy(hdr, ipv6->data, sizeof(ipv6_hdr_t));
+    gnrc_pktbuf_release(pkt);
+    gnrc_pktbuf_release(ipv6);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_sixlowpan_iphc_decode__tf_inline(void)
+{
+    /* TF = 00: ECN + DSCP + 4-bit pad + flow label inline */
+    uint8_t data[] = { 0x62, 0x33, 0x00, 0x0a, 0xbc, 0xde, TEST_NH };
+    ipv6_addr_t src = TEST_LL_SRC, dst = TEST_LL_DST;
+    ipv6_hdr_t hdr;
+
+    _decode(&hdr, data, sizeof(data));
+    TEST_ASSERT_EQUAL_INT(0x600abcde, byteorder_ntohl(hdr.v_tc_fl));
+    TEST_ASSERT_EQUAL_INT(TEST_NH, hdr.nh);
+    TEST_ASSERT_EQUAL_INT(TEST_HL, hdr.hl);
+    TEST_ASSERT(ipv6_addr_equal(&src, &hdr.src));
+    TEST_ASSERT(ipv6_addr_equal(&dst, &hdr.dst));
+}
+
+static void test_sixlowpan_iphc_encode__fl_inline(void)
+{
+    /* TF = 01: ECN + 2-bit pad + flow label inline, DSCP elided */
+    uint8_t exp[] = { 0x6a, 0x33, 0x01, 0x23, 0x45, TEST_NH };
+    ipv6_hdr_t hdr;
+
+    _init_hdr(&hdr, 0, 0x12345);
+    _encode(&hdr, exp, sizeof(exp));
+    _decode(&hdr, exp, sizeof(exp));
+    TEST_ASSERT_EQUAL_INT(0x60012345, byteorder_ntohl(hdr.v_tc_fl));
+}
+
+static void test_sixlowpan_iphc_encode__tc_inline(void)
+{
+    /* TF = 10: ECN + DSCP inline, flow label elided */
+    uint8_t exp[] = { 0x72, 0x33, 0x6e, TEST_NH };
+    /* DSCP 46 (expedited forwarding) and ECN 1 in IPv6 (RFC 3168) order */
+    uint8_t tc = (46 << 2) | 1;
+    ipv6_hdr_t hdr;
+
+    _init_hdr(&hdr, tc, 0);
+    _encode(&hdr, exp, sizeof(exp));
+    _decode(&hdr, exp, sizeof(exp));
+    TEST_ASSERT_EQUAL_INT(tc, ipv6_hdr_get_tc(&hdr));
+    TEST_ASSERT_EQUAL_INT(0, ipv6_hdr_get_fl(&hdr));
+}
+
+static void test_sixlowpan_iphc_encode__ecn_fl_inline(void)
+{
+    /* TF = 01: ECN + 2-bit pad + flow label inline, DSCP elided */
+    uint8_t exp[] = { 0x6a, 0x33, 0x41, 0x23, 0x45, TEST_NH };
+    ipv6_hdr_t hdr;
+
+    _init_hdr(&hdr, 1, 0x12345);
+    _encode(&hdr, exp, sizeof(exp));
+    _decode(&hdr, exp, sizeof(exp));
+    TEST_ASSERT_EQUAL_INT(1, ipv6_hdr_get_tc(&hdr));
+    TEST_ASSERT_EQUAL_INT(0x12345, ipv6_hdr_get_fl(&hdr));
+}
+
+static void _init_global_hdr(ipv6_hdr_t *hdr)
+{
+    ipv6_addr_t prefix = TEST_PREFIX;
+
+    _init_hdr(hdr, 0, 0);
+    /* 2001:db8::1 and 2001:db8::2, IIDs derived from the link-layer */
+    ipv6_addr_init_prefix(&hdr->src, &prefix, TEST_PREFIX_LEN);
+    ipv6_addr_init_prefix(&hdr->dst, &prefix, TEST_PREFIX_LEN);
+}
+
+static void test_sixlowpan_iphc_encode__ctx_no_comp(void)
+{
+    /* SAC = 0, SAM = 00 and DAC = 0, DAM = 00: both addresses inline */
+    uint8_t exp[3 + (2 * sizeof(ipv6_addr_t))] = { 0x7a, 0x00, TEST_NH };
+    ipv6_addr_t prefix = TEST_PREFIX;
+    ipv6_hdr_t hdr;
+
+    /* context may only be used for decompression */
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(0, &prefix, TEST_PREFIX_LEN,
+                                                   TEST_LTIME, false));
+    _init_global_hdr(&hdr);
+    memcpy(&exp[3], &hdr.src, sizeof(ipv6_addr_t));
+    memcpy(&exp[3 + sizeof(ipv6_addr_t)], &hdr.dst, sizeof(ipv6_addr_t));
+    _encode(&hdr, exp, sizeof(exp));
+}
+
+static void test_sixlowpan_iphc_encode__ctx_comp(void)
+{
+    /* SAC = 1, SAM = 11 and DAC = 1, DAM = 11: both addresses from context 0
+     * and the link-layer addresses */
+    uint8_t exp[] = { 0x7a, 0x77, TEST_NH };
+    ipv6_addr_t prefix = TEST_PREFIX;
+    ipv6_hdr_t hdr, res;
+
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(0, &prefix, TEST_PREFIX_LEN,
+                                                   TEST_LTIME, true));
+    _init_global_hdr(&hdr);
+    _encode(&hdr, exp, sizeof(exp));
+    _decode(&res, exp, sizeof(exp));
+    TEST_ASSERT(ipv6_addr_equal(&hdr.src, &res.src));
+    TEST_ASSERT(ipv6_addr_equal(&hdr.dst, &res.dst));
+}
+
+static void test_sixlowpan_iphc_encode__mcast_uc_prefix(void)
+{
+    /* CID = 1, SAC = 0, SAM = 11, M = 1, DAC = 1, DAM = 00: destination
+     * from context TEST_CID, which requires the CID extension */
+    uint8_t exp[] = { 0x7a, 0xbc, TEST_CID, TEST_NH,
+                      0x3e, 0x00, 0x12, 0x34, 0x56, 0x78 };
+    ipv6_addr_t prefix = TEST_PREFIX, dst = TEST_MCAST_UC_PREFIX;
+    ipv6_hdr_t hdr;
+
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(TEST_CID, &prefix, TEST_PREFIX_LEN,
+                                                   TEST_LTIME, true));
+    _init_hdr(&hdr, 0, 0);
+    hdr.dst = dst;
+    _encode(&hdr, exp, sizeof(exp));
+    _decode(&hdr, exp, sizeof(exp));
+    TEST_ASSERT(ipv6_addr_equal(&dst, &hdr.dst));
+}
+
+static void test_sixlowpan_iphc_encode__ctx_removed(void)
+{
+    /* SAC = 0, SAM = 00 and DAC = 0, DAM = 00: both addresses inline */
+    uint8_t exp[3 + (2 * sizeof(ipv6_addr_t))] = { 0x7a, 0x00, TEST_NH };
+    ipv6_addr_t prefix = TEST_PREFIX;
+    ipv6_hdr_t hdr;
+
+    /* neither of these contexts exist */
+    gnrc_sixlowpan_ctx_remove(TEST_CID);
+    gnrc_sixlowpan_ctx_remove(GNRC_SIXLOWPAN_CTX_SIZE);
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(0, &prefix, TEST_PREFIX_LEN,
+                                                   TEST_LTIME, true));
+    gnrc_sixlowpan_ctx_remove(0);
+    _init_global_hdr(&hdr);
+    memcpy(&exp[3], &hdr.src, sizeof(ipv6_addr_t));
+    memcpy(&exp[3 + sizeof(ipv6_addr_t)], &hdr.dst, sizeof(ipv6_addr_t));
+    _encode(&hdr, exp, sizeof(exp));
+}
+
+Test *tests_sixlowpan_iphc_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_sixlowpan_iphc_decode__tf_inline),
+        new_TestFixture(test_sixlowpan_iphc_encode__fl_inline),
+        new_TestFixture(test_sixlowpan_iphc_encode__tc_inline),
+        new_TestFixture(test_sixlowpan_iphc_encode__ecn_fl_inline),
+        new_TestFixture(test_sixlowpan_iphc_encode__ctx_no_comp),
+        new_TestFixture(test_sixlowpan_iphc_encode__ctx_comp),
+        new_TestFixture(test_sixlowpan_iphc_encode__mcast_uc_prefix),
+        new_TestFixture(test_sixlowpan_iphc_encode__ctx_removed),
+    };
+
+    EMB_UNIT_TESTCALLER(sixlowpan_iphc_tests, set_up, tear_down, fixtures);
+
+    return (Test *)&sixlowpan_iphc_tests;
+}
+
+void tests_sixlowpan_iphc(void)
+{
+    TESTS_RUN(tests_sixlowpan_iphc_tests());
+}
+/** @} */
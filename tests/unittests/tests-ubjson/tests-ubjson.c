@@ -26,7 +26,7 @@
 #include "irq.h"
 
 static pipe_t communication_pipe;
-static ringbuffer_t pipe_rb;
+static tsrb_t pipe_rb;
 static char pipe_buffer[16];
 
 static char receiver_stack[THREAD_STACKSIZE_DEFAULT];
@@ -39,7 +39,7 @@ typedef struct {
 
 static void ubjson_set_up(void)
 {
-    ringbuffer_init(&pipe_rb, pipe_buffer, sizeof(pipe_buffer));
+    tsrb_init(&pipe_rb, pipe_buffer, sizeof(pipe_buffer));
     pipe_init(&communication_pipe, &pipe_rb, NULL);
 }
 
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measures xtimer insert/remove cost and ISR duration for
+ *              different numbers of armed timers
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "random.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define TIMERS_MAX      (1000U)
+/* far enough in the future to never fire during a measurement */
+#define FAR_OFFSET      (10U * SEC_IN_USEC)
+#define FAR_SPREAD      (SEC_IN_USEC)
+/* the timers to measure ISR duration all fire at this offset, far enough
+ * in the future to arm all of them before */
+#define NEAR_OFFSET     (SEC_IN_USEC)
+
+static xtimer_t timers[TIMERS_MAX];
+static volatile unsigned fired;
+static volatile uint32_t last_fire;
+
+static void _cb(void *arg)
+{
+    (void)arg;
+    fired++;
+    last_fire = xtimer_now();
+}
+
+static void _arm(unsigned num, uint32_t offset, uint32_t spread)
+{
+    for (unsigned i = 0; i < num; i++) {
+        timers[i].callback = _cb;
+        timers[i].arg = NULL;
+        xtimer_set(&timers[i], offset + (genrand_uint32() % spread));
+    }
+}
+
+static void _arm_at(unsigned num, uint32_t target)
+{
+    for (unsigned i = 0; i < num; i++) {
+        timers[i].callback = _cb;
+        timers[i].arg = NULL;
+        _xtimer_set_absolute(&timers[i], target);
+    }
+}
+
+static void bench(unsigned num)
+{
+    uint32_t start, set_time, remove_time, isr_time;
+
+    /* insert */
+    start = xtimer_now();
+    _arm(num, FAR_OFFSET, FAR_SPREAD);
+    set_time = xtimer_now() - start;
+
+    /* remove, in a different order than inserted */
+    start = xtimer_now();
+    for (unsigned i = 0; i < num; i += 2) {
+        xtimer_remove(&timers[i]);
+    }
+    for (unsigned i = 1; i < num; i += 2) {
+        xtimer_remove(&timers[i]);
+    }
+    remove_time = xtimer_now() - start;
+
+    /* time spent in the ISR: the timers share their target, so one ISR
+     * pops and fires all of them back to back from that target on, without
+     * waiting for later targets in between */
+    fired = 0;
+    start = xtimer_now() + NEAR_OFFSET;
+    _arm_at(num, start);
+    while (fired < num) {
+        thread_yield();
+    }
+    isr_time = last_fire - start;
+
+    printf("+ %4u timers: set %5lu ns/op, remove %5lu ns/op, "
+           "ISR %5lu ns/timer\n", num,
+           (unsigned long)((set_time * 1000UL) / num),
+           (unsigned long)((remove_time * 1000UL) / num),
+           (unsigned long)((isr_time * 1000UL) / num));
+}
+
+int main(void)
+{
+    puts("Start.");
+#ifdef MODULE_XTIMER_HEAP
+    puts("backend: pairing heap");
+#else
+    puts("backend: sorted lists");
+#endif
+
+    genrand_init(0);
+
+    bench(10);
+    bench(100);
+    bench(1000);
+
+    puts("Done.");
+    return 0;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Compares the number of low-level timer interrupts of
+ *              xtimer_set_msg() and xtimer_set_msg_slack()
+ *
+ * A number of periodic timers with random periods, similar to trickle and
+ * retransmission timers of a network stack, is run once without and once with
+ * a tolerance window of a quarter of their period.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "msg.h"
+#include "random.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define PERIODIC_NUMOF     (16U)
+#define PERIOD_MIN      (50U * MS_IN_USEC)
+#define PERIOD_SPREAD   (200U * MS_IN_USEC)
+#define RUNTIME_S       (5U)
+#define MSG_TYPE_DONE   (0x5ac0)
+
+static xtimer_t timers[PERIODIC_NUMOF];
+static msg_t msgs[PERIODIC_NUMOF];
+static uint32_t periods[PERIODIC_NUMOF];
+static msg_t queue[PERIODIC_NUMOF * 2];
+
+static void _arm(unsigned i, int slack)
+{
+    msgs[i].content.value = i;
+    if (slack) {
+        xtimer_set_msg_slack(&timers[i], periods[i], periods[i] / 4, &msgs[i],
+                             thread_getpid());
+    }
+    else {
+        xtimer_set_msg(&timers[i], periods[i], &msgs[i], thread_getpid());
+    }
+}
+
+static void run(int slack)
+{
+    xtimer_t done_timer = { 0 };
+    msg_t done_msg, m;
+    unsigned expired = 0;
+
+    done_msg.type = MSG_TYPE_DONE;
+    for (unsigned i = 0; i < PERIODIC_NUMOF; i++) {
+        msgs[i].type = 0;
+        _arm(i, slack);
+    }
+
+    uint32_t isr_count = xtimer_isr_count;
+    xtimer_set_msg(&done_timer, RUNTIME_S * SEC_IN_USEC, &done_msg,
+                   thread_getpid());
+
+    while (1) {
+        msg_receive(&m);
+        if (m.type == MSG_TYPE_DONE) {
+            break;
+        }
+        expired++;
+        _arm(m.content.value, slack);
+    }
+    isr_count = xtimer_isr_count - isr_count;
+
+    for (unsigned i = 0; i < PERIODIC_NUMOF; i++) {
+        xtimer_remove(&timers[i]);
+    }
+    /* drop messages of timers that fired meanwhile */
+    while (msg_try_receive(&m) > 0) {}
+
+    printf("+ %s: %u expirations, %lu timer interrupts per second\n",
+           slack ? "with slack   " : "without slack", expired,
+           (unsigned long)(isr_count / RUNTIME_S));
+}
+
+int main(void)
+{
+    puts("Start.");
+
+    msg_init_queue(queue, sizeof(queue) / sizeof(queue[0]));
+    genrand_init(0);
+    for (unsigned i = 0; i < PERIODIC_NUMOF; i++) {
+        periods[i] = PERIOD_MIN + (genrand_uint32() % PERIOD_SPREAD);
+    }
+
+    run(0);
+    run(1);
+
+    puts("Done.");
+    return 0;
+}